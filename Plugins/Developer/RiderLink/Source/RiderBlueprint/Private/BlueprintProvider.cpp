@@ -1,5 +1,7 @@
 #include "BlueprintProvider.hpp"
 
+#include "BlueprintUsageIndex.hpp"
+
 #include "Async/Async.h"
 
 #include "AssetEditorMessages.h"
@@ -17,26 +19,222 @@
 
 #if ENGINE_MAJOR_VERSION < 5
 #include "AssetData.h"
+#include "AssetRegistryModule.h"
 #else
 #include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/AssetRegistryModule.h"
 #endif
+#include "Containers/Ticker.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/ScopeRWLock.h"
+#include "UObject/StrongObjectPtr.h"
+#include "Widgets/Notifications/SNotificationList.h"
 
-void BluePrintProvider::AddAsset(FAssetData const& AssetData) {
-#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 23
-    UObject* cls = AssetData.GetAsset();
+namespace BlueprintProviderImpl
+{
+    // Only hashes of package names are kept, so lookup of path range from log line doesn't need any string
+    FRWLock AssetIndexLock;
+    TMap<uint64, int32> KnownPackages;
+
+    static uint64 HashPackageName(const TCHAR* Name, int32 Length) {
+        // FNV-1a over lowercase characters, package names are case insensitive
+        uint64 Hash = 0xcbf29ce484222325ull;
+        for (int32 Index = 0; Index < Length; ++Index) {
+            Hash ^= static_cast<uint64>(FChar::ToLower(Name[Index]));
+            Hash *= 0x100000001b3ull;
+        }
+        return Hash;
+    }
+
+    static uint64 HashPackageName(FName const& PackageName) {
+        const FString Name = PackageName.ToString();
+        return HashPackageName(*Name, Name.Len());
+    }
+
+    static void AddPackage(uint64 Hash) {
+        FRWScopeLock Lock(AssetIndexLock, SLT_Write);
+        KnownPackages.FindOrAdd(Hash)++;
+    }
+
+    static void RemovePackage(uint64 Hash) {
+        FRWScopeLock Lock(AssetIndexLock, SLT_Write);
+        int32* Count = KnownPackages.Find(Hash);
+        if (Count && --(*Count) <= 0) {
+            KnownPackages.Remove(Hash);
+        }
+    }
+
+#if ENGINE_MAJOR_VERSION < 5
+    using FOpenTicker = FTicker;
+    using FOpenTickerHandle = FDelegateHandle;
 #else
-    UObject* cls = AssetData.FastGetAsset();
+    using FOpenTicker = FTSTicker;
+    using FOpenTickerHandle = FTSTicker::FDelegateHandle;
 #endif
-    if (cls) {
-        UBlueprint* Blueprint = Cast<UBlueprint>(cls);
-        if (Blueprint && Blueprint->IsValidLowLevel()) {
 
+    // Blueprint requested from IDE is loaded ahead of other streaming requests
+    constexpr int32 OpenLoadPriority = 100;
+    // Progress is shown only for loads that weren't finished almost instantly
+    constexpr float OpenProgressDelay = 0.25f;
+    constexpr int32 MaxRecentBlueprints = 8;
+    const TCHAR* const ConfigSection = TEXT("RiderLink");
+    const TCHAR* const RecentBlueprintsKey = TEXT("RecentBlueprints");
+
+    // Each request from IDE supersedes previous one, late completion of older load is ignored
+    uint32 LastOpenRequestId = 0;
+    FString OpeningPackageName;
+    FOpenTickerHandle OpenProgressTicker;
+    TSharedPtr<SNotificationItem> OpenNotification;
+
+    // Recently navigated blueprints are kept loaded, so navigating back to them is instant
+    TArray<TStrongObjectPtr<UPackage>> RecentPackages;
+
+    static bool TickOpenProgress(float DeltaTime) {
+        const float Percentage = GetAsyncLoadPercentage(FName(*OpeningPackageName));
+        const FText Text = FText::FromString(Percentage >= 0.f
+            ? FString::Printf(TEXT("Opening %s... %d%%"), *FPaths::GetBaseFilename(OpeningPackageName), FMath::FloorToInt(Percentage))
+            : FString::Printf(TEXT("Opening %s..."), *FPaths::GetBaseFilename(OpeningPackageName)));
+
+        if (!OpenNotification.IsValid()) {
+            FNotificationInfo Info(Text);
+            Info.bFireAndForget = false;
+            Info.bUseThrobber = true;
+            OpenNotification = FSlateNotificationManager::Get().AddNotification(Info);
+            if (OpenNotification.IsValid()) {
+                OpenNotification->SetCompletionState(SNotificationItem::CS_Pending);
+            }
+        }
+        else {
+            OpenNotification->SetText(Text);
         }
+        return true;
     }
+
+    static void StartOpenProgress(const FString& PackageName) {
+        OpeningPackageName = PackageName;
+        if (!OpenProgressTicker.IsValid()) {
+            OpenProgressTicker = FOpenTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&TickOpenProgress), OpenProgressDelay);
+        }
+    }
+
+    static void StopOpenProgress(bool bSucceeded) {
+        if (OpenProgressTicker.IsValid()) {
+            FOpenTicker::GetCoreTicker().RemoveTicker(OpenProgressTicker);
+            OpenProgressTicker.Reset();
+        }
+        if (OpenNotification.IsValid()) {
+            if (!bSucceeded) {
+                OpenNotification->SetText(FText::FromString(FString::Printf(TEXT("Failed to open %s"), *FPaths::GetBaseFilename(OpeningPackageName))));
+            }
+            OpenNotification->SetCompletionState(bSucceeded ? SNotificationItem::CS_Success : SNotificationItem::CS_Fail);
+            OpenNotification->ExpireAndFadeout();
+            OpenNotification.Reset();
+        }
+    }
+
+    static void AddRecentPackage(UPackage* Package) {
+        RecentPackages.RemoveAll([Package](const TStrongObjectPtr<UPackage>& Recent) { return Recent.Get() == Package; });
+        RecentPackages.Insert(TStrongObjectPtr<UPackage>(Package), 0);
+        if (RecentPackages.Num() > MaxRecentBlueprints) {
+            RecentPackages.SetNum(MaxRecentBlueprints);
+        }
+    }
+
+    static void SaveRecentPackages() {
+        TArray<FString> PackageNames;
+        for (const TStrongObjectPtr<UPackage>& Recent : RecentPackages) {
+            if (Recent.IsValid()) {
+                PackageNames.Add(Recent->GetName());
+            }
+        }
+        GConfig->SetArray(ConfigSection, RecentBlueprintsKey, PackageNames, GEditorPerProjectIni);
+    }
+
+#if !(ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 23)
+    static void FocusBlueprint(UPackage* Package, const FString& AssetPathName, const FGuid& AssetGuid, bool bIsValidGuid) {
+        Package->FullyLoad();
+
+        const FString AssetName = FPaths::GetBaseFilename(AssetPathName);
+        UObject* Object = FindObject<UObject>(Package, *AssetName);
+        const UBlueprint* Blueprint = Cast<UBlueprint>(Object);
+
+        if (Object != nullptr) {
+            AddRecentPackage(Package);
+            SaveRecentPackages();
+        }
+
+        if(bIsValidGuid && Blueprint != nullptr)
+        {
+            UEdGraphNode* EdGraphNode = FBlueprintEditorUtils::GetNodeByGUID(Blueprint, AssetGuid);
+            if(EdGraphNode != nullptr)
+            {
+                FKismetEditorUtilities::BringKismetToFocusAttentionOnObject(EdGraphNode); 
+            }
+            else
+            {
+                FKismetEditorUtilities::BringKismetToFocusAttentionOnObject(Blueprint);
+            }
+        }
+        else if(Object != nullptr)
+        {      
+            GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OpenEditorForAsset(Object);         
+        }
+    }
+#endif
+}
+
+void BluePrintProvider::AddAsset(FAssetData const& AssetData) {
+    BlueprintProviderImpl::AddPackage(BlueprintProviderImpl::HashPackageName(AssetData.PackageName));
+}
+
+void BluePrintProvider::RemoveAsset(FAssetData const& AssetData) {
+    BlueprintProviderImpl::RemovePackage(BlueprintProviderImpl::HashPackageName(AssetData.PackageName));
+}
+
+void BluePrintProvider::RenameAsset(FAssetData const& AssetData, FString const& OldObjectPath) {
+    int32 DotIndex = INDEX_NONE;
+    const int32 OldPackageLength = OldObjectPath.FindChar(TEXT('.'), DotIndex) ? DotIndex : OldObjectPath.Len();
+    BlueprintProviderImpl::RemovePackage(BlueprintProviderImpl::HashPackageName(*OldObjectPath, OldPackageLength));
+    AddAsset(AssetData);
+}
+
+void BluePrintProvider::RebuildAssetIndex() {
+    const IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+
+    TArray<FAssetData> Assets;
+    AssetRegistry.GetAllAssets(Assets);
+
+    TMap<uint64, int32> Packages;
+    Packages.Reserve(Assets.Num());
+    for (const FAssetData& AssetData : Assets) {
+        Packages.FindOrAdd(BlueprintProviderImpl::HashPackageName(AssetData.PackageName))++;
+    }
+
+    FRWScopeLock Lock(BlueprintProviderImpl::AssetIndexLock, SLT_Write);
+    BlueprintProviderImpl::KnownPackages = MoveTemp(Packages);
 }
 
 bool BluePrintProvider::IsBlueprint(FString const& pathName) {
-    return FPackageName::IsValidObjectPath(pathName);
+    return IsBlueprint(*pathName, pathName.Len());
+}
+
+bool BluePrintProvider::IsBlueprint(const TCHAR* PathName, int32 Length) {
+    // Object path is "/Package/Name.Object", only package part is looked up
+    int32 DotIndex = 0;
+    while (DotIndex < Length && PathName[DotIndex] != TEXT('.')) {
+        ++DotIndex;
+    }
+    if (DotIndex == 0 || PathName[0] != TEXT('/') || DotIndex >= Length - 1) return false;
+
+    const uint64 Hash = BlueprintProviderImpl::HashPackageName(PathName, DotIndex);
+
+    FRWScopeLock Lock(BlueprintProviderImpl::AssetIndexLock, SLT_ReadOnly);
+    return BlueprintProviderImpl::KnownPackages.Contains(Hash);
+}
+
+TArray<FString> BluePrintProvider::FindBlueprintUsages(FString const& Name) {
+    return FBlueprintUsageIndex::Get().FindUsages(Name);
 }
 
 void BluePrintProvider::OpenBlueprint(JetBrains::EditorPlugin::BlueprintReference const& BlueprintReference, TSharedPtr<FMessageEndpoint, ESPMode::ThreadSafe> const& messageEndpoint) {
@@ -50,34 +248,60 @@ void BluePrintProvider::OpenBlueprint(JetBrains::EditorPlugin::BlueprintReferenc
 #else
     AsyncTask(ENamedThreads::GameThread, [AssetPathName, AssetGuid, bIsValidGuid]()
     {
-        // An asset needs loading
-        UPackage* Package = LoadPackage(nullptr, *AssetPathName, LOAD_NoRedirects);
+        using namespace BlueprintProviderImpl;
 
-        if (Package)
-        {
-            Package->FullyLoad();
+        const uint32 RequestId = ++LastOpenRequestId;
+        const FString PackageName = FPackageName::ObjectPathToPackageName(AssetPathName);
 
-            const FString AssetName = FPaths::GetBaseFilename(AssetPathName);
-            UObject* Object = FindObject<UObject>(Package, *AssetName);
-            const UBlueprint* Blueprint = Cast<UBlueprint>(Object);
+        // Already loaded, e.g. recently navigated, no need to go through async loading
+        UPackage* LoadedPackage = FindPackage(nullptr, *PackageName);
+        if (LoadedPackage && LoadedPackage->IsFullyLoaded())
+        {
+            StopOpenProgress(true);
+            FocusBlueprint(LoadedPackage, AssetPathName, AssetGuid, bIsValidGuid);
+            return;
+        }
 
-            if(bIsValidGuid && Blueprint != nullptr)
+        // Editor keeps ticking while package with all its dependencies is streamed in
+        StartOpenProgress(PackageName);
+        LoadPackageAsync(PackageName, FLoadPackageAsyncDelegate::CreateLambda(
+            [RequestId, AssetPathName, AssetGuid, bIsValidGuid](const FName&, UPackage* Package, EAsyncLoadingResult::Type Result)
             {
-                UEdGraphNode* EdGraphNode = FBlueprintEditorUtils::GetNodeByGUID(Blueprint, AssetGuid);
-                if(EdGraphNode != nullptr)
-                {
-                    FKismetEditorUtilities::BringKismetToFocusAttentionOnObject(EdGraphNode); 
-                }
-                else
+                // Superseded by newer request, loaded package is just left warm
+                if (RequestId != LastOpenRequestId) return;
+
+                const bool bSucceeded = Result == EAsyncLoadingResult::Succeeded && Package != nullptr;
+                StopOpenProgress(bSucceeded);
+                if (bSucceeded)
                 {
-                    FKismetEditorUtilities::BringKismetToFocusAttentionOnObject(Blueprint);
+                    FocusBlueprint(Package, AssetPathName, AssetGuid, bIsValidGuid);
                 }
-            }
-            else if(Object != nullptr)
-            {      
-                GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OpenEditorForAsset(Object);         
-            }
-        }
+            }), OpenLoadPriority);
     });
 #endif
 }
+
+void BluePrintProvider::PrewarmRecentBlueprints() {
+    TArray<FString> PackageNames;
+    GConfig->GetArray(BlueprintProviderImpl::ConfigSection, BlueprintProviderImpl::RecentBlueprintsKey, PackageNames, GEditorPerProjectIni);
+
+    // Loaded with default priority, so they don't compete with blueprints actually being opened
+    for (const FString& PackageName : PackageNames) {
+        if (FindPackage(nullptr, *PackageName) != nullptr || !FPackageName::DoesPackageExist(PackageName)) continue;
+
+        LoadPackageAsync(PackageName, FLoadPackageAsyncDelegate::CreateLambda(
+            [](const FName&, UPackage* Package, EAsyncLoadingResult::Type Result)
+            {
+                if (Result == EAsyncLoadingResult::Succeeded && Package != nullptr
+                    && BlueprintProviderImpl::RecentPackages.Num() < BlueprintProviderImpl::MaxRecentBlueprints)
+                {
+                    BlueprintProviderImpl::RecentPackages.Add(TStrongObjectPtr<UPackage>(Package));
+                }
+            }));
+    }
+}
+
+void BluePrintProvider::ReleaseRecentBlueprints() {
+    BlueprintProviderImpl::StopOpenProgress(false);
+    BlueprintProviderImpl::RecentPackages.Empty();
+}
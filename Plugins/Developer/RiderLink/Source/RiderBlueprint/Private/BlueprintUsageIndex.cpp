@@ -0,0 +1,504 @@
+#include "BlueprintUsageIndex.hpp"
+
+#include "RiderBlueprint.hpp"
+
+#include "Algo/BinarySearch.h"
+#include "Algo/Unique.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Blueprint.h"
+#include "Hash/CityHash.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#if ENGINE_MAJOR_VERSION < 5
+#include "AssetRegistryModule.h"
+#else
+#include "AssetRegistry/AssetRegistryModule.h"
+#endif
+
+namespace BlueprintUsageIndexImpl
+{
+    constexpr uint32 FileMagic = 0x58494242; // "BBIX"
+    constexpr uint32 FileVersion = 1;
+
+    // Smallest serialized asset: empty path length, content hash and empty token count
+    constexpr int64 MinAssetSize = sizeof(int32) + sizeof(uint64) + sizeof(int32);
+
+    // Shorter identifiers are mostly noise from display names and comments
+    constexpr int32 MinTokenLength = 3;
+
+    static FString GetIndexFilePath()
+    {
+        return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("RiderLink"), TEXT("BlueprintUsageIndex.bin"));
+    }
+
+    static bool IsIdentifierStart(TCHAR Char)
+    {
+        return (Char >= TEXT('a') && Char <= TEXT('z')) || (Char >= TEXT('A') && Char <= TEXT('Z')) || Char == TEXT('_');
+    }
+
+    static bool IsIdentifierChar(TCHAR Char)
+    {
+        return IsIdentifierStart(Char) || (Char >= TEXT('0') && Char <= TEXT('9'));
+    }
+
+    static TArray<int32> Intersect(const TArray<int32>& A, const TArray<int32>& B)
+    {
+        TArray<int32> Result;
+        int32 IndexA = 0, IndexB = 0;
+        while (IndexA < A.Num() && IndexB < B.Num())
+        {
+            if (A[IndexA] < B[IndexB]) ++IndexA;
+            else if (B[IndexB] < A[IndexA]) ++IndexB;
+            else
+            {
+                Result.Add(A[IndexA]);
+                ++IndexA;
+                ++IndexB;
+            }
+        }
+        return Result;
+    }
+
+    static TArray<int32> Union(const TArray<int32>& A, const TArray<int32>& B)
+    {
+        TArray<int32> Result;
+        Result.Reserve(A.Num() + B.Num());
+        int32 IndexA = 0, IndexB = 0;
+        while (IndexA < A.Num() || IndexB < B.Num())
+        {
+            if (IndexB == B.Num() || (IndexA < A.Num() && A[IndexA] < B[IndexB])) Result.Add(A[IndexA++]);
+            else if (IndexA == A.Num() || B[IndexB] < A[IndexA]) Result.Add(B[IndexB++]);
+            else
+            {
+                Result.Add(A[IndexA++]);
+                ++IndexB;
+            }
+        }
+        return Result;
+    }
+}
+
+FBlueprintUsageIndex& FBlueprintUsageIndex::Get()
+{
+    static FBlueprintUsageIndex Instance;
+    return Instance;
+}
+
+void FBlueprintUsageIndex::Startup()
+{
+    // Index of previous session is available right away, registry scan only refreshes it
+    EnqueueJob([this]() { Load(); });
+
+    IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+    if (!AssetRegistry.IsLoadingAssets())
+    {
+        RequestRebuild();
+    }
+
+    OnFilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FBlueprintUsageIndex::RequestRebuild);
+    OnAssetAddedHandle = AssetRegistry.OnAssetAdded().AddLambda([this, AssetRegistryPtr = &AssetRegistry](const FAssetData& AssetData)
+    {
+        // Assets found by initial scan are indexed all at once when it finishes
+        if (!AssetRegistryPtr->IsLoadingAssets())
+        {
+            OnAssetChanged(AssetData);
+        }
+    });
+    OnAssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FBlueprintUsageIndex::OnAssetChanged);
+    OnAssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FBlueprintUsageIndex::OnAssetRemoved);
+    OnAssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FBlueprintUsageIndex::OnAssetRenamed);
+}
+
+void FBlueprintUsageIndex::Shutdown()
+{
+    if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(AssetRegistryConstants::ModuleName))
+    {
+        IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+        AssetRegistry.OnFilesLoaded().Remove(OnFilesLoadedHandle);
+        AssetRegistry.OnAssetAdded().Remove(OnAssetAddedHandle);
+        AssetRegistry.OnAssetUpdated().Remove(OnAssetUpdatedHandle);
+        AssetRegistry.OnAssetRemoved().Remove(OnAssetRemovedHandle);
+        AssetRegistry.OnAssetRenamed().Remove(OnAssetRenamedHandle);
+    }
+
+    while (bWorkerRunning.load())
+    {
+        FPlatformProcess::Sleep(0.001f);
+    }
+}
+
+TArray<FString> FBlueprintUsageIndex::FindUsages(const FString& Name) const
+{
+    using namespace BlueprintUsageIndexImpl;
+
+    TArray<FString> Parts;
+    Name.ParseIntoArray(Parts, TEXT("::"), true);
+
+    FRWScopeLock Lock(IndexLock, SLT_ReadOnly);
+
+    TArray<int32> AssetsIds;
+    for (int32 PartIndex = 0; PartIndex < Parts.Num(); ++PartIndex)
+    {
+        FString Part = Parts[PartIndex].TrimStartAndEnd();
+        Part.RemoveFromStart(TEXT("~"));
+
+        const TArray<int32>* Posting = Postings.Find(HashToken(*Part, Part.Len()));
+        TArray<int32> PartIds = Posting ? *Posting : TArray<int32>();
+
+        // Blueprints refer to native types without prefix, AActor is stored as Actor
+        if (Part.Len() > 2 && FCString::Strchr(TEXT("AUFIEST"), Part[0]) != nullptr && FChar::IsUpper(Part[1]))
+        {
+            if (const TArray<int32>* UnprefixedPosting = Postings.Find(HashToken(*Part + 1, Part.Len() - 1)))
+            {
+                PartIds = Union(PartIds, *UnprefixedPosting);
+            }
+        }
+
+        AssetsIds = PartIndex == 0 ? MoveTemp(PartIds) : Intersect(AssetsIds, PartIds);
+        if (AssetsIds.Num() == 0) break;
+    }
+
+    TArray<FString> Result;
+    Result.Reserve(AssetsIds.Num());
+    for (const int32 AssetId : AssetsIds)
+    {
+        Result.Add(Assets[AssetId].ObjectPath);
+    }
+    return Result;
+}
+
+bool FBlueprintUsageIndex::IsIndexedAsset(const FAssetData& AssetData)
+{
+    return AssetData.TagsAndValues.Contains(FBlueprintTags::ParentClassPath) ||
+        AssetData.TagsAndValues.Contains(FBlueprintTags::FindInBlueprintsData);
+}
+
+FString FBlueprintUsageIndex::GetObjectPath(const FAssetData& AssetData)
+{
+#if ENGINE_MAJOR_VERSION < 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION < 1)
+    return AssetData.ObjectPath.ToString();
+#else
+    return AssetData.GetObjectPathString();
+#endif
+}
+
+FString FBlueprintUsageIndex::GetIndexedContent(const FAssetData& AssetData)
+{
+    // Find-in-Blueprints data already lists every node with names of called functions and used members
+    static const FName Tags[] = {
+        FBlueprintTags::ParentClassPath,
+        FBlueprintTags::NativeParentClassPath,
+        FBlueprintTags::ImplementedInterfaces,
+        FBlueprintTags::FindInBlueprintsData
+    };
+
+    FString Content;
+    FString Value;
+    for (const FName& Tag : Tags)
+    {
+        if (AssetData.GetTagValue(Tag, Value))
+        {
+            Content += Value;
+            Content += TEXT('\n');
+        }
+    }
+    return Content;
+}
+
+uint64 FBlueprintUsageIndex::HashToken(const TCHAR* Token, int32 Length)
+{
+    // FNV-1a over lowercase characters, names are case insensitive
+    uint64 Hash = 0xcbf29ce484222325ull;
+    for (int32 Index = 0; Index < Length; ++Index)
+    {
+        Hash ^= static_cast<uint64>(FChar::ToLower(Token[Index]));
+        Hash *= 0x100000001b3ull;
+    }
+    return Hash;
+}
+
+void FBlueprintUsageIndex::Tokenize(const FString& Content, TArray<uint64>& OutTokens)
+{
+    using namespace BlueprintUsageIndexImpl;
+
+    OutTokens.Reset();
+
+    const TCHAR* Text = *Content;
+    const int32 Length = Content.Len();
+    int32 Index = 0;
+    while (Index < Length)
+    {
+        if (!IsIdentifierStart(Text[Index]))
+        {
+            ++Index;
+            continue;
+        }
+
+        const int32 Start = Index;
+        while (Index < Length && IsIdentifierChar(Text[Index]))
+        {
+            ++Index;
+        }
+        if (Index - Start >= MinTokenLength)
+        {
+            OutTokens.Add(HashToken(Text + Start, Index - Start));
+        }
+    }
+
+    OutTokens.Sort();
+    OutTokens.SetNum(Algo::Unique(OutTokens));
+}
+
+void FBlueprintUsageIndex::EnqueueJob(TFunction<void()> Job)
+{
+    Jobs.Enqueue(MoveTemp(Job));
+    if (!bWorkerRunning.exchange(true))
+    {
+        Async(EAsyncExecution::ThreadPool, [this]() { ProcessJobs(); });
+    }
+}
+
+void FBlueprintUsageIndex::ProcessJobs()
+{
+    while (true)
+    {
+        TFunction<void()> Job;
+        while (Jobs.Dequeue(Job))
+        {
+            Job();
+        }
+
+        // Saved once per burst of changes, e.g. after saving many assets at once
+        if (bDirty)
+        {
+            bDirty = false;
+            Save();
+        }
+
+        bWorkerRunning.store(false);
+        if (Jobs.IsEmpty() || bWorkerRunning.exchange(true)) return;
+    }
+}
+
+void FBlueprintUsageIndex::RequestRebuild()
+{
+    IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+
+    FARFilter Filter;
+#if ENGINE_MAJOR_VERSION < 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION < 1)
+    Filter.ClassNames.Add(UBlueprint::StaticClass()->GetFName());
+#else
+    Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+#endif
+    Filter.bRecursiveClasses = true;
+
+    TArray<FAssetData> RegistryAssets;
+    AssetRegistry.GetAssets(Filter, RegistryAssets);
+
+    EnqueueJob([this, RegistryAssets = MoveTemp(RegistryAssets)]() { Rebuild(RegistryAssets); });
+}
+
+void FBlueprintUsageIndex::OnAssetChanged(const FAssetData& AssetData)
+{
+    if (!IsIndexedAsset(AssetData)) return;
+
+    EnqueueJob([this, AssetData]() { UpdateAsset(AssetData); });
+}
+
+void FBlueprintUsageIndex::OnAssetRemoved(const FAssetData& AssetData)
+{
+    EnqueueJob([this, ObjectPath = GetObjectPath(AssetData)]() { RemoveAsset(ObjectPath); });
+}
+
+void FBlueprintUsageIndex::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+    EnqueueJob([this, OldObjectPath]() { RemoveAsset(OldObjectPath); });
+    OnAssetChanged(AssetData);
+}
+
+void FBlueprintUsageIndex::Rebuild(const TArray<FAssetData>& RegistryAssets)
+{
+    // Only worker modifies the index, so it can be read here without lock
+    TArray<FIndexedAsset> NewAssets;
+    NewAssets.SetNum(RegistryAssets.Num());
+    ParallelFor(RegistryAssets.Num(), [this, &RegistryAssets, &NewAssets](int32 Index)
+    {
+        FIndexedAsset& Asset = NewAssets[Index];
+        Asset.ObjectPath = GetObjectPath(RegistryAssets[Index]);
+
+        const FString Content = GetIndexedContent(RegistryAssets[Index]);
+        Asset.ContentHash = CityHash64(reinterpret_cast<const char*>(*Content), Content.Len() * sizeof(TCHAR));
+
+        // Assets that didn't change since index was saved keep their tokens
+        const int32* OldAssetId = AssetIds.Find(Asset.ObjectPath);
+        if (OldAssetId && Assets[*OldAssetId].ContentHash == Asset.ContentHash)
+        {
+            Asset.Tokens = Assets[*OldAssetId].Tokens;
+        }
+        else
+        {
+            Tokenize(Content, Asset.Tokens);
+        }
+    });
+
+    FRWScopeLock Lock(IndexLock, SLT_Write);
+    Assets = MoveTemp(NewAssets);
+    AssetIds.Reset();
+    Postings.Reset();
+    for (int32 AssetId = 0; AssetId < Assets.Num(); ++AssetId)
+    {
+        AssetIds.Add(Assets[AssetId].ObjectPath, AssetId);
+        AddToPostings(AssetId);
+    }
+    bDirty = true;
+}
+
+void FBlueprintUsageIndex::UpdateAsset(const FAssetData& AssetData)
+{
+    FIndexedAsset Asset;
+    Asset.ObjectPath = GetObjectPath(AssetData);
+
+    const FString Content = GetIndexedContent(AssetData);
+    Asset.ContentHash = CityHash64(reinterpret_cast<const char*>(*Content), Content.Len() * sizeof(TCHAR));
+
+    const int32* ExistingAssetId = AssetIds.Find(Asset.ObjectPath);
+    if (ExistingAssetId && Assets[*ExistingAssetId].ContentHash == Asset.ContentHash) return;
+
+    Tokenize(Content, Asset.Tokens);
+
+    FRWScopeLock Lock(IndexLock, SLT_Write);
+    int32 AssetId;
+    if (ExistingAssetId)
+    {
+        AssetId = *ExistingAssetId;
+        RemoveFromPostings(AssetId);
+        Assets[AssetId] = MoveTemp(Asset);
+    }
+    else
+    {
+        AssetId = Assets.Add(MoveTemp(Asset));
+        AssetIds.Add(Assets[AssetId].ObjectPath, AssetId);
+    }
+    AddToPostings(AssetId);
+    bDirty = true;
+}
+
+void FBlueprintUsageIndex::RemoveAsset(const FString& ObjectPath)
+{
+    FRWScopeLock Lock(IndexLock, SLT_Write);
+
+    int32 AssetId;
+    if (!AssetIds.RemoveAndCopyValue(ObjectPath, AssetId)) return;
+
+    RemoveFromPostings(AssetId);
+    Assets[AssetId] = FIndexedAsset();
+    bDirty = true;
+}
+
+void FBlueprintUsageIndex::AddToPostings(int32 AssetId)
+{
+    for (const uint64 Token : Assets[AssetId].Tokens)
+    {
+        TArray<int32>& Posting = Postings.FindOrAdd(Token);
+        Posting.Insert(AssetId, Algo::LowerBound(Posting, AssetId));
+    }
+}
+
+void FBlueprintUsageIndex::RemoveFromPostings(int32 AssetId)
+{
+    for (const uint64 Token : Assets[AssetId].Tokens)
+    {
+        TArray<int32>* Posting = Postings.Find(Token);
+        if (!Posting) continue;
+
+        const int32 Index = Algo::BinarySearch(*Posting, AssetId);
+        if (Index != INDEX_NONE)
+        {
+            Posting->RemoveAt(Index);
+        }
+        if (Posting->Num() == 0)
+        {
+            Postings.Remove(Token);
+        }
+    }
+}
+
+void FBlueprintUsageIndex::Load()
+{
+    using namespace BlueprintUsageIndexImpl;
+
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *GetIndexFilePath(), FILEREAD_Silent)) return;
+
+    FMemoryReader Reader(Data);
+    uint32 Magic = 0;
+    uint32 Version = 0;
+    int32 NumAssets = 0;
+    Reader << Magic << Version << NumAssets;
+    if (Magic != FileMagic || Version != FileVersion) return;
+
+    // Count comes from disk, a corrupted one mustn't size the allocation
+    if (Reader.IsError() || NumAssets < 0 || NumAssets > (Reader.TotalSize() - Reader.Tell()) / MinAssetSize)
+    {
+        UE_LOG(FLogRiderBlueprintModule, Warning, TEXT("Blueprint usage index is corrupted, it will be rebuilt"));
+        return;
+    }
+
+    TArray<FIndexedAsset> LoadedAssets;
+    LoadedAssets.SetNum(NumAssets);
+    for (FIndexedAsset& Asset : LoadedAssets)
+    {
+        Reader << Asset.ObjectPath << Asset.ContentHash << Asset.Tokens;
+        if (Reader.IsError()) break;
+    }
+    if (Reader.IsError())
+    {
+        UE_LOG(FLogRiderBlueprintModule, Warning, TEXT("Blueprint usage index is corrupted, it will be rebuilt"));
+        return;
+    }
+
+    FRWScopeLock Lock(IndexLock, SLT_Write);
+    // Rebuild from registry could have finished first, it's more recent then
+    if (Assets.Num() > 0) return;
+
+    Assets = MoveTemp(LoadedAssets);
+    for (int32 AssetId = 0; AssetId < Assets.Num(); ++AssetId)
+    {
+        AssetIds.Add(Assets[AssetId].ObjectPath, AssetId);
+        AddToPostings(AssetId);
+    }
+}
+
+void FBlueprintUsageIndex::Save()
+{
+    using namespace BlueprintUsageIndexImpl;
+
+    TArray<uint8> Data;
+    {
+        FRWScopeLock Lock(IndexLock, SLT_ReadOnly);
+
+        FMemoryWriter Writer(Data);
+        uint32 Magic = FileMagic;
+        uint32 Version = FileVersion;
+        int32 NumAssets = AssetIds.Num();
+        Writer << Magic << Version << NumAssets;
+        for (FIndexedAsset& Asset : Assets)
+        {
+            if (Asset.ObjectPath.IsEmpty()) continue;
+
+            Writer << Asset.ObjectPath << Asset.ContentHash << Asset.Tokens;
+        }
+    }
+
+    if (!FFileHelper::SaveArrayToFile(Data, *GetIndexFilePath()))
+    {
+        UE_LOG(FLogRiderBlueprintModule, Warning, TEXT("Failed to save blueprint usage index to %s"), *GetIndexFilePath());
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Containers/Map.h"
+#include "Containers/Queue.h"
+#include "Containers/UnrealString.h"
+#include "Delegates/IDelegateInstance.h"
+#include "Misc/ScopeRWLock.h"
+#include "Templates/Function.h"
+
+#include <atomic>
+
+struct FAssetData;
+
+/**
+ * Inverted index of names (classes, functions, variables) referenced by blueprint assets.
+ * Built from asset registry tags without loading any asset, persisted in Saved/RiderLink
+ * and updated incrementally by asset registry events.
+ * All updates run sequentially on a worker, queries only take read lock.
+ */
+class FBlueprintUsageIndex
+{
+public:
+    static FBlueprintUsageIndex& Get();
+
+    /** Loads index of previous session and starts following asset registry, game thread only */
+    void Startup();
+
+    /** Stops following asset registry and waits for pending updates, game thread only */
+    void Shutdown();
+
+    /** Returns object paths of blueprints referencing "Name" or "Class::Member", safe to call from any thread */
+    TArray<FString> FindUsages(const FString& Name) const;
+
+private:
+    struct FIndexedAsset
+    {
+        FString ObjectPath;
+        uint64 ContentHash = 0;
+        TArray<uint64> Tokens;
+    };
+
+    static bool IsIndexedAsset(const FAssetData& AssetData);
+    static FString GetObjectPath(const FAssetData& AssetData);
+    static FString GetIndexedContent(const FAssetData& AssetData);
+    static void Tokenize(const FString& Content, TArray<uint64>& OutTokens);
+    static uint64 HashToken(const TCHAR* Token, int32 Length);
+
+    /** Jobs are executed one by one on a worker, index is saved once queue is empty */
+    void EnqueueJob(TFunction<void()> Job);
+    void ProcessJobs();
+
+    void RequestRebuild();
+    void OnAssetChanged(const FAssetData& AssetData);
+    void OnAssetRemoved(const FAssetData& AssetData);
+    void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+    // Worker side
+    void Rebuild(const TArray<FAssetData>& RegistryAssets);
+    void UpdateAsset(const FAssetData& AssetData);
+    void RemoveAsset(const FString& ObjectPath);
+    void AddToPostings(int32 AssetId);
+    void RemoveFromPostings(int32 AssetId);
+    void Load();
+    void Save();
+
+    mutable FRWLock IndexLock;
+    // Removed assets leave empty slot until next rebuild, so posting lists stay sorted by id
+    TArray<FIndexedAsset> Assets;
+    TMap<FString, int32> AssetIds;
+    TMap<uint64, TArray<int32>> Postings;
+
+    TQueue<TFunction<void()>, EQueueMode::Mpsc> Jobs;
+    std::atomic<bool> bWorkerRunning{false};
+    bool bDirty = false;
+
+    FDelegateHandle OnFilesLoadedHandle;
+    FDelegateHandle OnAssetAddedHandle;
+    FDelegateHandle OnAssetUpdatedHandle;
+    FDelegateHandle OnAssetRemovedHandle;
+    FDelegateHandle OnAssetRenamedHandle;
+};
@@ -1,12 +1,15 @@
 #include "RiderBlueprint.hpp"
 
 #include "BlueprintProvider.hpp"
+#include "BlueprintUsageIndex.hpp"
 #include "IRiderLink.hpp"
 #include "Model/RdEditorProtocol/RdEditorModel/RdEditorModel.Pregenerated.h"
 
 
+#include "Async/Async.h"
 #include "Engine/Blueprint.h"
 #include "Framework/Docking/TabManager.h"
+#include "HAL/IConsoleManager.h"
 #include "HAL/PlatformProcess.h"
 #include "MessageEndpoint.h"
 #include "MessageEndpointBuilder.h"
@@ -25,6 +28,21 @@ DEFINE_LOG_CATEGORY(FLogRiderBlueprintModule);
 
 IMPLEMENT_MODULE(FRiderBlueprintModule, RiderBlueprint);
 
+static FAutoConsoleCommand FindBlueprintUsagesCommand(
+    TEXT("RiderLink.FindBlueprintUsages"),
+    TEXT("Lists blueprints referencing given class, function or property, e.g. RiderLink.FindBlueprintUsages AActor::K2_DestroyActor"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        if (Args.Num() == 0) return;
+
+        const TArray<FString> Usages = BluePrintProvider::FindBlueprintUsages(Args[0]);
+        UE_LOG(FLogRiderBlueprintModule, Display, TEXT("%d blueprints reference %s"), Usages.Num(), *Args[0]);
+        for (const FString& Usage : Usages)
+        {
+            UE_LOG(FLogRiderBlueprintModule, Display, TEXT("    %s"), *Usage);
+        }
+    }));
+
 static void AllowSetForeGroundForEditor(JetBrains::EditorPlugin::RdEditorModel const & unrealToBackendModel) {
     static const int32 CurrentProcessId = FPlatformProcess::GetCurrentProcessId();
     try {
@@ -52,15 +70,37 @@ void FRiderBlueprintModule::StartupModule()
     const FAssetRegistryModule* AssetRegistryModule = &FModuleManager::LoadModuleChecked<FAssetRegistryModule>
         (AssetRegistryConstants::ModuleName);
 
+    FBlueprintUsageIndex::Get().Startup();
+
     MessageEndpoint = FMessageEndpoint::Builder(FName("FAssetEditorManager")).Build();
 
-    AssetRegistryModule->Get().OnAssetAdded().AddLambda([](const FAssetData& AssetData) {
-        // TO-DO: Fix loading uasset's on 4.23-
-        // BluePrintProvider::AddAsset(AssetData);
+    // Asset index is filled once registry finishes initial scan, then kept up to date by its events
+    IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+    if (!AssetRegistry.IsLoadingAssets()) {
+        BluePrintProvider::RebuildAssetIndex();
+    }
+    OnFilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddStatic(&BluePrintProvider::RebuildAssetIndex);
+    OnAssetAddedHandle = AssetRegistry.OnAssetAdded().AddLambda([AssetRegistryPtr = &AssetRegistry](const FAssetData& AssetData) {
+        if (!AssetRegistryPtr->IsLoadingAssets()) {
+            BluePrintProvider::AddAsset(AssetData);
+        }
     });
+    OnAssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddStatic(&BluePrintProvider::RemoveAsset);
+    OnAssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddStatic(&BluePrintProvider::RenameAsset);
 
     RiderLinkModule.ViewModel(ModuleLifetimeDef.lifetime, [this] (rd::Lifetime ModelLifetime, JetBrains::EditorPlugin::RdEditorModel const& UnrealToBackendModel)
     {
+        // Once IDE is connected, blueprints navigated in previous sessions are likely to be opened again
+        static bool bPrewarmed = false;
+        if (!bPrewarmed)
+        {
+            bPrewarmed = true;
+            AsyncTask(ENamedThreads::GameThread, []()
+            {
+                BluePrintProvider::PrewarmRecentBlueprints();
+            });
+        }
+
         UnrealToBackendModel.get_openBlueprint().advise(
             ModelLifetime,
             [this, &UnrealToBackendModel](
@@ -101,7 +141,16 @@ void FRiderBlueprintModule::StartupModule()
 void FRiderBlueprintModule::ShutdownModule()
 {
     UE_LOG(FLogRiderBlueprintModule, Verbose, TEXT("SHUTDOWN START"));
+    if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(AssetRegistryConstants::ModuleName)) {
+        IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+        AssetRegistry.OnFilesLoaded().Remove(OnFilesLoadedHandle);
+        AssetRegistry.OnAssetAdded().Remove(OnAssetAddedHandle);
+        AssetRegistry.OnAssetRemoved().Remove(OnAssetRemovedHandle);
+        AssetRegistry.OnAssetRenamed().Remove(OnAssetRenamedHandle);
+    }
     ModuleLifetimeDef.terminate();
+    FBlueprintUsageIndex::Get().Shutdown();
+    BluePrintProvider::ReleaseRecentBlueprints();
     UE_LOG(FLogRiderBlueprintModule, Verbose, TEXT("SHUTDOWN FINISH"));
 }
 
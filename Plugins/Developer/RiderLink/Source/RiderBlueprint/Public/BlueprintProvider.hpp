@@ -17,9 +17,29 @@ class UBlueprint;
 class RIDERBLUEPRINT_API BluePrintProvider {
 public:
 
+    /** Known asset packages, maintained from asset registry events, used to tell asset paths in logs */
     static void AddAsset(FAssetData const& AssetData);
 
+    static void RemoveAsset(FAssetData const& AssetData);
+
+    static void RenameAsset(FAssetData const& AssetData, FString const& OldObjectPath);
+
+    static void RebuildAssetIndex();
+
     static bool IsBlueprint(FString const& pathName);
 
+    /** Doesn't allocate, safe to call from any thread */
+    static bool IsBlueprint(const TCHAR* PathName, int32 Length);
+
+    /** Returns object paths of blueprints that reference given class, function or property ("Name" or "Class::Member") */
+    static TArray<FString> FindBlueprintUsages(FString const& Name);
+
+    /** Loads blueprint asynchronously and opens it, newer request cancels one that is still loading */
     static void OpenBlueprint(JetBrains::EditorPlugin::BlueprintReference const& path, TSharedPtr<FMessageEndpoint, ESPMode::ThreadSafe> const& messageEndpoint);
+
+    /** Starts background loading of blueprints navigated in previous sessions */
+    static void PrewarmRecentBlueprints();
+
+    /** Releases blueprints kept loaded after navigation, must be called on game thread */
+    static void ReleaseRecentBlueprints();
 };
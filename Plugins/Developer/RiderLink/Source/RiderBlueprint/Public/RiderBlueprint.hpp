@@ -23,4 +23,8 @@ public:
 private:
     TSharedPtr<FMessageEndpoint, ESPMode::ThreadSafe> MessageEndpoint;
     rd::LifetimeDefinition ModuleLifetimeDef;
+    FDelegateHandle OnFilesLoadedHandle;
+    FDelegateHandle OnAssetAddedHandle;
+    FDelegateHandle OnAssetRemovedHandle;
+    FDelegateHandle OnAssetRenamedHandle;
 };
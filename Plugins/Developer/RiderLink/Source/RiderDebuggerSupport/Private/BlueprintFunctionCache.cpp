@@ -0,0 +1,73 @@
+﻿#include "BlueprintFunctionCache.h"
+
+#include "DebugLogger.h"
+#include "UnrealFunctions.h"
+#include "Containers/Map.h"
+#include "EdGraph/EdGraphNode.h"
+#include "Internationalization/Text.h"
+#include "UObject/Class.h"
+
+#include <atomic>
+
+namespace RiderDebuggerSupport
+{
+    // Recompiled blueprints get new functions, so cache only has to be kept from growing forever
+    constexpr int32 MaxCachedFunctions = 4096;
+
+    static TMap<TPair<const UFunction*, int32>, FBlueprintFunctionInfo> GFunctionInfos;
+    static std::atomic<uint32> GCacheGeneration{0};
+    static uint32 GFunctionInfosGeneration = 0;
+
+    static void BuildBlueprintFunctionInfo(FBlueprintFunctionInfo& Info, UFunction* Function, int32 CodeOffset)
+    {
+        Info.Function = Function;
+        Function->GetFullName(nullptr, Info.FullName, EObjectFullNameFlags::None);
+
+        const UObject* Outer = Function->GetOuter();
+        const UClass* SourceClass = CastToUClass(Outer);
+        SendLogToDebugger("SourceClass=%p", SourceClass);
+
+        Info.bHasSourceClass = nullptr != SourceClass;
+        Info.ScopeDisplayName = SourceClass
+            ? GetClassNameWithoutSuffix(SourceClass)
+            : FText::FromName(Outer->GetFName()).ToString();
+        Info.FunctionDisplayName = FText::FromName(Function->GetFName()).ToString();
+
+#if WITH_EDITORONLY_DATA
+        if (SourceClass)
+        {
+            if (const UEdGraphNode* GraphNode = FindSourceNodeForCodeLocation(SourceClass, Function, CodeOffset))
+            {
+                Info.bHasSourceNode = true;
+                Info.FunctionDisplayName = GraphNode->GetNodeTitle(ENodeTitleType::Type::ListView).ToString();
+            }
+        }
+#endif
+    }
+
+    const FBlueprintFunctionInfo& GetBlueprintFunctionInfo(UFunction* Function, int32 CodeOffset)
+    {
+        const uint32 Generation = GCacheGeneration.load();
+        if (GFunctionInfosGeneration != Generation || GFunctionInfos.Num() >= MaxCachedFunctions)
+        {
+            GFunctionInfos.Reset();
+            GFunctionInfosGeneration = Generation;
+        }
+
+        FBlueprintFunctionInfo& Info = GFunctionInfos.FindOrAdd(TPair<const UFunction*, int32>(Function, CodeOffset));
+
+        // Address could be reused by another function after garbage collection
+        if (Info.Function.Get(true) != Function)
+        {
+            SendLogToDebugger("Building names of Function=%p Offset=%d", Function, CodeOffset);
+            Info = FBlueprintFunctionInfo();
+            BuildBlueprintFunctionInfo(Info, Function, CodeOffset);
+        }
+        return Info;
+    }
+
+    void InvalidateBlueprintFunctionCache()
+    {
+        ++GCacheGeneration;
+    }
+}
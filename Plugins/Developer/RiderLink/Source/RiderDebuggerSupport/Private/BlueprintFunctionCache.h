@@ -0,0 +1,30 @@
+﻿#pragma once
+
+#include "Containers/UnrealString.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UFunction;
+
+namespace RiderDebuggerSupport
+{
+    /** Names shown by debugger for blueprint function frame */
+    struct FBlueprintFunctionInfo
+    {
+        TWeakObjectPtr<UFunction> Function;
+        FString FullName;
+        FString ScopeDisplayName;
+        // Title of source graph node if it was found, display name of function otherwise
+        FString FunctionDisplayName;
+        bool bHasSourceClass = false;
+        bool bHasSourceNode = false;
+    };
+
+    /**
+     * Returns names of function at given code offset, built only on first request.
+     * Called only from debugger evaluation, while the rest of process is suspended, so cache doesn't lock.
+     */
+    const FBlueprintFunctionInfo& GetBlueprintFunctionInfo(UFunction* Function, int32 CodeOffset);
+
+    /** Drops cached names on next request, called when blueprints are recompiled */
+    void InvalidateBlueprintFunctionCache();
+}
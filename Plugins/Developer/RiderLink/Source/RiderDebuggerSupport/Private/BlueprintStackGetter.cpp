@@ -1,9 +1,9 @@
 ﻿#include "UObject/Class.h"
+#include "BlueprintFunctionCache.h"
 #include "DebugLogger.h"
-#include "UnrealFunctions.h"
+#include "UObject/Stack.h"
 #include "UObject/UObjectBaseUtility.h"
 #include "WideStringWrapper.h"
-#include "EdGraph/EdGraphNode.h"
 
 namespace RiderDebuggerSupport
 {
@@ -17,11 +17,19 @@ namespace RiderDebuggerSupport
     constexpr int GSecondStringOffset = GFirstStringOffset + GStringEntrySizeInBytes;
     constexpr int GThirdStringOffset = GSecondStringOffset + GStringEntrySizeInBytes;
     constexpr int GBufferSizeInBytes = GResultCodeSizeInBytes + 3 * GStringEntrySizeInBytes;
+
+    // Call stack buffer: frames count, then for each frame result code and three strings
+    constexpr int MaxCallStackFrames = 64;
+    constexpr int CallStackStringBufferSizeInWideChars = 512;
+    constexpr int GCallStackStringEntrySizeInBytes = CallStackStringBufferSizeInWideChars * GWideCharSizeInBytes + GLengthSizeInBytes;
+    constexpr int GCallStackFrameSizeInBytes = GResultCodeSizeInBytes + 3 * GCallStackStringEntrySizeInBytes;
+    constexpr int GCallStackBufferSizeInBytes = GLengthSizeInBytes + MaxCallStackFrames * GCallStackFrameSizeInBytes;
 }
 
 /* Start Identifiers available from IDEA */
 
 extern "C" DLLEXPORT void __stdcall RiderDebuggerSupport_GetBlueprintFunction(void* PFunction, void* PContext);
+extern "C" DLLEXPORT void __stdcall RiderDebuggerSupport_GetBlueprintCallStack(void* PFrame);
 
 struct FJbCallContextModule
 {
@@ -36,6 +44,11 @@ int RiderDebuggerSupportBlueprintBufferSizeInBytes = RiderDebuggerSupport::GBuff
 int RiderDebuggerSupportBlueprintStringBufferSizeInChars = RiderDebuggerSupport::StringBufferSizeInWideChars;
 int RiderDebuggerSupportBlueprintWideCharSizeInBytes = RiderDebuggerSupport::GWideCharSizeInBytes;
 
+char RiderDebuggerSupportBlueprintCallStackBuffer[RiderDebuggerSupport::GCallStackBufferSizeInBytes] = {0};
+int RiderDebuggerSupportBlueprintCallStackBufferSizeInBytes = RiderDebuggerSupport::GCallStackBufferSizeInBytes;
+int RiderDebuggerSupportBlueprintCallStackMaxFrames = RiderDebuggerSupport::MaxCallStackFrames;
+int RiderDebuggerSupportBlueprintCallStackStringBufferSizeInChars = RiderDebuggerSupport::CallStackStringBufferSizeInWideChars;
+
 /* End Identifiers available from IDEA */
 
 namespace RiderDebuggerSupport
@@ -82,71 +95,64 @@ void RiderDebuggerSupport_GetBlueprintFunction(void* PFunction, void* PContext)
     }
     SetLastExecutedLine(__LINE__);
 
-    FString FullName;
-    SetLastExecutedLine(__LINE__);
-
-    Function->GetFullName(nullptr, FullName, EObjectFullNameFlags::None);
-    GJbFullNameWrapper.CopyFromNullTerminatedStr(
-        GetData(FullName), FullName.Len());
+    const FBlueprintFunctionInfo& Info = GetBlueprintFunctionInfo(Function, 0);
     SetLastExecutedLine(__LINE__);
 
-    const auto Outer = Function->GetOuter();
-
-    SendLogToDebugger("Trying to get SourceClass");
-
-    const UClass* SourceClass = CastToUClass(Outer);
+    constexpr int SourceClassNotNullFlag = 16;
+    constexpr int SourceNodeNotNullFlag = 17;
+    if (Info.bHasSourceClass) SetResultCodeFlag(SourceClassNotNullFlag);
+    if (Info.bHasSourceNode) SetResultCodeFlag(SourceNodeNotNullFlag);
 
-    SendLogToDebugger("SourceClass=%p", SourceClass);
-
-    SetLastExecutedLine(__LINE__);
-    if (nullptr != SourceClass)
-    {
-        constexpr int SourceCodeNotNullFlag = 16;
-        SetResultCodeFlag(SourceCodeNotNullFlag);
-    }
-
-    FString SourceClassDisplayName = GetClassNameWithoutSuffix(SourceClass);
-    SendLogToDebugger(
-        "SourceClassDisplayName length=%u, str_ptr=%p",
-        SourceClassDisplayName.Len(), GetData(SourceClassDisplayName));
+    GJbFullNameWrapper.CopyFromNullTerminatedStr(GetData(Info.FullName), Info.FullName.Len());
+    GJbScopeDisplayNameWrapper.CopyFromNullTerminatedStr(GetData(Info.ScopeDisplayName), Info.ScopeDisplayName.Len());
+    GJbFunctionDisplayNameWrapper.CopyFromNullTerminatedStr(GetData(Info.FunctionDisplayName), Info.FunctionDisplayName.Len());
     SetLastExecutedLine(__LINE__);
+}
 
-    SendLogToDebugger("Trying to get outerDisplayName");
-    FString OuterDisplayName = FText::FromName(Outer->GetFName()).ToString();
-    SendLogToDebugger(
-        "OuterDisplayName length=%u, str_ptr=%p",
-        OuterDisplayName.Len(), GetData(OuterDisplayName));
+void RiderDebuggerSupport_GetBlueprintCallStack(void* PFrame)
+{
+    using namespace RiderDebuggerSupport;
 
-    const auto ScopeDisplayName = SourceClass ? &SourceClassDisplayName : &OuterDisplayName;
-    GJbScopeDisplayNameWrapper.CopyFromNullTerminatedStr(
-        GetData(*ScopeDisplayName), ScopeDisplayName->Len());
-    SetLastExecutedLine(__LINE__);
+    SendLogToDebugger("Called %s: Frame=%p", __func__, PFrame);
 
-    auto FunctionDisplayName = FText::FromName(Function->GetFName()).ToString();
-    GJbFunctionDisplayNameWrapper.CopyFromNullTerminatedStr(GetData(FunctionDisplayName), FunctionDisplayName.Len());
-    SetLastExecutedLine(__LINE__);
+    // Whole script stack is resolved in one call, starting from the innermost frame
+    uint32_t* NumFrames = reinterpret_cast<uint32_t*>(RiderDebuggerSupportBlueprintCallStackBuffer);
+    *NumFrames = 0;
 
-#if WITH_EDITORONLY_DATA
-    if (SourceClass)
+    for (const FFrame* Frame = static_cast<const FFrame*>(PFrame);
+         Frame != nullptr && *NumFrames < static_cast<uint32_t>(MaxCallStackFrames);
+         Frame = Frame->PreviousFrame)
     {
-        const auto GraphNode = FindSourceNodeForCodeLocation(Context, Function);
-        SetLastExecutedLine(__LINE__);
+        char* FrameBuffer = RiderDebuggerSupportBlueprintCallStackBuffer + GLengthSizeInBytes + *NumFrames * GCallStackFrameSizeInBytes;
+        uint32_t* ResultCode = reinterpret_cast<uint32_t*>(FrameBuffer);
+        *ResultCode = 0;
 
-        if (nullptr != GraphNode)
-        {
-            constexpr int SourceCodeNotNullFlag = 17;
-            SetResultCodeFlag(SourceCodeNotNullFlag);
+        UFunction* Function = Frame->Node;
+        ++*NumFrames;
+        if (nullptr == Function || nullptr == Frame->Object) continue;
 
-            const FText NodeTitle = GraphNode->GetNodeTitle(ENodeTitleType::Type::ListView);
-            SetLastExecutedLine(__LINE__);
-
-            FString NodeTitleStr = NodeTitle.ToString();
-            SetLastExecutedLine(__LINE__);
-
-            GJbFunctionDisplayNameWrapper.CopyFromNullTerminatedStr(
-                GetData(NodeTitleStr), NodeTitleStr.Len());
-            SetLastExecutedLine(__LINE__);
+        // Code points past the instruction being executed
+        int32 CodeOffset = 0;
+        if (Frame->Code != nullptr && Function->Script.Num() > 0)
+        {
+            CodeOffset = FMath::Clamp(static_cast<int32>(Frame->Code - Function->Script.GetData()) - 1, 0, Function->Script.Num() - 1);
         }
+
+        const FBlueprintFunctionInfo& Info = GetBlueprintFunctionInfo(Function, CodeOffset);
+
+        constexpr int FrameResolvedFlag = 15;
+        constexpr int SourceClassNotNullFlag = 16;
+        constexpr int SourceNodeNotNullFlag = 17;
+        *ResultCode |= 1 << FrameResolvedFlag;
+        if (Info.bHasSourceClass) *ResultCode |= 1 << SourceClassNotNullFlag;
+        if (Info.bHasSourceNode) *ResultCode |= 1 << SourceNodeNotNullFlag;
+
+        char* StringsBuffer = FrameBuffer + GResultCodeSizeInBytes;
+        FWideStringWrapper(StringsBuffer, GCallStackStringEntrySizeInBytes)
+            .CopyFromNullTerminatedStr(GetData(Info.FullName), Info.FullName.Len());
+        FWideStringWrapper(StringsBuffer + GCallStackStringEntrySizeInBytes, GCallStackStringEntrySizeInBytes)
+            .CopyFromNullTerminatedStr(GetData(Info.ScopeDisplayName), Info.ScopeDisplayName.Len());
+        FWideStringWrapper(StringsBuffer + 2 * GCallStackStringEntrySizeInBytes, GCallStackStringEntrySizeInBytes)
+            .CopyFromNullTerminatedStr(GetData(Info.FunctionDisplayName), Info.FunctionDisplayName.Len());
     }
-#endif
-}
\ No newline at end of file
+}
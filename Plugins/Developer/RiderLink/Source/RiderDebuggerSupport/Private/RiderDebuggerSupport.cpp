@@ -1,14 +1,27 @@
 ﻿#include "RiderDebuggerSupport.h"
 
+#include "BlueprintFunctionCache.h"
+#include "UObject/UObjectGlobals.h"
+
 #define LOCTEXT_NAMESPACE "FRiderDebuggerSupportModule"
 
 
 void FRiderDebuggerSupportModule::StartupModule()
 {
+#if WITH_EDITOR
+    // Recompiled blueprint replaces its functions and graph nodes, cached names may point to old ones
+    ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddLambda([](const TMap<UObject*, UObject*>&)
+    {
+        RiderDebuggerSupport::InvalidateBlueprintFunctionCache();
+    });
+#endif
 }
 
 void FRiderDebuggerSupportModule::ShutdownModule()
 {
+#if WITH_EDITOR
+    FCoreUObjectDelegates::OnObjectsReplaced.Remove(ObjectsReplacedHandle);
+#endif
 }
 
 #undef LOCTEXT_NAMESPACE
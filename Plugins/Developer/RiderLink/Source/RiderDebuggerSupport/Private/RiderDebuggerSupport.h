@@ -8,4 +8,7 @@ class FRiderDebuggerSupportModule : public IModuleInterface
 public:
     virtual void StartupModule() override;
     virtual void ShutdownModule() override;
+
+private:
+    FDelegateHandle ObjectsReplacedHandle;
 };
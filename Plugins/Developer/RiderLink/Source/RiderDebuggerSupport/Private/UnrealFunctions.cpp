@@ -10,7 +10,7 @@ UClass* RiderDebuggerSupport::FindClassForNode(const UObject* Object, const UFun
     return nullptr;
 }
 
-UEdGraphNode* RiderDebuggerSupport::FindSourceNodeForCodeLocation(const UObject* Object, UFunction* Function)
+UEdGraphNode* RiderDebuggerSupport::FindSourceNodeForCodeLocation(const UObject* Object, UFunction* Function, int32 CodeOffset)
 {
 #if WITH_EDITORONLY_DATA
 
@@ -19,7 +19,7 @@ UEdGraphNode* RiderDebuggerSupport::FindSourceNodeForCodeLocation(const UObject*
     if (UBlueprintGeneratedClass* Class = Cast<UBlueprintGeneratedClass>(FindClassForNode(Object, Function)))
     {
         return Class->GetDebugData().
-                      FindSourceNodeFromCodeLocation(Function, 0, true);
+                      FindSourceNodeFromCodeLocation(Function, CodeOffset, true);
     }
 
 #endif
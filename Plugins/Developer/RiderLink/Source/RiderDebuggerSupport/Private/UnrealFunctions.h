@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "HAL/Platform.h"
 
 class UEdGraphNode;
 class UFunction;
@@ -10,7 +11,7 @@ class FString;
 namespace RiderDebuggerSupport
 {
     UClass* FindClassForNode(const UObject* Object, const UFunction* Function);
-    UEdGraphNode* FindSourceNodeForCodeLocation(const UObject* Object, UFunction* Function);
+    UEdGraphNode* FindSourceNodeForCodeLocation(const UObject* Object, UFunction* Function, int32 CodeOffset = 0);
     FString GetClassNameWithoutSuffix(const UClass* Class);
     const UClass* CastToUClass(const UObject* Object);
 }
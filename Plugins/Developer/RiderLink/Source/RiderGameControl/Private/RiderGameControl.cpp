@@ -1,5 +1,6 @@
 #include "RiderGameControl.hpp"
 
+#include "RiderPIEControl.hpp"
 
 #include "IRiderLink.hpp"
 
@@ -8,9 +9,9 @@
 #include "Model/Library/UE4Library/RequestSucceed.Pregenerated.h"
 #include "RdEditorModel/RdEditorModel.Pregenerated.h"
 
-#include "Async/Async.h"
 #include "Editor/UnrealEdEngine.h"
 #include "Framework/Application/SlateApplication.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet2/DebuggerCommands.h"
 #include "LevelEditor.h"
 #include "LevelEditorActions.h"
@@ -84,6 +85,11 @@ static int PlayModeToInt(EPlayModeType modeType)
 
 FSlateApplication* SlateApplication = nullptr;
 
+static FRiderGameControlModule& GetGameControlModule()
+{
+    return FModuleManager::GetModuleChecked<FRiderGameControlModule>(TEXT("RiderGameControl"));
+}
+
 struct FPlaySettings
 {
     EPlayModeType PlayMode;
@@ -232,21 +238,74 @@ void FRiderGameControlActionsCache::UpdatePlayWorldCommandsCache()
 }
 
 
+static FAutoConsoleCommand StepPlaySessionCommand(
+    TEXT("RiderLink.PIE.Step"),
+    TEXT("Advances paused play session by given number of frames, e.g. RiderLink.PIE.Step 10"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        FRiderGameControlModule& Module = GetGameControlModule();
+        FRiderPIECommand Command;
+        Command.Type = FRiderPIECommand::EType::Step;
+        Command.UICommand = Module.GetActionsCache().SingleFrameAdvance.Command;
+        Command.Frames = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1;
+        Module.GetPIEControl().Enqueue(MoveTemp(Command));
+    }));
+
+static FAutoConsoleCommand SetPlaySessionTimeDilationCommand(
+    TEXT("RiderLink.PIE.TimeDilation"),
+    TEXT("Sets time dilation of running play session, e.g. RiderLink.PIE.TimeDilation 0.5"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        if (Args.Num() == 0) return;
+
+        FRiderPIECommand Command;
+        Command.Type = FRiderPIECommand::EType::TimeDilation;
+        Command.TimeDilation = FCString::Atof(*Args[0]);
+        GetGameControlModule().GetPIEControl().Enqueue(MoveTemp(Command));
+    }));
+
+// Reply goes to the client which made the request only, and is dropped if that client disconnected meanwhile
+static void SendRequestResult(rd::Lifetime ModelLifetime, JetBrains::EditorPlugin::RdEditorModel const& Model, int RequestID,
+                              const FName& CommandName, const FRiderPIECommandResult& Result)
+{
+    using namespace JetBrains::EditorPlugin;
+    const FString Message = Result.bSucceeded
+        ? FString()
+        : FString::Format(TEXT("Command '{0}' was not executed.\n{1}"), {CommandName.ToString(), Result.Message});
+    // Model lifetime ends on MainScheduler before the model is released, so it's checked there
+    IRiderLinkModule::Get().QueueAction([ModelLifetime, &Model, RequestID, bSucceeded = Result.bSucceeded, Message]()
+    {
+        if (ModelLifetime->is_terminated()) return;
+
+        if (bSucceeded)
+        {
+            Model.get_notificationReplyFromEditor().fire(RequestSucceed(RequestID));
+        }
+        else
+        {
+            Model.get_notificationReplyFromEditor().fire(RequestFailed(NotificationType::Message, Message, RequestID));
+        }
+    });
+}
+
 class FRiderGameControl
 {
 public:
-    FRiderGameControl(rd::Lifetime Lifetime, JetBrains::EditorPlugin::RdEditorModel const &Model, FRiderGameControlActionsCache& ActionsCache);
+    FRiderGameControl(rd::Lifetime Lifetime, JetBrains::EditorPlugin::RdEditorModel const &Model, FRiderGameControlActionsCache& ActionsCache, FRiderPIEControl& InPIEControl);
     ~FRiderGameControl();
 private:
-    void RequestPlayWorldCommand(const FCachedCommandInfo& CommandInfo, int RequestID);
+    void RequestPlayWorldCommand(const FCachedCommandInfo& CommandInfo, int RequestID,
+                                 FRiderPIECommand::EPlayState ExpectedState,
+                                 FRiderPIECommand::EType Type = FRiderPIECommand::EType::Execute);
 
-    void SendRequestSucceed(int RequestID);
     void SendRequestFailed(int RequestID, JetBrains::EditorPlugin::NotificationType Type, const FString& Message);
 
     void ScheduleModelAction(TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Action);
 
 private:
     FRiderGameControlActionsCache& Actions;
+    FRiderPIEControl& PIEControl;
+    rd::Lifetime Lifetime;
     JetBrains::EditorPlugin::RdEditorModel const &Model;
 
     int32_t playMode;
@@ -260,15 +319,6 @@ private:
 };
 
 
-void FRiderGameControl::SendRequestSucceed(int RequestID)
-{
-    using namespace JetBrains::EditorPlugin;
-    ScheduleModelAction([=](RdEditorModel const& EditorModel)
-    {
-        EditorModel.get_notificationReplyFromEditor().fire(RequestSucceed(RequestID));
-    });
-}
-
 void FRiderGameControl::SendRequestFailed(int RequestID, JetBrains::EditorPlugin::NotificationType Type,
                                           const FString& Message)
 {
@@ -279,7 +329,9 @@ void FRiderGameControl::SendRequestFailed(int RequestID, JetBrains::EditorPlugin
     });
 }
 
-void FRiderGameControl::RequestPlayWorldCommand(const FCachedCommandInfo& CommandInfo, int RequestID)
+void FRiderGameControl::RequestPlayWorldCommand(const FCachedCommandInfo& CommandInfo, int RequestID,
+                                                FRiderPIECommand::EPlayState ExpectedState,
+                                                FRiderPIECommand::EType Type)
 {
     using namespace JetBrains::EditorPlugin;
     if (!CommandInfo.Command.IsValid())
@@ -289,19 +341,19 @@ void FRiderGameControl::RequestPlayWorldCommand(const FCachedCommandInfo& Comman
         SendRequestFailed(RequestID, NotificationType::Error, Message);
         return;
     }
-    AsyncTask(ENamedThreads::GameThread, [this, RequestID, CommandInfo]()
+
+    // Executed in order at the beginning of next frame, reply is sent in the frame command completed in.
+    // Reply doesn't depend on this connection object, only on the lifetime of its model
+    FRiderPIECommand Command;
+    Command.Type = Type;
+    Command.UICommand = CommandInfo.Command;
+    Command.ExpectedState = ExpectedState;
+    Command.OnCompleted = [ModelLifetime = Lifetime, &Model = Model, RequestID, CommandName = CommandInfo.CommandName](
+        const FRiderPIECommandResult& Result)
     {
-        if (FPlayWorldCommands::GlobalPlayWorldActions->TryExecuteAction(CommandInfo.Command.ToSharedRef()))
-        {
-            SendRequestSucceed(RequestID);
-        }
-        else
-        {
-            const FString Message = FString::Format(TEXT("Command '{0}' was not executed.\nRejected by Unreal Engine"),
-                                                    {CommandInfo.CommandName.ToString()});
-            SendRequestFailed(RequestID, NotificationType::Message, Message);
-        }
-    });
+        SendRequestResult(ModelLifetime, Model, RequestID, CommandName, Result);
+    };
+    PIEControl.Enqueue(MoveTemp(Command));
 }
 
 void FRiderGameControl::ScheduleModelAction(TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Action)
@@ -313,8 +365,8 @@ void FRiderGameControl::ScheduleModelAction(TFunction<void(JetBrains::EditorPlug
     });
 }
 
-FRiderGameControl::FRiderGameControl(rd::Lifetime Lifetime, JetBrains::EditorPlugin::RdEditorModel const &Model, FRiderGameControlActionsCache& ActionsCache) :
-    Actions(ActionsCache), Model(Model)
+FRiderGameControl::FRiderGameControl(rd::Lifetime Lifetime, JetBrains::EditorPlugin::RdEditorModel const &Model, FRiderGameControlActionsCache& ActionsCache, FRiderPIEControl& InPIEControl) :
+    Actions(ActionsCache), PIEControl(InPIEControl), Lifetime(Lifetime), Model(Model)
 {
     using namespace JetBrains::EditorPlugin;
     
@@ -399,31 +451,36 @@ FRiderGameControl::FRiderGameControl(rd::Lifetime Lifetime, JetBrains::EditorPlu
                          check(PlayInSettings);
                          const EPlayModeType PlayMode = PlayInSettings->LastExecutedPlayModeType;
 
-                         RequestPlayWorldCommand(Actions.PlayModeCommands[PlayMode], requestID);
+                         // Standalone game runs in its own process, no play session starts in the editor
+                         RequestPlayWorldCommand(Actions.PlayModeCommands[PlayMode], requestID,
+                                                 PlayMode == PlayMode_InNewProcess
+                                                     ? FRiderPIECommand::EPlayState::Any
+                                                     : FRiderPIECommand::EPlayState::Playing);
                      }
              );
         Model.get_requestPauseFromRider()
              .advise(Lifetime, [this](int requestID)
                      {
-                         RequestPlayWorldCommand(Actions.PausePlaySession, requestID);
+                         RequestPlayWorldCommand(Actions.PausePlaySession, requestID, FRiderPIECommand::EPlayState::Paused);
                      }
              );
         Model.get_requestResumeFromRider()
              .advise(Lifetime, [this](int requestID)
                      {
-                         RequestPlayWorldCommand(Actions.ResumePlaySession, requestID);
+                         RequestPlayWorldCommand(Actions.ResumePlaySession, requestID, FRiderPIECommand::EPlayState::Playing);
                      }
              );
         Model.get_requestStopFromRider()
              .advise(Lifetime, [this](int requestID)
                      {
-                         RequestPlayWorldCommand(Actions.StopPlaySession, requestID);
+                         RequestPlayWorldCommand(Actions.StopPlaySession, requestID, FRiderPIECommand::EPlayState::Stopped);
                      }
              );
         Model.get_requestFrameSkipFromRider()
              .advise(Lifetime, [this](int requestID)
                      {
-                         RequestPlayWorldCommand(Actions.SingleFrameAdvance, requestID);
+                         RequestPlayWorldCommand(Actions.SingleFrameAdvance, requestID, FRiderPIECommand::EPlayState::Any,
+                                                 FRiderPIECommand::EType::Step);
                      }
              );
 
@@ -482,6 +539,7 @@ void FRiderGameControlModule::StartupModule()
 
     // Actions cache is not related to connection and its lifetimes
     ActionsCache = MakeUnique<FRiderGameControlActionsCache>();
+    PIEControl = MakeUnique<FRiderPIEControl>();
 
     IRiderLinkModule& RiderLinkModule = IRiderLinkModule::Get();
     ModuleLifetimeDefinition = RiderLinkModule.CreateNestedLifetimeDefinition();
@@ -491,8 +549,9 @@ void FRiderGameControlModule::StartupModule()
         ModuleLifetime,
         [&](rd::Lifetime ModelLifetime, RdEditorModel const& Model)
         {
-            ModelLifetime->add_action([&]() { GameControl.Reset(); });
-            GameControl = MakeUnique<FRiderGameControl>(ModelLifetime, Model, *ActionsCache);
+            const int32 GameControlId = NextGameControlId++;
+            ModelLifetime->add_action([this, GameControlId]() { GameControls.Remove(GameControlId); });
+            GameControls.Add(GameControlId, MakeUnique<FRiderGameControl>(ModelLifetime, Model, *ActionsCache, *PIEControl));
         }
     );
 
@@ -503,6 +562,7 @@ void FRiderGameControlModule::ShutdownModule()
 {
     UE_LOG(FLogRiderGameControlModule, Verbose, TEXT("SHUTDOWN START"));
     ModuleLifetimeDefinition.terminate();
+    PIEControl.Reset();
     ActionsCache.Reset();
     UE_LOG(FLogRiderGameControlModule, Verbose, TEXT("SHUTDOWN FINISH"));
 }
@@ -0,0 +1,328 @@
+#include "RiderPIEControl.hpp"
+
+#include "RiderGameControl.hpp"
+
+#include "Editor.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet2/DebuggerCommands.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "RenderCore.h"
+#include "RHI.h"
+
+namespace RiderPIEControlImpl
+{
+static constexpr int32 MaxFrameStats = 256;
+
+// Starting a session may load maps and compile shaders first, a state change not seen by then isn't coming
+static constexpr double MaxExecuteWaitSeconds = 120.0;
+
+static TAutoConsoleVariable<int32> CVarStreamFrameStats(
+    TEXT("RiderLink.PIE.StreamFrameStats"),
+    0,
+    TEXT("Logs frame, game thread, render thread and GPU times of every play session frame"));
+}
+
+using namespace RiderPIEControlImpl;
+
+FRiderPIEControl::FRiderPIEControl()
+{
+    BeginFrameHandle = FCoreDelegates::OnBeginFrame.AddRaw(this, &FRiderPIEControl::OnBeginFrame);
+    EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FRiderPIEControl::OnEndFrame);
+    EndPIEHandle = FEditorDelegates::EndPIE.AddLambda([this](const bool)
+    {
+        OnPlayStateObserved(FRiderPIECommand::EPlayState::Stopped);
+        FrameStats.Reset();
+        FrameStatsHead = 0;
+    });
+    CancelPIEHandle = FEditorDelegates::CancelPIE.AddLambda([this]()
+    {
+        OnPlayStateObserved(FRiderPIECommand::EPlayState::Stopped);
+    });
+    PostPIEStartedHandle = FEditorDelegates::PostPIEStarted.AddLambda([this](const bool)
+    {
+        OnPlayStateObserved(FRiderPIECommand::EPlayState::Playing);
+    });
+    PausePIEHandle = FEditorDelegates::PausePIE.AddLambda([this](const bool)
+    {
+        OnPlayStateObserved(FRiderPIECommand::EPlayState::Paused);
+    });
+    ResumePIEHandle = FEditorDelegates::ResumePIE.AddLambda([this](const bool)
+    {
+        OnPlayStateObserved(FRiderPIECommand::EPlayState::Playing);
+    });
+}
+
+FRiderPIEControl::~FRiderPIEControl()
+{
+    FEditorDelegates::ResumePIE.Remove(ResumePIEHandle);
+    FEditorDelegates::PausePIE.Remove(PausePIEHandle);
+    FEditorDelegates::PostPIEStarted.Remove(PostPIEStartedHandle);
+    FEditorDelegates::CancelPIE.Remove(CancelPIEHandle);
+    FEditorDelegates::EndPIE.Remove(EndPIEHandle);
+    FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+    FCoreDelegates::OnBeginFrame.Remove(BeginFrameHandle);
+}
+
+uint64 FRiderPIEControl::Enqueue(FRiderPIECommand&& Command)
+{
+    const uint64 Sequence = NextSequence.fetch_add(1);
+    Commands.Enqueue({Sequence, MoveTemp(Command)});
+    return Sequence;
+}
+
+TArray<FRiderPIEFrameStats> FRiderPIEControl::GetRecentFrameStats() const
+{
+    TArray<FRiderPIEFrameStats> Result;
+    Result.Reserve(FrameStats.Num());
+    for (int32 Index = 0; Index < FrameStats.Num(); ++Index)
+    {
+        Result.Add(FrameStats[(FrameStatsHead + Index) % FrameStats.Num()]);
+    }
+    return Result;
+}
+
+UWorld* FRiderPIEControl::GetPlayWorld()
+{
+    return GEditor != nullptr ? GEditor->PlayWorld : nullptr;
+}
+
+bool FRiderPIEControl::IsPlayWorldPaused()
+{
+    const UWorld* PlayWorld = GetPlayWorld();
+    return PlayWorld != nullptr && PlayWorld->bDebugPauseExecution;
+}
+
+void FRiderPIEControl::OnBeginFrame()
+{
+    // Active command blocks the queue, commands behind it see the session in the state it left it in
+    if (ActiveCommand.IsSet())
+    {
+        TickActiveCommand();
+        return;
+    }
+
+    FQueuedCommand Queued;
+    while (Commands.Dequeue(Queued))
+    {
+        if (!StartCommand(Queued))
+        {
+            TickActiveCommand();
+            return;
+        }
+    }
+}
+
+void FRiderPIEControl::TickActiveCommand()
+{
+    FQueuedCommand& Active = ActiveCommand.GetValue();
+    if (Active.Command.Type == FRiderPIECommand::EType::Step)
+    {
+        if (!bStepAdvanced) TickStep();
+    }
+    else if (FPlatformTime::Seconds() - ExecuteStartTime > MaxExecuteWaitSeconds)
+    {
+        Complete(Active, false, TEXT("Play session didn't reach the requested state"));
+    }
+}
+
+void FRiderPIEControl::OnPlayStateObserved(FRiderPIECommand::EPlayState State)
+{
+    if (!ActiveCommand.IsSet()) return;
+
+    FQueuedCommand& Active = ActiveCommand.GetValue();
+    if (Active.Command.Type == FRiderPIECommand::EType::Step)
+    {
+        if (State == FRiderPIECommand::EPlayState::Stopped)
+        {
+            Complete(Active, false, TEXT("Play session ended before stepping finished"));
+        }
+    }
+    else if (Active.Command.ExpectedState == State)
+    {
+        Complete(Active, true, {});
+    }
+    else if (State == FRiderPIECommand::EPlayState::Stopped)
+    {
+        Complete(Active, false, TEXT("Play session ended before reaching the requested state"));
+    }
+}
+
+void FRiderPIEControl::OnEndFrame()
+{
+    RecordFrameStats();
+
+    if (!ActiveCommand.IsSet() || !bStepAdvanced) return;
+
+    const UWorld* PlayWorld = GetPlayWorld();
+    if (PlayWorld == nullptr)
+    {
+        Complete(ActiveCommand.GetValue(), false, TEXT("Play session ended before stepping finished"));
+        return;
+    }
+
+    // Engine pauses the world again after stepped frame was ticked, world time doesn't move with zero time dilation
+    const bool bStepped = IsPlayWorldPaused() &&
+        (PlayWorld->GetTimeSeconds() != StepAdvanceWorldTime || GFrameCounter > StepAdvanceFrame + 1);
+    if (!bStepped) return;
+
+    bStepAdvanced = false;
+    FQueuedCommand& Step = ActiveCommand.GetValue();
+    const int32 SteppedFrames = Step.Command.Frames - StepsRemaining;
+    if (Step.Command.Condition && Step.Command.Condition())
+    {
+        Complete(Step, true, FString::Printf(TEXT("Condition met after %d frames"), SteppedFrames));
+    }
+    else if (StepsRemaining == 0)
+    {
+        Complete(Step, true, FString::Printf(TEXT("Stepped %d frames"), SteppedFrames));
+    }
+}
+
+bool FRiderPIEControl::StartCommand(FQueuedCommand& Queued)
+{
+    const FRiderPIECommand& Command = Queued.Command;
+    switch (Command.Type)
+    {
+    case FRiderPIECommand::EType::Execute:
+    {
+        if (!Command.UICommand.IsValid())
+        {
+            Complete(Queued, false, TEXT("Command was not registered in Unreal Engine"));
+            return true;
+        }
+
+        // Play and stop only take effect in a later frame, the reply waits until the session got there.
+        // Command is active before it's executed, pause and resume report the new state from within the action
+        ActiveCommand.Emplace(MoveTemp(Queued));
+        ExecuteStartTime = FPlatformTime::Seconds();
+        FQueuedCommand& Active = ActiveCommand.GetValue();
+        if (!FPlayWorldCommands::GlobalPlayWorldActions->TryExecuteAction(Active.Command.UICommand.ToSharedRef()))
+        {
+            Complete(Active, false, TEXT("Rejected by Unreal Engine"));
+            return true;
+        }
+        if (ActiveCommand.IsSet() && Active.Command.ExpectedState == FRiderPIECommand::EPlayState::Any)
+        {
+            Complete(Active, true, {});
+        }
+        return !ActiveCommand.IsSet();
+    }
+
+    case FRiderPIECommand::EType::Step:
+        if (!Command.UICommand.IsValid())
+        {
+            Complete(Queued, false, TEXT("Command was not registered in Unreal Engine"));
+            return true;
+        }
+        if (!IsPlayWorldPaused())
+        {
+            Complete(Queued, false, TEXT("Play session is not paused"));
+            return true;
+        }
+        if (Command.Frames < 1)
+        {
+            Complete(Queued, false, TEXT("Number of frames to step must be positive"));
+            return true;
+        }
+        StepsRemaining = Command.Frames;
+        bStepAdvanced = false;
+        ActiveCommand.Emplace(MoveTemp(Queued));
+        return false;
+
+    case FRiderPIECommand::EType::TimeDilation:
+    {
+        bool bApplied = false;
+        for (const FWorldContext& Context : GEditor->GetWorldContexts())
+        {
+            UWorld* World = Context.World();
+            if (Context.WorldType != EWorldType::PIE || World == nullptr) continue;
+
+            if (AWorldSettings* WorldSettings = World->GetWorldSettings())
+            {
+                WorldSettings->TimeDilation = FMath::Clamp(Command.TimeDilation,
+                    WorldSettings->MinGlobalTimeDilation, WorldSettings->MaxGlobalTimeDilation);
+                bApplied = true;
+            }
+        }
+        Complete(Queued, bApplied, bApplied ? FString() : TEXT("No play session is running"));
+        return true;
+    }
+    }
+    return true;
+}
+
+void FRiderPIEControl::TickStep()
+{
+    FQueuedCommand& Step = ActiveCommand.GetValue();
+    if (GetPlayWorld() == nullptr)
+    {
+        Complete(Step, false, TEXT("Play session ended before stepping finished"));
+        return;
+    }
+    // Breakpoint or user may have resumed the session, stepping continues once it's paused again
+    if (!IsPlayWorldPaused()) return;
+
+    if (!FPlayWorldCommands::GlobalPlayWorldActions->TryExecuteAction(Step.Command.UICommand.ToSharedRef()))
+    {
+        Complete(Step, false, TEXT("Frame advance was rejected by Unreal Engine"));
+        return;
+    }
+    --StepsRemaining;
+    bStepAdvanced = true;
+    StepAdvanceFrame = GFrameCounter;
+    StepAdvanceWorldTime = GetPlayWorld()->GetTimeSeconds();
+}
+
+void FRiderPIEControl::Complete(FQueuedCommand& Queued, bool bSucceeded, const FString& Message)
+{
+    FRiderPIECommandResult Result;
+    Result.Sequence = Queued.Sequence;
+    Result.Frame = GFrameCounter;
+    Result.bSucceeded = bSucceeded;
+    Result.Message = Message;
+
+    UE_LOG(FLogRiderGameControlModule, Verbose, TEXT("PIE command #%llu %s in frame %llu %s"), Result.Sequence,
+           bSucceeded ? TEXT("succeeded") : TEXT("failed"), Result.Frame, *Message);
+
+    const TFunction<void(const FRiderPIECommandResult&)> OnCompleted = MoveTemp(Queued.Command.OnCompleted);
+    if (ActiveCommand.IsSet() && &ActiveCommand.GetValue() == &Queued)
+    {
+        ActiveCommand.Reset();
+        bStepAdvanced = false;
+    }
+    if (OnCompleted)
+    {
+        OnCompleted(Result);
+    }
+}
+
+void FRiderPIEControl::RecordFrameStats()
+{
+    if (GetPlayWorld() == nullptr) return;
+
+    FRiderPIEFrameStats Stats;
+    Stats.Frame = GFrameCounter;
+    Stats.FrameTimeMs = static_cast<float>(FApp::GetDeltaTime() * 1000.0);
+    Stats.GameThreadTimeMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+    Stats.RenderThreadTimeMs = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+    Stats.GPUTimeMs = FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles());
+
+    if (FrameStats.Num() < MaxFrameStats)
+    {
+        FrameStats.Add(Stats);
+    }
+    else
+    {
+        FrameStats[FrameStatsHead] = Stats;
+        FrameStatsHead = (FrameStatsHead + 1) % MaxFrameStats;
+    }
+
+    // Log lines reach Rider through RiderLogging, so this is the stream IDE scripts can follow
+    if (CVarStreamFrameStats.GetValueOnGameThread() != 0)
+    {
+        UE_LOG(FLogRiderGameControlModule, Display, TEXT("PIE frame %llu: %.2f ms (game %.2f ms, render %.2f ms, GPU %.2f ms)"),
+               Stats.Frame, Stats.FrameTimeMs, Stats.GameThreadTimeMs, Stats.RenderThreadTimeMs, Stats.GPUTimeMs);
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Containers/Queue.h"
+#include "Containers/UnrealString.h"
+#include "Delegates/IDelegateInstance.h"
+#include "Misc/Optional.h"
+#include "Templates/Function.h"
+#include "Templates/SharedPointer.h"
+
+#include <atomic>
+
+class FUICommandInfo;
+class UWorld;
+
+struct FRiderPIECommandResult
+{
+    /** Order in which commands were queued, completions are reported in the same order */
+    uint64 Sequence = 0;
+    /** GFrameCounter of the frame command was completed in */
+    uint64 Frame = 0;
+    bool bSucceeded = false;
+    FString Message;
+};
+
+struct FRiderPIEFrameStats
+{
+    uint64 Frame = 0;
+    float FrameTimeMs = 0.0f;
+    float GameThreadTimeMs = 0.0f;
+    float RenderThreadTimeMs = 0.0f;
+    float GPUTimeMs = 0.0f;
+};
+
+struct FRiderPIECommand
+{
+    enum class EType : uint8
+    {
+        /** Executes play world UI command (play, pause, resume, stop), completes once session is in ExpectedState */
+        Execute,
+        /** Advances paused session by Frames frames or until Condition returns true */
+        Step,
+        /** Sets time dilation of all PIE worlds */
+        TimeDilation
+    };
+
+    /** Play session state an Execute command is completed in, Any completes it as soon as the UI command was accepted */
+    enum class EPlayState : uint8
+    {
+        Any,
+        Playing,
+        Paused,
+        Stopped
+    };
+
+    EType Type = EType::Execute;
+    TSharedPtr<FUICommandInfo> UICommand;
+    EPlayState ExpectedState = EPlayState::Any;
+    int32 Frames = 1;
+    TFunction<bool()> Condition;
+    float TimeDilation = 1.0f;
+    TFunction<void(const FRiderPIECommandResult&)> OnCompleted;
+};
+
+/**
+ * Queue of play session commands, executed in order at the beginning of game thread frame,
+ * so each command sees the state left by previous one and stepping is frame accurate.
+ * Commands can be queued from any thread, completion callbacks are called on game thread
+ * in the frame command finished in.
+ */
+class FRiderPIEControl
+{
+public:
+    FRiderPIEControl();
+    ~FRiderPIEControl();
+
+    /** Returns sequence number of queued command */
+    uint64 Enqueue(FRiderPIECommand&& Command);
+
+    /** Returns stats of last frames of current play session, oldest first, game thread only */
+    TArray<FRiderPIEFrameStats> GetRecentFrameStats() const;
+
+private:
+    struct FQueuedCommand
+    {
+        uint64 Sequence;
+        FRiderPIECommand Command;
+    };
+
+    void OnBeginFrame();
+    void OnEndFrame();
+
+    /** Returns true if command finished, otherwise it stays active and blocks the queue */
+    bool StartCommand(FQueuedCommand& Queued);
+    void TickActiveCommand();
+    void TickStep();
+    /** Completes active Execute command waiting for State, or fails active command which can't finish in it */
+    void OnPlayStateObserved(FRiderPIECommand::EPlayState State);
+    void Complete(FQueuedCommand& Queued, bool bSucceeded, const FString& Message);
+    void RecordFrameStats();
+
+    static UWorld* GetPlayWorld();
+    static bool IsPlayWorldPaused();
+
+    TQueue<FQueuedCommand, EQueueMode::Mpsc> Commands;
+    std::atomic<uint64> NextSequence{1};
+
+    // Step, or Execute waiting for the play session to reach its expected state
+    TOptional<FQueuedCommand> ActiveCommand;
+    double ExecuteStartTime = 0.0;
+    int32 StepsRemaining = 0;
+    bool bStepAdvanced = false;
+    uint64 StepAdvanceFrame = 0;
+    double StepAdvanceWorldTime = 0.0;
+
+    // Ring buffer, overwritten from FrameStatsHead once full
+    TArray<FRiderPIEFrameStats> FrameStats;
+    int32 FrameStatsHead = 0;
+
+    FDelegateHandle BeginFrameHandle;
+    FDelegateHandle EndFrameHandle;
+    FDelegateHandle EndPIEHandle;
+    FDelegateHandle CancelPIEHandle;
+    FDelegateHandle PostPIEStartedHandle;
+    FDelegateHandle PausePIEHandle;
+    FDelegateHandle ResumePIEHandle;
+};
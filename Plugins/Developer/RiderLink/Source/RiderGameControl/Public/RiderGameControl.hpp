@@ -2,6 +2,7 @@
 
 #include "lifetime/LifetimeDefinition.h"
 
+#include "Containers/Map.h"
 #include "Logging/LogMacros.h"
 #include "Logging/LogVerbosity.h"
 #include "Modules/ModuleInterface.h"
@@ -11,6 +12,7 @@ DECLARE_LOG_CATEGORY_EXTERN(FLogRiderGameControlModule, Log, All);
 
 class FRiderGameControl;
 class FRiderGameControlActionsCache;
+class FRiderPIEControl;
 
 class FRiderGameControlModule : public IModuleInterface
 {
@@ -23,8 +25,15 @@ public:
     virtual void ShutdownModule() override;
     virtual bool SupportsDynamicReloading() override { return true; }
 
+    /** Ordered queue of play session commands, valid between StartupModule and ShutdownModule */
+    FRiderPIEControl& GetPIEControl() const { return *PIEControl; }
+    FRiderGameControlActionsCache& GetActionsCache() const { return *ActionsCache; }
+
 private:
     rd::LifetimeDefinition ModuleLifetimeDefinition;
-    TUniquePtr<FRiderGameControl> GameControl;
+    // One per connected client
+    TMap<int32, TUniquePtr<FRiderGameControl>> GameControls;
+    int32 NextGameControlId = 0;
     TUniquePtr<FRiderGameControlActionsCache> ActionsCache;
+    TUniquePtr<FRiderPIEControl> PIEControl;
 };
@@ -27,7 +27,9 @@ public class RiderGameControl : ModuleRules
 			"UnrealEd",
 			"Slate",
 			"CoreUObject",
-			"Engine"
+			"Engine",
+			"RenderCore",
+			"RHI"
 		});
 	}
 }
@@ -2,6 +2,7 @@
 
 #include "IRiderLink.hpp"
 #include "RdEditorModel/RdEditorModel.Pregenerated.h"
+#include "LiveCodingModel/LiveCodingModel.Pregenerated.h"
 
 #include "Async/Async.h"
 #if WITH_LIVE_CODING
@@ -17,11 +18,20 @@ IMPLEMENT_MODULE(FRiderLCModule, RiderLC)
 
 const FName HotReloadModule("HotReload");
 
+// Live coding has no event for compile start, so its state is still polled, but much less often than every tick
+constexpr float StatePollInterval = 0.25f;
+
 void FRiderLCModule::SetupLiveCodingBinds()
 {
 	IRiderLinkModule& RiderLinkModule = IRiderLinkModule::Get();
-	RiderLinkModule.ViewModel(ModuleLifetimeDef.lifetime, [](const rd::Lifetime& Lifetime, JetBrains::EditorPlugin::RdEditorModel const& RdEditorModel)
+	RiderLinkModule.ViewModel(ModuleLifetimeDef.lifetime, [this](const rd::Lifetime& Lifetime, JetBrains::EditorPlugin::RdEditorModel const& RdEditorModel)
 	{
+		// New connection starts with default values, current state has to be sent again
+		AsyncTask(ENamedThreads::GameThread, [this]
+		{
+			UpdateState(true);
+		});
+
 		RdEditorModel.get_triggerHotReload().advise(Lifetime, []
 		{
 			AsyncTask(ENamedThreads::GameThread, []
@@ -52,7 +62,56 @@ void FRiderLCModule::SetupLiveCodingBinds()
 	});
 }
 
-bool FRiderLCModule::Tick(float DeltaTime)
+void FRiderLCModule::SetupCompileEvents()
+{
+#if WITH_LIVE_CODING && ENGINE_MAJOR_VERSION >= 5
+	if (ILiveCodingModule* LiveCoding = FModuleManager::GetModulePtr<ILiveCodingModule>(LIVE_CODING_MODULE_NAME))
+	{
+		PatchCompleteHandle = LiveCoding->GetOnPatchCompleteDelegate().AddLambda([this]
+		{
+			UpdateState(false);
+			IRiderLinkModule::Get().QueueModelAction(TEXT("RiderLC"), [](JetBrains::EditorPlugin::RdEditorModel const& RdEditorModel)
+			{
+				using JetBrains::EditorPlugin::LiveCodingModel;
+				LiveCodingModel::getOrCreateExtensionOf(const_cast<JetBrains::EditorPlugin::RdEditorModel&>(RdEditorModel))
+					.get_lC_OnPatchComplete().fire();
+			});
+		});
+	}
+#endif
+#if WITH_HOT_RELOAD
+	if (IHotReloadInterface* HotReload = FModuleManager::GetModulePtr<IHotReloadInterface>(HotReloadModule))
+	{
+		CompilerStartedHandle = HotReload->OnModuleCompilerStarted().AddLambda([this](bool)
+		{
+			UpdateState(false);
+		});
+		CompilerFinishedHandle = HotReload->OnModuleCompilerFinished().AddLambda([this](const FString&, ECompilationResult::Type, bool)
+		{
+			UpdateState(false);
+		});
+	}
+#endif
+}
+
+void FRiderLCModule::RemoveCompileEvents()
+{
+#if WITH_LIVE_CODING && ENGINE_MAJOR_VERSION >= 5
+	if (ILiveCodingModule* LiveCoding = FModuleManager::GetModulePtr<ILiveCodingModule>(LIVE_CODING_MODULE_NAME))
+	{
+		LiveCoding->GetOnPatchCompleteDelegate().Remove(PatchCompleteHandle);
+	}
+#endif
+#if WITH_HOT_RELOAD
+	if (IHotReloadInterface* HotReload = FModuleManager::GetModulePtr<IHotReloadInterface>(HotReloadModule))
+	{
+		HotReload->OnModuleCompilerStarted().Remove(CompilerStartedHandle);
+		HotReload->OnModuleCompilerFinished().Remove(CompilerFinishedHandle);
+	}
+#endif
+}
+
+void FRiderLCModule::UpdateState(bool bForceSend)
 {
 	bool bIsAvailable = false;
 	bool bIsCompiling = false;
@@ -75,13 +134,27 @@ bool FRiderLCModule::Tick(float DeltaTime)
 		}
 #endif
 	}
+
+	// Only transitions are sent to IDE
+	if (!bForceSend && bHasSentState && bIsAvailable == bSentIsAvailable && bIsCompiling == bSentIsCompiling) return;
+
+	bHasSentState = true;
+	bSentIsAvailable = bIsAvailable;
+	bSentIsCompiling = bIsCompiling;
+
 	IRiderLinkModule& RiderLinkModule = IRiderLinkModule::Get();
-	RiderLinkModule.QueueModelAction([bIsAvailable, bIsCompiling](JetBrains::EditorPlugin::RdEditorModel const& RdEditorModel)
+	// Only the latest state matters if previous one wasn't sent yet
+	RiderLinkModule.QueueCoalescedModelAction(TEXT("RiderLC"), TEXT("HotReloadState"),
+		[bIsAvailable, bIsCompiling](JetBrains::EditorPlugin::RdEditorModel const& RdEditorModel)
 	{
 		RdEditorModel.get_isHotReloadAvailable().set(bIsAvailable);
 		RdEditorModel.get_isHotReloadCompiling().set(bIsCompiling);
 	});
+}
 
+bool FRiderLCModule::Tick(float DeltaTime)
+{
+	UpdateState(false);
 	return true;
 }
 
@@ -92,11 +165,12 @@ void FRiderLCModule::StartupModule()
 	const IRiderLinkModule& RiderLinkModule = IRiderLinkModule::Get();
 	ModuleLifetimeDef = RiderLinkModule.CreateNestedLifetimeDefinition();
 	SetupLiveCodingBinds();
+	SetupCompileEvents();
 	TickDelegate = FTickerDelegate::CreateRaw(this, &FRiderLCModule::Tick);
 #if ENGINE_MAJOR_VERSION < 5
-	TickDelegateHandle = FTicker::GetCoreTicker().AddTicker(TickDelegate);
+	TickDelegateHandle = FTicker::GetCoreTicker().AddTicker(TickDelegate, StatePollInterval);
 #else
-	TickDelegateHandle = FTSTicker::GetCoreTicker().AddTicker(TickDelegate);
+	TickDelegateHandle = FTSTicker::GetCoreTicker().AddTicker(TickDelegate, StatePollInterval);
 #endif
 	
 	UE_LOG(FLogRiderLCModule, Verbose, TEXT("RiderLC STARTUP FINISH"));
@@ -111,6 +185,7 @@ void FRiderLCModule::ShutdownModule()
 #else
 	FTSTicker::GetCoreTicker().RemoveTicker(TickDelegateHandle);
 #endif
+	RemoveCompileEvents();
 	ModuleLifetimeDef.terminate();
 	
 	UE_LOG(FLogRiderLCModule, Verbose, TEXT("RiderLC SHUTDOWN FINISH"));
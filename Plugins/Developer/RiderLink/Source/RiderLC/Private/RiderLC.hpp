@@ -17,8 +17,21 @@ public:
 	void SetupLiveCodingBinds();
 	
 private:
+	/** Hot reload compile start/finish and live coding patch completion update state right away */
+	void SetupCompileEvents();
+	void RemoveCompileEvents();
+
+	/** Sends availability and compiling state to IDE if it changed since last time */
+	void UpdateState(bool bForceSend);
 	bool Tick(float DeltaTime);
 	
+	bool bHasSentState = false;
+	bool bSentIsAvailable = false;
+	bool bSentIsCompiling = false;
+	FDelegateHandle PatchCompleteHandle;
+	FDelegateHandle CompilerStartedHandle;
+	FDelegateHandle CompilerFinishedHandle;
+
 	rd::LifetimeDefinition ModuleLifetimeDef;
 	FTickerDelegate TickDelegate;
 #if ENGINE_MAJOR_VERSION < 5
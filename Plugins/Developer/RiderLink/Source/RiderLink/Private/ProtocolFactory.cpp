@@ -108,8 +108,11 @@ std::shared_ptr<rd::SocketWire::Server> ProtocolFactory::CreateWire(rd::ISchedul
 
 TUniquePtr<rd::Protocol> ProtocolFactory::CreateProtocol(rd::IScheduler* Scheduler, rd::Lifetime SocketLifetime, std::shared_ptr<rd::SocketWire::Server> wire)
 {
-    auto protocol = MakeUnique<rd::Protocol>(rd::Identities::SERVER, Scheduler, wire, SocketLifetime);
+    return MakeUnique<rd::Protocol>(rd::Identities::SERVER, Scheduler, wire, SocketLifetime);
+}
 
+void ProtocolFactory::PublishPort(uint16 Port) const
+{
     auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
     const FString PortFullDirectoryPath = GetPathToPortsFolder();
     if (PlatformFile.CreateDirectoryTree(*PortFullDirectoryPath) && !IsRunningCommandlet())
@@ -117,9 +120,8 @@ TUniquePtr<rd::Protocol> ProtocolFactory::CreateProtocol(rd::IScheduler* Schedul
         const FString ProjectFileName = ProjectName + TEXT(".uproject");
         const FString TmpPortFile = TEXT("~") + ProjectFileName;
         const FString TmpPortFileFullPath = FPaths::Combine(*PortFullDirectoryPath, *TmpPortFile);
-        FFileHelper::SaveStringToFile(FString::FromInt(wire->port), *TmpPortFileFullPath);
+        FFileHelper::SaveStringToFile(FString::FromInt(Port), *TmpPortFileFullPath);
         const FString PortFileFullPath = FPaths::Combine(*PortFullDirectoryPath, *ProjectFileName);
         IFileManager::Get().Move(*PortFileFullPath, *TmpPortFileFullPath, true, true);
     }
-    return protocol;
 }
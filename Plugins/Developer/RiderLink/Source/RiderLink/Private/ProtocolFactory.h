@@ -15,6 +15,9 @@ public:
 	TUniquePtr<rd::Protocol> CreateProtocol(rd::IScheduler* Scheduler, rd::Lifetime SocketLifetime,
 	                                        std::shared_ptr<rd::SocketWire::Server> wire);
 
+	/** Points port file read by IDE to given server, so the next client connects there */
+	void PublishPort(uint16 Port) const;
+
 private:
 	void InitRdLogging();
 
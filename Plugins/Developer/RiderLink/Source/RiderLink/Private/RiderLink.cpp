@@ -5,9 +5,10 @@
 
 #include "Async/Async.h"
 #include "Misc/App.h"
-#include "Misc/ScopeRWLock.h"
+#include "Misc/ConfigCacheIni.h"
 #include "Modules/ModuleManager.h"
 #include "HAL/Platform.h"
+#include "HAL/PlatformProcess.h"
 
 #define LOCTEXT_NAMESPACE "RiderLink"
 
@@ -28,6 +29,7 @@ void FRiderLinkModule::ShutdownModule()
 	UE_LOG(FLogRiderLinkModule, Verbose, TEXT("RiderLink SHUTDOWN START"));
 	
 	ModuleLifetimeDef.terminate();
+	UpdateModelSnapshot(true);
 	ProtocolFactory.Reset();
 	UE_LOG(FLogRiderLinkModule, Verbose, TEXT("RiderLink SHUTDOWN FINISH"));
 }
@@ -36,89 +38,165 @@ void FRiderLinkModule::StartupModule()
 {
 	UE_LOG(FLogRiderLinkModule, Verbose, TEXT("RiderLink STARTUP START"));
 	
+	GConfig->GetInt(TEXT("RiderLink"), TEXT("MaxClients"), MaxClients, GEditorPerProjectIni);
+	MaxClients = FMath::Max(MaxClients, 1);
+
 	ProtocolFactory = MakeUnique<class ProtocolFactory>(GetProjectName());
 	Scheduler.queue([this]()
 	{
-		InitProtocol();
+		OpenClientSlot();
 	});
 	UE_LOG(FLogRiderLinkModule, Verbose, TEXT("RiderLink STARTUP FINISH"));
 }
 
-void FRiderLinkModule::InitProtocol()
-{
-	WireLifetimeDef = MakeUnique<rd::LifetimeDefinition>(ModuleLifetimeDef.lifetime);
-	rd::Lifetime WireLifetime = WireLifetimeDef->lifetime;
-	std::shared_ptr<rd::SocketWire::Server> Wire = ProtocolFactory->CreateWire(&Scheduler, WireLifetime);
-	Protocol = ProtocolFactory->CreateProtocol(&Scheduler, WireLifetime.create_nested(), Wire);
-	// Exception fired for Server::Base::~Base() when trying to invoke it this way
-//	WireLifetime->add_action([this]()
-//	{
-//		if (!ModuleLifetimeDef.is_terminated())
-//		{
-//			Scheduler.queue([this]()
-//			{
-//				InitProtocol();
-//			});
-//		}
-//	});
-	Protocol->wire->connected.view(WireLifetime, [this](rd::Lifetime ConnectionLifetime, bool const& IsConnected)
-	{
-		Scheduler.queue([this, ConnectionLifetime, IsConnected]()
+void FRiderLinkModule::OpenClientSlot()
+{
+	if (Clients.Num() >= MaxClients)
+	{
+		UE_LOG(FLogRiderLinkModule, Warning, TEXT("All %d RiderLink connections are in use, no more clients can connect"), MaxClients);
+		return;
+	}
+
+	TUniquePtr<FRiderLinkClient> NewClient = MakeUnique<FRiderLinkClient>();
+	FRiderLinkClient& Client = *NewClient;
+	Client.Id = Clients.Num();
+	Client.WireLifetimeDef = MakeUnique<rd::LifetimeDefinition>(ModuleLifetimeDef.lifetime);
+	rd::Lifetime WireLifetime = Client.WireLifetimeDef->lifetime;
+	Client.Wire = ProtocolFactory->CreateWire(&Scheduler, WireLifetime);
+	Client.Protocol = ProtocolFactory->CreateProtocol(&Scheduler, WireLifetime.create_nested(), Client.Wire);
+	Clients.Add(MoveTemp(NewClient));
+	ProtocolFactory->PublishPort(Client.Wire->port);
+
+	Client.Wire->heartbeatAlive.advise(WireLifetime, [&Client](bool const& bAlive)
+	{
+		Client.bHeartbeatAlive.store(bAlive);
+		if (!bAlive) return;
+
+		Client.bHeartbeatSeen.store(true);
+		const uint32 Dropped = Client.DroppedActions.exchange(0);
+		if (Dropped > 0)
+		{
+			UE_LOG(FLogRiderLinkModule, Warning, TEXT("RiderLink client %d didn't respond, %u updates were not sent to it"), Client.Id, Dropped);
+		}
+	});
+	Client.Protocol->wire->connected.view(WireLifetime, [this, &Client](rd::Lifetime ConnectionLifetime, bool const& IsConnected)
+	{
+		Scheduler.queue([this, &Client, ConnectionLifetime, IsConnected]()
 		{
 			if (!IsConnected) return;
 
-			FRWScopeLock LockOnConnect(ModelLock, SLT_Write);
-			EditorModel = MakeUnique<JetBrains::EditorPlugin::RdEditorModel>();
-			EditorModel->connect(ConnectionLifetime, Protocol.Get());
-			JetBrains::EditorPlugin::UE4Library::serializersOwner.registerSerializersCore(
-				EditorModel->get_serialization_context().get_serializers()
-			);
-			ConnectionLifetime->add_action([&]() mutable
-			{
-				Scheduler.queue([&]()mutable
-				{
-                    FRWScopeLock LockOnDisconnect(ModelLock, SLT_Write);
-                    RdIsModelAlive.set(false);
-				});
-			});
-			RdIsModelAlive.set(true);
-			
-			FString projectName = GetProjectName();
-			FString executableName = FPlatformProcess::ExecutableName(false);
-			uint32_t pid = FPlatformProcess::GetCurrentProcessId();
-			
-			std::wstring projectNameWstr = TCHAR_TO_WCHAR(GetData(projectName));
-			std::wstring executableNameWstr = TCHAR_TO_WCHAR(GetData(executableName));
-			auto connectionInfo = JetBrains::EditorPlugin::ConnectionInfo(projectNameWstr, executableNameWstr, pid);
-			EditorModel->get_connectionInfo().set(connectionInfo);
+			OnClientConnected(Client, ConnectionLifetime);
 		});
 	});
 }
 
+void FRiderLinkModule::OnClientConnected(FRiderLinkClient& Client, rd::Lifetime ConnectionLifetime)
+{
+	Client.EditorModel = MakeShared<JetBrains::EditorPlugin::RdEditorModel, ESPMode::ThreadSafe>();
+	Client.EditorModel->connect(ConnectionLifetime, Client.Protocol.Get());
+	JetBrains::EditorPlugin::UE4Library::serializersOwner.registerSerializersCore(
+		Client.EditorModel->get_serialization_context().get_serializers()
+	);
+	Client.bConnected = true;
+	Client.bHeartbeatSeen.store(false);
+	UpdateModelSnapshot();
+	ConnectionLifetime->add_action([this, &Client]()
+	{
+		Scheduler.queue([this, &Client]()
+		{
+			OnClientDisconnected(Client);
+		});
+	});
+	ConnectedClients.add(Client.Id);
+
+	FString projectName = GetProjectName();
+	FString executableName = FPlatformProcess::ExecutableName(false);
+	uint32_t pid = FPlatformProcess::GetCurrentProcessId();
+	
+	std::wstring projectNameWstr = TCHAR_TO_WCHAR(GetData(projectName));
+	std::wstring executableNameWstr = TCHAR_TO_WCHAR(GetData(executableName));
+	auto connectionInfo = JetBrains::EditorPlugin::ConnectionInfo(projectNameWstr, executableNameWstr, pid);
+	Client.EditorModel->get_connectionInfo().set(connectionInfo);
+
+	UE_LOG(FLogRiderLinkModule, Log, TEXT("RiderLink client %d connected"), Client.Id);
+	PublishFreeSlot();
+}
+
+void FRiderLinkModule::OnClientDisconnected(FRiderLinkClient& Client)
+{
+	Client.bConnected = false;
+	UpdateModelSnapshot();
+	ConnectedClients.remove(Client.Id);
+
+	UE_LOG(FLogRiderLinkModule, Log, TEXT("RiderLink client %d disconnected"), Client.Id);
+	PublishFreeSlot();
+}
+
+void FRiderLinkModule::PublishFreeSlot()
+{
+	if (ModuleLifetimeDef.is_terminated()) return;
+
+	// Lowest free slot is published, so IDE reconnecting after restart gets the first one again
+	for (const TUniquePtr<FRiderLinkClient>& Client : Clients)
+	{
+		if (!Client->bConnected)
+		{
+			ProtocolFactory->PublishPort(Client->Wire->port);
+			return;
+		}
+	}
+	OpenClientSlot();
+}
+
 bool FRiderLinkModule::SupportsDynamicReloading() { return true; }
 
 
-// Can't place RdEditorModel or TUniquePtr<RdEditorModel> into RdProperty.
-// Have to resort to RdProperty<bool> and change it before creating new RdEditorModel
+// Can't place RdEditorModel or TUniquePtr<RdEditorModel> into reactive collection.
+// Set of connected client ids gives each handler its own lifetime per connection instead
 void FRiderLinkModule::ViewModel(rd::Lifetime Lifetime,
                                  TFunction<void(rd::Lifetime, JetBrains::EditorPlugin::RdEditorModel const&)> Handler)
 {
 	Scheduler.invoke_or_queue([this, Lifetime, Handler]
 	{
-		RdIsModelAlive.view(Lifetime, [this, Handler](rd::Lifetime ModelLifetime, bool const& Cond)
+		ConnectedClients.view(Lifetime, [this, Handler](rd::Lifetime ModelLifetime, int32 const& ClientId)
 		{
-			if (Cond) Handler(ModelLifetime, *EditorModel.Get());
+			Handler(ModelLifetime, *Clients[ClientId]->EditorModel.Get());
 		});
 	});
 }
 
+void FRiderLinkModule::RunModelAction(const TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)>& Handler) const
+{
+	// Clients are only modified on MainScheduler, no lock is needed here
+	for (const TUniquePtr<FRiderLinkClient>& Client : Clients)
+	{
+		if (Client->bConnected)
+		{
+			Handler(*Client->EditorModel.Get());
+		}
+	}
+}
+
 void FRiderLinkModule::QueueModelAction(TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Handler)
-{	
-	Scheduler.invoke_or_queue([this, Handler]
+{
+	QueueModelAction(NAME_None, MoveTemp(Handler));
+}
+
+void FRiderLinkModule::QueueModelAction(FName QueueName,
+                                        TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Handler)
+{
+	ActionQueues.Enqueue(QueueName, [this, Handler = MoveTemp(Handler)]
+	{
+		RunModelAction(Handler);
+	});
+}
+
+void FRiderLinkModule::QueueCoalescedModelAction(FName QueueName, FName Key,
+                                                 TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Handler)
+{
+	ActionQueues.EnqueueCoalesced(QueueName, Key, [this, Handler = MoveTemp(Handler)]
 	{
-		if(!RdIsModelAlive.has_value() || !RdIsModelAlive.get()) return;
-		
-		Handler(*EditorModel.Get());
+		RunModelAction(Handler);
 	});
 }
 
@@ -132,14 +210,89 @@ void FRiderLinkModule::QueueAction(TFunction<void()> Handler)
 
 bool FRiderLinkModule::FireAsyncAction(TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Handler)
 {
-	FRWScopeLock Lock(ModelLock, SLT_ReadOnly);
-	if(!RdIsModelAlive.has_value()) return false;
-	
-	if(RdIsModelAlive.get())
+	// Register as reader of current epoch, retry if writer moved to the next one in between
+	uint32 Epoch = SnapshotEpoch.load();
+	for (;;)
+	{
+		SnapshotReaders[Epoch & 1].fetch_add(1);
+		const uint32 CurrentEpoch = SnapshotEpoch.load();
+		if (CurrentEpoch == Epoch) break;
+
+		SnapshotReaders[Epoch & 1].fetch_sub(1);
+		Epoch = CurrentEpoch;
+	}
+
+	const FRiderLinkModelSnapshot* Snapshot = ModelSnapshot.load();
+	const bool bAnyConnected = Snapshot != nullptr && Snapshot->Entries.Num() > 0;
+	if (Snapshot != nullptr)
+	{
+		for (const FRiderLinkModelSnapshot::FEntry& Entry : Snapshot->Entries)
+		{
+			if (Entry.Client->IsStalled())
+			{
+				Entry.Client->DroppedActions.fetch_add(1);
+				continue;
+			}
+			Handler(*Entry.Model.Get());
+		}
+	}
+
+	SnapshotReaders[Epoch & 1].fetch_sub(1);
+	return bAnyConnected;
+}
+
+void FRiderLinkModule::UpdateModelSnapshot(bool bEmpty)
+{
+	FRiderLinkModelSnapshot* NewSnapshot = nullptr;
+	if (!bEmpty)
+	{
+		NewSnapshot = new FRiderLinkModelSnapshot();
+		for (const TUniquePtr<FRiderLinkClient>& Client : Clients)
+		{
+			if (Client->bConnected)
+			{
+				NewSnapshot->Entries.Add({Client.Get(), Client->EditorModel});
+			}
+		}
+	}
+
+	FRiderLinkModelSnapshot* OldSnapshot = ModelSnapshot.exchange(NewSnapshot);
+	SnapshotEpoch.fetch_add(1);
+	if (OldSnapshot != nullptr)
 	{
-		Handler(*EditorModel.Get());
+		RetiredSnapshots.Add({OldSnapshot, 3});
+	}
+	ReclaimSnapshots(bEmpty);
+}
+
+void FRiderLinkModule::ReclaimSnapshots(bool bWait)
+{
+	while (RetiredSnapshots.Num() > 0)
+	{
+		// Reader loads the snapshot after registering, so once its parity was empty after retirement it's gone,
+		// later readers find a newer snapshot
+		uint8 EmptyParities = 0;
+		for (int32 Parity = 0; Parity < 2; ++Parity)
+		{
+			if (SnapshotReaders[Parity].load() == 0)
+			{
+				EmptyParities |= 1 << Parity;
+			}
+		}
+		for (int32 Index = RetiredSnapshots.Num() - 1; Index >= 0; --Index)
+		{
+			FRetiredSnapshot& Retired = RetiredSnapshots[Index];
+			Retired.PendingParities &= ~EmptyParities;
+			if (Retired.PendingParities == 0)
+			{
+				delete Retired.Snapshot;
+				RetiredSnapshots.RemoveAtSwap(Index);
+			}
+		}
+		if (!bWait) return;
+
+		FPlatformProcess::YieldThread();
 	}
-	return RdIsModelAlive.get();
 }
 
 #undef LOCTEXT_NAMESPACE
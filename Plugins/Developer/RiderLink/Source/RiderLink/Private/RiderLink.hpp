@@ -1,8 +1,9 @@
 #pragma once
 
 #include "IRiderLink.hpp"
-#include "impl/RdProperty.h"
+#include "RiderLinkActionQueues.hpp"
 #include "lifetime/LifetimeDefinition.h"
+#include "reactive/ViewableSet.h"
 #include "scheduler/SingleThreadScheduler.h"
 #include "wire/SocketWire.h"
 
@@ -12,6 +13,8 @@
 
 #include "RdEditorModel/RdEditorModel.Pregenerated.h"
 
+#include <atomic>
+
 class ProtocolFactory;
 
 namespace rd
@@ -21,6 +24,36 @@ namespace rd
 
 DECLARE_LOG_CATEGORY_EXTERN(FLogRiderLinkModule, Log, All);
 
+/** Server slot accepting single IDE or tool connection, each with its own protocol and model */
+struct FRiderLinkClient
+{
+	int32 Id = 0;
+	TUniquePtr<rd::LifetimeDefinition> WireLifetimeDef;
+	std::shared_ptr<rd::SocketWire::Server> Wire;
+	TUniquePtr<rd::Protocol> Protocol;
+	TSharedPtr<JetBrains::EditorPlugin::RdEditorModel, ESPMode::ThreadSafe> EditorModel;
+	bool bConnected = false;
+
+	// Client which stopped answering heartbeats doesn't get droppable updates, so they don't pile up in its send buffer
+	std::atomic<bool> bHeartbeatSeen{false};
+	std::atomic<bool> bHeartbeatAlive{false};
+	std::atomic<uint32> DroppedActions{0};
+
+	bool IsStalled() const { return bHeartbeatSeen.load() && !bHeartbeatAlive.load(); }
+};
+
+/** Immutable list of connected clients, read by FireAsyncAction without taking any lock */
+struct FRiderLinkModelSnapshot
+{
+	struct FEntry
+	{
+		FRiderLinkClient* Client;
+		// Model is kept alive by snapshot until its readers are gone, even if client reconnected meanwhile
+		TSharedPtr<JetBrains::EditorPlugin::RdEditorModel, ESPMode::ThreadSafe> Model;
+	};
+	TArray<FEntry> Entries;
+};
+
 class RIDERLINK_API FRiderLinkModule : public IRiderLinkModule
 {
 public:
@@ -41,18 +74,53 @@ public:
 	                       TFunction<void(rd::Lifetime,
 	                                      JetBrains::EditorPlugin::RdEditorModel const&)> Handler) override;
 	virtual void QueueModelAction(TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Handler) override;
+	virtual void QueueModelAction(FName QueueName,
+	                              TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Handler) override;
+	virtual void QueueCoalescedModelAction(FName QueueName, FName Key,
+	                                       TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Handler) override;
 	virtual void QueueAction(TFunction<void()> Handler) override;
 	virtual bool FireAsyncAction(TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Handler) override;
 
 private:
-	void InitProtocol();
+	/** Starts listening for one more client, unless MaxClients are already served */
+	void OpenClientSlot();
+	void OnClientConnected(FRiderLinkClient& Client, rd::Lifetime ConnectionLifetime);
+	void OnClientDisconnected(FRiderLinkClient& Client);
+	void PublishFreeSlot();
+	void RunModelAction(const TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)>& Handler) const;
+
+	/** Publishes snapshot of connected clients and retires previous one, MainScheduler only */
+	void UpdateModelSnapshot(bool bEmpty = false);
+	/** Frees retired snapshots no reader can still use, never waits for readers unless bWait is set on shutdown */
+	void ReclaimSnapshots(bool bWait = false);
 
 	rd::LifetimeDefinition ModuleLifetimeDef{rd::Lifetime::Eternal()};
 	rd::SingleThreadScheduler Scheduler{ModuleLifetimeDef.lifetime, "MainScheduler"};
-	TUniquePtr<rd::LifetimeDefinition> WireLifetimeDef;
 	TUniquePtr<ProtocolFactory> ProtocolFactory;
-	TUniquePtr<rd::Protocol> Protocol;
-	rd::RdProperty<bool> RdIsModelAlive;
-	TUniquePtr<JetBrains::EditorPlugin::RdEditorModel> EditorModel;
-	FRWLock ModelLock;
+	int32 MaxClients = 4;
+	// Slots are only added, so ids are indices. Only changed on MainScheduler, other threads see it through ModelSnapshot
+	TArray<TUniquePtr<FRiderLinkClient>> Clients;
+	rd::ViewableSet<int32> ConnectedClients;
+	FRiderLinkActionQueues ActionQueues{[this](TFunction<void()> Action)
+	{
+		Scheduler.queue([this, Action = MoveTemp(Action)]
+		{
+			Action();
+			ReclaimSnapshots();
+		});
+	}};
+
+	// Readers register in counter of current epoch parity, writer bumps epoch and retires the previous snapshot
+	std::atomic<FRiderLinkModelSnapshot*> ModelSnapshot{nullptr};
+	std::atomic<uint32> SnapshotEpoch{0};
+	std::atomic<int32> SnapshotReaders[2] = {{0}, {0}};
+
+	struct FRetiredSnapshot
+	{
+		FRiderLinkModelSnapshot* Snapshot;
+		// Parities not yet seen without readers since retirement, a reader of the snapshot is in one of them
+		uint8 PendingParities;
+	};
+	// MainScheduler only
+	TArray<FRetiredSnapshot> RetiredSnapshots;
 };
@@ -0,0 +1,107 @@
+#include "RiderLinkActionQueues.hpp"
+
+#include "Misc/ScopeLock.h"
+
+namespace RiderLinkActionQueuesImpl
+{
+static constexpr int32 MaxActionsPerDrain = 64;
+}
+
+using namespace RiderLinkActionQueuesImpl;
+
+FRiderLinkActionQueues::FRiderLinkActionQueues(TFunction<void(TFunction<void()>)> InSchedule)
+	: Schedule(MoveTemp(InSchedule))
+{
+}
+
+FRiderLinkActionQueues::FActionQueue& FRiderLinkActionQueues::FindOrAddQueue(FName QueueName)
+{
+	for (FActionQueue& Queue : Queues)
+	{
+		if (Queue.Name == QueueName) return Queue;
+	}
+	FActionQueue& Queue = Queues.AddDefaulted_GetRef();
+	Queue.Name = QueueName;
+	return Queue;
+}
+
+void FRiderLinkActionQueues::Enqueue(FName QueueName, TFunction<void()> Action)
+{
+	{
+		FScopeLock Lock(&CriticalSection);
+		FindOrAddQueue(QueueName).Actions.Add({NAME_None, MoveTemp(Action)});
+		++NumPending;
+	}
+	ScheduleDrain();
+}
+
+void FRiderLinkActionQueues::EnqueueCoalesced(FName QueueName, FName Key, TFunction<void()> Action)
+{
+	{
+		FScopeLock Lock(&CriticalSection);
+		FActionQueue& Queue = FindOrAddQueue(QueueName);
+		if (TFunction<void()>* Pending = Queue.Coalesced.Find(Key))
+		{
+			// Keeps position of the first pending action, only its value is replaced
+			*Pending = MoveTemp(Action);
+			return;
+		}
+		Queue.Coalesced.Add(Key, MoveTemp(Action));
+		Queue.Actions.Add({Key, nullptr});
+		++NumPending;
+	}
+	ScheduleDrain();
+}
+
+void FRiderLinkActionQueues::ScheduleDrain()
+{
+	{
+		FScopeLock Lock(&CriticalSection);
+		if (bDrainScheduled) return;
+		bDrainScheduled = true;
+	}
+	Schedule([this]() { Drain(); });
+}
+
+void FRiderLinkActionQueues::Drain()
+{
+	for (int32 Executed = 0; Executed < MaxActionsPerDrain; ++Executed)
+	{
+		TFunction<void()> Action;
+		{
+			FScopeLock Lock(&CriticalSection);
+			if (NumPending == 0)
+			{
+				bDrainScheduled = false;
+				return;
+			}
+
+			// Next non-empty queue after the one served last
+			while (Queues[NextQueue].IsEmpty())
+			{
+				NextQueue = (NextQueue + 1) % Queues.Num();
+			}
+			FActionQueue& Queue = Queues[NextQueue];
+			NextQueue = (NextQueue + 1) % Queues.Num();
+
+			FQueuedAction& Queued = Queue.Actions[Queue.Head++];
+			Action = Queued.Key.IsNone() ? MoveTemp(Queued.Action) : Queue.Coalesced.FindAndRemoveChecked(Queued.Key);
+			if (Queue.IsEmpty())
+			{
+				Queue.Actions.Reset();
+				Queue.Head = 0;
+			}
+			else if (Queue.Head >= 1024 && Queue.Head * 2 >= Queue.Actions.Num())
+			{
+				// Queue which never gets empty is compacted once most of it was consumed
+				Queue.Actions.RemoveAt(0, Queue.Head);
+				Queue.Head = 0;
+			}
+			--NumPending;
+		}
+		Action();
+	}
+
+	// Budget is used up, the rest runs after tasks queued to the scheduler meanwhile
+	Schedule([this]() { Drain(); });
+}
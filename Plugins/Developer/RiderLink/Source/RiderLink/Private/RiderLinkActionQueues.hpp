@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/Function.h"
+#include "UObject/NameTypes.h"
+
+/**
+ * Model actions queued per module and executed on MainScheduler round robin,
+ * so a module queueing thousands of actions can't delay the others.
+ * Coalesced actions with the same key replace each other while pending, only the latest one runs.
+ */
+class FRiderLinkActionQueues
+{
+public:
+	/** Schedule has to run given function on MainScheduler */
+	explicit FRiderLinkActionQueues(TFunction<void(TFunction<void()>)> InSchedule);
+
+	void Enqueue(FName QueueName, TFunction<void()> Action);
+	void EnqueueCoalesced(FName QueueName, FName Key, TFunction<void()> Action);
+
+private:
+	struct FQueuedAction
+	{
+		FName Key;
+		TFunction<void()> Action;
+	};
+
+	struct FActionQueue
+	{
+		FName Name;
+		TArray<FQueuedAction> Actions;
+		int32 Head = 0;
+		// Latest action for each pending key, queue only holds placeholder with the key
+		TMap<FName, TFunction<void()>> Coalesced;
+
+		bool IsEmpty() const { return Head == Actions.Num(); }
+	};
+
+	FActionQueue& FindOrAddQueue(FName QueueName);
+	void ScheduleDrain();
+
+	/** Runs limited number of actions, then yields to other scheduler tasks */
+	void Drain();
+
+	TFunction<void(TFunction<void()>)> Schedule;
+	FCriticalSection CriticalSection;
+	TArray<FActionQueue> Queues;
+	int32 NextQueue = 0;
+	int32 NumPending = 0;
+	bool bDrainScheduled = false;
+};
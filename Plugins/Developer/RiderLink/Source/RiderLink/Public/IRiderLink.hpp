@@ -26,4 +26,8 @@ public:
 	virtual void QueueAction(TFunction<void()> Handler) = 0;
 	virtual bool FireAsyncAction(TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Handler) = 0;
 	virtual void QueueModelAction(TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Handler) = 0;
+	// Actions of different queues are executed round robin, so each module should use its own queue
+	virtual void QueueModelAction(FName QueueName, TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Handler) = 0;
+	// Pending action with the same key is replaced, use for state where only the latest value matters
+	virtual void QueueCoalescedModelAction(FName QueueName, FName Key, TFunction<void(JetBrains::EditorPlugin::RdEditorModel const&)> Handler) = 0;
 };
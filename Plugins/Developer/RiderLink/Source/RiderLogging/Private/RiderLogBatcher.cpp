@@ -0,0 +1,266 @@
+#include "RiderLogBatcher.hpp"
+
+#include "BlueprintProvider.hpp"
+#include "IRiderLink.hpp"
+#include "Model/Library/UE4Library/StringRange.Pregenerated.h"
+#include "Model/Library/UE4Library/UnrealLogEvent.Pregenerated.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/DateTime.h"
+
+namespace LoggingExtensionImpl
+{
+static constexpr int32 MaxChunkLength = 1024;
+static constexpr double MaxLinesPerSecond = 2000.0;
+static constexpr double SkippedNoticeInterval = 1.0;
+
+using FStringRanges = TArray<rd::Wrapper<JetBrains::EditorPlugin::StringRange>>;
+
+static bool IsPathChar(TCHAR Char)
+{
+	return FChar::IsAlnum(Char) || Char == TEXT('_') || Char == TEXT('.');
+}
+
+static bool IsIdentifierChar(TCHAR Char)
+{
+	return (Char >= TEXT('a') && Char <= TEXT('z')) || (Char >= TEXT('A') && Char <= TEXT('Z')) ||
+		(Char >= TEXT('0') && Char <= TEXT('9')) || Char == TEXT('_');
+}
+
+/**
+ * Finds blueprint paths ("/Game/Blueprint.Blueprint_C") and methods ("Class::Method", "Class::~Class") in single pass.
+ * Both are tracked by independent state machines, so ranges are the same as matches of former
+ * "(/[\w\.]+)+" and "[0-9a-z_A-Z]+::~?[0-9a-z_A-Z]+" regexes.
+ */
+static void FindLinkRanges(const FString& Str, FStringRanges& BlueprintRanges, FStringRanges& MethodRanges)
+{
+	using JetBrains::EditorPlugin::StringRange;
+
+	enum class EPathState : uint8 { None, Slash, Segment, SegmentSlash };
+	enum class EMethodState : uint8 { None, Class, Colon, DoubleColon, Tilde, Method };
+
+	const TCHAR* Text = *Str;
+	const int32 Length = Str.Len();
+
+	EPathState PathState = EPathState::None;
+	int32 PathStart = 0;
+	EMethodState MethodState = EMethodState::None;
+	int32 MethodStart = 0;
+
+	const auto AddPath = [&](int32 End)
+	{
+		if (BluePrintProvider::IsBlueprint(Text + PathStart, End - PathStart))
+		{
+			BlueprintRanges.Emplace(StringRange(PathStart, End));
+		}
+	};
+
+	for (int32 Index = 0; Index < Length; ++Index)
+	{
+		const TCHAR Char = Text[Index];
+
+		// Path is a sequence of "/" followed by at least one path character
+		switch (PathState)
+		{
+		case EPathState::Slash:
+			PathState = IsPathChar(Char) ? EPathState::Segment : EPathState::None;
+			break;
+		case EPathState::Segment:
+			if (Char == TEXT('/'))
+			{
+				PathState = EPathState::SegmentSlash;
+			}
+			else if (!IsPathChar(Char))
+			{
+				AddPath(Index);
+				PathState = EPathState::None;
+			}
+			break;
+		case EPathState::SegmentSlash:
+			if (IsPathChar(Char))
+			{
+				PathState = EPathState::Segment;
+			}
+			else
+			{
+				// Trailing slash isn't part of the path
+				AddPath(Index - 1);
+				PathState = EPathState::None;
+			}
+			break;
+		default:
+			break;
+		}
+		if (PathState == EPathState::None && Char == TEXT('/'))
+		{
+			PathState = EPathState::Slash;
+			PathStart = Index;
+		}
+
+		// Method is identifier, "::", optional "~" and another identifier
+		const bool bIdentifierChar = IsIdentifierChar(Char);
+		switch (MethodState)
+		{
+		case EMethodState::Class:
+			if (Char == TEXT(':')) MethodState = EMethodState::Colon;
+			else if (!bIdentifierChar) MethodState = EMethodState::None;
+			break;
+		case EMethodState::Colon:
+			MethodState = Char == TEXT(':') ? EMethodState::DoubleColon : EMethodState::None;
+			break;
+		case EMethodState::DoubleColon:
+			if (Char == TEXT('~')) MethodState = EMethodState::Tilde;
+			else MethodState = bIdentifierChar ? EMethodState::Method : EMethodState::None;
+			break;
+		case EMethodState::Tilde:
+			MethodState = bIdentifierChar ? EMethodState::Method : EMethodState::None;
+			break;
+		case EMethodState::Method:
+			if (!bIdentifierChar)
+			{
+				MethodRanges.Emplace(StringRange(MethodStart, Index));
+				MethodState = EMethodState::None;
+			}
+			break;
+		default:
+			break;
+		}
+		// Character that broke the match can still start a new one
+		if (MethodState == EMethodState::None && bIdentifierChar)
+		{
+			MethodState = EMethodState::Class;
+			MethodStart = Index;
+		}
+	}
+
+	if (PathState == EPathState::Segment) AddPath(Length);
+	else if (PathState == EPathState::SegmentSlash) AddPath(Length - 1);
+
+	if (MethodState == EMethodState::Method) MethodRanges.Emplace(StringRange(MethodStart, Length));
+}
+}
+
+using namespace LoggingExtensionImpl;
+
+FRiderLogBatcher::FRiderLogBatcher(int64 InStartTime)
+	: StartTime(InStartTime)
+	, Budget(MaxLinesPerSecond)
+	, LastRefillTime(FPlatformTime::Seconds())
+{
+}
+
+JetBrains::EditorPlugin::LogMessageInfo FRiderLogBatcher::MakeMessageInfo(const FRiderLogLine& Line) const
+{
+	return {Line.Verbosity, Line.Category.GetPlainNameString(), rd::DateTime(StartTime + static_cast<int64>(Line.Time))};
+}
+
+void FRiderLogBatcher::Add(const FRiderLogLine& Line, bool bRateLimited)
+{
+	// Identical consecutive lines are sent once, followed by number of repeats
+	if (bHasLastLine && LastLine.Verbosity == Line.Verbosity && LastLine.Category == Line.Category &&
+		LastLine.Message.Equals(Line.Message, ESearchCase::CaseSensitive))
+	{
+		LastLine.Time = Line.Time;
+		++RepeatCount;
+		return;
+	}
+	FlushRepeats();
+
+	// Warnings and errors are never skipped
+	if (bRateLimited && Line.Verbosity > ELogVerbosity::Warning && !ConsumeRateLimit())
+	{
+		++SkippedCount;
+		return;
+	}
+
+	Append(MakeMessageInfo(Line), Line.Message);
+	LastLine = Line;
+	bHasLastLine = true;
+}
+
+void FRiderLogBatcher::AddSkipped(uint32 Count)
+{
+	SkippedCount += Count;
+}
+
+void FRiderLogBatcher::Append(const JetBrains::EditorPlugin::LogMessageInfo& Info, const FString& Message)
+{
+	const TCHAR* Text = *Message;
+	const int32 Length = Message.Len();
+
+	int32 LineStart = 0;
+	for (int32 Index = 0; Index <= Length; ++Index)
+	{
+		if (Index != Length && Text[Index] != TEXT('\n')) continue;
+
+		for (int32 ChunkStart = LineStart; ChunkStart < Index; ChunkStart += MaxChunkLength)
+		{
+			const int32 ChunkLength = FMath::Min(MaxChunkLength, Index - ChunkStart);
+			Pending.Add({Info, FString(ChunkLength, Text + ChunkStart)});
+		}
+		LineStart = Index + 1;
+	}
+}
+
+bool FRiderLogBatcher::ConsumeRateLimit()
+{
+	const double Now = FPlatformTime::Seconds();
+	Budget = FMath::Min(MaxLinesPerSecond, Budget + (Now - LastRefillTime) * MaxLinesPerSecond);
+	LastRefillTime = Now;
+
+	if (Budget < 1.0) return false;
+
+	Budget -= 1.0;
+	return true;
+}
+
+void FRiderLogBatcher::FlushRepeats()
+{
+	if (RepeatCount == 0) return;
+
+	Pending.Add({MakeMessageInfo(LastLine), FString::Printf(TEXT("Previous message repeated %d times"), RepeatCount)});
+	RepeatCount = 0;
+}
+
+void FRiderLogBatcher::FlushSkipped()
+{
+	if (SkippedCount == 0) return;
+
+	// Under constant flood notice is sent once per interval, not after every batch
+	const double Now = FPlatformTime::Seconds();
+	if (Now - LastSkippedNoticeTime < SkippedNoticeInterval) return;
+
+	const JetBrains::EditorPlugin::LogMessageInfo Info{
+		ELogVerbosity::Warning, TEXT("RiderLogging"), rd::DateTime(FDateTime::UtcNow().ToUnixTimestamp())
+	};
+	Pending.Add({
+		Info,
+		FString::Printf(TEXT("%u log messages were not sent to Rider, logging rate exceeded %d messages per second"),
+		                SkippedCount, static_cast<int32>(MaxLinesPerSecond))
+	});
+	SkippedCount = 0;
+	LastSkippedNoticeTime = Now;
+}
+
+void FRiderLogBatcher::Flush()
+{
+	FlushRepeats();
+	FlushSkipped();
+
+	if (Pending.Num() == 0) return;
+
+	// Whole batch goes through single model action instead of one per line
+	IRiderLinkModule::Get().FireAsyncAction(
+	[this] (JetBrains::EditorPlugin::RdEditorModel const& RdEditorModel)
+	{
+		rd::ISignal<JetBrains::EditorPlugin::UnrealLogEvent> const& UnrealLog = RdEditorModel.get_unrealLog();
+		for (const FPendingMessage& Message : Pending)
+		{
+			FStringRanges BlueprintRanges;
+			FStringRanges MethodRanges;
+			FindLinkRanges(Message.Text, BlueprintRanges, MethodRanges);
+			UnrealLog.fire({Message.Info, Message.Text, MoveTemp(BlueprintRanges), MoveTemp(MethodRanges)});
+		}
+	});
+	Pending.Reset();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "RiderOutputDevice.hpp"
+
+#include "Model/Library/UE4Library/LogMessageInfo.Pregenerated.h"
+
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+
+/**
+ * Consumer side of log streaming, runs on LoggingScheduler.
+ * Collects drained lines, coalesces repeated messages, applies rate limit
+ * and sends whole batch to Rider in a single model action.
+ */
+class FRiderLogBatcher
+{
+public:
+	explicit FRiderLogBatcher(int64 InStartTime);
+
+	/** Adds captured line, backlog lines aren't rate limited */
+	void Add(const FRiderLogLine& Line, bool bRateLimited);
+
+	/** Reports lines lost before reaching batcher, e.g. because capture ring was full */
+	void AddSkipped(uint32 Count);
+
+	/** Sends all pending messages to Rider */
+	void Flush();
+
+private:
+	struct FPendingMessage
+	{
+		JetBrains::EditorPlugin::LogMessageInfo Info;
+		FString Text;
+	};
+
+	JetBrains::EditorPlugin::LogMessageInfo MakeMessageInfo(const FRiderLogLine& Line) const;
+
+	/** Splits message into lines and chunks of MaxChunkLength in single pass */
+	void Append(const JetBrains::EditorPlugin::LogMessageInfo& Info, const FString& Message);
+
+	bool ConsumeRateLimit();
+	void FlushRepeats();
+	void FlushSkipped();
+
+	int64 StartTime;
+	TArray<FPendingMessage> Pending;
+
+	FRiderLogLine LastLine;
+	bool bHasLastLine = false;
+	int32 RepeatCount = 0;
+
+	double Budget;
+	double LastRefillTime = 0.0;
+	uint32 SkippedCount = 0;
+	double LastSkippedNoticeTime = 0.0;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "RiderLogBatcher.hpp"
 #include "RiderOutputDevice.hpp"
 
 #include "Templates/UniquePtr.h"
@@ -25,7 +26,11 @@ public:
     virtual bool SupportsDynamicReloading() override { return true; }
 
 private:
+    /** Sends lines captured since last drain, runs on LoggingScheduler */
+    void DrainLogs();
+
     TUniquePtr<rd::SingleThreadScheduler> LoggingScheduler;
+    TUniquePtr<FRiderLogBatcher> LogBatcher;
     FRiderOutputDevice OutputDevice;
     rd::LifetimeDefinition ModuleLifetimeDef;
 };
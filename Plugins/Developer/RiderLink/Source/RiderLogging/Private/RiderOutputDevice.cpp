@@ -1,9 +1,53 @@
 #include "RiderOutputDevice.hpp"
 
 #include "CoreGlobals.h"
-#include "Misc/ScopeLock.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTLS.h"
 #include "Misc/OutputDeviceRedirector.h"
 
+FRiderLogRing::FRiderLogRing()
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be power of two");
+	Lines.SetNum(Capacity);
+}
+
+bool FRiderLogRing::Push(const TCHAR* Message, ELogVerbosity::Type Verbosity, const FName& Category, double Time)
+{
+	const uint32 CurrentHead = Head.load(std::memory_order_relaxed);
+	if (CurrentHead - Tail.load(std::memory_order_acquire) >= Capacity)
+	{
+		Dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	FRiderLogLine& Line = Lines[CurrentHead & (Capacity - 1)];
+	Line.Message = Message;
+	Line.Category = Category;
+	Line.Verbosity = Verbosity;
+	Line.Time = Time;
+
+	Head.store(CurrentHead + 1, std::memory_order_release);
+	return true;
+}
+
+uint32 FRiderLogRing::Pop(TFunctionRef<void(const FRiderLogLine&)> Consumer)
+{
+	const uint32 CurrentHead = Head.load(std::memory_order_acquire);
+	const uint32 CurrentTail = Tail.load(std::memory_order_relaxed);
+	for (uint32 Index = CurrentTail; Index != CurrentHead; ++Index)
+	{
+		Consumer(Lines[Index & (Capacity - 1)]);
+	}
+	Tail.store(CurrentHead, std::memory_order_release);
+
+	return Dropped.exchange(0, std::memory_order_relaxed);
+}
+
+FRiderOutputDevice::FRiderOutputDevice()
+	: TlsSlot(FPlatformTLS::AllocTlsSlot())
+{
+}
+
 void FRiderOutputDevice::Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category)
 {
 	Serialize(V, Verbosity, Category, {});
@@ -12,38 +56,115 @@ void FRiderOutputDevice::Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity
 void FRiderOutputDevice::Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category,
                                    const double Time)
 {
-	FScopeLock Lock{&CriticalSection};
-	
-	onSerializeMessage.ExecuteIfBound(V, Verbosity, Category, {Time});
+	if (Verbosity > ELogVerbosity::All) return;
+
+	// Counter lets TearDown wait for lines being captured right now, without making them wait for each other
+	InFlight.fetch_add(1);
+	if (bCapturing.load())
+	{
+		if (bCapturingBacklog.load(std::memory_order_relaxed) && FPlatformTLS::GetCurrentThreadId() == BacklogThreadId)
+		{
+			FRiderLogLine& Line = Backlog.AddDefaulted_GetRef();
+			Line.Message = V;
+			Line.Category = Category;
+			Line.Verbosity = Verbosity;
+			Line.Time = Time;
+		}
+		else if (GetThreadRing().Push(V, Verbosity, Category, Time) && !bDrainScheduled.exchange(true))
+		{
+			OnLinesCaptured();
+		}
+	}
+	InFlight.fetch_sub(1, std::memory_order_release);
+}
+
+FRiderLogRing& FRiderOutputDevice::GetThreadRing()
+{
+	FRiderLogRing* Ring = static_cast<FRiderLogRing*>(FPlatformTLS::GetTlsValue(TlsSlot));
+	if (Ring == nullptr)
+	{
+		Ring = new FRiderLogRing();
+		Ring->Next = Rings.load(std::memory_order_relaxed);
+		while (!Rings.compare_exchange_weak(Ring->Next, Ring, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+		FPlatformTLS::SetTlsValue(TlsSlot, Ring);
+	}
+	return *Ring;
+}
+
+uint32 FRiderOutputDevice::Drain(TFunctionRef<void(const FRiderLogLine& Line, bool bBacklog)> Consumer)
+{
+	// Lines captured from now on will schedule next drain
+	bDrainScheduled.store(false);
+
+	// Backlog has to go first, Setup will schedule drain again once it's ready
+	if (bCapturingBacklog.load(std::memory_order_acquire)) return 0;
+
+	if (bHasBacklog.exchange(false, std::memory_order_acquire))
+	{
+		for (const FRiderLogLine& Line : Backlog)
+		{
+			Consumer(Line, true);
+		}
+		Backlog.Empty();
+	}
+
+	uint32 Dropped = 0;
+	for (FRiderLogRing* Ring = Rings.load(std::memory_order_acquire); Ring != nullptr; Ring = Ring->Next)
+	{
+		Dropped += Ring->Pop([&Consumer](const FRiderLogLine& Line) { Consumer(Line, false); });
+	}
+	return Dropped;
 }
 
 FRiderOutputDevice::~FRiderOutputDevice()
 {
 	// At shutdown, GLog may already be null
-	// This should be out of scoped lock, because it'll implicitly try take a lock in OutputDeviceRedirector
-	// And Serialize is already holding that lock, so we'll have a deadlock here
 	if (GLog != nullptr)
 	{
 		GLog->RemoveOutputDevice(this);
 	}
+
+	TearDown();
+
+	FRiderLogRing* Ring = Rings.exchange(nullptr);
+	while (Ring != nullptr)
+	{
+		FRiderLogRing* Next = Ring->Next;
+		delete Ring;
+		Ring = Next;
+	}
+	FPlatformTLS::FreeTlsSlot(TlsSlot);
 }
 
-void FRiderOutputDevice::Setup(TFunction<FOnSerializeMessage::TFuncType> Callback)
+void FRiderOutputDevice::Setup(TFunction<void()> InOnLinesCaptured)
 {
-	FScopeLock Lock{&CriticalSection};
+	if (bCapturing.load()) return;
+
+	OnLinesCaptured = MoveTemp(InOnLinesCaptured);
+	BacklogThreadId = FPlatformTLS::GetCurrentThreadId();
+	bCapturingBacklog.store(true);
+	bCapturing.store(true);
 
-	if(onSerializeMessage.IsBound()) return;
-	
-	onSerializeMessage.BindLambda(Callback);
 	GLog->AddOutputDevice(this);
 	GLog->SerializeBacklog(this);
+
+	bHasBacklog.store(Backlog.Num() > 0);
+	bCapturingBacklog.store(false, std::memory_order_release);
+	if (!bDrainScheduled.exchange(true))
+	{
+		OnLinesCaptured();
+	}
 }
 
 void FRiderOutputDevice::TearDown()
 {
-	FScopeLock Lock{&CriticalSection};
+	if (!bCapturing.exchange(false)) return;
 
-	if(onSerializeMessage.IsBound() == false) return;
-
-	onSerializeMessage.Unbind();
+	while (InFlight.load() > 0)
+	{
+		FPlatformProcess::YieldThread();
+	}
+	OnLinesCaptured = nullptr;
 }
@@ -1,30 +1,85 @@
 #pragma once
 
 #include "Misc/OutputDevice.h"
-#include "Delegates/Delegate.h"
+#include "Containers/Array.h"
 #include "Logging/LogVerbosity.h"
-#include "Runtime/Launch/Resources/Version.h"
+#include "Templates/Function.h"
+#include "UObject/NameTypes.h"
 
-using FOnSerializeMessage =
-#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 26
-	TBaseDelegate<void, const TCHAR*, ELogVerbosity::Type, const FName&, TOptional<double>>;
-#elif ENGINE_MAJOR_VERSION < 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION < 3)
-	TDelegate<void(const TCHAR*, ELogVerbosity::Type, const FName&, TOptional<double>)>;
-#else
-	TDelegate<void(const TCHAR*, ELogVerbosity::Type, const FName&, TOptional<double>), FDefaultTSDelegateUserPolicy>;
-#endif
+#include <atomic>
 
+struct FRiderLogLine
+{
+	FString Message;
+	FName Category;
+	ELogVerbosity::Type Verbosity = ELogVerbosity::Log;
+	double Time = 0.0;
+};
+
+/**
+ * Single producer/single consumer ring of captured lines, one per logging thread.
+ * Slots are reused, so steady logging doesn't allocate once message buffers have grown.
+ */
+class FRiderLogRing
+{
+public:
+	static constexpr uint32 Capacity = 1024;
+
+	FRiderLogRing();
+
+	/** Called only by owning thread, returns false if ring is full and line was dropped */
+	bool Push(const TCHAR* Message, ELogVerbosity::Type Verbosity, const FName& Category, double Time);
+
+	/** Called only by consumer, returns number of lines dropped since last call */
+	uint32 Pop(TFunctionRef<void(const FRiderLogLine&)> Consumer);
+
+	FRiderLogRing* Next = nullptr;
+
+private:
+	TArray<FRiderLogLine> Lines;
+	std::atomic<uint32> Head{0};
+	std::atomic<uint32> Tail{0};
+	std::atomic<uint32> Dropped{0};
+};
+
+/**
+ * Captures log lines without taking any lock on logging threads.
+ * Each thread writes to its own ring, consumer is notified once per batch and drains all rings at once.
+ */
 class FRiderOutputDevice : public FOutputDevice {
 public:
+	FRiderOutputDevice();
 	~FRiderOutputDevice();
-	void Setup(TFunction<FOnSerializeMessage::TFuncType>);
+
+	/** OnLinesCaptured is called from logging thread when new lines are waiting and drain isn't scheduled yet */
+	void Setup(TFunction<void()> OnLinesCaptured);
 	virtual void TearDown() override;
+	virtual bool CanBeUsedOnMultipleThreads() const override { return true; }
+
+	/**
+	 * Drains backlog and all thread rings, must be called from single consumer thread.
+	 * Returns number of lines dropped because some ring was full.
+	 */
+	uint32 Drain(TFunctionRef<void(const FRiderLogLine& Line, bool bBacklog)> Consumer);
 
 protected:
 	virtual void Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category) override;
 	virtual void Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category, double Time) override;
-	
+
 private:
-	FOnSerializeMessage onSerializeMessage;
-	FCriticalSection CriticalSection;
+	FRiderLogRing& GetThreadRing();
+
+	TFunction<void()> OnLinesCaptured;
+	uint32 TlsSlot;
+	std::atomic<FRiderLogRing*> Rings{nullptr};
+	std::atomic<bool> bCapturing{false};
+	std::atomic<bool> bDrainScheduled{false};
+	std::atomic<int32> InFlight{0};
+
+	// GLog backlog is serialized in one go on setup thread and could easily overflow its ring,
+	// so it's collected separately and handed to consumer as a whole
+	TArray<FRiderLogLine> Backlog;
+	uint32 BacklogThreadId = 0;
+	std::atomic<bool> bCapturingBacklog{false};
+	std::atomic<bool> bHasBacklog{false};
 };
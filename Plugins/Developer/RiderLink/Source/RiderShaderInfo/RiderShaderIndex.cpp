@@ -0,0 +1,346 @@
+﻿#include "RiderShaderIndex.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+namespace RiderShaderIndexImpl
+{
+static const TCHAR* CacheHeader = TEXT("RiderShaderIncludeGraph 1");
+
+static FString NormalizeDirectory(const FString& Directory)
+{
+	FString Result = FPaths::ConvertRelativePathToFull(Directory);
+	FPaths::NormalizeDirectoryName(Result);
+	return Result;
+}
+
+static bool IsInDirectory(const FString& Path, const FString& Directory)
+{
+	return Path.Len() > Directory.Len() && Path[Directory.Len()] == TEXT('/') &&
+		Path.StartsWith(Directory, ESearchCase::IgnoreCase);
+}
+}
+
+using namespace RiderShaderIndexImpl;
+
+FRiderShaderIndex::FRiderShaderIndex(const TMap<FString, FString>& ShaderMappings, const FString& InCacheFile)
+	: CacheFile(InCacheFile)
+{
+	for(const TTuple<FString, FString>& Pair : ShaderMappings)
+	{
+		FString VirtualDirectory = Pair.Key;
+		FPaths::NormalizeDirectoryName(VirtualDirectory);
+		Mappings.Emplace(VirtualDirectory, NormalizeDirectory(Pair.Value));
+	}
+	// Nested mappings ("/Plugin/A/B" inside "/Plugin/A") have to win over their parents
+	Mappings.Sort([](const TPair<FString, FString>& A, const TPair<FString, FString>& B)
+	{
+		return A.Key.Len() > B.Key.Len();
+	});
+}
+
+bool FRiderShaderIndex::IsShaderFile(const FString& Path)
+{
+	return Path.EndsWith(TEXT(".usf"), ESearchCase::IgnoreCase) || Path.EndsWith(TEXT(".ush"), ESearchCase::IgnoreCase);
+}
+
+FString FRiderShaderIndex::ResolveVirtualPath(const FString& VirtualPath) const
+{
+	for(const TPair<FString, FString>& Mapping : Mappings)
+	{
+		if(IsInDirectory(VirtualPath, Mapping.Key))
+		{
+			return Mapping.Value + VirtualPath.RightChop(Mapping.Key.Len());
+		}
+	}
+	return {};
+}
+
+FString FRiderShaderIndex::ToVirtualPath(const FString& FullPath) const
+{
+	FString Path = FPaths::ConvertRelativePathToFull(FullPath);
+	FPaths::NormalizeFilename(Path);
+
+	// Longest virtual directory isn't necessarily the longest directory on disk
+	const TPair<FString, FString>* Best = nullptr;
+	for(const TPair<FString, FString>& Mapping : Mappings)
+	{
+		if(IsInDirectory(Path, Mapping.Value) && (Best == nullptr || Mapping.Value.Len() > Best->Value.Len()))
+		{
+			Best = &Mapping;
+		}
+	}
+	return Best != nullptr ? Best->Key + Path.RightChop(Best->Value.Len()) : FString();
+}
+
+void FRiderShaderIndex::ParseIncludes(const FString& Source, const FString& VirtualPath, TArray<FString>& OutIncludes)
+{
+	const TCHAR* Text = *Source;
+	const int32 Length = Source.Len();
+	const FString VirtualDirectory = FPaths::GetPath(VirtualPath);
+
+	for(int32 LineStart = 0; LineStart < Length;)
+	{
+		int32 LineEnd = LineStart;
+		while(LineEnd < Length && Text[LineEnd] != TEXT('\n')) ++LineEnd;
+
+		// Only "#include" directives matter, the rest of the line is skipped without copying
+		int32 Index = LineStart;
+		while(Index < LineEnd && FChar::IsWhitespace(Text[Index])) ++Index;
+		if(Index < LineEnd && Text[Index] == TEXT('#'))
+		{
+			++Index;
+			while(Index < LineEnd && FChar::IsWhitespace(Text[Index])) ++Index;
+			if(FCString::Strncmp(Text + Index, TEXT("include"), 7) == 0)
+			{
+				int32 PathStart = Index + 7;
+				while(PathStart < LineEnd && Text[PathStart] != TEXT('"')) ++PathStart;
+				int32 PathEnd = ++PathStart;
+				while(PathEnd < LineEnd && Text[PathEnd] != TEXT('"')) ++PathEnd;
+				if(PathEnd < LineEnd)
+				{
+					FString Include(PathEnd - PathStart, Text + PathStart);
+					FPaths::NormalizeFilename(Include);
+					if(!Include.StartsWith(TEXT("/")))
+					{
+						Include = VirtualDirectory / Include;
+						FPaths::CollapseRelativeDirectories(Include);
+					}
+					OutIncludes.AddUnique(MoveTemp(Include));
+				}
+			}
+		}
+		LineStart = LineEnd + 1;
+	}
+}
+
+void FRiderShaderIndex::Build()
+{
+	struct FFoundFile
+	{
+		FString VirtualPath;
+		FString FullPath;
+		FDateTime Timestamp;
+		FShaderFile* Cached = nullptr;
+	};
+
+	TMap<FString, FShaderFile> Cached = LoadCache();
+
+	// Single pass over directories gives timestamps too, unchanged files aren't opened at all
+	TArray<FFoundFile> Found;
+	TSet<FString> Visited;
+	for(const TPair<FString, FString>& Mapping : Mappings)
+	{
+		IFileManager::Get().IterateDirectoryStatRecursively(*Mapping.Value,
+			[this, &Found, &Visited](const TCHAR* FilenameOrDirectory, const FFileStatData& StatData)
+			{
+				if(StatData.bIsDirectory || !IsShaderFile(FilenameOrDirectory)) return true;
+
+				FString VirtualPath = ToVirtualPath(FilenameOrDirectory);
+				bool bAlreadyVisited = false;
+				Visited.Add(VirtualPath, &bAlreadyVisited);
+				if(!VirtualPath.IsEmpty() && !bAlreadyVisited)
+				{
+					Found.Add({MoveTemp(VirtualPath), FilenameOrDirectory, StatData.ModificationTime});
+				}
+				return true;
+			});
+	}
+
+	int32 NumParsed = 0;
+	for(FFoundFile& File : Found)
+	{
+		FShaderFile* CachedFile = Cached.Find(File.VirtualPath);
+		if(CachedFile != nullptr && CachedFile->Timestamp == File.Timestamp)
+		{
+			File.Cached = CachedFile;
+		}
+		else
+		{
+			++NumParsed;
+		}
+	}
+
+	TArray<FShaderFile> Parsed;
+	Parsed.SetNum(Found.Num());
+	ParallelFor(Found.Num(), [&Found, &Parsed](int32 Index)
+	{
+		const FFoundFile& File = Found[Index];
+		Parsed[Index].Timestamp = File.Timestamp;
+		if(File.Cached != nullptr)
+		{
+			Parsed[Index].Includes = MoveTemp(File.Cached->Includes);
+			return;
+		}
+		FString Source;
+		if(FFileHelper::LoadFileToString(Source, *File.FullPath))
+		{
+			ParseIncludes(Source, File.VirtualPath, Parsed[Index].Includes);
+		}
+	});
+
+	{
+		FScopeLock Lock(&CriticalSection);
+		Files.Empty(Found.Num());
+		IncludedBy.Empty();
+		for(int32 Index = 0; Index < Found.Num(); ++Index)
+		{
+			AddIncludedBy(Found[Index].VirtualPath, Parsed[Index]);
+			Files.Add(MoveTemp(Found[Index].VirtualPath), MoveTemp(Parsed[Index]));
+		}
+		if(NumParsed > 0 || Cached.Num() != Files.Num())
+		{
+			SaveCache();
+		}
+	}
+}
+
+void FRiderShaderIndex::UpdateFiles(TArrayView<const FFileChange> Changes)
+{
+	struct FUpdate
+	{
+		FString VirtualPath;
+		FShaderFile File;
+		bool bRemoved;
+	};
+
+	// Files are parsed before locking, lookups aren't blocked by reading them
+	TArray<FUpdate> Updates;
+	Updates.Reserve(Changes.Num());
+	for(const FFileChange& Change : Changes)
+	{
+		FString VirtualPath = ToVirtualPath(Change.FullPath);
+		if(VirtualPath.IsEmpty()) continue;
+
+		FShaderFile File;
+		if(!Change.bRemoved)
+		{
+			FString Source;
+			if(!FFileHelper::LoadFileToString(Source, *Change.FullPath)) continue;
+			File.Timestamp = IFileManager::Get().GetTimeStamp(*Change.FullPath);
+			ParseIncludes(Source, VirtualPath, File.Includes);
+		}
+		Updates.Add({MoveTemp(VirtualPath), MoveTemp(File), Change.bRemoved});
+	}
+
+	FScopeLock Lock(&CriticalSection);
+	bool bChanged = false;
+	for(FUpdate& Update : Updates)
+	{
+		if(FShaderFile* OldFile = Files.Find(Update.VirtualPath))
+		{
+			bChanged = true;
+			if(!Update.bRemoved && OldFile->Includes == Update.File.Includes)
+			{
+				OldFile->Timestamp = Update.File.Timestamp;
+				continue;
+			}
+			RemoveIncludedBy(Update.VirtualPath, *OldFile);
+			Files.Remove(Update.VirtualPath);
+		}
+		if(!Update.bRemoved)
+		{
+			bChanged = true;
+			AddIncludedBy(Update.VirtualPath, Update.File);
+			Files.Add(MoveTemp(Update.VirtualPath), MoveTemp(Update.File));
+		}
+	}
+	if(bChanged)
+	{
+		SaveCache();
+	}
+}
+
+TArray<FString> FRiderShaderIndex::FindIncludingFiles(const FString& VirtualPath) const
+{
+	TArray<FString> Result;
+	TSet<FString> Visited;
+	Visited.Add(VirtualPath);
+
+	FScopeLock Lock(&CriticalSection);
+	TArray<const FString*> Pending{&VirtualPath};
+	for(int32 PendingIndex = 0; PendingIndex < Pending.Num(); ++PendingIndex)
+	{
+		const TArray<FString>* Includers = IncludedBy.Find(*Pending[PendingIndex]);
+		if(Includers == nullptr) continue;
+
+		for(const FString& Includer : *Includers)
+		{
+			bool bAlreadyVisited = false;
+			Visited.Add(Includer, &bAlreadyVisited);
+			if(bAlreadyVisited) continue;
+
+			Result.Add(Includer);
+			Pending.Add(&Includer);
+		}
+	}
+	Result.Sort();
+	return Result;
+}
+
+void FRiderShaderIndex::AddIncludedBy(const FString& VirtualPath, const FShaderFile& File)
+{
+	for(const FString& Include : File.Includes)
+	{
+		IncludedBy.FindOrAdd(Include).Add(VirtualPath);
+	}
+}
+
+void FRiderShaderIndex::RemoveIncludedBy(const FString& VirtualPath, const FShaderFile& File)
+{
+	for(const FString& Include : File.Includes)
+	{
+		if(TArray<FString>* Includers = IncludedBy.Find(Include))
+		{
+			Includers->RemoveSingleSwap(VirtualPath);
+			if(Includers->Num() == 0)
+			{
+				IncludedBy.Remove(Include);
+			}
+		}
+	}
+}
+
+TMap<FString, FRiderShaderIndex::FShaderFile> FRiderShaderIndex::LoadCache() const
+{
+	// One line per file: "<virtual path>\t<timestamp ticks>\t<include>;<include>..."
+	TMap<FString, FShaderFile> Result;
+	TArray<FString> Lines;
+	if(!FFileHelper::LoadFileToStringArray(Lines, *CacheFile) || Lines.Num() == 0 || Lines[0] != CacheHeader)
+	{
+		return Result;
+	}
+
+	TArray<FString> Columns;
+	for(int32 Index = 1; Index < Lines.Num(); ++Index)
+	{
+		Lines[Index].ParseIntoArray(Columns, TEXT("\t"), false);
+		if(Columns.Num() != 3) continue;
+
+		FShaderFile& File = Result.Add(Columns[0]);
+		File.Timestamp = FDateTime(FCString::Atoi64(*Columns[1]));
+		Columns[2].ParseIntoArray(File.Includes, TEXT(";"));
+	}
+	return Result;
+}
+
+void FRiderShaderIndex::SaveCache() const
+{
+	TArray<FString> Lines;
+	Lines.Reserve(Files.Num() + 1);
+	Lines.Add(CacheHeader);
+	for(const TPair<FString, FShaderFile>& Pair : Files)
+	{
+		Lines.Add(FString::Printf(TEXT("%s\t%lld\t%s"), *Pair.Key, Pair.Value.Timestamp.GetTicks(),
+		                          *FString::Join(Pair.Value.Includes, TEXT(";"))));
+	}
+
+	const FString TmpCacheFile = FPaths::Combine(FPaths::GetPath(CacheFile), TEXT("~") + FPaths::GetCleanFilename(CacheFile));
+	if(FFileHelper::SaveStringArrayToFile(Lines, *TmpCacheFile))
+	{
+		IFileManager::Get().Move(*CacheFile, *TmpCacheFile, true, true);
+	}
+}
@@ -0,0 +1,65 @@
+﻿#pragma once
+
+#include "Containers/ArrayView.h"
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/DateTime.h"
+
+/**
+ * Include graph of all .usf/.ush files in shader source directory mappings.
+ * Files are addressed by virtual paths ("/Engine/Private/Common.ush"), graph is cached in
+ * Intermediate, so on start only files changed since last session are parsed again.
+ */
+class FRiderShaderIndex
+{
+public:
+	FRiderShaderIndex(const TMap<FString, FString>& ShaderMappings, const FString& InCacheFile);
+
+	/** Scans all mapped directories, can be called from any thread */
+	void Build();
+
+	struct FFileChange
+	{
+		/** Path on disk */
+		FString FullPath;
+		bool bRemoved = false;
+	};
+
+	/** Reparses or removes changed files and saves cache once for all of them, can be called from any thread */
+	void UpdateFiles(TArrayView<const FFileChange> Changes);
+
+	/** Returns path on disk of given virtual path, empty if it isn't in any mapped directory */
+	FString ResolveVirtualPath(const FString& VirtualPath) const;
+
+	/** Returns virtual path of file on disk, empty if it isn't in any mapped directory */
+	FString ToVirtualPath(const FString& FullPath) const;
+
+	/** Returns virtual paths of all files including given file directly or through other includes */
+	TArray<FString> FindIncludingFiles(const FString& VirtualPath) const;
+
+	static bool IsShaderFile(const FString& Path);
+
+private:
+	struct FShaderFile
+	{
+		FDateTime Timestamp;
+		TArray<FString> Includes;
+	};
+
+	static void ParseIncludes(const FString& Source, const FString& VirtualPath, TArray<FString>& OutIncludes);
+
+	void AddIncludedBy(const FString& VirtualPath, const FShaderFile& File);
+	void RemoveIncludedBy(const FString& VirtualPath, const FShaderFile& File);
+
+	TMap<FString, FShaderFile> LoadCache() const;
+	void SaveCache() const;
+
+	// Virtual directory and its full path on disk, longest virtual directories first
+	TArray<TPair<FString, FString>> Mappings;
+	FString CacheFile;
+
+	mutable FCriticalSection CriticalSection;
+	TMap<FString, FShaderFile> Files;
+	TMap<FString, TArray<FString>> IncludedBy;
+};
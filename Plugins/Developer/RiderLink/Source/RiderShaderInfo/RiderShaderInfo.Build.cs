@@ -14,6 +14,6 @@ public class RiderShaderInfo : ModuleRules
 		bDisableStaticAnalysis = true;
 #endif
 
-		PrivateDependencyModuleNames.AddRange(new string[] { "Core",  "Projects", "RenderCore" });
+		PrivateDependencyModuleNames.AddRange(new string[] { "Core",  "Projects", "RenderCore", "DirectoryWatcher" });
 	}
 }
@@ -1,22 +1,107 @@
 ﻿#include "RiderShaderInfo.h"
 
+#include "RiderShaderIndex.h"
+
+#include "Async/Async.h"
+#include "DirectoryWatcherModule.h"
 #include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "IDirectoryWatcher.h"
 #include "Interfaces/IPluginManager.h"
 #include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
 #include "Modules/ModuleManager.h"
 #include "ShaderCore.h"
 
+DEFINE_LOG_CATEGORY_STATIC(LogRiderShaderInfo, Log, All);
+
 IMPLEMENT_MODULE(FRiderShaderInfoModule, RiderShaderInfo);
 
+static FAutoConsoleCommand FindIncludingShadersCommand(
+	TEXT("RiderLink.FindIncludingShaders"),
+	TEXT("Lists shader files including given file, e.g. RiderLink.FindIncludingShaders /Engine/Private/Common.ush"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if(Args.Num() == 0) return;
+
+		const FRiderShaderInfoModule& Module = FModuleManager::GetModuleChecked<FRiderShaderInfoModule>(TEXT("RiderShaderInfo"));
+		const TArray<FString> Includers = Module.FindIncludingFiles(Args[0]);
+		UE_LOG(LogRiderShaderInfo, Display, TEXT("%d shader files include %s (%s)"), Includers.Num(), *Args[0], *Module.ResolveVirtualPath(Args[0]));
+		for(const FString& Includer : Includers)
+		{
+			UE_LOG(LogRiderShaderInfo, Display, TEXT("    %s"), *Includer);
+		}
+	}));
+
 void FRiderShaderInfoModule::StartupModule()
 {
 	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("RiderLink"));
 	if(!Plugin.IsValid()) return;
-	
-	const FString MappingFile = FPaths::Combine(Plugin->GetBaseDir(), TEXT("Intermediate"), TEXT("FileSystemMappings.ini"));
-	const FString TmpMappingFile = FPaths::Combine(Plugin->GetBaseDir(), TEXT("Intermediate"), TEXT("~FileSystemMappings.ini"));
 
+	const FString IntermediateDir = FPaths::Combine(Plugin->GetBaseDir(), TEXT("Intermediate"));
 	const TMap<FString, FString> ShaderMappings = AllShaderSourceDirectoryMappings();
+	WriteMappings(IntermediateDir, ShaderMappings);
+
+	// Include graph lives next to mappings, Rider reads both from Intermediate
+	ShaderIndex = MakeShared<FRiderShaderIndex, ESPMode::ThreadSafe>(ShaderMappings, FPaths::Combine(IntermediateDir, TEXT("ShaderIncludeGraph.txt")));
+	const TWeakPtr<FRiderShaderIndex, ESPMode::ThreadSafe> WeakIndex = ShaderIndex;
+	BuildTask = Async(EAsyncExecution::ThreadPool, [WeakIndex]()
+	{
+		if(const TSharedPtr<FRiderShaderIndex, ESPMode::ThreadSafe> Index = WeakIndex.Pin())
+		{
+			Index->Build();
+		}
+		// Watching starts only after build, so changes can't be overwritten by results of full scan
+		AsyncTask(ENamedThreads::GameThread, [WeakIndex]()
+		{
+			if(!WeakIndex.IsValid()) return;
+			FModuleManager::GetModuleChecked<FRiderShaderInfoModule>(TEXT("RiderShaderInfo")).StartWatching();
+		});
+	});
+}
+
+void FRiderShaderInfoModule::ShutdownModule()
+{
+	if(BuildTask.IsValid())
+	{
+		BuildTask.Wait();
+	}
+
+	if(FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+	{
+		if(IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule->Get())
+		{
+			for(const TPair<FString, FDelegateHandle>& Watched : WatchedDirectories)
+			{
+				DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(Watched.Key, Watched.Value);
+			}
+		}
+	}
+	WatchedDirectories.Empty();
+
+	// No new changes arrive once watchers are gone, last update still uses the index
+	if(UpdateTask.IsValid())
+	{
+		UpdateTask.Wait();
+	}
+	ShaderIndex.Reset();
+}
+
+FString FRiderShaderInfoModule::ResolveVirtualPath(const FString& VirtualPath) const
+{
+	return ShaderIndex.IsValid() ? ShaderIndex->ResolveVirtualPath(VirtualPath) : FString();
+}
+
+TArray<FString> FRiderShaderInfoModule::FindIncludingFiles(const FString& VirtualPath) const
+{
+	return ShaderIndex.IsValid() ? ShaderIndex->FindIncludingFiles(VirtualPath) : TArray<FString>();
+}
+
+void FRiderShaderInfoModule::WriteMappings(const FString& IntermediateDir, const TMap<FString, FString>& ShaderMappings) const
+{
+	const FString MappingFile = FPaths::Combine(IntermediateDir, TEXT("FileSystemMappings.ini"));
+	const FString TmpMappingFile = FPaths::Combine(IntermediateDir, TEXT("~FileSystemMappings.ini"));
+
 	const TArray<FString> Mappings = [&ShaderMappings]()->TArray<FString>
 	{
 		TArray<FString> Result;
@@ -35,3 +120,70 @@ void FRiderShaderInfoModule::StartupModule()
 	FFileHelper::SaveStringArrayToFile(Mappings, *TmpMappingFile);
 	IFileManager::Get().Move(*MappingFile, *TmpMappingFile, true, true);
 }
+
+void FRiderShaderInfoModule::StartWatching()
+{
+	IDirectoryWatcher* DirectoryWatcher = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")).Get();
+	if(DirectoryWatcher == nullptr) return;
+
+	for(const TTuple<FString, FString>& Pair : AllShaderSourceDirectoryMappings())
+	{
+		const FString Directory = FPaths::ConvertRelativePathToFull(Pair.Value);
+		FDelegateHandle Handle;
+		DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(Directory,
+			IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FRiderShaderInfoModule::OnDirectoryChanged), Handle);
+		if(Handle.IsValid())
+		{
+			WatchedDirectories.Emplace(Directory, Handle);
+		}
+	}
+}
+
+void FRiderShaderInfoModule::OnDirectoryChanged(const TArray<FFileChangeData>& Changes)
+{
+	if(!ShaderIndex.IsValid()) return;
+
+	FScopeLock Lock(&PendingCriticalSection);
+	for(const FFileChangeData& Change : Changes)
+	{
+		if(!FRiderShaderIndex::IsShaderFile(Change.Filename)) continue;
+
+		// Editors save through temporary files, only the last change of a file matters
+		PendingFiles.Add(Change.Filename, Change.Action == FFileChangeData::FCA_Removed);
+	}
+
+	// Running task picks up new changes before it finishes, so updates never run concurrently or out of order
+	if(PendingFiles.Num() > 0 && !bUpdateScheduled)
+	{
+		bUpdateScheduled = true;
+		UpdateTask = Async(EAsyncExecution::ThreadPool, [this]()
+		{
+			UpdatePendingFiles();
+		});
+	}
+}
+
+void FRiderShaderInfoModule::UpdatePendingFiles()
+{
+	const TSharedPtr<FRiderShaderIndex, ESPMode::ThreadSafe> Index = ShaderIndex;
+	TArray<FRiderShaderIndex::FFileChange> Changes;
+	while(true)
+	{
+		{
+			FScopeLock Lock(&PendingCriticalSection);
+			if(PendingFiles.Num() == 0 || !Index.IsValid())
+			{
+				bUpdateScheduled = false;
+				return;
+			}
+
+			Changes.Reset(PendingFiles.Num());
+			for(const TPair<FString, bool>& Pending : PendingFiles)
+			{
+				Changes.Add({Pending.Key, Pending.Value});
+			}
+			PendingFiles.Empty();
+		}
+		Index->UpdateFiles(Changes);
+	}
+}
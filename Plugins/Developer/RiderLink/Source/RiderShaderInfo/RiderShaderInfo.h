@@ -1,9 +1,42 @@
 ﻿#pragma once
 
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "Async/Future.h"
+#include "Containers/Map.h"
+#include "Delegates/IDelegateInstance.h"
+#include "HAL/CriticalSection.h"
 #include "Modules/ModuleInterface.h"
+#include "Templates/SharedPointer.h"
+
+class FRiderShaderIndex;
+struct FFileChangeData;
 
 class RIDERSHADERINFO_API FRiderShaderInfoModule : public IModuleInterface
 {
 public:
 	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+
+	/** Returns path on disk of shader virtual path, e.g. "/Engine/Private/Common.ush" */
+	FString ResolveVirtualPath(const FString& VirtualPath) const;
+
+	/** Returns virtual paths of shader files including given file directly or through other includes */
+	TArray<FString> FindIncludingFiles(const FString& VirtualPath) const;
+
+private:
+	void WriteMappings(const FString& IntermediateDir, const TMap<FString, FString>& ShaderMappings) const;
+	void StartWatching();
+	void OnDirectoryChanged(const TArray<FFileChangeData>& Changes);
+	void UpdatePendingFiles();
+
+	TSharedPtr<FRiderShaderIndex, ESPMode::ThreadSafe> ShaderIndex;
+	TFuture<void> BuildTask;
+
+	// Changed shader files by path on disk and whether they were removed, updated by one task at a time
+	FCriticalSection PendingCriticalSection;
+	TMap<FString, bool> PendingFiles;
+	bool bUpdateScheduled = false;
+	TFuture<void> UpdateTask;
+	TArray<TPair<FString, FDelegateHandle>> WatchedDirectories;
 };
@@ -43,7 +43,8 @@ public class DynamicAISystem : ModuleRules
 				"DeveloperSettings",
 				"GameplayTasks",
 				"GameplayTags",
-				"NavigationSystem"
+				"NavigationSystem",
+				"RenderCore"
 			}
 			);
 		
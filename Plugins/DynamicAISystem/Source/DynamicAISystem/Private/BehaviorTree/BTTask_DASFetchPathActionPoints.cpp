@@ -0,0 +1,109 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+
+#include "BehaviorTree/BTTask_DASFetchPathActionPoints.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "Components/DASComponent.h"
+#include "Utils/DASInterface.h"
+#include "AIController.h"
+
+
+UBTTask_DASFetchPathActionPoints::UBTTask_DASFetchPathActionPoints()
+{
+	NodeName = "DAS Fetch Path Action Points";
+}
+
+UDASComponent* UBTTask_DASFetchPathActionPoints::FindDASComponent( const UBehaviorTreeComponent& OwnerComp )
+{
+	AAIController* AIController = OwnerComp.GetAIOwner();
+	APawn* pawn = AIController ? AIController->GetPawn() : nullptr;
+
+	if( pawn && pawn->GetClass()->ImplementsInterface( UDASInterface::StaticClass() ) )
+	{
+		return IDASInterface::Execute_GetDASComponent( pawn );
+	}
+
+	return nullptr;
+}
+
+EBTNodeResult::Type UBTTask_DASFetchPathActionPoints::ExecuteTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory )
+{
+	UDASComponent* DASComponent = FindDASComponent( OwnerComp );
+	if( !IsValid( DASComponent ) )
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	FBTFetchPathActionPointsMemory* MyMemory = (FBTFetchPathActionPointsMemory*)NodeMemory;
+	check( MyMemory );
+	MyMemory->RequestId++;
+	MyMemory->bFinished = false;
+	MyMemory->bHadAnyActions = false;
+	MyMemory->bExecuting = true;
+
+	DASComponent->RequestPathActionPoints( FOnPathActionPointsFetched::CreateUObject( this, &UBTTask_DASFetchPathActionPoints::OnPathActionPointsFetched,
+		TWeakObjectPtr<UBehaviorTreeComponent>( &OwnerComp ), MyMemory->RequestId ) );
+
+	MyMemory->bExecuting = false;
+
+	// answered right away when component isn't registered in update manager
+	if( MyMemory->bFinished )
+	{
+		return MyMemory->bHadAnyActions ? EBTNodeResult::Succeeded : EBTNodeResult::Failed;
+	}
+
+	return EBTNodeResult::InProgress;
+}
+
+void UBTTask_DASFetchPathActionPoints::OnPathActionPointsFetched( bool bHadAnyActions, TWeakObjectPtr<UBehaviorTreeComponent> OwnerComp, int32 RequestId )
+{
+	UBehaviorTreeComponent* BTComp = OwnerComp.Get();
+	if( !BTComp )
+	{
+		return;
+	}
+
+	// find memory of node instance which sent request
+	const int32 InstanceIdx = BTComp->FindInstanceContainingNode( this );
+	FBTFetchPathActionPointsMemory* MyMemory = InstanceIdx != INDEX_NONE ? CastInstanceNodeMemory<FBTFetchPathActionPointsMemory>( BTComp->GetNodeMemory( this, InstanceIdx ) ) : nullptr;
+
+	// task was aborted or executed again in the meantime
+	if( !MyMemory || MyMemory->RequestId != RequestId || MyMemory->bFinished )
+	{
+		return;
+	}
+
+	MyMemory->bFinished = true;
+	MyMemory->bHadAnyActions = bHadAnyActions;
+
+	// still inside ExecuteTask, it will return result itself
+	if( MyMemory->bExecuting )
+	{
+		return;
+	}
+
+	FinishLatentTask( *BTComp, bHadAnyActions ? EBTNodeResult::Succeeded : EBTNodeResult::Failed );
+}
+
+EBTNodeResult::Type UBTTask_DASFetchPathActionPoints::AbortTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory )
+{
+	FBTFetchPathActionPointsMemory* MyMemory = (FBTFetchPathActionPointsMemory*)NodeMemory;
+	check( MyMemory );
+
+	// result of pending request will be ignored
+	MyMemory->RequestId++;
+	MyMemory->bFinished = true;
+
+	return EBTNodeResult::Aborted;
+}
+
+void UBTTask_DASFetchPathActionPoints::DescribeRuntimeValues( const UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTDescriptionVerbosity::Type Verbosity, TArray<FString>& Values ) const
+{
+	Super::DescribeRuntimeValues( OwnerComp, NodeMemory, Verbosity, Values );
+
+	FBTFetchPathActionPointsMemory* MyMemory = (FBTFetchPathActionPointsMemory*)NodeMemory;
+	if( MyMemory && !MyMemory->bFinished )
+	{
+		Values.Add( TEXT( "Waiting for scored action points" ) );
+	}
+}
@@ -11,6 +11,8 @@
 #include "Objects/DASActionSelector.h"
 #include "Points/DASActionPoint.h"
 #include "Utils/DASWorldSubsystem.h"
+#include "Utils/DASUpdateManager.h"
+#include "Utils/DASWorldSnapshot.h"
 #include "BrainComponent.h"
 #include "AIController.h"
 #include "Net/Core/PushModel/PushModel.h"
@@ -23,6 +25,7 @@
 
 #if WITH_EDITORONLY_DATA
 #include "DrawDebugHelpers.h"
+#include "Selection.h"
 #endif
 #include "Objects/DASAction.h"
 
@@ -39,6 +42,11 @@ UDASComponent::UDASComponent()
 	bIsMovingForwardAlongPath = true;
 	bIsReturningToPathPoint = false;
 	bAutoCalculateMoveFromPointDistanceTolerance = true;
+	bHasBlueprintDecisionUpdate = false;
+	bLastCanRunActionPoint = false;
+	bLastCanRunPathPoint = false;
+	bIsUpdatingDecisions = false;
+	bActionSelectorOverridden = false;
 	RunMode = EDASRunMode::ExecutePathPoints;
 
 	SetIsReplicatedByDefault( true );
@@ -76,6 +84,30 @@ void UDASComponent::OnRegister()
 	Super::OnRegister();
 }
 
+void UDASComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// cache reference, so all components in the world can be saved at once
+	if( UDASWorldSubsystem* DASSubsystem = GetWorld()->GetSubsystem<UDASWorldSubsystem>() )
+	{
+		DASSubsystem->AddDASComponent( this );
+	}
+}
+
+void UDASComponent::EndPlay( const EEndPlayReason::Type EndPlayReason )
+{
+	// stop receiving decision updates when owner is removed from the world
+	SetRegisteredToUpdateManager( false );
+
+	if( UDASWorldSubsystem* DASSubsystem = GetWorld()->GetSubsystem<UDASWorldSubsystem>() )
+	{
+		DASSubsystem->RemoveDASComponent( this );
+	}
+
+	Super::EndPlay( EndPlayReason );
+}
+
 
 bool UDASComponent::Init( UBehaviorTree* BehaviorTree )
 {
@@ -138,6 +170,9 @@ bool UDASComponent::Init( UBehaviorTree* BehaviorTree )
 		}
 
 		SetIsInitialized( true );
+
+		// start receiving budgeted decision updates
+		SetRegisteredToUpdateManager( true );
 		return true;
 	}
 
@@ -197,6 +232,7 @@ void UDASComponent::SetActionSelector( UDASActionSelector* NewActionSelector )
 	if( ActionSelector != NewActionSelector )
 	{
 		ActionSelector = NewActionSelector;
+		bActionSelectorOverridden = true;
 
 		// if AI was already executing actions from selector, reset them to pick new actions from new selector
 		if( RunMode == EDASRunMode::ExecuteActionsFromSelector )
@@ -232,6 +268,7 @@ void UDASComponent::Reset()
 	if( UDASComponent* ComponentCDO = Cast<UDASComponent>( UDASBPLibrary::FindDefaultComponentByClass( GetOwner()->GetClass(), GetClass() ) ) )
 	{
 		// reset data
+		SetRegisteredToUpdateManager( false );
 		SetIsInitialized( false );
 		ClearActionPointsQueue();
 		SetActionPoint( nullptr );
@@ -244,6 +281,7 @@ void UDASComponent::Reset()
 		SetIsMovingForwardAlongPath( ComponentCDO->bIsMovingForwardAlongPath );
 		SetPathBehavior( EDASPathBehavior::Undefined );
 		ActionSelector = nullptr;
+		bActionSelectorOverridden = false;
 		InitialPathPoint = nullptr;
 		OwnerAIController = nullptr;
 
@@ -299,64 +337,184 @@ void UDASComponent::LoadFromSnapshot( const FDASComponentSnapshot& Snapshot, boo
 	{
 		if( UDASWorldSubsystem* DASSubsystem = world->GetSubsystem<UDASWorldSubsystem>() )
 		{
-			// Load mode
-			SetRunMode( Snapshot.RunMode ); // should call directly to not clear action points
+			FDASComponentState state;
+			state.RunMode = Snapshot.RunMode;
+			state.ActionSelectorClass = Snapshot.ActionSelectorClass;
+			state.ActionSelectorData = Snapshot.ActionSelectorData;
+			state.ActivePathPoint = DASSubsystem->FindPathPointById( Snapshot.ActivePathPointId );
 
-			// Recreate action selector
-			UDASActionSelector* selector = nullptr; // this could also clear action points
-			if( Snapshot.ActionSelectorClass )
+			state.ActionPointsQueue.Reserve( Snapshot.ActionPointsIdQueue.Num() );
+			for( const FGuid& actionPointId : Snapshot.ActionPointsIdQueue )
 			{
-				selector = NewObject<UDASActionSelector>( this, Snapshot.ActionSelectorClass );
-				FMemoryReader memoryReader( Snapshot.ActionSelectorData, true );
-				FDASSaveGameArchive Ar( memoryReader );
-				selector->Serialize( Ar );
+				state.ActionPointsQueue.Add( DASSubsystem->FindActionPointById( actionPointId ) );
 			}
-			SetActionSelector( selector );
 
-			// Load active path point
-			ADASPathPoint* activePathPoint = DASSubsystem->FindPathPointById( Snapshot.ActivePathPointId );
-			SetPathPoint( activePathPoint ); // this could also clear action points
+			state.bWasMovingForward = Snapshot.bWasMovingForward;
+			state.bWasReturningToPathPoint = Snapshot.bWasReturningToPathPoint;
+			state.bHasNewPathPoint = Snapshot.bHasNewPathPoint;
+			state.bLoadOwnerTransform = bLoadOwnerTransform;
+			state.OwnerLocation = Snapshot.OwnerLocation;
+			state.OwnerRotation = Snapshot.OwnerRotation;
 
-			// Reset action point, it will be taken from ActionPointsQueue
-			SetActionPoint( nullptr );
+			LoadFromState( state );
+		}
+	}
+}
 
-			// Reset as it no longer will be needed because data was loaded
-			InitialPathPoint = nullptr;
+void UDASComponent::LoadFromState( const FDASComponentState& State )
+{
+	// Load mode
+	SetRunMode( State.RunMode ); // should call directly to not clear action points
 
-			// Load actions queue
-			TArray<ADASActionPoint*> loadedQueue;
-			loadedQueue.Reserve( Snapshot.ActionPointsIdQueue.Num() );
+	// Recreate action selector
+	if( State.bLoadActionSelector )
+	{
+		UDASActionSelector* selector = nullptr; // this could also clear action points
+		if( State.ActionSelectorClass )
+		{
+			selector = NewObject<UDASActionSelector>( this, State.ActionSelectorClass );
+			FMemoryReaderView memoryReader( State.ActionSelectorData, true );
+			FDASSaveGameArchive Ar( memoryReader );
+			selector->Serialize( Ar );
+		}
+		SetActionSelector( selector );
+	}
+	else if( State.bLoadActionSelectorState && ActionSelector )
+	{
+		// selector is kept, only its SaveGame properties are restored
+		FMemoryReaderView memoryReader( State.ActionSelectorData, true );
+		FDASSaveGameArchive Ar( memoryReader );
+		ActionSelector->Serialize( Ar );
+	}
 
-			for( const FGuid& actionPointId : Snapshot.ActionPointsIdQueue )
-			{
-				ADASActionPoint* actionPoint = DASSubsystem->FindActionPointById( actionPointId );
-				loadedQueue.Add( actionPoint );
-			}
-			SetActionPointsQueue( loadedQueue );
+	// Load active path point
+	SetPathPoint( State.ActivePathPoint ); // this could also clear action points
 
-			SetIsMovingForwardAlongPath( Snapshot.bWasMovingForward );
-			SetIsReturningToPathPoint( Snapshot.bWasReturningToPathPoint );
-			SetHasNewPathPoint( Snapshot.bHasNewPathPoint );
+	// Reset action point, it will be taken from ActionPointsQueue
+	SetActionPoint( nullptr );
 
-			// load transform
-			if( bLoadOwnerTransform )
+	// Reset as it no longer will be needed because data was loaded
+	InitialPathPoint = nullptr;
+
+	// Load actions queue
+	SetActionPointsQueue( State.ActionPointsQueue );
+
+	SetIsMovingForwardAlongPath( State.bWasMovingForward );
+	SetIsReturningToPathPoint( State.bWasReturningToPathPoint );
+	SetHasNewPathPoint( State.bHasNewPathPoint );
+
+	// load transform
+	if( State.bLoadOwnerTransform )
+	{
+		if( AActor* owner = GetOwner() )
+		{
+			owner->SetActorLocationAndRotation( State.OwnerLocation, State.OwnerRotation );
+		}
+	}
+
+	// restart logic if is already running ( behavior tree )
+	if( GetOwnerAIController() )
+	{
+		if( UBrainComponent* brain = GetOwnerAIController()->BrainComponent )
+		{
+			brain->RestartLogic();
+		}
+	}
+}
+
+
+void UDASComponent::UpdateDecisions( float DeltaTime )
+{
+	bIsUpdatingDecisions = true;
+
+	// action points requested by behavior tree, selector picks them on its own
+	if( PendingPathActionPointsFetch.IsBound() )
+	{
+		FOnPathActionPointsFetched onFetched = MoveTemp( PendingPathActionPointsFetch );
+		PendingPathActionPointsFetch.Unbind();
+
+		// AI could get other path point while request waited for update, result doesn't belong to it then
+		const bool bSamePathPoint = PendingFetchPathPoint.Get() == ActivePathPoint;
+		PendingFetchPathPoint.Reset();
+		onFetched.ExecuteIfBound( bSamePathPoint && FetchPathActionPoints() );
+	}
+
+	// conditions are evaluated here instead of in their change events, so evaluation stays within budget
+	// cooldown of action point is based on world time and doesn't broadcast when it ends
+	// so it has to be polled to let behavior tree know that point can be run again
+	if( IsValid( ActiveActionPoint ) )
+	{
+		const bool bCanRunActionPoint = ActiveActionPoint->CanRun();
+		if( bCanRunActionPoint != bLastCanRunActionPoint )
+		{
+			UpdateCanRunActionPointBBKey( bCanRunActionPoint );
+		}
+	}
+
+	if( IsValid( ActivePathPoint ) )
+	{
+		const bool bCanRunPathPoint = ActivePathPoint->CanRun();
+		if( bCanRunPathPoint != bLastCanRunPathPoint )
+		{
+			UpdateCanRunPathPointBBKey( bCanRunPathPoint );
+		}
+	}
+
+	if( bHasBlueprintDecisionUpdate )
+	{
+		ReceiveUpdateDecisions( DeltaTime );
+	}
+
+	bIsUpdatingDecisions = false;
+}
+
+void UDASComponent::SetRegisteredToUpdateManager( bool bRegister )
+{
+	if( UWorld* world = GetWorld() )
+	{
+		if( UDASUpdateManager* updateManager = world->GetSubsystem<UDASUpdateManager>() )
+		{
+			if( bRegister )
 			{
-				if( AActor* owner = GetOwner() )
-				{
-					owner->SetActorLocationAndRotation( Snapshot.OwnerLocation, Snapshot.OwnerRotation );
-				}
+				bHasBlueprintDecisionUpdate = GetClass()->IsFunctionImplementedInScript( GET_FUNCTION_NAME_CHECKED( UDASComponent, ReceiveUpdateDecisions ) );
+				updateManager->RegisterComponent( this );
 			}
-
-			// restart logic if is already running ( behavior tree )
-			if( GetOwnerAIController() )
+			else
 			{
-				if( UBrainComponent* brain = GetOwnerAIController()->BrainComponent )
-				{
-					brain->RestartLogic();
-				}
+				updateManager->UnregisterComponent( this );
 			}
 		}
 	}
+
+	// fetch waiting for update which won't come
+	if( !bRegister )
+	{
+		PendingPathActionPointsFetch.Unbind();
+		PendingFetchPathPoint.Reset();
+	}
+}
+
+bool UDASComponent::RequestDecisionUpdate()
+{
+	UWorld* world = GetWorld();
+	UDASUpdateManager* updateManager = world ? world->GetSubsystem<UDASUpdateManager>() : nullptr;
+	return updateManager && updateManager->RequestDecisionUpdate( this );
+}
+
+void UDASComponent::OnPathPointConditionChanged( bool bIsConditionFulfilled )
+{
+	if( bIsUpdatingDecisions || RequestDecisionUpdate() )
+		return;
+
+	UpdateCanRunPathPointBBKey( bIsConditionFulfilled );
+}
+
+void UDASComponent::OnActionPointConditionChanged( bool bIsConditionFulfilled )
+{
+	if( bIsUpdatingDecisions || RequestDecisionUpdate() )
+		return;
+
+	UpdateCanRunActionPointBBKey( bIsConditionFulfilled );
 }
 
 
@@ -494,7 +652,7 @@ void UDASComponent::SetPathPoint( ADASPathPoint* NewPathPoint )
 			// stop observing condition of previous point
 			if( previousPathPoint->ConditionQuery.IsValid() )
 			{
-				previousPathPoint->ConditionQuery.Instance->OnConditionResultChanged.RemoveDynamic( this, &UDASComponent::UpdateCanRunPathPointBBKey );
+				previousPathPoint->ConditionQuery.Instance->OnConditionResultChanged.RemoveDynamic( this, &UDASComponent::OnPathPointConditionChanged );
 			}
 		}
 
@@ -504,8 +662,17 @@ void UDASComponent::SetPathPoint( ADASPathPoint* NewPathPoint )
 			// start observing condition of new point
 			if( NewPathPoint->ConditionQuery.IsValid() )
 			{
-				NewPathPoint->ConditionQuery.Instance->OnConditionResultChanged.AddUniqueDynamic( this, &UDASComponent::UpdateCanRunPathPointBBKey );
-				UpdateCanRunPathPointBBKey( NewPathPoint->ConditionQuery.Instance->IsConditionFulfilled() );
+				NewPathPoint->ConditionQuery.Instance->OnConditionResultChanged.AddUniqueDynamic( this, &UDASComponent::OnPathPointConditionChanged );
+
+				// condition is evaluated in next decision update, until then point is treated as not runnable
+				if( RequestDecisionUpdate() )
+				{
+					UpdateCanRunPathPointBBKey( false );
+				}
+				else
+				{
+					UpdateCanRunPathPointBBKey( NewPathPoint->ConditionQuery.Instance->IsConditionFulfilled() );
+				}
 			}
 			// if new point doesn't have any condition then set can run bb key to true
 			else
@@ -562,7 +729,7 @@ bool UDASComponent::UpdatePathPoint()
 	return false;
 }
 
-bool UDASComponent::FetchPathActionPoints()
+UDASActionSelector* UDASComponent::GetPathActionSelectorToExecute() const
 {
 	// is path point and path action valid?
 	if( IsValid( ActivePathPoint ) && ActivePathPoint->ActionSelector )
@@ -571,19 +738,69 @@ bool UDASComponent::FetchPathActionPoints()
 			ActivePathPoint->PathActionExecutionMethod == EDASPathExecuteMethod::Forward && bIsMovingForwardAlongPath ||	// only forward actions allowed
 			ActivePathPoint->PathActionExecutionMethod == EDASPathExecuteMethod::Backward && !bIsMovingForwardAlongPath )	// only backward actions allowed
 		{
-			TArray<ADASActionPoint*> actionPoints;
-			ActivePathPoint->ActionSelector->GetActionPointsToExecute( actionPoints, this );
-
-			SetActionPointsQueue( actionPoints );
-			return actionPoints.Num() > 0;
+			return ActivePathPoint->ActionSelector;
 		}
 	}
+	return nullptr;
+}
+
+bool UDASComponent::FetchPathActionPoints()
+{
+	if( UDASActionSelector* actionSelector = GetPathActionSelectorToExecute() )
+	{
+		TArray<ADASActionPoint*> actionPoints;
+		actionSelector->GetActionPointsToExecute( actionPoints, this );
+
+		SetActionPointsQueue( actionPoints );
+		return actionPoints.Num() > 0;
+	}
 
 	// if function got there, it means that getting action points from current path point failed
 	ClearActionPointsQueue();
 	return false;
 }
 
+void UDASComponent::RequestPathActionPoints( FOnPathActionPointsFetched OnFetched )
+{
+	UDASActionSelector* actionSelector = GetPathActionSelectorToExecute();
+	UDASUpdateManager* updateManager = GetWorld() ? GetWorld()->GetSubsystem<UDASUpdateManager>() : nullptr;
+
+	FDASActionPointScoringParams params;
+	if( !actionSelector || !updateManager || !actionSelector->GetScoringParams( this, params ) )
+	{
+		// selector picks points on its own, it runs in next decision update within frame budget
+		if( RequestDecisionUpdate() )
+		{
+			// previous request is answered as failed, it was superseded by this one
+			FOnPathActionPointsFetched previousFetch = MoveTemp( PendingPathActionPointsFetch );
+			PendingPathActionPointsFetch = MoveTemp( OnFetched );
+			PendingFetchPathPoint = ActivePathPoint;
+			previousFetch.ExecuteIfBound( false );
+		}
+		// not registered in update manager, so result is known right away
+		else
+		{
+			OnFetched.ExecuteIfBound( FetchPathActionPoints() );
+		}
+		return;
+	}
+
+	TWeakObjectPtr<ADASPathPoint> requestingPathPoint = ActivePathPoint;
+	updateManager->RequestActionPointSelection( params, this, FOnActionPointsSelected::CreateWeakLambda( this,
+		[this, requestingPathPoint, OnFetched]( const TArray<ADASActionPoint*>& ActionPoints )
+		{
+			// AI could get other path point while request waited for its batch, result doesn't belong to it then
+			if( requestingPathPoint.Get() != ActivePathPoint )
+			{
+				OnFetched.ExecuteIfBound( false );
+				return;
+			}
+
+			SetActionPointsQueue( ActionPoints );
+			OnFetched.ExecuteIfBound( ActionPoints.Num() > 0 );
+		} ) );
+}
+
 
 
 void UDASComponent::SetActionPoint( ADASActionPoint* NewActionPoint )
@@ -605,7 +822,7 @@ void UDASComponent::SetActionPoint( ADASActionPoint* NewActionPoint )
 			// stop observing condition of previous point
 			if( previousActionPoint->ConditionQuery.IsValid() )
 			{
-				previousActionPoint->ConditionQuery.Instance->OnConditionResultChanged.RemoveDynamic( this, &UDASComponent::UpdateCanRunActionPointBBKey );
+				previousActionPoint->ConditionQuery.Instance->OnConditionResultChanged.RemoveDynamic( this, &UDASComponent::OnActionPointConditionChanged );
 			}
 
 		}
@@ -620,8 +837,17 @@ void UDASComponent::SetActionPoint( ADASActionPoint* NewActionPoint )
 			// start observing condition of new point
 			if( NewActionPoint->ConditionQuery.IsValid() )
 			{
-				NewActionPoint->ConditionQuery.Instance->OnConditionResultChanged.AddUniqueDynamic( this, &UDASComponent::UpdateCanRunActionPointBBKey );
-				UpdateCanRunActionPointBBKey( NewActionPoint->ConditionQuery.Instance->IsConditionFulfilled() );
+				NewActionPoint->ConditionQuery.Instance->OnConditionResultChanged.AddUniqueDynamic( this, &UDASComponent::OnActionPointConditionChanged );
+
+				// condition is evaluated in next decision update, until then point is treated as not runnable
+				if( RequestDecisionUpdate() )
+				{
+					UpdateCanRunActionPointBBKey( false );
+				}
+				else
+				{
+					UpdateCanRunActionPointBBKey( NewActionPoint->ConditionQuery.Instance->IsConditionFulfilled() );
+				}
 			}
 			// if new point doesn't have any condition then set can run bb key to true
 			else
@@ -783,6 +1009,8 @@ void UDASComponent::UpdateActionSelectorBBKey()
 
 void UDASComponent::UpdateCanRunActionPointBBKey( bool bCanRunActionPoint )
 {
+	bLastCanRunActionPoint = bCanRunActionPoint;
+
 	if( OwnerAIController )
 	{
 		if( UBlackboardComponent* bb = OwnerAIController->GetBlackboardComponent() )
@@ -794,6 +1022,8 @@ void UDASComponent::UpdateCanRunActionPointBBKey( bool bCanRunActionPoint )
 
 void UDASComponent::UpdateCanRunPathPointBBKey( bool bCanRunPathPoint )
 {
+	bLastCanRunPathPoint = bCanRunPathPoint;
+
 	if( OwnerAIController )
 	{
 		if( UBlackboardComponent* bb = OwnerAIController->GetBlackboardComponent() )
@@ -928,6 +1158,41 @@ UDASVisComponent::UDASVisComponent()
 	PrimaryComponentTick.TickInterval = UDASDeveloperSettings::Get()->DebugTickInterval;
 }
 
+void UDASVisComponent::OnRegister()
+{
+	Super::OnRegister();
+
+#if WITH_EDITORONLY_DATA
+	// editor debug depends on selection only, so tick is switched on selection change instead of checking it every tick
+	// runtime debug is animated & toggled by DAS.Debug, so in game worlds this component keeps ticking
+	UWorld* world = GetWorld();
+	if( world && !world->IsGameWorld() )
+	{
+		SelectionChangedHandle = USelection::SelectionChangedEvent.AddUObject( this, &UDASVisComponent::UpdateEditorTick );
+		SelectObjectHandle = USelection::SelectObjectEvent.AddUObject( this, &UDASVisComponent::UpdateEditorTick );
+		UpdateEditorTick();
+	}
+#endif
+}
+
+void UDASVisComponent::OnUnregister()
+{
+#if WITH_EDITORONLY_DATA
+	USelection::SelectionChangedEvent.Remove( SelectionChangedHandle );
+	USelection::SelectObjectEvent.Remove( SelectObjectHandle );
+	SelectionChangedHandle.Reset();
+	SelectObjectHandle.Reset();
+#endif
+
+	Super::OnUnregister();
+}
+
+void UDASVisComponent::UpdateEditorTick( UObject* ChangedSelection )
+{
+	const AActor* owner = GetOwner();
+	SetComponentTickEnabled( owner && owner->IsSelected() );
+}
+
 void UDASVisComponent::TickComponent( float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction )
 {
 	Super::TickComponent( DeltaTime, TickType, ThisTickFunction );
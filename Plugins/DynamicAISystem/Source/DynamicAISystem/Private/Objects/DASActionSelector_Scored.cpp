@@ -0,0 +1,41 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+
+#include "Objects/DASActionSelector_Scored.h"
+#include "Components/DASComponent.h"
+#include "Points/DASPathPoint.h"
+#include "Utils/DASActionPointScoring.h"
+
+
+
+void UDASActionSelector_Scored::GetActionPointsToExecute_Implementation( TArray< ADASActionPoint* >& OutActionPoints, UDASComponent* DASComponent )
+{
+	OutActionPoints.Reset();
+
+	// direct calls can't wait for batch, so this one request is scored right away
+	FDASActionPointScoringParams params;
+	if( GetScoringParams( DASComponent, params ) )
+	{
+		FDASActionPointScoring::SelectActionPoints( GetWorld(), params, OutActionPoints, DASComponent );
+	}
+}
+
+bool UDASActionSelector_Scored::GetScoringParams( UDASComponent* DASComponent, FDASActionPointScoringParams& OutParams ) const
+{
+	const AActor* source = nullptr;
+	if( bScoreFromPathPoint )
+	{
+		source = Cast<ADASPathPoint>( GetOuter() );
+	}
+	if( !source && DASComponent )
+	{
+		source = DASComponent->GetOwner();
+	}
+
+	if( !source )
+		return false;
+
+	OutParams = ScoringParams;
+	OutParams.SourceLocation = source->GetActorLocation();
+	return true;
+}
@@ -5,6 +5,8 @@
 #include "Components/DASComponent.h"
 #include "Utils/DASWorldSubsystem.h"
 #include "Utils/DASBPLibrary.h"
+#include "Utils/DASPointsReplicator.h"
+#include "Utils/DASDebugRenderer.h"
 #include "Net/UnrealNetwork.h"
 #include "Net/Core/PushModel/PushModel.h"
 
@@ -53,11 +55,26 @@ void ADASActionPoint::PostInitializeComponents()
 			if( UDASWorldSubsystem* DASSubsystem = world->GetSubsystem<UDASWorldSubsystem>() )
 			{
 				DASSubsystem->AddActionPoint( this );
+
+				// static points never leave cell they were registered in
+				USceneComponent* root = GetRootComponent();
+				if( root && root->Mobility == EComponentMobility::Movable )
+				{
+					root->TransformUpdated.AddUObject( this, &ADASActionPoint::OnRootTransformUpdated );
+				}
 			}
 		}
 	}
 }
 
+void ADASActionPoint::OnRootTransformUpdated( USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport )
+{
+	if( UDASWorldSubsystem* DASSubsystem = GetWorld()->GetSubsystem<UDASWorldSubsystem>() )
+	{
+		DASSubsystem->UpdateActionPointLocation( this );
+	}
+}
+
 
 void ADASActionPoint::RefreshInstancedObjects()
 {
@@ -85,6 +102,11 @@ void ADASActionPoint::EndPlay( const EEndPlayReason::Type EndPlayReason )
 				DASSubsystem->RemoveActionPoint( this );
 			}
 		}
+
+		if( USceneComponent* root = GetRootComponent() )
+		{
+			root->TransformUpdated.RemoveAll( this );
+		}
 	}
 
 	Super::EndPlay( EndPlayReason );
@@ -169,7 +191,7 @@ void ADASActionPoint::SetIsExecuting( bool bNewExecuting )
 	{
 		bIsExecuting = bNewExecuting;
 		MARK_PROPERTY_DIRTY_FROM_NAME( ADASActionPoint, bIsExecuting, this );
-		ForceNetUpdate();
+		NotifyStateChanged();
 	}
 }
 
@@ -238,7 +260,7 @@ void ADASActionPoint::SetIsTaken( bool bNewIsTaken )
 		bIsTaken = bNewIsTaken;
 		MARK_PROPERTY_DIRTY_FROM_NAME( ADASActionPoint, bIsTaken, this );
 		OnRep_IsTaken();
-		ForceNetUpdate();
+		NotifyStateChanged();
 	}
 }
 
@@ -249,15 +271,37 @@ void ADASActionPoint::OnRep_IsTaken()
 }
 
 
-void ADASActionPoint::DrawDebug( float DeltaTime, bool bIsInEditor )
+void ADASActionPoint::ApplyReplicatedState( bool bNewIsTaken, bool bNewIsExecuting )
 {
-	Super::DrawDebug( DeltaTime, bIsInEditor );
+	if( bIsTaken != bNewIsTaken )
+	{
+		bIsTaken = bNewIsTaken;
+		OnRep_IsTaken();
+	}
 
-#if WITH_EDITORONLY_DATA
+	if( bIsExecuting != bNewIsExecuting )
+	{
+		bIsExecuting = bNewIsExecuting;
+		OnRep_IsExecuting();
+	}
+}
 
-	if( UWorld* world = GetWorld() )
+void ADASActionPoint::NotifyStateChanged()
+{
+	if( StateReplicator )
 	{
-		DrawDebugPoint( world, FVector( 0.f, 0.f, 20.f ) + GetActorLocation(), GetActorRotation(), DeltaTime );
+		StateReplicator->MarkPointDirty( this );
 	}
-#endif
+	else
+	{
+		ForceNetUpdate();
+	}
+}
+
+
+void ADASActionPoint::GatherDebugPrimitives( FDASDebugPrimitives& Primitives, float AnimationTime ) const
+{
+	Super::GatherDebugPrimitives( Primitives, AnimationTime );
+
+	AddDebugPoint( Primitives, FVector( 0.f, 0.f, 20.f ) + GetActorLocation(), GetActorRotation() );
 }
\ No newline at end of file
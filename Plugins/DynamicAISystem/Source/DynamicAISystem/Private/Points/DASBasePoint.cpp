@@ -4,10 +4,7 @@
 #include "Kismet/KismetMathLibrary.h"
 #include "Utils/DASDeveloperSettings.h"
 #include "Components/BillboardComponent.h"
-
-#if WITH_EDITORONLY_DATA
-#include "DrawDebugHelpers.h"
-#endif
+#include "Utils/DASDebugRenderer.h"
 
 
 ADASBasePoint::ADASBasePoint()
@@ -85,6 +82,31 @@ void ADASBasePoint::PostActorCreated()
 }
 
 
+#if WITH_EDITOR
+void ADASBasePoint::PostEditMove( bool bFinished )
+{
+	Super::PostEditMove( bFinished );
+
+	// rebuild debug while point is being dragged, not only after it was dropped
+	MarkDebugDirty();
+}
+
+void ADASBasePoint::PostEditChangeProperty( struct FPropertyChangedEvent& PropertyChangedEvent )
+{
+	Super::PostEditChangeProperty( PropertyChangedEvent );
+
+	MarkDebugDirty();
+}
+
+void ADASBasePoint::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	MarkDebugDirty();
+}
+#endif
+
+
 bool ADASBasePoint::CanRun_Implementation()
 {
 	// default implementation of checking if point can be used by AI
@@ -106,6 +128,40 @@ void ADASBasePoint::DrawDebug( float DeltaTime, bool bIsInEditor )
 
 		// call blueprint version of draw debug to allow implement debug logic in blueprints
 		K2_DrawDebug( DeltaTime, !world->IsGameWorld() );
+
+		// lines of point are drawn here only if they aren't already batched by debug render subsystem
+		UDASDebugRenderSubsystem* debugRenderer = world->GetSubsystem<UDASDebugRenderSubsystem>();
+		if( !debugRenderer || !debugRenderer->IsPointRegistered( this ) )
+		{
+			const bool bAnimateArrows = UDASDeveloperSettings::Get()->bAnimatePathArrows && !bIsInEditor;
+
+			FDASDebugPrimitives primitives;
+			GatherDebugPrimitives( primitives, bAnimateArrows ? world->GetTimeSeconds() : -1.f );
+			primitives.Draw( world, DeltaTime );
+		}
+	}
+#endif
+}
+
+void ADASBasePoint::GatherDebugPrimitives( FDASDebugPrimitives& Primitives, float AnimationTime ) const
+{
+	// base point has nothing to show, derived points add their shapes
+}
+
+bool ADASBasePoint::HasCustomDebug() const
+{
+	return ConditionQuery.IsValid() || GetClass()->IsFunctionImplementedInScript( GET_FUNCTION_NAME_CHECKED( ADASBasePoint, K2_DrawDebug ) );
+}
+
+void ADASBasePoint::MarkDebugDirty()
+{
+#if WITH_EDITORONLY_DATA
+	if( UWorld* world = GetWorld() )
+	{
+		if( UDASDebugRenderSubsystem* debugRenderer = world->GetSubsystem<UDASDebugRenderSubsystem>() )
+		{
+			debugRenderer->MarkPointDirty( this );
+		}
 	}
 #endif
 }
@@ -134,11 +190,56 @@ UDASPointVisComponent::UDASPointVisComponent()
 	PrimaryComponentTick.TickInterval = UDASDeveloperSettings::Get()->DebugTickInterval;
 }
 
+void UDASPointVisComponent::OnRegister()
+{
+	Super::OnRegister();
+
+#if WITH_EDITORONLY_DATA
+	// in editor lines of point are drawn by debug render subsystem, this component ticks only if point has custom debug
+	ADASBasePoint* point = Cast<ADASBasePoint>( GetOwner() );
+	if( point && !point->IsTemplate( RF_ClassDefaultObject | RF_ArchetypeObject ) )
+	{
+		if( UDASDebugRenderSubsystem* debugRenderer = GetWorld()->GetSubsystem<UDASDebugRenderSubsystem>() )
+		{
+			debugRenderer->RegisterPoint( point );
+		}
+	}
+#endif
+}
+
+void UDASPointVisComponent::OnUnregister()
+{
+#if WITH_EDITORONLY_DATA
+	if( ADASBasePoint* point = Cast<ADASBasePoint>( GetOwner() ) )
+	{
+		if( UDASDebugRenderSubsystem* debugRenderer = GetWorld()->GetSubsystem<UDASDebugRenderSubsystem>() )
+		{
+			debugRenderer->UnregisterPoint( point );
+		}
+	}
+#endif
+
+	Super::OnUnregister();
+}
+
 void UDASPointVisComponent::TickComponent( float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction )
 {
 	Super::TickComponent( DeltaTime, TickType, ThisTickFunction );
 
 #if WITH_EDITORONLY_DATA
+	// lines of point are already drawn by debug render subsystem, stop ticking if there is nothing else to draw
+	// tick is enabled again by subsystem when point gets custom debug
+	if( TickType == ELevelTick::LEVELTICK_ViewportsOnly )
+	{
+		ADASBasePoint* point = Cast<ADASBasePoint>( GetOwner() );
+		UDASDebugRenderSubsystem* debugRenderer = GetWorld()->GetSubsystem<UDASDebugRenderSubsystem>();
+		if( point && debugRenderer && debugRenderer->IsPointRegistered( point ) && !point->HasCustomDebug() )
+		{
+			SetComponentTickEnabled( false );
+			return;
+		}
+	}
+
 	// always draw debug in editor, in runtime only if console variable DAS_Debug is set to true
 	if( TickType == ELevelTick::LEVELTICK_ViewportsOnly || DAS_Debug.GetValueOnGameThread() )
 	{
@@ -196,19 +297,17 @@ void ADASBasePoint::RefreshInstancedObjects()
 	}
 }
 
-void ADASBasePoint::DrawDebugPoint( UWorld* world, const FVector& SpotLocation, const FRotator& SpotRotation, float DeltaTime )
+void ADASBasePoint::AddDebugPoint( FDASDebugPrimitives& Primitives, const FVector& SpotLocation, const FRotator& SpotRotation ) const
 {
 	// helper function which shows point, either an arrow ( if point uses rotation ) or a sphere if it doesn't
-#if WITH_EDITORONLY_DATA
 	if( bRotateToPoint )
 	{
-		DrawDebugDirectionalArrow( world, SpotLocation, SpotLocation + ( SpotRotation.Vector() * 50 ), 100.f, FColor::Blue, false, DeltaTime, 0, 2.f );
+		Primitives.AddArrow( SpotLocation, SpotLocation + ( SpotRotation.Vector() * 50 ), 100.f, FColor::Blue, 2.f );
 	}
 	else
 	{
-		DrawDebugSphere( world, SpotLocation, 10.f, 6, UDASDeveloperSettings::Get()->PathPointsDebugColor, false, DeltaTime, 0, 1.f );
+		Primitives.AddSphere( SpotLocation, 10.f, 6, UDASDeveloperSettings::Get()->PathPointsDebugColor, 1.f );
 	}
-#endif
 }
 
 
@@ -7,9 +7,9 @@
 #include "Objects/DASActionSelector.h"
 #include "Utils/DASWorldSubsystem.h"
 #include "Objects/DASPathSolver.h"
+#include "Utils/DASDebugRenderer.h"
 
 #if WITH_EDITORONLY_DATA
-#include "DrawDebugHelpers.h"
 #include "Kismet/GameplayStatics.h"
 #endif
 
@@ -300,6 +300,7 @@ void ADASPathPoint::GenerateSpots()
 	}
 
 	UKismetSystemLibrary::EndTransaction();
+	MarkDebugDirty();
 #endif
 }
 
@@ -317,6 +318,7 @@ void ADASPathPoint::ClearSpots()
 	Spots.Empty();
 
 	UKismetSystemLibrary::EndTransaction();
+	MarkDebugDirty();
 #endif
 }
 
@@ -396,6 +398,7 @@ void ADASPathPoint::PostDuplicate( EDuplicateMode::Type DuplicateMode )
 						{
 							actorAsPathPoint->NextPathPoints.Add( this );
 							PreviousPathPoints.Add( actorAsPathPoint );
+							actorAsPathPoint->MarkDebugDirty();
 						}
 
 						break;
@@ -453,97 +456,95 @@ void ADASPathPoint::DrawDebug( float DeltaTime, bool bIsInEditor )
 
 	if( UWorld* world = GetWorld() )
 	{
-		const FVector ownerLocation = GetActorLocation();
-
 		// call debug function on Action Selector
 		if( ActionSelector && PathActionExecutionMethod != EDASPathExecuteMethod::None )
 		{
 			ActionSelector->DrawDebug( DeltaTime, this, !world->IsGameWorld() );
 		}
+	}
+#endif
+}
 
-		// Draw Spots
-		if( Spots.Num() > 0 )
-		{
-			for( const FDASSpot& spot : Spots )
-			{
-				// get spot location in world space
-				FVector worldSpaceLoc = FVector( 0.f, 0.f, 20.f ) + GetTransform().TransformPosition( spot.Transform.GetLocation() );
+bool ADASPathPoint::HasCustomDebug() const
+{
+	return Super::HasCustomDebug() || ( ActionSelector && PathActionExecutionMethod != EDASPathExecuteMethod::None );
+}
 
-				// draw line from actor to spot
-				DrawDebugLine( world, FVector( 0.f, 0.f, 20.f ) + ownerLocation, worldSpaceLoc, FColor::Cyan, false, DeltaTime, 0, 2.f );
+void ADASPathPoint::GatherDebugPrimitives( FDASDebugPrimitives& Primitives, float AnimationTime ) const
+{
+	Super::GatherDebugPrimitives( Primitives, AnimationTime );
 
-				// draw spot
-				DrawDebugPoint( world, worldSpaceLoc, spot.Transform.GetRotation().Rotator(), DeltaTime );
-			}
-		}
-		else
+	const FVector ownerLocation = GetActorLocation();
+	const FVector debugOffset( 0.f, 0.f, 20.f );
+
+	// Draw Spots
+	if( Spots.Num() > 0 )
+	{
+		for( const FDASSpot& spot : Spots )
 		{
-			// draw spot on owner location
-			DrawDebugPoint( world, FVector( 0.f, 0.f, 20.f ) + ownerLocation, GetActorRotation(), DeltaTime );
+			// get spot location in world space
+			FVector worldSpaceLoc = debugOffset + GetTransform().TransformPosition( spot.Transform.GetLocation() );
+
+			// draw line from actor to spot
+			Primitives.AddLine( debugOffset + ownerLocation, worldSpaceLoc, FColor::Cyan, 2.f );
+
+			// draw spot
+			AddDebugPoint( Primitives, worldSpaceLoc, spot.Transform.GetRotation().Rotator() );
 		}
+	}
+	else
+	{
+		// draw spot on owner location
+		AddDebugPoint( Primitives, debugOffset + ownerLocation, GetActorRotation() );
+	}
 
-		float pathOffsetDistance = 10.f;
-		const bool bAnimateArrows = UDASDeveloperSettings::Get()->bAnimatePathArrows && !bIsInEditor;
-		float currentTime = world->GetTimeSeconds();
-		float arrowSpeed = UDASDeveloperSettings::Get()->AnimatedArrowsSpeed;
-		float arrowAlpha = 0.5f;
+	const float pathOffsetDistance = 10.f;
+	const float arrowSpeed = UDASDeveloperSettings::Get()->AnimatedArrowsSpeed;
+
+	auto addPathLink = [&]( const ADASPathPoint* PathPoint, const FColor& Color )
+	{
+		FVector dirToPath = UKismetMathLibrary::GetDirectionUnitVector( ownerLocation, PathPoint->GetActorLocation() );
+		FVector rightVec = UKismetMathLibrary::Cross_VectorVector( dirToPath, FVector::UpVector );
+		FVector startLoc = debugOffset + ownerLocation + rightVec * pathOffsetDistance + dirToPath * pathOffsetDistance * 2.f;
+		FVector endLoc = debugOffset + PathPoint->GetActorLocation() + rightVec * pathOffsetDistance - dirToPath * pathOffsetDistance * 2.f;
 
-		// Draw Forward Path
-		if( bCanMoveForward )
+		// arrow moves along the link, or stays in the middle of it
+		float arrowAlpha = 0.5f;
+		if( AnimationTime >= 0.f )
 		{
-			for( ADASPathPoint* pathPoint : NextPathPoints )
-			{
-				if( pathPoint )
-				{
-					FVector dirToPath = UKismetMathLibrary::GetDirectionUnitVector( GetActorLocation(), pathPoint->GetActorLocation() );
-					FVector rightVec = UKismetMathLibrary::Cross_VectorVector( dirToPath, FVector::UpVector );
-					FVector startLoc = FVector( 0.f, 0.f, 20.f ) + GetActorLocation() + rightVec * pathOffsetDistance + dirToPath * pathOffsetDistance * 2.f;
-					FVector endLoc = FVector( 0.f, 0.f, 20.f ) + pathPoint->GetActorLocation() + rightVec * pathOffsetDistance - dirToPath * pathOffsetDistance * 2.f;
+			float distance = ( startLoc - endLoc ).Size();
+			float requiredTime = distance / arrowSpeed;
+			arrowAlpha = ( FMath::Fmod( AnimationTime, requiredTime ) * arrowSpeed ) / distance;
+		}
 
-					if( bAnimateArrows )
-					{
-						float distSquared = ( startLoc - endLoc ).Size();
-						float requiredTime = distSquared / arrowSpeed;
-						arrowAlpha = ( FMath::Fmod( currentTime, requiredTime ) * arrowSpeed ) / distSquared;
-					}
+		FVector arrowLoc = UKismetMathLibrary::VLerp( startLoc, endLoc, arrowAlpha );
 
-					FVector arrowLoc = UKismetMathLibrary::VLerp( startLoc, endLoc, arrowAlpha );
+		Primitives.AddLine( startLoc, endLoc, Color, 2.f );
+		Primitives.AddArrow( startLoc, arrowLoc, 250.f, Color, 2.f );
+	};
 
-					DrawDebugLine( world, startLoc, endLoc, FColor::Green, false, DeltaTime, 0, 2.f );
-					DrawDebugDirectionalArrow( world, startLoc, arrowLoc, 250.f, FColor::Green, false, DeltaTime, 0, 2.f );
-				}
+	// Draw Forward Path
+	if( bCanMoveForward )
+	{
+		for( const ADASPathPoint* pathPoint : NextPathPoints )
+		{
+			if( pathPoint )
+			{
+				addPathLink( pathPoint, FColor::Green );
 			}
 		}
+	}
 
-		// Draw Backward Path
-		if( bCanMoveBackward )
+	// Draw Backward Path
+	if( bCanMoveBackward )
+	{
+		for( const ADASPathPoint* pathPoint : PreviousPathPoints )
 		{
-			for( ADASPathPoint* pathPoint : PreviousPathPoints )
+			if( pathPoint )
 			{
-				if( pathPoint )
-				{
-					FVector dirToPath = UKismetMathLibrary::GetDirectionUnitVector( GetActorLocation(), pathPoint->GetActorLocation() );
-					FVector rightVec = UKismetMathLibrary::Cross_VectorVector( dirToPath, FVector::UpVector );
-					FVector startLoc = FVector( 0.f, 0.f, 20.f ) + GetActorLocation() + ( rightVec * pathOffsetDistance ) + dirToPath * pathOffsetDistance * 2.f;;
-					FVector endLoc = FVector( 0.f, 0.f, 20.f ) + pathPoint->GetActorLocation() + ( rightVec * pathOffsetDistance ) - dirToPath * pathOffsetDistance * 2.f;
-
-					if( bAnimateArrows )
-					{
-						float distSquared = ( startLoc - endLoc ).Size();
-						float requiredTime = distSquared / arrowSpeed;
-						arrowAlpha = ( FMath::Fmod( currentTime, requiredTime ) * arrowSpeed ) / distSquared;
-					}
-
-					FVector arrowLoc = UKismetMathLibrary::VLerp( startLoc, endLoc, arrowAlpha );
-
-					DrawDebugLine( world, startLoc, endLoc, FColor::Red, false, DeltaTime, 0, 2.f );
-					DrawDebugDirectionalArrow( world, startLoc, arrowLoc, 250.f, FColor::Red, false, DeltaTime, 0, 2.f );
-
-				}
+				addPathLink( pathPoint, FColor::Red );
 			}
 		}
-
 	}
-#endif
 }
 
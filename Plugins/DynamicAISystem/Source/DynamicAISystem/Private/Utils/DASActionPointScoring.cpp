@@ -0,0 +1,216 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+
+#include "Utils/DASActionPointScoring.h"
+#include "Utils/DASWorldSubsystem.h"
+#include "Points/DASActionPoint.h"
+#include "Components/DASComponent.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+
+
+DECLARE_CYCLE_STAT( TEXT( "DAS Action Point Gather" ), STAT_DASActionPointGather, STATGROUP_DAS );
+DECLARE_CYCLE_STAT( TEXT( "DAS Action Point Scoring" ), STAT_DASActionPointScoring, STATGROUP_DAS );
+
+
+namespace DASActionPointScoring
+{
+	/** Score of candidates that can't be selected at all */
+	static constexpr float ExcludedScore = -MAX_FLT;
+
+	/** Distance used to normalize distance penalty, when request doesn't limit radius */
+	static constexpr float DefaultNormalizationDistance = 1000.f;
+}
+
+
+
+void FDASActionPointCandidates::Reset( int32 ExpectedNum )
+{
+	Points.Reset( ExpectedNum );
+	LocationX.Reset( ExpectedNum );
+	LocationY.Reset( ExpectedNum );
+	LocationZ.Reset( ExpectedNum );
+	CooldownRemaining.Reset( ExpectedNum );
+	TagWeight.Reset( ExpectedNum );
+	TakenMask.Reset( ExpectedNum );
+	Scores.Reset( ExpectedNum );
+}
+
+void FDASActionPointCandidates::Add( ADASActionPoint* Point, const FVector& Location, float InCooldownRemaining, float InTagWeight, bool bIsTaken )
+{
+	Points.Add( Point );
+	LocationX.Add( ( float )Location.X );
+	LocationY.Add( ( float )Location.Y );
+	LocationZ.Add( ( float )Location.Z );
+	CooldownRemaining.Add( InCooldownRemaining );
+	TagWeight.Add( InTagWeight );
+	TakenMask.Add( bIsTaken ? 1.f : 0.f );
+}
+
+
+
+void FDASActionPointScoring::ProcessRequests( UWorld* World, TArrayView<FDASActionPointSelectionRequest> Requests )
+{
+	check( IsInGameThread() );
+
+	// gathering touches actors, so it stays on game thread
+	{
+		SCOPE_CYCLE_COUNTER( STAT_DASActionPointGather );
+		for( FDASActionPointSelectionRequest& request : Requests )
+		{
+			GatherCandidates( World, request );
+		}
+	}
+
+	// scoring & selection works only on gathered plain data, so requests are processed in parallel
+	SCOPE_CYCLE_COUNTER( STAT_DASActionPointScoring );
+	ParallelFor( Requests.Num(), [&Requests]( int32 RequestIndex )
+		{
+			FDASActionPointSelectionRequest& request = Requests[ RequestIndex ];
+
+			ScoreCandidates( request.Params, request.Candidates );
+
+			TArray<int32> selectedIndices;
+			SelectTopK( request.Candidates, request.Params.MaxResults, selectedIndices );
+
+			request.Result.Reset( selectedIndices.Num() );
+			for( int32 candidateIndex : selectedIndices )
+			{
+				request.Result.Add( request.Candidates.Points[ candidateIndex ] );
+			}
+		} );
+}
+
+void FDASActionPointScoring::SelectActionPoints( UWorld* World, const FDASActionPointScoringParams& Params, TArray<ADASActionPoint*>& OutActionPoints, UDASComponent* DASComponent /*= nullptr*/ )
+{
+	FDASActionPointSelectionRequest request;
+	request.Params = Params;
+	request.DASComponent = DASComponent;
+
+	ProcessRequests( World, MakeArrayView( &request, 1 ) );
+
+	OutActionPoints = MoveTemp( request.Result );
+}
+
+void FDASActionPointScoring::GatherCandidates( UWorld* World, FDASActionPointSelectionRequest& Request )
+{
+	const FDASActionPointScoringParams& params = Request.Params;
+	FDASActionPointCandidates& candidates = Request.Candidates;
+
+	UDASWorldSubsystem* DASSubsystem = World ? World->GetSubsystem<UDASWorldSubsystem>() : nullptr;
+	if( !DASSubsystem )
+	{
+		candidates.Reset( 0 );
+		return;
+	}
+
+	// only points from grid cells overlapping radius, not all points in the level
+	TArray<ADASActionPoint*> gatheredPoints;
+	DASSubsystem->GatherActionPointsInRadius( params.SourceLocation, params.Radius, gatheredPoints );
+
+	candidates.Reset( gatheredPoints.Num() );
+
+	const float currentTime = World->GetTimeSeconds();
+	const UDASComponent* requester = Request.DASComponent.Get();
+	const ADASActionPoint* requesterActivePoint = requester ? requester->ActiveActionPoint : nullptr;
+
+	for( ADASActionPoint* point : gatheredPoints )
+	{
+		if( !IsValid( point ) )
+			continue;
+
+		if( params.RequiredTag.IsValid() && !point->PointTag.MatchesTag( params.RequiredTag ) )
+			continue;
+
+		// sum weights of all matching tags
+		float tagWeight = 0.f;
+		for( const FDASTagWeight& weight : params.TagWeights )
+		{
+			if( weight.Tag.IsValid() && point->PointTag.MatchesTag( weight.Tag ) )
+			{
+				tagWeight += weight.Weight;
+			}
+		}
+
+		const float cooldownRemaining = FMath::Max( 0.f, point->GetCooldownEndWorldTime() - currentTime );
+
+		// point taken by requester itself is not treated as taken
+		const bool bIsTaken = point->IsTaken() && point != requesterActivePoint;
+
+		candidates.Add( point, point->GetActorLocation(), cooldownRemaining, tagWeight, bIsTaken );
+	}
+}
+
+void FDASActionPointScoring::ScoreCandidates( const FDASActionPointScoringParams& Params, FDASActionPointCandidates& Candidates )
+{
+	const int32 numCandidates = Candidates.Num();
+	Candidates.Scores.SetNumUninitialized( numCandidates );
+
+	const float sourceX = ( float )Params.SourceLocation.X;
+	const float sourceY = ( float )Params.SourceLocation.Y;
+	const float sourceZ = ( float )Params.SourceLocation.Z;
+
+	const bool bLimitRadius = Params.Radius > 0.f;
+	const float radiusSquared = bLimitRadius ? FMath::Square( Params.Radius ) : MAX_FLT;
+	const float distanceScale = Params.DistanceWeight / ( bLimitRadius ? Params.Radius : DASActionPointScoring::DefaultNormalizationDistance );
+	const float cooldownWeight = Params.CooldownWeight;
+	const float excludeTaken = Params.bExcludeTaken ? 1.f : 0.f;
+	const float excludeOnCooldown = Params.bExcludeOnCooldown ? 1.f : 0.f;
+
+	const float* RESTRICT locationX = Candidates.LocationX.GetData();
+	const float* RESTRICT locationY = Candidates.LocationY.GetData();
+	const float* RESTRICT locationZ = Candidates.LocationZ.GetData();
+	const float* RESTRICT cooldownRemaining = Candidates.CooldownRemaining.GetData();
+	const float* RESTRICT tagWeight = Candidates.TagWeight.GetData();
+	const float* RESTRICT takenMask = Candidates.TakenMask.GetData();
+	float* RESTRICT scores = Candidates.Scores.GetData();
+
+	// single branchless pass, selects instead of branches to let compiler vectorize it
+	for( int32 i = 0; i < numCandidates; i++ )
+	{
+		const float dx = locationX[ i ] - sourceX;
+		const float dy = locationY[ i ] - sourceY;
+		const float dz = locationZ[ i ] - sourceZ;
+		const float distanceSquared = dx * dx + dy * dy + dz * dz;
+
+		const float score = tagWeight[ i ] - FMath::Sqrt( distanceSquared ) * distanceScale - cooldownRemaining[ i ] * cooldownWeight;
+
+		const float excludedByState = takenMask[ i ] * excludeTaken + ( cooldownRemaining[ i ] > 0.f ? excludeOnCooldown : 0.f );
+		const bool bExcluded = excludedByState > 0.f || distanceSquared > radiusSquared;
+
+		scores[ i ] = bExcluded ? DASActionPointScoring::ExcludedScore : score;
+	}
+}
+
+void FDASActionPointScoring::SelectTopK( const FDASActionPointCandidates& Candidates, int32 K, TArray<int32>& OutIndices )
+{
+	OutIndices.Reset();
+
+	if( K <= 0 )
+		return;
+
+	const TArray<float>& scores = Candidates.Scores;
+
+	// min-heap of K best candidates, worst of them on top
+	// costs O( N log K ) instead of sorting all candidates
+	auto worseScore = [&scores]( int32 A, int32 B ) { return scores[ A ] < scores[ B ]; };
+
+	for( int32 i = 0; i < scores.Num(); i++ )
+	{
+		if( scores[ i ] <= DASActionPointScoring::ExcludedScore )
+			continue;
+
+		if( OutIndices.Num() < K )
+		{
+			OutIndices.HeapPush( i, worseScore );
+		}
+		else if( scores[ i ] > scores[ OutIndices.HeapTop() ] )
+		{
+			OutIndices.HeapPopDiscard( worseScore, EAllowShrinking::No );
+			OutIndices.HeapPush( i, worseScore );
+		}
+	}
+
+	// only K elements left to sort, best first
+	OutIndices.Sort( [&scores]( int32 A, int32 B ) { return scores[ A ] > scores[ B ]; } );
+}
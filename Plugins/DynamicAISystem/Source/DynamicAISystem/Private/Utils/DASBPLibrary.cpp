@@ -9,6 +9,8 @@
 #include "Points/DASActionPoint.h"
 #include "Points/DASPathPoint.h"
 #include "TimerManager.h"
+#include "Utils/DASActionPointScoring.h"
+#include "Utils/DASWorldSnapshot.h"
 
 
 const FName UDASBPLibrary::BBKeyName_GoalLocation = FName( "GoalLocation" );
@@ -162,62 +164,90 @@ void UDASBPLibrary::FilterOutTakenActionPoints( TArray<ADASActionPoint*>& Filter
 
 void UDASBPLibrary::SortActionPointsByDistance( const TArray<ADASActionPoint*>& ArrayToSort, TArray<ADASActionPoint*>& SortedArray, FVector SourceLocation, bool bInverse )
 {
-	SortedArray = ArrayToSort;
+	// calculate distance of every valid point only once, instead of twice per comparison
+	TArray<TPair<float, ADASActionPoint*>> pointsWithDistance;
+	pointsWithDistance.Reserve( ArrayToSort.Num() );
 
-	// remove any invalid elements before sorting
-	for( int32 i = SortedArray.Num() - 1; i >= 0; i-- )
+	for( ADASActionPoint* point : ArrayToSort )
 	{
-		if( !IsValid( SortedArray[ i ] ) )
-			SortedArray.RemoveAt( i, 1, false );
+		if( IsValid( point ) )
+		{
+			pointsWithDistance.Emplace( ( float )FVector::DistSquared( point->GetActorLocation(), SourceLocation ), point );
+		}
 	}
-	SortedArray.Shrink();
-
 
-	SortedArray.Sort( [&SourceLocation, &bInverse]( const ADASActionPoint& LHS, const ADASActionPoint& RHS ){
-
-		const float distA = FVector::DistSquared( LHS.GetActorLocation(), SourceLocation );
-		const float distB = FVector::DistSquared( RHS.GetActorLocation(), SourceLocation );
+	pointsWithDistance.Sort( [bInverse]( const TPair<float, ADASActionPoint*>& LHS, const TPair<float, ADASActionPoint*>& RHS ){
 
 		if( bInverse )
 		{
-			return distB < distA;
+			return RHS.Key < LHS.Key;
 		}
 		else
 		{
-			return distB > distA;
+			return RHS.Key > LHS.Key;
 		}
 
 		} );
+
+	SortedArray.Reset( pointsWithDistance.Num() );
+	for( const TPair<float, ADASActionPoint*>& pointWithDistance : pointsWithDistance )
+	{
+		SortedArray.Add( pointWithDistance.Value );
+	}
 }
 
 void UDASBPLibrary::SortPathPointsByDistance( const TArray<ADASPathPoint*>& ArrayToSort, TArray<ADASPathPoint*>& SortedArray, FVector SourceLocation, bool bInverse )
 {
-	SortedArray = ArrayToSort;
+	// calculate distance of every valid point only once, instead of twice per comparison
+	TArray<TPair<float, ADASPathPoint*>> pointsWithDistance;
+	pointsWithDistance.Reserve( ArrayToSort.Num() );
 
-	// remove any invalid elements before sorting
-	for( int32 i = SortedArray.Num() - 1; i >= 0; i-- )
+	for( ADASPathPoint* point : ArrayToSort )
 	{
-		if( !IsValid( SortedArray[ i ] ) )
-			SortedArray.RemoveAt( i, 1, false );
+		if( IsValid( point ) )
+		{
+			pointsWithDistance.Emplace( ( float )FVector::DistSquared( point->GetActorLocation(), SourceLocation ), point );
+		}
 	}
-	SortedArray.Shrink();
 
-
-	SortedArray.Sort( [&SourceLocation, &bInverse]( const ADASPathPoint& LHS, const ADASPathPoint& RHS ){
-
-		const float distA = FVector::DistSquared( LHS.GetActorLocation(), SourceLocation );
-		const float distB = FVector::DistSquared( RHS.GetActorLocation(), SourceLocation );
+	pointsWithDistance.Sort( [bInverse]( const TPair<float, ADASPathPoint*>& LHS, const TPair<float, ADASPathPoint*>& RHS ){
 
 		if( bInverse )
 		{
-			return distB < distA;
+			return RHS.Key < LHS.Key;
 		}
 		else
 		{
-			return distB > distA;
+			return RHS.Key > LHS.Key;
 		}
 
 		} );
+
+	SortedArray.Reset( pointsWithDistance.Num() );
+	for( const TPair<float, ADASPathPoint*>& pointWithDistance : pointsWithDistance )
+	{
+		SortedArray.Add( pointWithDistance.Value );
+	}
+}
+
+void UDASBPLibrary::SelectBestActionPoints( UObject* WorldContextObject, const FDASActionPointScoringParams& Params, TArray<ADASActionPoint*>& OutActionPoints, UDASComponent* DASComponent /*= nullptr*/ )
+{
+	OutActionPoints.Reset();
+
+	if( UWorld* world = GEngine->GetWorldFromContextObject( WorldContextObject, EGetWorldErrorMode::LogAndReturnNull ) )
+	{
+		FDASActionPointScoring::SelectActionPoints( world, Params, OutActionPoints, DASComponent );
+	}
 }
 
+bool UDASBPLibrary::SaveDASWorldSnapshot( UObject* WorldContextObject, TArray<uint8>& OutData )
+{
+	UWorld* world = GEngine->GetWorldFromContextObject( WorldContextObject, EGetWorldErrorMode::LogAndReturnNull );
+	return FDASWorldSnapshot::Save( world, OutData );
+}
 
+int32 UDASBPLibrary::LoadDASWorldSnapshot( UObject* WorldContextObject, const TArray<uint8>& Data, bool bLoadOwnerTransform /*= true*/ )
+{
+	UWorld* world = GEngine->GetWorldFromContextObject( WorldContextObject, EGetWorldErrorMode::LogAndReturnNull );
+	return FDASWorldSnapshot::Load( world, Data, bLoadOwnerTransform );
+}
@@ -0,0 +1,502 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+
+#include "Utils/DASDebugRenderer.h"
+#include "Utils/DASDeveloperSettings.h"
+#include "Points/DASBasePoint.h"
+#include "Points/DASPathPoint.h"
+#include "PrimitiveSceneProxy.h"
+#include "SceneManagement.h"
+#include "SceneView.h"
+#include "RenderingThread.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+#include "DrawDebugHelpers.h"
+
+
+DECLARE_CYCLE_STAT( TEXT( "DAS Debug Rebuild" ), STAT_DASDebugRebuild, STATGROUP_DAS );
+
+
+
+/************************************************************************/
+/*							DEBUG PRIMITIVES							*/
+/************************************************************************/
+
+void FDASDebugPrimitives::AddLine( const FVector& Start, const FVector& End, const FColor& Color, float Thickness )
+{
+	Lines.Add( { Start, End, Color, Thickness } );
+}
+
+void FDASDebugPrimitives::AddArrow( const FVector& Start, const FVector& End, float ArrowSize, const FColor& Color, float Thickness )
+{
+	AddLine( Start, End, Color, Thickness );
+
+	FVector dir = End - Start;
+	dir.Normalize();
+
+	FVector up( 0.f, 0.f, 1.f );
+	FVector right = dir ^ up;
+	if( !right.IsNormalized() )
+	{
+		dir.FindBestAxisVectors( up, right );
+	}
+
+	const FVector origin = FVector::ZeroVector;
+	FMatrix arrowTM;
+	arrowTM.SetAxes( &dir, &right, &up, &origin );
+
+	// arrow head points backward, both sides of line
+	const float arrowSqrt = FMath::Sqrt( ArrowSize );
+	AddLine( End, End + arrowTM.TransformPosition( FVector( -arrowSqrt, arrowSqrt, 0.f ) ), Color, Thickness );
+	AddLine( End, End + arrowTM.TransformPosition( FVector( -arrowSqrt, -arrowSqrt, 0.f ) ), Color, Thickness );
+}
+
+void FDASDebugPrimitives::AddSphere( const FVector& Center, float Radius, int32 Segments, const FColor& Color, float Thickness )
+{
+	Segments = FMath::Max( Segments, 4 );
+	const float angleInc = 2.f * UE_PI / Segments;
+
+	Lines.Reserve( Lines.Num() + Segments * Segments * 2 );
+
+	float latitude = angleInc;
+	float sinY1 = 0.f;
+	float cosY1 = 1.f;
+
+	for( int32 y = 0; y < Segments; y++ )
+	{
+		const float sinY2 = FMath::Sin( latitude );
+		const float cosY2 = FMath::Cos( latitude );
+
+		FVector vertex1 = FVector( sinY1, 0.f, cosY1 ) * Radius + Center;
+		FVector vertex3 = FVector( sinY2, 0.f, cosY2 ) * Radius + Center;
+		float longitude = angleInc;
+
+		for( int32 x = 0; x < Segments; x++ )
+		{
+			const float sinX = FMath::Sin( longitude );
+			const float cosX = FMath::Cos( longitude );
+
+			const FVector vertex2 = FVector( cosX * sinY1, sinX * sinY1, cosY1 ) * Radius + Center;
+			const FVector vertex4 = FVector( cosX * sinY2, sinX * sinY2, cosY2 ) * Radius + Center;
+
+			AddLine( vertex1, vertex2, Color, Thickness );
+			AddLine( vertex1, vertex3, Color, Thickness );
+
+			vertex1 = vertex2;
+			vertex3 = vertex4;
+			longitude += angleInc;
+		}
+
+		sinY1 = sinY2;
+		cosY1 = cosY2;
+		latitude += angleInc;
+	}
+}
+
+void FDASDebugPrimitives::Draw( UWorld* World, float LifeTime ) const
+{
+	for( const FDASDebugLine& line : Lines )
+	{
+		DrawDebugLine( World, line.Start, line.End, line.Color, false, LifeTime, 0, line.Thickness );
+	}
+}
+/************************************************************************/
+
+
+
+
+
+/************************************************************************/
+/*								SCENE PROXY								*/
+/************************************************************************/
+
+/**
+ * Owns copy of all debug cells on render thread
+ * Cells are culled by distance & view frustum every frame, only changed cells are sent from game thread
+ */
+class FDASDebugSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+	FDASDebugSceneProxy( const UDASDebugRenderComponent* InComponent, const TMap<FIntPoint, FDASDebugCell>& InCells )
+		: FPrimitiveSceneProxy( InComponent )
+		, Cells( InCells )
+		, MaxDrawDistance( UDASDeveloperSettings::Get()->DrawDebugMaxDistance )
+	{
+	}
+
+	virtual SIZE_T GetTypeHash() const override
+	{
+		static size_t uniquePointer;
+		return reinterpret_cast< size_t >( &uniquePointer );
+	}
+
+	virtual uint32 GetMemoryFootprint() const override
+	{
+		SIZE_T size = sizeof( *this ) + GetAllocatedSize() + Cells.GetAllocatedSize();
+		for( const TPair<FIntPoint, FDASDebugCell>& cell : Cells )
+		{
+			size += cell.Value.Lines.GetAllocatedSize();
+		}
+		return ( uint32 )size;
+	}
+
+	virtual FPrimitiveViewRelevance GetViewRelevance( const FSceneView* View ) const override
+	{
+		FPrimitiveViewRelevance result;
+		result.bDrawRelevance = IsShown( View );
+		result.bDynamicRelevance = true;
+		result.bShadowRelevance = false;
+		result.bEditorPrimitiveRelevance = UseEditorCompositing( View );
+		return result;
+	}
+
+	virtual void GetDynamicMeshElements( const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector ) const override
+	{
+		const double maxDistanceSquared = FMath::Square( ( double )MaxDrawDistance );
+
+		for( int32 viewIndex = 0; viewIndex < Views.Num(); viewIndex++ )
+		{
+			if( !( VisibilityMap & ( 1 << viewIndex ) ) )
+				continue;
+
+			const FSceneView* view = Views[ viewIndex ];
+			const FVector viewOrigin = view->ViewMatrices.GetViewOrigin();
+			FPrimitiveDrawInterface* PDI = Collector.GetPDI( viewIndex );
+
+			for( const TPair<FIntPoint, FDASDebugCell>& cell : Cells )
+			{
+				const FBox& bounds = cell.Value.Bounds;
+
+				// whole cell is out of range or not visible
+				if( bounds.ComputeSquaredDistanceToPoint( viewOrigin ) > maxDistanceSquared )
+					continue;
+
+				if( !view->ViewFrustum.IntersectBox( bounds.GetCenter(), bounds.GetExtent() ) )
+					continue;
+
+				// lines longer than draw distance may pass near view while both ends are far away
+				for( const FDASDebugLine& line : cell.Value.Lines )
+				{
+					if( FMath::PointDistToSegmentSquared( viewOrigin, line.Start, line.End ) < maxDistanceSquared )
+					{
+						PDI->DrawLine( line.Start, line.End, line.Color, SDPG_World, line.Thickness );
+					}
+				}
+			}
+		}
+	}
+
+	void UpdateCells_RenderThread( TMap<FIntPoint, FDASDebugCell>&& ChangedCells )
+	{
+		check( IsInRenderingThread() );
+
+		for( TPair<FIntPoint, FDASDebugCell>& changedCell : ChangedCells )
+		{
+			if( changedCell.Value.Lines.Num() > 0 )
+			{
+				Cells.Add( changedCell.Key, MoveTemp( changedCell.Value ) );
+			}
+			else
+			{
+				Cells.Remove( changedCell.Key );
+			}
+		}
+	}
+
+private:
+	TMap<FIntPoint, FDASDebugCell> Cells;
+	float MaxDrawDistance;
+};
+/************************************************************************/
+
+
+
+
+
+/************************************************************************/
+/*							RENDER COMPONENT							*/
+/************************************************************************/
+
+UDASDebugRenderComponent::UDASDebugRenderComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SetCollisionProfileName( UCollisionProfile::NoCollision_ProfileName );
+	SetGenerateOverlapEvents( false );
+	CastShadow = false;
+	bUseEditorCompositing = true;
+	bIsEditorOnly = true;
+	bSelectable = false;
+}
+
+FPrimitiveSceneProxy* UDASDebugRenderComponent::CreateSceneProxy()
+{
+	return new FDASDebugSceneProxy( this, Cells );
+}
+
+FBoxSphereBounds UDASDebugRenderComponent::CalcBounds( const FTransform& LocalToWorld ) const
+{
+	// component is never culled as a whole, cells are culled by scene proxy
+	return FBoxSphereBounds( FVector::ZeroVector, FVector( HALF_WORLD_MAX ), HALF_WORLD_MAX );
+}
+
+void UDASDebugRenderComponent::UpdateCells( TMap<FIntPoint, FDASDebugCell>&& ChangedCells )
+{
+	for( const TPair<FIntPoint, FDASDebugCell>& changedCell : ChangedCells )
+	{
+		if( changedCell.Value.Lines.Num() > 0 )
+		{
+			Cells.Add( changedCell.Key, changedCell.Value );
+		}
+		else
+		{
+			Cells.Remove( changedCell.Key );
+		}
+	}
+
+	// send only changed cells, instead of recreating whole proxy
+	if( FDASDebugSceneProxy* proxy = static_cast< FDASDebugSceneProxy* >( SceneProxy ) )
+	{
+		ENQUEUE_RENDER_COMMAND( UpdateDASDebugCells )(
+			[proxy, changedCells = MoveTemp( ChangedCells )]( FRHICommandListImmediate& RHICmdList ) mutable
+			{
+				proxy->UpdateCells_RenderThread( MoveTemp( changedCells ) );
+			} );
+	}
+}
+/************************************************************************/
+
+
+
+
+
+/************************************************************************/
+/*							RENDER SUBSYSTEM							*/
+/************************************************************************/
+
+namespace DASDebugRenderer
+{
+	/** Points without custom debug logic don't need their visualizer to tick at all */
+	static void UpdatePointVisTick( ADASBasePoint* Point )
+	{
+#if WITH_EDITORONLY_DATA
+		if( Point->PointVisComponent )
+		{
+			Point->PointVisComponent->SetComponentTickEnabled( Point->HasCustomDebug() );
+		}
+#endif
+	}
+}
+
+bool UDASDebugRenderSubsystem::ShouldCreateSubsystem( UObject* Outer ) const
+{
+	if( !GIsEditor || !Super::ShouldCreateSubsystem( Outer ) )
+		return false;
+
+	return UDASDeveloperSettings::Get()->bUseBatchedDebugRenderer;
+}
+
+bool UDASDebugRenderSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const
+{
+	// in runtime debug is drawn only on demand ( DAS.Debug ) and may be animated, so it keeps using DrawDebug
+	return WorldType == EWorldType::Editor;
+}
+
+void UDASDebugRenderSubsystem::Deinitialize()
+{
+	if( RenderComponent )
+	{
+		RenderComponent->DestroyComponent();
+		RenderComponent = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+TStatId UDASDebugRenderSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT( UDASDebugRenderSubsystem, STATGROUP_Tickables );
+}
+
+void UDASDebugRenderSubsystem::Tick( float DeltaTime )
+{
+	if( !RenderComponent )
+	{
+		RenderComponent = NewObject<UDASDebugRenderComponent>( GetWorld(), NAME_None, RF_Transient );
+		RenderComponent->RegisterComponentWithWorld( GetWorld() );
+	}
+
+	RebuildDirtyCells();
+}
+
+
+
+void UDASDebugRenderSubsystem::RegisterPoint( ADASBasePoint* Point )
+{
+	if( !Point || PointCells.Contains( Point ) )
+		return;
+
+	const FIntPoint cell = GetCell( Point->GetActorLocation() );
+	PointCells.Add( Point, cell );
+	CellPoints.FindOrAdd( cell ).Add( Point );
+	DirtyCells.Add( cell );
+
+	// links of other points to this one may be drawn only now
+	MarkPointDirty( Point );
+}
+
+void UDASDebugRenderSubsystem::UnregisterPoint( ADASBasePoint* Point )
+{
+	FIntPoint cell;
+	if( PointCells.RemoveAndCopyValue( Point, cell ) )
+	{
+		if( TArray<TWeakObjectPtr<ADASBasePoint>>* points = CellPoints.Find( cell ) )
+		{
+			points->RemoveSwap( Point );
+		}
+		DirtyCells.Add( cell );
+
+		UpdatePointLinks( Point, nullptr );
+	}
+}
+
+void UDASDebugRenderSubsystem::MarkPointDirty( ADASBasePoint* Point )
+{
+	if( !PointCells.Contains( Point ) )
+		return;
+
+	DirtyPoints.Add( Point );
+	DASDebugRenderer::UpdatePointVisTick( Point );
+
+	// links of point itself may have been edited
+	if( const ADASPathPoint* pathPoint = Cast<ADASPathPoint>( Point ) )
+	{
+		UpdatePointLinks( pathPoint, pathPoint );
+	}
+
+	// lines of path points linked to this one end at its location, so they have to be rebuilt too
+	if( const TArray<const ADASBasePoint*>* linkingPoints = LinkedBy.Find( Point ) )
+	{
+		for( const ADASBasePoint* linkingPoint : *linkingPoints )
+		{
+			if( const FIntPoint* cell = PointCells.Find( linkingPoint ) )
+			{
+				DirtyCells.Add( *cell );
+			}
+		}
+	}
+}
+
+void UDASDebugRenderSubsystem::UpdatePointLinks( const ADASBasePoint* Point, const ADASPathPoint* PathPoint )
+{
+	TArray<const ADASBasePoint*>& links = PointLinks.FindOrAdd( Point );
+
+	for( const ADASBasePoint* linkedPoint : links )
+	{
+		if( TArray<const ADASBasePoint*>* linkingPoints = LinkedBy.Find( linkedPoint ) )
+		{
+			linkingPoints->RemoveSwap( Point );
+			if( linkingPoints->Num() == 0 )
+			{
+				LinkedBy.Remove( linkedPoint );
+			}
+		}
+	}
+	links.Reset();
+
+	if( !PathPoint )
+	{
+		PointLinks.Remove( Point );
+		return;
+	}
+
+	for( const TArray<ADASPathPoint*>* pathPoints : { &PathPoint->NextPathPoints, &PathPoint->PreviousPathPoints } )
+	{
+		for( const ADASPathPoint* linkedPoint : *pathPoints )
+		{
+			if( linkedPoint && linkedPoint != Point && !links.Contains( linkedPoint ) )
+			{
+				links.Add( linkedPoint );
+				LinkedBy.FindOrAdd( linkedPoint ).Add( Point );
+			}
+		}
+	}
+}
+
+FIntPoint UDASDebugRenderSubsystem::GetCell( const FVector& Location )
+{
+	return FIntPoint( FMath::FloorToInt( Location.X / CellSize ), FMath::FloorToInt( Location.Y / CellSize ) );
+}
+
+void UDASDebugRenderSubsystem::RebuildDirtyCells()
+{
+	// move points that left their cells
+	for( const TWeakObjectPtr<ADASBasePoint>& weakPoint : DirtyPoints )
+	{
+		ADASBasePoint* point = weakPoint.Get();
+		FIntPoint* registeredCell = point ? PointCells.Find( point ) : nullptr;
+		if( !registeredCell )
+			continue;
+
+		const FIntPoint newCell = GetCell( point->GetActorLocation() );
+		if( newCell != *registeredCell )
+		{
+			if( TArray<TWeakObjectPtr<ADASBasePoint>>* oldCellPoints = CellPoints.Find( *registeredCell ) )
+			{
+				oldCellPoints->RemoveSwap( point );
+			}
+			CellPoints.FindOrAdd( newCell ).Add( point );
+
+			DirtyCells.Add( *registeredCell );
+			*registeredCell = newCell;
+		}
+		DirtyCells.Add( newCell );
+	}
+	DirtyPoints.Reset();
+
+	if( DirtyCells.Num() == 0 || !RenderComponent )
+		return;
+
+	SCOPE_CYCLE_COUNTER( STAT_DASDebugRebuild );
+
+	TMap<FIntPoint, FDASDebugCell> changedCells;
+	changedCells.Reserve( DirtyCells.Num() );
+
+	for( const FIntPoint& cell : DirtyCells )
+	{
+		FDASDebugCell& debugCell = changedCells.Add( cell );
+
+		TArray<TWeakObjectPtr<ADASBasePoint>>* points = CellPoints.Find( cell );
+		if( !points )
+			continue;
+
+		FDASDebugPrimitives primitives;
+		for( int32 i = points->Num() - 1; i >= 0; i-- )
+		{
+			if( ADASBasePoint* point = ( *points )[ i ].Get() )
+			{
+				point->GatherDebugPrimitives( primitives, -1.f );
+			}
+			else
+			{
+				points->RemoveAtSwap( i, 1, EAllowShrinking::No );
+			}
+		}
+
+		if( points->Num() == 0 )
+		{
+			CellPoints.Remove( cell );
+		}
+
+		for( const FDASDebugLine& line : primitives.Lines )
+		{
+			debugCell.Bounds += line.Start;
+			debugCell.Bounds += line.End;
+		}
+		debugCell.Lines = MoveTemp( primitives.Lines );
+	}
+
+	DirtyCells.Reset();
+	RenderComponent->UpdateCells( MoveTemp( changedCells ) );
+}
+/************************************************************************/
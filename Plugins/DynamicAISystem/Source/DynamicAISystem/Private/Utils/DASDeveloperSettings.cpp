@@ -6,4 +6,7 @@
 UDASDeveloperSettings::UDASDeveloperSettings()
 {
 	bAnimatePathArrows = true;
+	bUseBatchedDebugRenderer = true;
+	bUseUpdateManager = true;
+	bBatchActionPointsReplication = true;
 }
@@ -0,0 +1,139 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+
+#include "Utils/DASPointsReplicator.h"
+#include "Points/DASActionPoint.h"
+#include "Components/SceneComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "TimerManager.h"
+#include "Engine/World.h"
+
+
+
+ADASPointsReplicator::ADASPointsReplicator()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	// root is needed to have location, relevancy is calculated by distance to it
+	RootComponent = CreateDefaultSubobject<USceneComponent>( TEXT( "Root" ) );
+
+	// network settings
+	bReplicates = true;
+	SetReplicatingMovement( false );
+	NetDormancy = ENetDormancy::DORM_DormantAll;
+	NetUpdateFrequency = 10.f;
+
+	bFlushScheduled = false;
+}
+
+void ADASPointsReplicator::GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const
+{
+	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
+
+	FDoRepLifetimeParams SharedParams;
+	SharedParams.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST( ADASPointsReplicator, Points, SharedParams );
+	DOREPLIFETIME_WITH_PARAMS_FAST( ADASPointsReplicator, StateBits, SharedParams );
+}
+
+
+
+void ADASPointsReplicator::InitCell( const FIntPoint& InCell, float CellSize, float CullDistance )
+{
+	Cell = InCell;
+
+	// replicator is in the middle of cell, so add half of cell diagonal to reach its corners
+	const float cellHalfDiagonal = CellSize * UE_HALF_SQRT_2;
+	SetNetCullDistanceSquared( FMath::Square( CullDistance + cellHalfDiagonal ) );
+}
+
+void ADASPointsReplicator::AddPoint( ADASActionPoint* Point )
+{
+	if( !Point || PointIndices.Contains( Point ) )
+		return;
+
+	// reuse slot of removed point if there is any
+	int32 index = Points.Find( nullptr );
+	if( index == INDEX_NONE )
+	{
+		index = Points.Add( Point );
+		StateBits.SetNumZeroed( FMath::DivideAndRoundUp( Points.Num(), PointsPerByte ) );
+	}
+	else
+	{
+		Points[ index ] = Point;
+	}
+
+	PointIndices.Add( Point, index );
+	WritePointState( index, Point );
+
+	MARK_PROPERTY_DIRTY_FROM_NAME( ADASPointsReplicator, Points, this );
+	FlushState();
+}
+
+void ADASPointsReplicator::RemovePoint( ADASActionPoint* Point )
+{
+	int32 index = INDEX_NONE;
+	if( PointIndices.RemoveAndCopyValue( Point, index ) )
+	{
+		// keep indices of other points, slot will be reused by next added point
+		Points[ index ] = nullptr;
+		WritePointState( index, nullptr );
+
+		MARK_PROPERTY_DIRTY_FROM_NAME( ADASPointsReplicator, Points, this );
+		FlushState();
+	}
+}
+
+void ADASPointsReplicator::MarkPointDirty( ADASActionPoint* Point )
+{
+	if( const int32* index = PointIndices.Find( Point ) )
+	{
+		WritePointState( *index, Point );
+
+		// many points can change in the same frame, replicator wakes up only once for all of them
+		if( !bFlushScheduled )
+		{
+			bFlushScheduled = true;
+			GetWorldTimerManager().SetTimerForNextTick( this, &ADASPointsReplicator::FlushState );
+		}
+	}
+}
+
+void ADASPointsReplicator::WritePointState( int32 Index, const ADASActionPoint* Point )
+{
+	const int32 byteIndex = Index / PointsPerByte;
+	const int32 shift = ( Index % PointsPerByte ) * 2;
+
+	uint8 state = 0;
+	if( Point && Point->IsTaken() )		state |= TakenBit;
+	if( Point && Point->IsExecuting() )	state |= ExecutingBit;
+
+	uint8& stateByte = StateBits[ byteIndex ];
+	stateByte = ( stateByte & ~( ( TakenBit | ExecutingBit ) << shift ) ) | ( state << shift );
+}
+
+void ADASPointsReplicator::FlushState()
+{
+	bFlushScheduled = false;
+
+	MARK_PROPERTY_DIRTY_FROM_NAME( ADASPointsReplicator, StateBits, this );
+	FlushNetDormancy();
+}
+
+void ADASPointsReplicator::OnRep_PointsState()
+{
+	// both arrays can arrive in separate bunches, apply only part that is already known
+	const int32 numPoints = FMath::Min( Points.Num(), StateBits.Num() * PointsPerByte );
+	for( int32 i = 0; i < numPoints; i++ )
+	{
+		if( ADASActionPoint* point = Points[ i ] )
+		{
+			const uint8 state = StateBits[ i / PointsPerByte ] >> ( ( i % PointsPerByte ) * 2 );
+			point->ApplyReplicatedState( ( state & TakenBit ) != 0, ( state & ExecutingBit ) != 0 );
+		}
+	}
+}
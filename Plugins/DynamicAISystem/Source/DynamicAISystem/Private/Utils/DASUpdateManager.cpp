@@ -0,0 +1,350 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+
+#include "Utils/DASUpdateManager.h"
+#include "Components/DASComponent.h"
+#include "Utils/DASDeveloperSettings.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+
+DECLARE_CYCLE_STAT( TEXT( "DAS Update Manager Tick" ), STAT_DASUpdateManagerTick, STATGROUP_DAS );
+DECLARE_DWORD_COUNTER_STAT( TEXT( "DAS Registered Components" ), STAT_DASRegisteredComponents, STATGROUP_DAS );
+DECLARE_DWORD_COUNTER_STAT( TEXT( "DAS Decision Updates" ), STAT_DASDecisionUpdates, STATGROUP_DAS );
+DECLARE_DWORD_COUNTER_STAT( TEXT( "DAS Skipped Updates" ), STAT_DASSkippedUpdates, STATGROUP_DAS );
+DECLARE_DWORD_COUNTER_STAT( TEXT( "DAS Deferred Updates" ), STAT_DASDeferredUpdates, STATGROUP_DAS );
+
+
+
+bool UDASUpdateManager::ShouldCreateSubsystem( UObject* Outer ) const
+{
+	if( !Super::ShouldCreateSubsystem( Outer ) )
+		return false;
+
+	return UDASDeveloperSettings::Get()->bUseUpdateManager;
+}
+
+bool UDASUpdateManager::DoesSupportWorldType( const EWorldType::Type WorldType ) const
+{
+	// AI logic runs only in game, no need to tick in editor worlds
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UDASUpdateManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT( UDASUpdateManager, STATGROUP_Tickables );
+}
+
+
+
+void UDASUpdateManager::RegisterComponent( UDASComponent* Component )
+{
+	if( !IsValid( Component ) )
+		return;
+
+	// entry under the same address can be left by destroyed component, that wasn't compacted yet
+	const int32* existingIndex = EntryIndices.Find( Component );
+	if( existingIndex && Entries[ *existingIndex ].Component.IsValid() )
+		return;
+
+	const int32 index = existingIndex ? *existingIndex : Entries.Num();
+	if( !existingIndex )
+	{
+		EntryIndices.Add( Component, index );
+		Entries.AddDefaulted();
+	}
+
+	FEntry& entry = Entries[ index ];
+	entry = FEntry();
+	entry.Component = Component;
+	entry.Key = Component;
+	entry.LastUpdateTime = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0;
+
+	// calculate significance right away, so component doesn't wait for its turn with default one
+	CacheViewLocations();
+	UpdateSignificance( entry );
+}
+
+void UDASUpdateManager::UnregisterComponent( UDASComponent* Component )
+{
+	// only clear reference, entry will be removed on next tick
+	// this makes it safe to unregister from within decision update
+	int32 index;
+	if( EntryIndices.RemoveAndCopyValue( Component, index ) )
+	{
+		Entries[ index ].Component.Reset();
+		Entries[ index ].Key = nullptr;
+	}
+}
+
+bool UDASUpdateManager::RequestDecisionUpdate( UDASComponent* Component )
+{
+	const int32* index = EntryIndices.Find( Component );
+	if( !index )
+		return false;
+
+	Entries[ *index ].bUpdateRequested = true;
+	return true;
+}
+
+EDASUpdateSignificance UDASUpdateManager::GetComponentSignificance( const UDASComponent* Component ) const
+{
+	const int32* index = EntryIndices.Find( Component );
+	return index ? Entries[ *index ].Significance : EDASUpdateSignificance::Dormant;
+}
+
+
+
+void UDASUpdateManager::Tick( float DeltaTime )
+{
+	SCOPE_CYCLE_COUNTER( STAT_DASUpdateManagerTick );
+
+	FDASUpdateManagerStats frameStats;
+
+	// selections are not part of budget, AI waiting for them would stall otherwise
+	ProcessPendingSelectionRequests();
+
+	UWorld* world = GetWorld();
+	CompactEntries();
+
+	const int32 numEntries = Entries.Num();
+	SET_DWORD_STAT( STAT_DASRegisteredComponents, numEntries );
+
+	if( !world || numEntries == 0 )
+	{
+		LastFrameStats = frameStats;
+		return;
+	}
+
+	const UDASDeveloperSettings* settings = UDASDeveloperSettings::Get();
+
+	// recalculate significance only for part of components each frame
+	CacheViewLocations();
+	const int32 numSignificanceUpdates = FMath::Min( settings->SignificanceUpdatesPerFrame, numEntries );
+	for( int32 i = 0; i < numSignificanceUpdates; i++ )
+	{
+		SignificanceCursor = SignificanceCursor % numEntries;
+		UpdateSignificance( Entries[ SignificanceCursor ] );
+		SignificanceCursor++;
+	}
+
+	const double worldTime = world->GetTimeSeconds();
+	const double startTime = FPlatformTime::Seconds();
+	const double budgetSeconds = settings->UpdateBudgetMs * 0.001;
+
+	bool bBudgetExceeded = false;
+	int32 nextCursor = INDEX_NONE;
+
+	// round-robin over all entries, starting from the one that didn't fit into previous frame
+	for( int32 i = 0; i < numEntries; i++ )
+	{
+		const int32 index = ( UpdateCursor + i ) % numEntries;
+		const FEntry& entry = Entries[ index ];
+
+		UDASComponent* component = entry.Component.Get();
+		const float interval = GetUpdateInterval( entry.Significance );
+		const double timeSinceUpdate = worldTime - entry.LastUpdateTime;
+
+		// not due yet, or not updated at all in current significance
+		if( !component || ( !entry.bUpdateRequested && ( interval < 0.f || timeSinceUpdate < interval ) ) )
+		{
+			frameStats.NumSkipped++;
+			continue;
+		}
+
+		// due, but there is no time left in this frame
+		if( bBudgetExceeded )
+		{
+			frameStats.NumDeferred++;
+			continue;
+		}
+
+		// cleared before update, so work requested from within it runs in next tick
+		Entries[ index ].bUpdateRequested = false;
+		component->UpdateDecisions( ( float )timeSinceUpdate );
+
+		// access by index again, decision update could register new components and reallocate array
+		Entries[ index ].LastUpdateTime = worldTime;
+		frameStats.NumUpdated++;
+		nextCursor = index + 1;
+
+		if( FPlatformTime::Seconds() - startTime >= budgetSeconds )
+		{
+			bBudgetExceeded = true;
+		}
+	}
+
+	// next frame starts from first component that wasn't updated in this one
+	if( nextCursor != INDEX_NONE )
+	{
+		UpdateCursor = nextCursor % numEntries;
+	}
+
+	frameStats.UsedTimeMs = ( float )( ( FPlatformTime::Seconds() - startTime ) * 1000.0 );
+	LastFrameStats = frameStats;
+
+	SET_DWORD_STAT( STAT_DASDecisionUpdates, frameStats.NumUpdated );
+	SET_DWORD_STAT( STAT_DASSkippedUpdates, frameStats.NumSkipped );
+	SET_DWORD_STAT( STAT_DASDeferredUpdates, frameStats.NumDeferred );
+}
+
+
+
+void UDASUpdateManager::RequestActionPointSelection( const FDASActionPointScoringParams& Params, UDASComponent* DASComponent, FOnActionPointsSelected OnSelected )
+{
+	FDASActionPointSelectionRequest& request = PendingSelectionRequests.AddDefaulted_GetRef();
+	request.Params = Params;
+	request.DASComponent = DASComponent;
+
+	PendingSelectionCallbacks.Add( MoveTemp( OnSelected ) );
+}
+
+void UDASUpdateManager::ProcessPendingSelectionRequests()
+{
+	if( PendingSelectionRequests.Num() == 0 )
+		return;
+
+	// move requests out, callbacks may queue new ones which will be processed in next frame
+	TArray<FDASActionPointSelectionRequest> requests = MoveTemp( PendingSelectionRequests );
+	TArray<FOnActionPointsSelected> callbacks = MoveTemp( PendingSelectionCallbacks );
+	PendingSelectionRequests.Reset();
+	PendingSelectionCallbacks.Reset();
+
+	FDASActionPointScoring::ProcessRequests( GetWorld(), requests );
+
+	for( int32 i = 0; i < requests.Num(); i++ )
+	{
+		callbacks[ i ].ExecuteIfBound( requests[ i ].Result );
+	}
+}
+
+
+
+void UDASUpdateManager::CacheViewLocations()
+{
+	// components registered during the frame reuse views cached in it
+	if( ViewLocationsFrame == GFrameCounter )
+		return;
+
+	ViewLocationsFrame = GFrameCounter;
+	ViewLocations.Reset();
+
+	UWorld* world = GetWorld();
+	if( !world )
+		return;
+
+	// use view points of local players ( on listen server or standalone )
+	for( FConstPlayerControllerIterator it = world->GetPlayerControllerIterator(); it; ++it )
+	{
+		APlayerController* playerController = it->Get();
+		if( playerController )
+		{
+			FVector viewLocation;
+			FRotator viewRotation;
+			playerController->GetPlayerViewPoint( viewLocation, viewRotation );
+			ViewLocations.Add( viewLocation );
+		}
+	}
+
+	// fallback to last rendered views, if there aren't any player controllers
+	if( ViewLocations.Num() == 0 )
+	{
+		ViewLocations.Append( world->ViewLocationsRenderedLastFrame );
+	}
+}
+
+void UDASUpdateManager::UpdateSignificance( FEntry& Entry ) const
+{
+	const UDASComponent* component = Entry.Component.Get();
+	const AActor* owner = component ? component->GetOwner() : nullptr;
+	if( !owner )
+		return;
+
+	// without any view, treat everything as significant to not stall AI
+	if( ViewLocations.Num() == 0 )
+	{
+		Entry.Significance = EDASUpdateSignificance::High;
+		return;
+	}
+
+	const FVector ownerLocation = owner->GetActorLocation();
+	float closestDistanceSquared = FLT_MAX;
+	for( const FVector& viewLocation : ViewLocations )
+	{
+		closestDistanceSquared = FMath::Min( closestDistanceSquared, ( float )FVector::DistSquared( ownerLocation, viewLocation ) );
+	}
+
+	const UDASDeveloperSettings* settings = UDASDeveloperSettings::Get();
+	const bool bIsVisible = owner->WasRecentlyRendered( 0.2f );
+
+	if( closestDistanceSquared < FMath::Square( settings->HighSignificanceDistance ) )
+	{
+		Entry.Significance = EDASUpdateSignificance::High;
+	}
+	else if( closestDistanceSquared < FMath::Square( settings->MediumSignificanceDistance ) )
+	{
+		// visible AI in mid range is promoted
+		Entry.Significance = bIsVisible ? EDASUpdateSignificance::High : EDASUpdateSignificance::Medium;
+	}
+	else if( settings->DormantDistance > 0.f && closestDistanceSquared > FMath::Square( settings->DormantDistance ) && !bIsVisible )
+	{
+		Entry.Significance = EDASUpdateSignificance::Dormant;
+	}
+	else
+	{
+		Entry.Significance = bIsVisible ? EDASUpdateSignificance::Medium : EDASUpdateSignificance::Low;
+	}
+}
+
+float UDASUpdateManager::GetUpdateInterval( EDASUpdateSignificance Significance )
+{
+	const UDASDeveloperSettings* settings = UDASDeveloperSettings::Get();
+
+	switch( Significance )
+	{
+	case EDASUpdateSignificance::High:		return settings->HighSignificanceInterval;
+	case EDASUpdateSignificance::Medium:	return settings->MediumSignificanceInterval;
+	case EDASUpdateSignificance::Low:		return settings->LowSignificanceInterval;
+	default:								return -1.f;
+	}
+}
+
+void UDASUpdateManager::CompactEntries()
+{
+	for( int32 i = Entries.Num() - 1; i >= 0; i-- )
+	{
+		if( !Entries[ i ].Component.IsValid() )
+		{
+			// component destroyed without unregistering, its key is still in the map
+			if( const UDASComponent* key = Entries[ i ].Key )
+			{
+				EntryIndices.Remove( key );
+			}
+
+			const int32 lastIndex = Entries.Num() - 1;
+			Entries.RemoveAtSwap( i, 1, EAllowShrinking::No );
+
+			// last entry moved into removed slot, cursors pointing to it follow it
+			if( i != lastIndex )
+			{
+				if( const UDASComponent* movedKey = Entries[ i ].Key )
+				{
+					EntryIndices.Add( movedKey, i );
+				}
+				if( UpdateCursor == lastIndex ) UpdateCursor = i;
+				if( SignificanceCursor == lastIndex ) SignificanceCursor = i;
+			}
+		}
+	}
+
+	if( Entries.Num() == 0 )
+	{
+		UpdateCursor = 0;
+		SignificanceCursor = 0;
+	}
+	else
+	{
+		UpdateCursor = UpdateCursor % Entries.Num();
+		SignificanceCursor = SignificanceCursor % Entries.Num();
+	}
+}
@@ -0,0 +1,460 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+
+#include "Utils/DASWorldSnapshot.h"
+#include "Utils/DASWorldSubsystem.h"
+#include "Utils/DASBPLibrary.h"
+#include "Components/DASComponent.h"
+#include "Objects/DASActionSelector.h"
+#include "Points/DASPathPoint.h"
+#include "Points/DASActionPoint.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+
+
+DECLARE_CYCLE_STAT( TEXT( "DAS World Snapshot Save" ), STAT_DASWorldSnapshotSave, STATGROUP_DAS );
+DECLARE_CYCLE_STAT( TEXT( "DAS World Snapshot Load" ), STAT_DASWorldSnapshotLoad, STATGROUP_DAS );
+
+
+namespace DASWorldSnapshot
+{
+	/** 'DASW', first bytes of every snapshot */
+	static constexpr uint32 Magic = 0x57534144;
+
+	/** Fields of record which are written only if they differ from defaults */
+	enum EField : uint8
+	{
+		Field_RunMode			= 1 << 0,
+		Field_ActivePathPoint	= 1 << 1,
+		Field_ActionQueue		= 1 << 2,
+		Field_ActionSelector	= 1 << 3,
+		Field_OwnerTransform	= 1 << 4,
+		Field_SelectorState		= 1 << 5,
+	};
+
+	/** Flags of component packed into single byte */
+	enum EFlag : uint8
+	{
+		Flag_MovingForward		= 1 << 0,
+		Flag_ReturningToPath	= 1 << 1,
+		Flag_HasNewPathPoint	= 1 << 2,
+	};
+
+	/** Component that record will be loaded into */
+	struct FLoadTarget
+	{
+		UDASComponent* Component = nullptr;
+		EDASRunMode DefaultRunMode = EDASRunMode::ExecutePathPoints;
+	};
+
+	/** Writes SaveGame properties of selector, tagged serialization skips values equal to its archetype */
+	static void WriteSelectorData( FArchive& Writer, UDASActionSelector* Selector, TArray<uint8>& Buffer )
+	{
+		Buffer.Reset();
+		FMemoryWriter selectorWriter( Buffer, true );
+		FDASSaveGameArchive Ar( selectorWriter );
+		Selector->Serialize( Ar );
+
+		uint32 dataSize = Buffer.Num();
+		Writer.SerializeIntPacked( dataSize );
+		Writer.Serialize( Buffer.GetData(), dataSize );
+	}
+
+	/** Reads view of data written by WriteSelectorData, returns false if it doesn't fit into record */
+	static bool ReadSelectorData( FMemoryReaderView& Reader, const uint8* RecordData, int64 RecordSize, TArrayView<const uint8>& OutData )
+	{
+		uint32 dataSize = 0;
+		Reader.SerializeIntPacked( dataSize );
+
+		const int64 dataStart = Reader.Tell();
+		if( dataStart + dataSize > RecordSize )
+			return false;
+
+		// selector data is not copied, it is read directly from snapshot when applying state
+		OutData = MakeArrayView( RecordData + dataStart, dataSize );
+		Reader.Seek( dataStart + dataSize );
+		return true;
+	}
+
+	/** Returns defaults of component, including components added in blueprint */
+	static const UDASComponent* GetComponentDefaults( const UDASComponent* Component )
+	{
+		const AActor* owner = Component->GetOwner();
+		const UDASComponent* defaults = owner ? Cast<UDASComponent>( UDASBPLibrary::FindDefaultComponentByClass( owner->GetClass(), Component->GetClass() ) ) : nullptr;
+		return defaults ? defaults : GetDefault<UDASComponent>( Component->GetClass() );
+	}
+}
+
+
+
+bool FDASWorldSnapshot::Save( UWorld* World, TArray<uint8>& OutData )
+{
+	using namespace DASWorldSnapshot;
+
+	SCOPE_CYCLE_COUNTER( STAT_DASWorldSnapshotSave );
+	check( IsInGameThread() );
+
+	OutData.Reset();
+
+	UDASWorldSubsystem* DASSubsystem = World ? World->GetSubsystem<UDASWorldSubsystem>() : nullptr;
+	if( !DASSubsystem )
+		return false;
+
+	TArray<FGuid> pointIds;
+	TMap<FGuid, uint32> pointIndices;
+	TArray<FString> componentNames;
+	TArray<FString> selectorClasses;
+	TMap<const UClass*, uint32> selectorClassIndices;
+	TMap<const UClass*, const UDASComponent*> defaultsByOwnerClass;
+
+	TArray<uint32> recordOffsets;
+	TArray<uint8> records;
+	TArray<uint8> selectorData;
+
+	const int32 numComponents = DASSubsystem->DASComponents.Num();
+	recordOffsets.Reserve( numComponents );
+	componentNames.Reserve( numComponents );
+	records.Reserve( numComponents * 64 );
+
+	auto getPointIndex = [&pointIds, &pointIndices]( const FGuid& PointId ) -> uint32
+	{
+		if( const uint32* foundIndex = pointIndices.Find( PointId ) )
+			return *foundIndex;
+
+		const uint32 newIndex = pointIds.Add( PointId );
+		pointIndices.Add( PointId, newIndex );
+		return newIndex;
+	};
+
+	FMemoryWriter recordsWriter( records, true );
+
+	for( UDASComponent* component : DASSubsystem->DASComponents )
+	{
+		AActor* owner = IsValid( component ) ? component->GetOwner() : nullptr;
+		if( !owner )
+			continue;
+
+		// defaults are the same for all components of given owner class
+		const UDASComponent*& defaults = defaultsByOwnerClass.FindOrAdd( owner->GetClass() );
+		if( !defaults || defaults->GetClass() != component->GetClass() )
+		{
+			defaults = GetComponentDefaults( component );
+		}
+
+		const bool bHasActivePathPoint = component->ActivePathPoint && component->ActivePathPoint->PointId.IsValid();
+
+		uint8 fields = Field_OwnerTransform;
+		if( component->RunMode != defaults->RunMode )		fields |= Field_RunMode;
+		if( bHasActivePathPoint )							fields |= Field_ActivePathPoint;
+		if( component->ActionPointsQueue.Num() > 0 )		fields |= Field_ActionQueue;
+		if( component->WasActionSelectorOverridden() )		fields |= Field_ActionSelector;
+		else if( component->ActionSelector )				fields |= Field_SelectorState;
+
+		uint8 flags = 0;
+		if( component->bIsMovingForwardAlongPath )			flags |= Flag_MovingForward;
+		if( component->bIsReturningToPathPoint )			flags |= Flag_ReturningToPath;
+		if( component->bHasNewPathPoint )					flags |= Flag_HasNewPathPoint;
+
+		recordOffsets.Add( records.Num() );
+
+		uint32 nameIndex = componentNames.Add( component->GetPathName( World ) );
+		recordsWriter.SerializeIntPacked( nameIndex );
+		recordsWriter << fields;
+		recordsWriter << flags;
+
+		if( fields & Field_RunMode )
+		{
+			uint8 runMode = ( uint8 )component->RunMode;
+			recordsWriter << runMode;
+		}
+
+		if( fields & Field_ActivePathPoint )
+		{
+			uint32 pointIndex = getPointIndex( component->ActivePathPoint->PointId );
+			recordsWriter.SerializeIntPacked( pointIndex );
+		}
+
+		if( fields & Field_ActionQueue )
+		{
+			uint32 queueNum = component->ActionPointsQueue.Num();
+			recordsWriter.SerializeIntPacked( queueNum );
+
+			for( ADASActionPoint* actionPoint : component->ActionPointsQueue )
+			{
+				// missing points are stored as index 0, real indices are shifted by one
+				uint32 pointIndex = ( actionPoint && actionPoint->PointId.IsValid() ) ? getPointIndex( actionPoint->PointId ) + 1 : 0;
+				recordsWriter.SerializeIntPacked( pointIndex );
+			}
+		}
+
+		if( fields & Field_ActionSelector )
+		{
+			// selector cleared in runtime is stored as index 0, real indices are shifted by one
+			const UClass* selectorClass = component->ActionSelector ? component->ActionSelector->GetClass() : nullptr;
+			uint32 classIndex = 0;
+			if( selectorClass )
+			{
+				const uint32* foundIndex = selectorClassIndices.Find( selectorClass );
+				classIndex = 1 + ( foundIndex ? *foundIndex : selectorClassIndices.Add( selectorClass, selectorClasses.Add( selectorClass->GetPathName() ) ) );
+			}
+			recordsWriter.SerializeIntPacked( classIndex );
+
+			if( selectorClass )
+			{
+				// selector is the only part which still needs tagged serialization, it is rarely changed in runtime
+				WriteSelectorData( recordsWriter, component->ActionSelector, selectorData );
+			}
+		}
+
+		if( fields & Field_SelectorState )
+		{
+			// selector from defaults is kept on load, but its SaveGame properties may have changed in runtime
+			WriteSelectorData( recordsWriter, component->ActionSelector, selectorData );
+		}
+
+		if( fields & Field_OwnerTransform )
+		{
+			FVector location = owner->GetActorLocation();
+			FRotator3f rotation = FRotator3f( owner->GetActorRotation() );
+			recordsWriter << location;
+			recordsWriter << rotation;
+		}
+	}
+
+	// header and tables go before records
+	FMemoryWriter writer( OutData, true );
+
+	uint32 magic = Magic;
+	uint32 version = ( uint32 )EVersion::Latest;
+	writer << magic;
+	writer << version;
+
+	int32 numPoints = pointIds.Num();
+	writer << numPoints;
+	for( FGuid& pointId : pointIds )
+	{
+		writer << pointId;
+	}
+
+	writer << componentNames;
+	writer << selectorClasses;
+	writer << recordOffsets;
+
+	int32 recordsSize = records.Num();
+	writer << recordsSize;
+	writer.Serialize( records.GetData(), recordsSize );
+
+	return !writer.IsError();
+}
+
+int32 FDASWorldSnapshot::Load( UWorld* World, const TArray<uint8>& Data, bool bLoadOwnerTransform /*= true*/ )
+{
+	using namespace DASWorldSnapshot;
+
+	SCOPE_CYCLE_COUNTER( STAT_DASWorldSnapshotLoad );
+	check( IsInGameThread() );
+
+	UDASWorldSubsystem* DASSubsystem = World ? World->GetSubsystem<UDASWorldSubsystem>() : nullptr;
+	if( !DASSubsystem )
+		return INDEX_NONE;
+
+	FMemoryReader reader( Data, true );
+
+	uint32 magic = 0;
+	uint32 version = 0;
+	reader << magic;
+	reader << version;
+
+	if( reader.IsError() || magic != Magic || version == 0 || version > ( uint32 )EVersion::Latest )
+	{
+		UE_LOG( LogDAS, Error, TEXT( "Trying to load invalid or unsupported DAS world snapshot ( version %u )" ), version );
+		return INDEX_NONE;
+	}
+
+	int32 numPoints = 0;
+	reader << numPoints;
+	if( numPoints < 0 || ( int64 )numPoints * sizeof( FGuid ) > Data.Num() )
+		return INDEX_NONE;
+
+	TArray<FGuid> pointIds;
+	pointIds.SetNum( numPoints );
+	for( FGuid& pointId : pointIds )
+	{
+		reader << pointId;
+	}
+
+	TArray<FString> componentNames;
+	TArray<FString> selectorClassPaths;
+	TArray<uint32> recordOffsets;
+	int32 recordsSize = 0;
+	reader << componentNames;
+	reader << selectorClassPaths;
+	reader << recordOffsets;
+	reader << recordsSize;
+
+	const int64 recordsStart = reader.Tell();
+	if( reader.IsError() || recordsSize < 0 || recordsStart + recordsSize > Data.Num() )
+	{
+		UE_LOG( LogDAS, Error, TEXT( "DAS world snapshot is corrupted" ) );
+		return INDEX_NONE;
+	}
+
+	// classes can be loaded only on game thread
+	TArray<UClass*> selectorClasses;
+	selectorClasses.Reserve( selectorClassPaths.Num() );
+	for( const FString& classPath : selectorClassPaths )
+	{
+		selectorClasses.Add( FSoftClassPath( classPath ).TryLoadClass<UDASActionSelector>() );
+	}
+
+	// components currently in the world, by the same names that were saved
+	TMap<FString, FLoadTarget> targetsByName;
+	targetsByName.Reserve( DASSubsystem->DASComponents.Num() );
+	for( UDASComponent* component : DASSubsystem->DASComponents )
+	{
+		if( IsValid( component ) && component->GetOwner() )
+		{
+			FLoadTarget& target = targetsByName.Add( component->GetPathName( World ) );
+			target.Component = component;
+			target.DefaultRunMode = GetComponentDefaults( component )->RunMode;
+		}
+	}
+
+	// resolve point table once, instead of searching points for every reference
+	TArray<ADASPathPoint*> pathPoints;
+	TArray<ADASActionPoint*> actionPoints;
+	pathPoints.SetNumZeroed( numPoints );
+	actionPoints.SetNumZeroed( numPoints );
+
+	ParallelFor( numPoints, [&]( int32 PointIndex )
+		{
+			pathPoints[ PointIndex ] = DASSubsystem->FindPathPointById( pointIds[ PointIndex ] );
+			actionPoints[ PointIndex ] = DASSubsystem->FindActionPointById( pointIds[ PointIndex ] );
+		} );
+
+	// decode records and fix up references in parallel, it only reads data prepared above
+	const int32 numRecords = recordOffsets.Num();
+	TArray<FDASComponentState> states;
+	TArray<UDASComponent*> components;
+	states.SetNum( numRecords );
+	components.SetNumZeroed( numRecords );
+
+	const uint8* recordsData = Data.GetData() + recordsStart;
+
+	ParallelFor( numRecords, [&]( int32 RecordIndex )
+		{
+			const uint32 recordStart = recordOffsets[ RecordIndex ];
+			const uint32 recordEnd = RecordIndex + 1 < numRecords ? recordOffsets[ RecordIndex + 1 ] : ( uint32 )recordsSize;
+			if( recordStart > recordEnd || recordEnd > ( uint32 )recordsSize )
+				return;
+
+			FMemoryReaderView recordReader( MakeArrayView( recordsData + recordStart, recordEnd - recordStart ), true );
+
+			uint32 nameIndex = 0;
+			uint8 fields = 0;
+			uint8 flags = 0;
+			recordReader.SerializeIntPacked( nameIndex );
+			recordReader << fields;
+			recordReader << flags;
+
+			const FLoadTarget* target = componentNames.IsValidIndex( nameIndex ) ? targetsByName.Find( componentNames[ nameIndex ] ) : nullptr;
+			if( !target )
+				return;
+
+			FDASComponentState& state = states[ RecordIndex ];
+			state.bWasMovingForward = ( flags & Flag_MovingForward ) != 0;
+			state.bWasReturningToPathPoint = ( flags & Flag_ReturningToPath ) != 0;
+			state.bHasNewPathPoint = ( flags & Flag_HasNewPathPoint ) != 0;
+			state.RunMode = target->DefaultRunMode;
+
+			if( fields & Field_RunMode )
+			{
+				uint8 runMode = 0;
+				recordReader << runMode;
+				state.RunMode = ( EDASRunMode )runMode;
+			}
+
+			if( fields & Field_ActivePathPoint )
+			{
+				uint32 pointIndex = 0;
+				recordReader.SerializeIntPacked( pointIndex );
+				state.ActivePathPoint = pathPoints.IsValidIndex( pointIndex ) ? pathPoints[ pointIndex ] : nullptr;
+			}
+
+			if( fields & Field_ActionQueue )
+			{
+				uint32 queueNum = 0;
+				recordReader.SerializeIntPacked( queueNum );
+
+				// every entry takes at least one byte
+				if( queueNum > ( uint32 )( recordEnd - recordStart ) )
+					return;
+
+				state.ActionPointsQueue.Reserve( queueNum );
+				for( uint32 i = 0; i < queueNum; i++ )
+				{
+					uint32 pointIndex = 0;
+					recordReader.SerializeIntPacked( pointIndex );
+					state.ActionPointsQueue.Add( actionPoints.IsValidIndex( ( int32 )pointIndex - 1 ) ? actionPoints[ pointIndex - 1 ] : nullptr );
+				}
+			}
+
+			state.bLoadActionSelector = ( fields & Field_ActionSelector ) != 0;
+			if( state.bLoadActionSelector )
+			{
+				uint32 classIndex = 0;
+				recordReader.SerializeIntPacked( classIndex );
+
+				if( classIndex > 0 )
+				{
+					if( !ReadSelectorData( recordReader, recordsData + recordStart, recordEnd - recordStart, state.ActionSelectorData ) )
+						return;
+
+					state.ActionSelectorClass = selectorClasses.IsValidIndex( classIndex - 1 ) ? selectorClasses[ classIndex - 1 ] : nullptr;
+				}
+			}
+
+			state.bLoadActionSelectorState = ( fields & Field_SelectorState ) != 0;
+			if( state.bLoadActionSelectorState )
+			{
+				if( !ReadSelectorData( recordReader, recordsData + recordStart, recordEnd - recordStart, state.ActionSelectorData ) )
+					return;
+			}
+
+			state.bLoadOwnerTransform = bLoadOwnerTransform && ( fields & Field_OwnerTransform );
+			if( fields & Field_OwnerTransform )
+			{
+				FVector location;
+				FRotator3f rotation;
+				recordReader << location;
+				recordReader << rotation;
+				state.OwnerLocation = location;
+				state.OwnerRotation = FRotator( rotation );
+			}
+
+			if( !recordReader.IsError() )
+			{
+				components[ RecordIndex ] = target->Component;
+			}
+		} );
+
+	// applying state touches actors & behavior tree, so it stays on game thread
+	int32 numLoaded = 0;
+	for( int32 i = 0; i < numRecords; i++ )
+	{
+		if( components[ i ] )
+		{
+			components[ i ]->LoadFromState( states[ i ] );
+			numLoaded++;
+		}
+	}
+
+	if( numLoaded != numRecords )
+	{
+		UE_LOG( LogDAS, Warning, TEXT( "Loaded %d of %d DAS Components from world snapshot, rest of them are no longer in the world" ), numLoaded, numRecords );
+	}
+
+	return numLoaded;
+}
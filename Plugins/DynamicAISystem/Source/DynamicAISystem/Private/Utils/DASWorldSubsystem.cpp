@@ -2,8 +2,12 @@
 
 
 #include "Utils/DASWorldSubsystem.h"
+#include "Components/DASComponent.h"
 #include "Points/DASPathPoint.h"
 #include "Points/DASActionPoint.h"
+#include "Utils/DASPointsReplicator.h"
+#include "Utils/DASDeveloperSettings.h"
+#include "Engine/World.h"
 
 
 
@@ -14,42 +18,99 @@ UDASWorldSubsystem::UDASWorldSubsystem()
 	PathPoints.Reserve( 128 );
 }
 
-ADASPathPoint* UDASWorldSubsystem::FindPathPointById( const FGuid& Id )
+void UDASWorldSubsystem::OnWorldBeginPlay( UWorld& InWorld )
 {
-	ADASPathPoint* ret = nullptr;
+	Super::OnWorldBeginPlay( InWorld );
 
-	// find point by Id
-	ADASPathPoint** result = PathPoints.FindByPredicate( [&Id]( const ADASPathPoint* point )
+	// points of persistent level are registered before begin play, when replicators can't be spawned yet
+	if( ShouldBatchPointsReplication() )
+	{
+		for( ADASActionPoint* actionPoint : ActionPoints )
 		{
-			return ( point && point->PointId == Id );
-		} );
+			AddActionPointToReplicator( actionPoint );
+		}
+	}
+}
+
+bool UDASWorldSubsystem::ShouldBatchPointsReplication() const
+{
+	const UWorld* world = GetWorld();
+	if( !world || !UDASDeveloperSettings::Get()->bBatchActionPointsReplication )
+		return false;
+
+	// replicators are spawned only by server, there is nothing to replicate in standalone
+	const ENetMode netMode = world->GetNetMode();
+	return netMode == NM_DedicatedServer || netMode == NM_ListenServer;
+}
+
+void UDASWorldSubsystem::AddActionPointToReplicator( ADASActionPoint* ActionPoint )
+{
+	// replicator references points by pointer, so only points with stable names ( placed in level ) can be batched
+	// points spawned in runtime keep replicating their state by themselves
+	if( !IsValid( ActionPoint ) || ActionPoint->GetStateReplicator() || !ActionPoint->GetIsReplicated() || !ActionPoint->IsNameStableForNetworking() )
+		return;
+
+	const UDASDeveloperSettings* settings = UDASDeveloperSettings::Get();
+	const FVector location = ActionPoint->GetActorLocation();
+	const FIntPoint cell( FMath::FloorToInt( location.X / settings->PointsReplicationCellSize ), FMath::FloorToInt( location.Y / settings->PointsReplicationCellSize ) );
 
-	// if found, update ret value
-	if( result )
+	ADASPointsReplicator*& replicator = PointsReplicators.FindOrAdd( cell );
+	if( !replicator )
 	{
-		ret = *result;
+		const FVector cellCenter( ( cell.X + 0.5f ) * settings->PointsReplicationCellSize, ( cell.Y + 0.5f ) * settings->PointsReplicationCellSize, location.Z );
+
+		FActorSpawnParameters spawnParams;
+		spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		spawnParams.ObjectFlags |= RF_Transient;
+
+		replicator = GetWorld()->SpawnActor<ADASPointsReplicator>( cellCenter, FRotator::ZeroRotator, spawnParams );
+		if( !replicator )
+		{
+			PointsReplicators.Remove( cell );
+			return;
+		}
+
+		replicator->InitCell( cell, settings->PointsReplicationCellSize, settings->PointsReplicationCullDistance );
 	}
 
-	return ret;
+	replicator->AddPoint( ActionPoint );
+	ActionPoint->SetStateReplicator( replicator );
 }
 
-ADASActionPoint* UDASWorldSubsystem::FindActionPointById( const FGuid& Id )
+void UDASWorldSubsystem::RemoveActionPointFromReplicator( ADASActionPoint* ActionPoint )
 {
-	ADASActionPoint* ret = nullptr;
+	if( ADASPointsReplicator* replicator = ActionPoint ? ActionPoint->GetStateReplicator() : nullptr )
+	{
+		replicator->RemovePoint( ActionPoint );
+		ActionPoint->SetStateReplicator( nullptr );
 
-	// find point by Id
-	ADASActionPoint** result = ActionPoints.FindByPredicate( [&Id]( const ADASActionPoint* point )
+		// cells emptied by unloaded streaming levels would keep replicators relevant to clients for nothing
+		// replicator is spawned again if any point is added to its cell later
+		if( replicator->GetNumPoints() == 0 && PointsReplicators.FindRef( replicator->GetCell() ) == replicator )
 		{
-			return ( point && point->PointId == Id );
-		} );
+			PointsReplicators.Remove( replicator->GetCell() );
 
-	// if found, update ret value
-	if( result )
-	{
-		ret = *result;
+			UWorld* world = GetWorld();
+			if( world && !world->bIsTearingDown )
+			{
+				replicator->Destroy();
+			}
+		}
 	}
+}
 
-	return ret;
+ADASPathPoint* UDASWorldSubsystem::FindPathPointById( const FGuid& Id )
+{
+	// find point by Id
+	ADASPathPoint* const* result = PathPointsById.Find( Id );
+	return result ? *result : nullptr;
+}
+
+ADASActionPoint* UDASWorldSubsystem::FindActionPointById( const FGuid& Id )
+{
+	// find point by Id
+	ADASActionPoint* const* result = ActionPointsById.Find( Id );
+	return result ? *result : nullptr;
 }
 
 ADASPathPoint* UDASWorldSubsystem::FindClosestPathPoint( const FVector& SourceLocation, FGameplayTag PointTag )
@@ -104,22 +165,162 @@ ADASActionPoint* UDASWorldSubsystem::FindClosestActionPoint( const FVector& Sour
 	return retPoint;
 }
 
+void UDASWorldSubsystem::AddDASComponent( UDASComponent* DASComponent )
+{
+	if( !DASComponent || DASComponent->WorldSubsystemIndex != INDEX_NONE )
+		return;
+
+	DASComponent->WorldSubsystemIndex = DASComponents.Add( DASComponent );
+}
+
+void UDASWorldSubsystem::RemoveDASComponent( UDASComponent* DASComponent )
+{
+	if( !DASComponent || !DASComponents.IsValidIndex( DASComponent->WorldSubsystemIndex ) || DASComponents[ DASComponent->WorldSubsystemIndex ] != DASComponent )
+		return;
+
+	// last component takes place of removed one
+	const int32 index = DASComponent->WorldSubsystemIndex;
+	DASComponents.RemoveAtSwap( index, 1, EAllowShrinking::No );
+	if( DASComponents.IsValidIndex( index ) && DASComponents[ index ] )
+	{
+		DASComponents[ index ]->WorldSubsystemIndex = index;
+	}
+	DASComponent->WorldSubsystemIndex = INDEX_NONE;
+}
+
 void UDASWorldSubsystem::AddPathPoint( ADASPathPoint* PathPoint )
 {
 	PathPoints.Add( PathPoint );
+
+	// points spawned in runtime may not have Id, they can't be found by it
+	if( PathPoint && PathPoint->PointId.IsValid() )
+	{
+		PathPointsById.Add( PathPoint->PointId, PathPoint );
+	}
 }
 
 void UDASWorldSubsystem::RemovePathPoint( ADASPathPoint* PathPoint )
 {
 	PathPoints.Remove( PathPoint );
+
+	if( PathPoint && PathPointsById.FindRef( PathPoint->PointId ) == PathPoint )
+	{
+		PathPointsById.Remove( PathPoint->PointId );
+	}
 }
 
 void UDASWorldSubsystem::AddActionPoint( ADASActionPoint* ActionPoint )
 {
 	ActionPoints.Add( ActionPoint );
+
+	// points spawned in runtime may not have Id, they can't be found by it
+	if( ActionPoint && ActionPoint->PointId.IsValid() )
+	{
+		ActionPointsById.Add( ActionPoint->PointId, ActionPoint );
+	}
+
+	if( ActionPoint )
+	{
+		const FIntPoint cell = GetGridCell( ActionPoint->GetActorLocation() );
+		ActionPointsGrid.FindOrAdd( cell ).Add( ActionPoint );
+		ActionPointCells.Add( ActionPoint, cell );
+	}
+
+	// points from streamed levels are registered after begin play
+	if( ActionPoint && GetWorld()->HasBegunPlay() && ShouldBatchPointsReplication() )
+	{
+		AddActionPointToReplicator( ActionPoint );
+	}
 }
 
 void UDASWorldSubsystem::RemoveActionPoint( ADASActionPoint* ActionPoint )
 {
 	ActionPoints.Remove( ActionPoint );
+	RemoveActionPointFromReplicator( ActionPoint );
+
+	if( ActionPoint && ActionPointsById.FindRef( ActionPoint->PointId ) == ActionPoint )
+	{
+		ActionPointsById.Remove( ActionPoint->PointId );
+	}
+
+	FIntPoint cell;
+	if( ActionPointCells.RemoveAndCopyValue( ActionPoint, cell ) )
+	{
+		if( TArray<ADASActionPoint*>* cellPoints = ActionPointsGrid.Find( cell ) )
+		{
+			cellPoints->RemoveSwap( ActionPoint );
+			if( cellPoints->Num() == 0 )
+			{
+				ActionPointsGrid.Remove( cell );
+			}
+		}
+	}
+}
+
+void UDASWorldSubsystem::UpdateActionPointLocation( ADASActionPoint* ActionPoint )
+{
+	FIntPoint* registeredCell = ActionPointCells.Find( ActionPoint );
+	if( !registeredCell )
+		return;
+
+	const FIntPoint newCell = GetGridCell( ActionPoint->GetActorLocation() );
+	if( newCell != *registeredCell )
+	{
+		if( TArray<ADASActionPoint*>* cellPoints = ActionPointsGrid.Find( *registeredCell ) )
+		{
+			cellPoints->RemoveSwap( ActionPoint );
+			if( cellPoints->Num() == 0 )
+			{
+				ActionPointsGrid.Remove( *registeredCell );
+			}
+		}
+
+		ActionPointsGrid.FindOrAdd( newCell ).Add( ActionPoint );
+		*registeredCell = newCell;
+	}
+}
+
+void UDASWorldSubsystem::GatherActionPointsInRadius( const FVector& Location, float Radius, TArray<ADASActionPoint*>& OutActionPoints ) const
+{
+	if( Radius <= 0.f )
+	{
+		OutActionPoints.Append( ActionPoints );
+		return;
+	}
+
+	const FIntPoint minCell = GetGridCell( Location - FVector( Radius ) );
+	const FIntPoint maxCell = GetGridCell( Location + FVector( Radius ) );
+	const int64 numCellsInRadius = int64( maxCell.X - minCell.X + 1 ) * int64( maxCell.Y - minCell.Y + 1 );
+
+	// radius covers more cells than there are occupied, it's cheaper to visit occupied ones
+	if( numCellsInRadius > ActionPointsGrid.Num() )
+	{
+		for( const TPair<FIntPoint, TArray<ADASActionPoint*>>& cellPoints : ActionPointsGrid )
+		{
+			if( cellPoints.Key.X >= minCell.X && cellPoints.Key.X <= maxCell.X &&
+				cellPoints.Key.Y >= minCell.Y && cellPoints.Key.Y <= maxCell.Y )
+			{
+				OutActionPoints.Append( cellPoints.Value );
+			}
+		}
+		return;
+	}
+
+	for( int32 x = minCell.X; x <= maxCell.X; x++ )
+	{
+		for( int32 y = minCell.Y; y <= maxCell.Y; y++ )
+		{
+			if( const TArray<ADASActionPoint*>* cellPoints = ActionPointsGrid.Find( FIntPoint( x, y ) ) )
+			{
+				OutActionPoints.Append( *cellPoints );
+			}
+		}
+	}
+}
+
+FIntPoint UDASWorldSubsystem::GetGridCell( const FVector& Location )
+{
+	return FIntPoint(
+		FMath::FloorToInt( Location.X / ActionPointsGridCellSize ),
+		FMath::FloorToInt( Location.Y / ActionPointsGridCellSize ) );
 }
@@ -0,0 +1,49 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_DASFetchPathActionPoints.generated.h"
+
+
+struct FBTFetchPathActionPointsMemory
+{
+	/** Id of request which result is awaited, results of older requests are ignored */
+	int32 RequestId = 0;
+
+	/** True while ExecuteTask runs, result of request answered right away is returned by ExecuteTask itself */
+	bool bExecuting = false;
+	bool bFinished = false;
+	bool bHadAnyActions = false;
+};
+
+
+class UDASComponent;
+
+/**
+ * Fetches action points of active path point into action points queue of DAS Component, like FetchPathActionPoints
+ * but if path point's selector provides scoring params, task waits until DAS Update Manager scores its request in a batch with other AI
+ * Succeeds if any action points were fetched
+ */
+UCLASS()
+class DYNAMICAISYSTEM_API UBTTask_DASFetchPathActionPoints : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+
+	UBTTask_DASFetchPathActionPoints();
+
+	virtual EBTNodeResult::Type ExecuteTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) override;
+	virtual EBTNodeResult::Type AbortTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) override;
+	virtual void DescribeRuntimeValues( const UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTDescriptionVerbosity::Type Verbosity, TArray<FString>& Values ) const override;
+
+	virtual uint16 GetInstanceMemorySize() const override { return sizeof( FBTFetchPathActionPointsMemory ); }
+
+protected:
+
+	void OnPathActionPointsFetched( bool bHadAnyActions, TWeakObjectPtr<UBehaviorTreeComponent> OwnerComp, int32 RequestId );
+
+	static UDASComponent* FindDASComponent( const UBehaviorTreeComponent& OwnerComp );
+};
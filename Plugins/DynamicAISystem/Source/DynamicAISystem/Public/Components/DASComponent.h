@@ -17,6 +17,7 @@ class ADASPathPoint;
 class ADASActionPoint;
 class ADASPathPoint;
 class UBehaviorTree;
+struct FDASComponentState;
 
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE( FOnInitialized );
@@ -24,6 +25,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams( FOnPathPointChanged, ADASPathPoint
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams( FOnActionPointChanged, ADASActionPoint*, PreviousActionPoint, ADASActionPoint*, NewActionPoint );
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams( FOnPathBehaviorChanged, EDASPathBehavior, PreviousPathBehavior, EDASPathBehavior, NewPathBehavior );
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams( FOnRunModeChanged, EDASRunMode, PreviousRunMode, EDASRunMode, NewRunMode );
+DECLARE_DELEGATE_OneParam( FOnPathActionPointsFetched, bool /* bHadAnyActions */ );
 
 
 /**
@@ -47,6 +49,14 @@ public:
 
 protected:
 	virtual void OnRegister() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
+
+private:
+	friend class UDASWorldSubsystem;
+
+	/** Index of this component in UDASWorldSubsystem::DASComponents, INDEX_NONE if not added */
+	int32 WorldSubsystemIndex = INDEX_NONE;
 	/************************************************************************/
 
 
@@ -87,6 +97,9 @@ public:
 	UFUNCTION( BlueprintCallable, Category = DASComponent )
 	void SetInitialPathPoint( ADASPathPoint* NewPathPoint );
 
+	/** Returns true if action selector was changed in runtime, so it differs from the one set in level */
+	bool WasActionSelectorOverridden() const { return bActionSelectorOverridden; }
+
 protected:
 	/** Called when RunMode is changed */
 	UFUNCTION( BlueprintImplementableEvent, Category = DASComponent )
@@ -95,6 +108,9 @@ protected:
 	/** Called when action selector is changed */
 	UFUNCTION( BlueprintImplementableEvent, Category = DASComponent )
 	void ActionSelectorChanged( UDASActionSelector* NewActionSelector );
+
+	/** Flag telling if action selector was changed by SetActionSelector, only then it has to be saved */
+	uint32 bActionSelectorOverridden : 1;
 	/************************************************************************/
 
 
@@ -134,6 +150,9 @@ public:
 	UFUNCTION( BlueprintCallable, Category = DASComponent )
 	void LoadFromSnapshot( const FDASComponentSnapshot& Snapshot, bool bLoadOwnerTransform = true );
 
+	/** Loads state with already resolved points, used by LoadFromSnapshot & DAS world snapshot */
+	void LoadFromState( const FDASComponentState& State );
+
 protected:
 	/** Flag telling if DAS Component was already initialized */
 	UPROPERTY( ReplicatedUsing = "OnRep_IsInitialized", BlueprintReadOnly, Category = DASComponent )
@@ -275,6 +294,67 @@ public:
 
 
 
+	/************************************************************************/
+	/*							DECISION UPDATE								*/
+	/************************************************************************/
+public:
+	/**
+	 * Re-evaluates state of active points ( conditions, cooldown of action point ) and refreshes blackboard keys
+	 * only if their value has changed, then fetches action points requested by behavior tree
+	 * Called by DAS Update Manager within its frame budget, how often depends on significance of owner,
+	 * changed conditions and fetch requests ask for update in next tick
+	 * @param DeltaTime - time since last decision update
+	 */
+	virtual void UpdateDecisions( float DeltaTime );
+
+protected:
+	/**
+	 * Event called on decision update
+	 * Called only if implemented in blueprint, to not pay for blueprint call on every component
+	 */
+	UFUNCTION( BlueprintImplementableEvent, Category = DASComponent, meta = ( DisplayName = "Update Decisions" ) )
+	void ReceiveUpdateDecisions( float DeltaTime );
+
+	/** Registers/unregisters this component in DAS Update Manager of its world */
+	void SetRegisteredToUpdateManager( bool bRegister );
+
+	/**
+	 * Asks DAS Update Manager to run decision update in next tick, within its frame budget
+	 * @return false if component isn't registered in update manager, work has to be done right away then
+	 */
+	bool RequestDecisionUpdate();
+
+	/** Bound to condition of active path point, re-evaluation is left to next decision update */
+	UFUNCTION()
+	void OnPathPointConditionChanged( bool bIsConditionFulfilled );
+
+	/** Bound to condition of active action point, re-evaluation is left to next decision update */
+	UFUNCTION()
+	void OnActionPointConditionChanged( bool bIsConditionFulfilled );
+
+	/** Fetch requested by RequestPathActionPoints, executed in next decision update */
+	FOnPathActionPointsFetched PendingPathActionPointsFetch;
+
+	/** Path point which was active when PendingPathActionPointsFetch was requested */
+	TWeakObjectPtr<ADASPathPoint> PendingFetchPathPoint;
+
+	/** Set during UpdateDecisions, conditions changed by it don't need another update */
+	uint32 bIsUpdatingDecisions : 1;
+
+	/** Flag telling if blueprint implements ReceiveUpdateDecisions, cached on registering to update manager */
+	uint32 bHasBlueprintDecisionUpdate : 1;
+
+	/** Last value passed to CanRunActionPoint bb key, used to avoid redundant blackboard updates */
+	uint32 bLastCanRunActionPoint : 1;
+
+	/** Last value passed to CanRunPathPoint bb key, used to avoid redundant blackboard updates */
+	uint32 bLastCanRunPathPoint : 1;
+	/************************************************************************/
+
+
+
+
+
 	/************************************************************************/
 	/*								PATH POINT								*/
 	/************************************************************************/
@@ -347,6 +427,16 @@ public:
 	UFUNCTION( BlueprintCallable, Category = DASComponent, meta = ( ReturnDisplayName = "HadAnyActions" ))
 	bool FetchPathActionPoints();
 
+	/**
+	 * Same as FetchPathActionPoints, but selectors providing scoring params are scored by DAS Update Manager
+	 * in one parallel batch with requests of other AI, and OnFetched is called when batch is processed
+	 * Other selectors are run in next decision update of this component, or right away if there is no update manager
+	 */
+	void RequestPathActionPoints( FOnPathActionPointsFetched OnFetched );
+
+	/** Action selector of active path point, if its actions should be executed in current direction along path */
+	UDASActionSelector* GetPathActionSelectorToExecute() const;
+
 protected:
 	/** Called when active path point changes */
 	UFUNCTION( BlueprintImplementableEvent, Category = DASComponent )
@@ -529,6 +619,7 @@ protected:
 /**
  * Visualizer component used only by DASComponent
  * Takes care of calling its debug logic
+ * In editor it ticks only while its owner is selected, debug of unselected components is never drawn there
  */
 UCLASS()
 class DYNAMICAISYSTEM_API UDASVisComponent : public UPrimitiveComponent
@@ -540,5 +631,15 @@ public:
 
 	virtual void TickComponent( float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction ) override;
 	UDASComponent* DASComponent;
+
+protected:
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+
+	/** Enables tick in editor world only if owner is selected */
+	void UpdateEditorTick( UObject* ChangedSelection = nullptr );
+
+	FDelegateHandle SelectionChangedHandle;
+	FDelegateHandle SelectObjectHandle;
 };
 /************************************************************************/
\ No newline at end of file
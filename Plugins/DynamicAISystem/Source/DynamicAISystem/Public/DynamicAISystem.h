@@ -6,6 +6,7 @@
 #include "Modules/ModuleManager.h"
 
 DECLARE_LOG_CATEGORY_EXTERN( LogDAS, Log, All );
+DECLARE_STATS_GROUP( TEXT( "DAS" ), STATGROUP_DAS, STATCAT_Advanced );
 
 class FDynamicAISystemModule : public IModuleInterface
 {
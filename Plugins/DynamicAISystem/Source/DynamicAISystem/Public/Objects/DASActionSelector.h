@@ -6,6 +6,8 @@
 #include "UObject/NoExportTypes.h"
 #include "DASActionSelector.generated.h"
 
+struct FDASActionPointScoringParams;
+
 /**
  * Object which is used for selecting ActionPoints
  */
@@ -25,7 +27,13 @@ public:
 	 */
 	UFUNCTION( BlueprintNativeEvent, BlueprintCallable, Category = PathAction )
 	void GetActionPointsToExecute( TArray< ADASActionPoint* >& OutActionPoints, UDASComponent* DASComponent );
-	void GetActionPointsToExecute_Implementation( TArray< ADASActionPoint* >& OutActionPoints, UDASComponent* DASComponent ) {};
+	virtual void GetActionPointsToExecute_Implementation( TArray< ADASActionPoint* >& OutActionPoints, UDASComponent* DASComponent ) {};
+
+	/**
+	 * Selectors picking points purely by score fill OutParams and return true
+	 * their query is then scored in one parallel batch with queries of other AI by DAS Update Manager, see UDASComponent::RequestPathActionPoints
+	 */
+	virtual bool GetScoringParams( UDASComponent* DASComponent, FDASActionPointScoringParams& OutParams ) const { return false; }
 
 
 	UFUNCTION( BlueprintNativeEvent, BlueprintCallable, Category = Debug, meta = ( DevelopmentOnly ) )
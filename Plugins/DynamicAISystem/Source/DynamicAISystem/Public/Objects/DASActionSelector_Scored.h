@@ -0,0 +1,30 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Objects/DASActionSelector.h"
+#include "Utils/DASTypes.h"
+#include "DASActionSelector_Scored.generated.h"
+
+/**
+ * Selects best scored action points around path point owning this selector
+ * Scoring runs natively, batched with other AI in DAS Update Manager when fetched through UDASComponent::RequestPathActionPoints
+ */
+UCLASS( BlueprintType, Blueprintable, EditInlineNew, DefaultToInstanced, meta = ( DisplayName = "DAS Action Selector Best Scored" ) )
+class DYNAMICAISYSTEM_API UDASActionSelector_Scored : public UDASActionSelector
+{
+	GENERATED_BODY()
+public:
+
+	/** Scoring of points, SourceLocation is replaced by location of path point or AI */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = ActionSelector )
+	FDASActionPointScoringParams ScoringParams;
+
+	/** If true, distance is measured from path point owning this selector, otherwise from AI */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = ActionSelector )
+	bool bScoreFromPathPoint = true;
+
+	virtual void GetActionPointsToExecute_Implementation( TArray< ADASActionPoint* >& OutActionPoints, UDASComponent* DASComponent ) override;
+	virtual bool GetScoringParams( UDASComponent* DASComponent, FDASActionPointScoringParams& OutParams ) const override;
+};
@@ -11,6 +11,7 @@
 
 
 class UDASComponent;
+class ADASPointsReplicator;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FOnIsTakenChanged, bool, bNewIsTaken );
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FOnIsExecutingChanged, bool, bNewIsExecuting );
@@ -42,10 +43,14 @@ protected:
 
 public:
 	virtual bool CanRun_Implementation() override;
-	virtual void DrawDebug( float DeltaTime, bool bIsInEditor ) override;
+	virtual void GatherDebugPrimitives( FDASDebugPrimitives& Primitives, float AnimationTime ) const override;
 	virtual void GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const override;
 	virtual void PostInitializeComponents() override;
 	virtual void RefreshInstancedObjects() override;
+
+protected:
+	/** Keeps movable point in its current cell of DAS Subsystem grid, so it is found by scoring after being moved in runtime */
+	void OnRootTransformUpdated( USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport );
 	/************************************************************************/
 
 
@@ -197,6 +202,36 @@ protected:
 
 
 
+
+	/************************************************************************/
+	/*							STATE REPLICATION							*/
+	/************************************************************************/
+public:
+	/**
+	 * Sets replicator which replicates taken/executing state instead of this point
+	 * Point stays dormant then and state changes don't wake it up
+	 */
+	void SetStateReplicator( ADASPointsReplicator* NewStateReplicator ) { StateReplicator = NewStateReplicator; }
+
+	/** Returns replicator of this point state, nullptr if point replicates its state by itself */
+	ADASPointsReplicator* GetStateReplicator() const { return StateReplicator; }
+
+	/** Applies state received by DAS Points Replicator on client, calls OnRep events of changed values */
+	void ApplyReplicatedState( bool bNewIsTaken, bool bNewIsExecuting );
+
+protected:
+	/** Replicator of state of this point, server only */
+	UPROPERTY( Transient )
+	ADASPointsReplicator* StateReplicator = nullptr;
+
+	/** Sends changed state to clients, either through replicator or by waking up this point */
+	void NotifyStateChanged();
+	/************************************************************************/
+
+
+
+
+
 	/************************************************************************/
 	/*						CANCEL ON CONDITION FAIL LOGIC		            */
 	/************************************************************************/
@@ -251,6 +286,9 @@ public:
 	UFUNCTION( BlueprintCallable, BlueprintPure, Category = DASActionPoint )
 	float GetCooldownRemainingTime() const;
 
+	/** Returns world time at which cooldown ends, allows to check many points against single cached world time */
+	FORCEINLINE float GetCooldownEndWorldTime() const { return CooldownEndWorldTime; }
+
 protected:
 	/**
 	 * World time telling when this action point cooldown will end
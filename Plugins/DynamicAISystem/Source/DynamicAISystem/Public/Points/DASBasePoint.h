@@ -11,6 +11,7 @@
 
 
 class UDASConditionsWrapper;
+struct FDASDebugPrimitives;
 
 
 
@@ -35,6 +36,12 @@ public:
 	virtual void PostDuplicate( EDuplicateMode::Type DuplicateMode ) override;
 	virtual void PostActorCreated() override;
 
+#if WITH_EDITOR
+	virtual void PostEditMove( bool bFinished ) override;
+	virtual void PostEditChangeProperty( struct FPropertyChangedEvent& PropertyChangedEvent ) override;
+	virtual void PostEditUndo() override;
+#endif
+
 protected:
 	virtual void BeginPlay() override;
 	/************************************************************************/
@@ -126,8 +133,24 @@ public:
 	UFUNCTION( BlueprintCallable, Category = Settings, meta = ( DevelopmentOnly ) )
 	virtual void RefreshInstancedObjects();
 
+	/**
+	 * Appends lines showing this point ( location, links etc. )
+	 * Used by DrawDebug in runtime and by DAS Debug Render Subsystem in editor
+	 * @param AnimationTime - time used to animate arrows, negative means arrows are static
+	 */
+	virtual void GatherDebugPrimitives( FDASDebugPrimitives& Primitives, float AnimationTime ) const;
+
+	/**
+	 * Returns true if point has debug logic which can't be batched ( blueprint DrawDebug, condition query )
+	 * so it still needs to call DrawDebug every tick
+	 */
+	virtual bool HasCustomDebug() const;
+
+	/** Tells DAS Debug Render Subsystem that debug lines of this point have to be rebuilt */
+	void MarkDebugDirty();
+
 	/** Helper function to visualize point location */
-	void DrawDebugPoint( UWorld* world, const FVector& SpotLocation, const FRotator& SpotRotation, float DeltaTime );
+	void AddDebugPoint( FDASDebugPrimitives& Primitives, const FVector& SpotLocation, const FRotator& SpotRotation ) const;
 
 	/** Editor only component, just visual representation of point in world */
 	UPROPERTY( VisibleDefaultsOnly, BlueprintReadOnly, Category = Components )
@@ -157,5 +180,9 @@ class DYNAMICAISYSTEM_API UDASPointVisComponent : public UPrimitiveComponent
 public:
 	UDASPointVisComponent();
 	virtual void TickComponent( float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction ) override;
+
+protected:
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
 };
 /************************************************************************/
\ No newline at end of file
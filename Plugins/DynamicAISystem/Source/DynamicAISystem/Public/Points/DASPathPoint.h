@@ -35,6 +35,8 @@ public:
 
 	virtual void ValidateData_Implementation();
 	virtual void DrawDebug( float DeltaTime, bool bIsInEditor ) override;
+	virtual void GatherDebugPrimitives( FDASDebugPrimitives& Primitives, float AnimationTime ) const override;
+	virtual bool HasCustomDebug() const override;
 	virtual void RefreshInstancedObjects() override;
 
 protected:
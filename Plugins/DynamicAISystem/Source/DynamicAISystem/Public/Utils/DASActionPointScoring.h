@@ -0,0 +1,75 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utils/DASTypes.h"
+
+class ADASActionPoint;
+class UDASComponent;
+class UWorld;
+
+
+/**
+ * Candidates of single selection request, stored as structure of arrays
+ * so scoring pass runs over tightly packed floats and can be vectorized by compiler
+ */
+struct DYNAMICAISYSTEM_API FDASActionPointCandidates
+{
+	TArray<ADASActionPoint*> Points;
+	TArray<float> LocationX;
+	TArray<float> LocationY;
+	TArray<float> LocationZ;
+	TArray<float> CooldownRemaining;
+	TArray<float> TagWeight;
+	TArray<float> TakenMask;	// 1 if taken, 0 if free, float to keep scoring loop branchless
+	TArray<float> Scores;
+
+	int32 Num() const { return Points.Num(); }
+	void Reset( int32 ExpectedNum );
+	void Add( ADASActionPoint* Point, const FVector& Location, float InCooldownRemaining, float InTagWeight, bool bIsTaken );
+};
+
+
+/**
+ * Single request of action point selection, usually one per AI
+ */
+struct DYNAMICAISYSTEM_API FDASActionPointSelectionRequest
+{
+	FDASActionPointScoringParams Params;
+
+	/** Optional, AI that requested selection, it never gets its own active point filtered out as taken */
+	TWeakObjectPtr<UDASComponent> DASComponent;
+
+	/** Best points, sorted from highest score */
+	TArray<ADASActionPoint*> Result;
+
+	/** Internal data, filled when request is processed */
+	FDASActionPointCandidates Candidates;
+};
+
+
+/**
+ * Native scoring pipeline of action points
+ * 1. candidates are gathered on game thread from spatial grid of DAS World Subsystem
+ * 2. candidates are scored in a single branchless pass over SoA data
+ * 3. best K points are picked with bounded heap, without sorting all of candidates
+ * Steps 2 and 3 of many requests run in parallel
+ */
+struct DYNAMICAISYSTEM_API FDASActionPointScoring
+{
+	/** Processes all requests, must be called on game thread */
+	static void ProcessRequests( UWorld* World, TArrayView<FDASActionPointSelectionRequest> Requests );
+
+	/** Helper processing single request */
+	static void SelectActionPoints( UWorld* World, const FDASActionPointScoringParams& Params, TArray<ADASActionPoint*>& OutActionPoints, UDASComponent* DASComponent = nullptr );
+
+	/** Gathers candidates of request, reads actors so must be called on game thread */
+	static void GatherCandidates( UWorld* World, FDASActionPointSelectionRequest& Request );
+
+	/** Calculates scores of gathered candidates, thread safe */
+	static void ScoreCandidates( const FDASActionPointScoringParams& Params, FDASActionPointCandidates& Candidates );
+
+	/** Picks indices of K best scored candidates, sorted from highest score, thread safe */
+	static void SelectTopK( const FDASActionPointCandidates& Candidates, int32 K, TArray<int32>& OutIndices );
+};
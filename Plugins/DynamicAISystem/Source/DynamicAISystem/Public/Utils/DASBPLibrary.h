@@ -10,6 +10,7 @@
 
 class ADASPathPoint;
 class ADASActionPoint;
+class UDASComponent;
 
 /**
  * Library which includes bunch of helpful functions used across the system
@@ -76,6 +77,40 @@ public:
 	 */
 	UFUNCTION( BlueprintCallable, Category = DASLibrary )
 	static void SortPathPointsByDistance( const TArray<ADASPathPoint*>& ArrayToSort, TArray<ADASPathPoint*>& SortedArray, FVector SourceLocation, bool bInverse );
+
+	/**
+	 * Selects best action points near source location using native scoring
+	 * ( distance, cooldown remaining, tag weights, taken state )
+	 * Much cheaper than filtering & sorting all points, because only points from nearby grid cells are checked
+	 * and only best MaxResults of them are ordered
+	 * @param DASComponent - optional, AI selecting points, its own active point is not treated as taken
+	 */
+	UFUNCTION( BlueprintCallable, Category = DASLibrary, meta = ( WorldContext = "WorldContextObject" ) )
+	static void SelectBestActionPoints( UObject* WorldContextObject, const FDASActionPointScoringParams& Params, TArray<ADASActionPoint*>& OutActionPoints, UDASComponent* DASComponent = nullptr );
+	/************************************************************************/
+
+
+
+
+
+	/************************************************************************/
+	/*							WORLD SNAPSHOT								*/
+	/************************************************************************/
+public:
+	/**
+	 * Saves state of all DAS Components in the world into one compact binary blob
+	 * Much faster than calling GetSnapshot on every component, should be preferred for many AI
+	 */
+	UFUNCTION( BlueprintCallable, Category = DASLibrary, meta = ( WorldContext = "WorldContextObject" ) )
+	static bool SaveDASWorldSnapshot( UObject* WorldContextObject, TArray<uint8>& OutData );
+
+	/**
+	 * Loads state of DAS Components from data saved by SaveDASWorldSnapshot
+	 * Components are matched by their names, so it should be called after level was loaded
+	 * @return number of loaded components, -1 if data is invalid
+	 */
+	UFUNCTION( BlueprintCallable, Category = DASLibrary, meta = ( WorldContext = "WorldContextObject" ) )
+	static int32 LoadDASWorldSnapshot( UObject* WorldContextObject, const TArray<uint8>& Data, bool bLoadOwnerTransform = true );
 	/************************************************************************/
 
 
@@ -0,0 +1,145 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DASDebugRenderer.generated.h"
+
+class ADASBasePoint;
+
+
+/** Single debug line */
+struct FDASDebugLine
+{
+	FVector Start;
+	FVector End;
+	FColor Color;
+	float Thickness;
+};
+
+
+/**
+ * Debug shapes of points, built as plain lines
+ * Drawn either by DrawDebug functions ( in runtime ) or batched by DAS Debug Render Subsystem ( in editor )
+ */
+struct DYNAMICAISYSTEM_API FDASDebugPrimitives
+{
+	TArray<FDASDebugLine> Lines;
+
+	void Reset() { Lines.Reset(); }
+
+	void AddLine( const FVector& Start, const FVector& End, const FColor& Color, float Thickness );
+
+	/** Same shape as DrawDebugDirectionalArrow */
+	void AddArrow( const FVector& Start, const FVector& End, float ArrowSize, const FColor& Color, float Thickness );
+
+	/** Same shape as DrawDebugSphere */
+	void AddSphere( const FVector& Center, float Radius, int32 Segments, const FColor& Color, float Thickness );
+
+	/** Draws all lines with DrawDebugLine */
+	void Draw( UWorld* World, float LifeTime ) const;
+};
+
+
+/** Lines of all points in single cell of debug grid */
+struct FDASDebugCell
+{
+	TArray<FDASDebugLine> Lines;
+	FBox Bounds = FBox( ForceInit );
+};
+
+
+/**
+ * Primitive component drawing debug lines of all points in the world in one scene proxy
+ * Lines are split into cells, culled on render thread by view frustum and DrawDebugMaxDistance
+ */
+UCLASS( Transient )
+class DYNAMICAISYSTEM_API UDASDebugRenderComponent : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDASDebugRenderComponent();
+
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+	virtual FBoxSphereBounds CalcBounds( const FTransform& LocalToWorld ) const override;
+
+	/** Replaces lines of given cells, cells without lines are removed */
+	void UpdateCells( TMap<FIntPoint, FDASDebugCell>&& ChangedCells );
+
+protected:
+	/** Copy of cells on game thread, used to recreate scene proxy */
+	TMap<FIntPoint, FDASDebugCell> Cells;
+};
+
+
+/**
+ * Editor world manager of points debug drawing
+ * Replaces per-point DrawDebug ticking in editor, debug lines of point are rebuilt only when point or its links were changed
+ * Points that still have custom debug logic ( blueprint DrawDebug, conditions, selectors ) keep ticking only for it
+ */
+UCLASS()
+class DYNAMICAISYSTEM_API UDASDebugRenderSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/************************************************************************/
+	/*							PARENT OVERRIDES							*/
+	/************************************************************************/
+	virtual bool ShouldCreateSubsystem( UObject* Outer ) const override;
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickableInEditor() const override { return true; }
+	/************************************************************************/
+
+public:
+	/** Called by point visualizer component when it gets registered */
+	void RegisterPoint( ADASBasePoint* Point );
+
+	/** Called by point visualizer component when it gets unregistered */
+	void UnregisterPoint( ADASBasePoint* Point );
+
+	/** Rebuilds debug of point & all path points linked to it in next tick */
+	void MarkPointDirty( ADASBasePoint* Point );
+
+	/** Returns true if debug of given point is drawn by this subsystem */
+	bool IsPointRegistered( const ADASBasePoint* Point ) const { return PointCells.Contains( Point ); }
+
+protected:
+	/** Size of single cell of debug grid */
+	static constexpr float CellSize = 5000.f;
+
+	UPROPERTY( Transient )
+	UDASDebugRenderComponent* RenderComponent = nullptr;
+
+	/** Points by cell of debug grid */
+	TMap<FIntPoint, TArray<TWeakObjectPtr<ADASBasePoint>>> CellPoints;
+
+	/** Cell in which each point was placed */
+	TMap<const ADASBasePoint*, FIntPoint> PointCells;
+
+	/** Next & previous path points of each registered path point, as they were when it was last marked dirty */
+	TMap<const ADASBasePoint*, TArray<const ADASBasePoint*>> PointLinks;
+
+	/** Registered path points linking to given point, their lines end at its location */
+	TMap<const ADASBasePoint*, TArray<const ADASBasePoint*>> LinkedBy;
+
+	/** Points that changed since last tick */
+	TSet<TWeakObjectPtr<ADASBasePoint>> DirtyPoints;
+
+	/** Cells that need to be rebuilt in next tick */
+	TSet<FIntPoint> DirtyCells;
+
+	static FIntPoint GetCell( const FVector& Location );
+
+	/** Refreshes links of point in PointLinks & LinkedBy, nullptr path point removes them */
+	void UpdatePointLinks( const ADASBasePoint* Point, const ADASPathPoint* PathPoint );
+
+	/** Moves dirty points to their current cells, then rebuilds lines of all dirty cells */
+	void RebuildDirtyCells();
+};
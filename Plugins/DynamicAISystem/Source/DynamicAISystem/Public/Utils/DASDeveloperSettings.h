@@ -41,6 +41,72 @@ public:
 	UPROPERTY( EditAnywhere, config, Category = "Debug" )
 	FColor ActionPointsDebugColor = FColor::Purple;
 
+	/**
+	 * Should debug of points in editor be drawn by single batched renderer
+	 * instead of every point drawing its debug every frame
+	 * Requires reopening level to take effect
+	 */
+	UPROPERTY( EditAnywhere, config, Category = "Debug" )
+	uint32 bUseBatchedDebugRenderer : 1;
+
+	/**
+	 * Should DAS Components register to update manager
+	 * which runs their decision updates within frame budget
+	 */
+	UPROPERTY( EditAnywhere, config, Category = "Update Manager" )
+	uint32 bUseUpdateManager : 1;
+
+	/** Max time in milliseconds that decision updates of all DAS Components can take in single frame */
+	UPROPERTY( EditAnywhere, config, Category = "Update Manager", meta = ( ClampMin = 0.01f, EditCondition = "bUseUpdateManager" ) )
+	float UpdateBudgetMs = 0.5f;
+
+	/** Distance to view below which AI is treated as highly significant */
+	UPROPERTY( EditAnywhere, config, Category = "Update Manager", meta = ( ClampMin = 0.f, EditCondition = "bUseUpdateManager" ) )
+	float HighSignificanceDistance = 2500.f;
+
+	/** Distance to view below which AI is treated as medium significant, above it AI is low significant */
+	UPROPERTY( EditAnywhere, config, Category = "Update Manager", meta = ( ClampMin = 0.f, EditCondition = "bUseUpdateManager" ) )
+	float MediumSignificanceDistance = 8000.f;
+
+	/**
+	 * Distance to view above which decision updates are skipped completely
+	 * 0 means there is no limit
+	 */
+	UPROPERTY( EditAnywhere, config, Category = "Update Manager", meta = ( ClampMin = 0.f, EditCondition = "bUseUpdateManager" ) )
+	float DormantDistance = 0.f;
+
+	/** Min time between decision updates of highly significant AI, 0 means every frame */
+	UPROPERTY( EditAnywhere, config, Category = "Update Manager", meta = ( ClampMin = 0.f, EditCondition = "bUseUpdateManager" ) )
+	float HighSignificanceInterval = 0.f;
+
+	/** Min time between decision updates of medium significant AI */
+	UPROPERTY( EditAnywhere, config, Category = "Update Manager", meta = ( ClampMin = 0.f, EditCondition = "bUseUpdateManager" ) )
+	float MediumSignificanceInterval = 0.25f;
+
+	/** Min time between decision updates of low significant AI */
+	UPROPERTY( EditAnywhere, config, Category = "Update Manager", meta = ( ClampMin = 0.f, EditCondition = "bUseUpdateManager" ) )
+	float LowSignificanceInterval = 1.f;
+
+	/** How many components get their significance recalculated per frame */
+	UPROPERTY( EditAnywhere, config, Category = "Update Manager", meta = ( ClampMin = 1, EditCondition = "bUseUpdateManager" ) )
+	int32 SignificanceUpdatesPerFrame = 64;
+
+	/**
+	 * Should state of action points placed in level be replicated in batches by DAS Points Replicators ( one per grid cell )
+	 * instead of every action point replicating by itself
+	 * Points stay dormant then and clients receive state only of cells close to them
+	 */
+	UPROPERTY( EditAnywhere, config, Category = "Replication" )
+	uint32 bBatchActionPointsReplication : 1;
+
+	/** Size of single cell of replication grid, each cell has its own replicator */
+	UPROPERTY( EditAnywhere, config, Category = "Replication", meta = ( ClampMin = 100.f, EditCondition = "bBatchActionPointsReplication" ) )
+	float PointsReplicationCellSize = 10000.f;
+
+	/** Distance from cell at which clients stop receiving state of its points */
+	UPROPERTY( EditAnywhere, config, Category = "Replication", meta = ( ClampMin = 0.f, EditCondition = "bBatchActionPointsReplication" ) )
+	float PointsReplicationCullDistance = 15000.f;
+
 	/** Returns default object of this class */
 	static const UDASDeveloperSettings* Get() { return GetDefault<UDASDeveloperSettings>(); }
 };
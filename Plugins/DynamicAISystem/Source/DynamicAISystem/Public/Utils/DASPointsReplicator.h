@@ -0,0 +1,95 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "DASPointsReplicator.generated.h"
+
+class ADASActionPoint;
+
+
+/**
+ * Replicates state ( taken/executing ) of all action points placed in one cell of replication grid
+ * Points registered in replicator stay dormant, so server doesn't consider thousands of point actors for every connection,
+ * only one replicator per cell, which is relevant only to connections close enough to it
+ * Replicator itself is dormant and wakes up only when state of any of its points changes
+ * Spawned on server by DAS World Subsystem
+ */
+UCLASS( NotBlueprintable, NotPlaceable, Transient )
+class DYNAMICAISYSTEM_API ADASPointsReplicator : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ADASPointsReplicator();
+
+	/************************************************************************/
+	/*							PARENT OVERRIDES							*/
+	/************************************************************************/
+public:
+	virtual void GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const override;
+	/************************************************************************/
+
+
+
+
+
+	/************************************************************************/
+	/*								POINTS									*/
+	/************************************************************************/
+public:
+	/** Sets cell of this replicator and how far from it connections receive its state, must be called before adding points */
+	void InitCell( const FIntPoint& InCell, float CellSize, float CullDistance );
+
+	/** Returns cell of replication grid this replicator belongs to */
+	const FIntPoint& GetCell() const { return Cell; }
+
+	/** Starts replicating state of given point through this replicator */
+	void AddPoint( ADASActionPoint* Point );
+
+	/** Stops replicating state of given point */
+	void RemovePoint( ADASActionPoint* Point );
+
+	/** Called by point when its state has changed, replication is flushed once per frame for all changed points */
+	void MarkPointDirty( ADASActionPoint* Point );
+
+	/** Returns number of points in this replicator */
+	int32 GetNumPoints() const { return PointIndices.Num(); }
+
+protected:
+	/** Points of this cell, replicated only when point is added or removed */
+	UPROPERTY( ReplicatedUsing = "OnRep_PointsState" )
+	TArray<ADASActionPoint*> Points;
+
+	/**
+	 * State of points, same indices as Points
+	 * two bits per point ( taken, executing ), so only changed bytes are sent
+	 */
+	UPROPERTY( ReplicatedUsing = "OnRep_PointsState" )
+	TArray<uint8> StateBits;
+
+	/** Cell of replication grid, server only */
+	FIntPoint Cell = FIntPoint::ZeroValue;
+
+	/** Index of each point in Points array, server only */
+	TMap<const ADASActionPoint*, int32> PointIndices;
+
+	/** Is flush of state already scheduled for next tick */
+	uint32 bFlushScheduled : 1;
+
+	/** Applies replicated state to points on client */
+	UFUNCTION()
+	void OnRep_PointsState();
+
+	/** Writes current state of point into StateBits */
+	void WritePointState( int32 Index, const ADASActionPoint* Point );
+
+	/** Marks replicated properties dirty & wakes replicator up, so changes are sent */
+	void FlushState();
+
+	static constexpr int32 PointsPerByte = 4;
+	static constexpr uint8 TakenBit = 1 << 0;
+	static constexpr uint8 ExecutingBit = 1 << 1;
+	/************************************************************************/
+};
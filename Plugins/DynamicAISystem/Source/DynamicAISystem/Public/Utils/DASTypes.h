@@ -247,5 +247,67 @@ struct DYNAMICAISYSTEM_API FDASComponentSnapshot
 	uint32 bHasNewPathPoint : 1;
 };
 
+/**
+ * Weight added to score of action point matching given tag
+ * used by native action point scoring
+ */
+USTRUCT( BlueprintType )
+struct DYNAMICAISYSTEM_API FDASTagWeight
+{
+	GENERATED_BODY()
+
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = DASTagWeight )
+	FGameplayTag Tag;
+
+	/** Added to score of point if its tag matches, negative values make point less preferred */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = DASTagWeight )
+	float Weight = 1.f;
+};
 
 
+/**
+ * Parameters of native action point scoring
+ * Points are gathered from spatial grid of DAS World Subsystem, scored and only best K of them are returned
+ * Higher score is better
+ */
+USTRUCT( BlueprintType )
+struct DYNAMICAISYSTEM_API FDASActionPointScoringParams
+{
+	GENERATED_BODY()
+
+	/** Location from which distance to points is measured */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = DASActionPointScoring )
+	FVector SourceLocation = FVector::ZeroVector;
+
+	/** Only points within this radius are considered, 0 means all points in the world */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = DASActionPointScoring, meta = ( ClampMin = 0.f ) )
+	float Radius = 2000.f;
+
+	/** Max number of returned points ( K ) */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = DASActionPointScoring, meta = ( ClampMin = 1 ) )
+	int32 MaxResults = 1;
+
+	/** If valid, only points matching this tag are considered */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = DASActionPointScoring )
+	FGameplayTag RequiredTag;
+
+	/** Score penalty per unit of distance, normalized by radius ( or 1000 units if radius is 0 ) */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = DASActionPointScoring )
+	float DistanceWeight = 1.f;
+
+	/** Score penalty per second of remaining cooldown */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = DASActionPointScoring )
+	float CooldownWeight = 1.f;
+
+	/** Weights added to points matching tags */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = DASActionPointScoring )
+	TArray<FDASTagWeight> TagWeights;
+
+	/** Should points taken by other AI be excluded? */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = DASActionPointScoring )
+	bool bExcludeTaken = true;
+
+	/** Should points on cooldown be excluded? if not, they are only penalized by CooldownWeight */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = DASActionPointScoring )
+	bool bExcludeOnCooldown = false;
+};
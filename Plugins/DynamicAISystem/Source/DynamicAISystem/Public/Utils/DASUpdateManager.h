@@ -0,0 +1,185 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Utils/DASActionPointScoring.h"
+#include "DASUpdateManager.generated.h"
+
+class UDASComponent;
+class ADASActionPoint;
+
+/** Delegate called when queued action point selection was processed */
+DECLARE_DELEGATE_OneParam( FOnActionPointsSelected, const TArray<ADASActionPoint*>& );
+
+
+/**
+ * Significance bucket of DAS Component
+ * defines how often its decision update is allowed to run
+ */
+UENUM( BlueprintType )
+enum class EDASUpdateSignificance : uint8
+{
+	High		UMETA( ToolTip = "Close to view or recently rendered, updated as often as possible" ),
+	Medium		UMETA( ToolTip = "In mid range, updated with medium interval" ),
+	Low			UMETA( ToolTip = "Far away and not visible, updated rarely" ),
+	Dormant		UMETA( ToolTip = "Beyond max distance, decision updates are skipped" )
+};
+
+
+/**
+ * Counters of last frame processed by update manager
+ */
+USTRUCT( BlueprintType )
+struct DYNAMICAISYSTEM_API FDASUpdateManagerStats
+{
+	GENERATED_BODY()
+
+	/** Number of components which had decision update executed */
+	UPROPERTY( BlueprintReadOnly, Category = DASUpdateManager )
+	int32 NumUpdated = 0;
+
+	/** Number of components which were not due yet ( interval not elapsed ) or are dormant */
+	UPROPERTY( BlueprintReadOnly, Category = DASUpdateManager )
+	int32 NumSkipped = 0;
+
+	/** Number of components which were due, but didn't fit into frame budget and were moved to next frame */
+	UPROPERTY( BlueprintReadOnly, Category = DASUpdateManager )
+	int32 NumDeferred = 0;
+
+	/** Time spent on decision updates in milliseconds */
+	UPROPERTY( BlueprintReadOnly, Category = DASUpdateManager )
+	float UsedTimeMs = 0.f;
+};
+
+
+/**
+ * World level manager of DAS Components decision updates
+ * Buckets registered components by significance ( distance to view, visibility )
+ * and runs their updates round-robin, within frame time budget defined in DAS developer settings
+ */
+UCLASS()
+class DYNAMICAISYSTEM_API UDASUpdateManager : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/************************************************************************/
+	/*							PARENT OVERRIDES							*/
+	/************************************************************************/
+	virtual bool ShouldCreateSubsystem( UObject* Outer ) const override;
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+	/************************************************************************/
+
+
+
+
+
+	/************************************************************************/
+	/*							REGISTRATION								*/
+	/************************************************************************/
+public:
+	/** Called by DAS Component when it gets initialized */
+	void RegisterComponent( UDASComponent* Component );
+
+	/** Called by DAS Component when it gets reset or removed from the world */
+	void UnregisterComponent( UDASComponent* Component );
+
+	/**
+	 * Runs decision update of component in next tick regardless of its significance, still within frame budget
+	 * Used for work triggered by behavior tree or delegates ( goal selection, condition re-evaluation )
+	 * @return false if component isn't registered, caller has to do the work right away then
+	 */
+	bool RequestDecisionUpdate( UDASComponent* Component );
+
+	/** Returns number of currently registered components */
+	UFUNCTION( BlueprintCallable, BlueprintPure, Category = DASUpdateManager )
+	int32 GetNumRegisteredComponents() const { return Entries.Num(); }
+
+	/** Returns significance that was last calculated for given component */
+	UFUNCTION( BlueprintCallable, BlueprintPure, Category = DASUpdateManager )
+	EDASUpdateSignificance GetComponentSignificance( const UDASComponent* Component ) const;
+
+	/** Returns counters of last processed frame */
+	UFUNCTION( BlueprintCallable, BlueprintPure, Category = DASUpdateManager )
+	const FDASUpdateManagerStats& GetLastFrameStats() const { return LastFrameStats; }
+	/************************************************************************/
+
+
+
+
+
+	/************************************************************************/
+	/*						ACTION POINT SELECTION							*/
+	/************************************************************************/
+public:
+	/**
+	 * Queues action point selection, processed at the beginning of next update manager tick
+	 * together with requests of all other AI, scoring of all of them runs in parallel
+	 */
+	void RequestActionPointSelection( const FDASActionPointScoringParams& Params, UDASComponent* DASComponent, FOnActionPointsSelected OnSelected );
+
+protected:
+	/** Selection requests waiting for next tick */
+	TArray<FDASActionPointSelectionRequest> PendingSelectionRequests;
+
+	/** Callbacks of pending requests, same indices as in PendingSelectionRequests */
+	TArray<FOnActionPointsSelected> PendingSelectionCallbacks;
+
+	/** Processes all pending selection requests in one batch */
+	void ProcessPendingSelectionRequests();
+	/************************************************************************/
+
+protected:
+	/** Data of single registered component */
+	struct FEntry
+	{
+		TWeakObjectPtr<UDASComponent> Component;
+
+		/** Component this entry was registered for, key in EntryIndices even after component is gone */
+		const UDASComponent* Key = nullptr;
+
+		/** World time of last executed decision update */
+		double LastUpdateTime = 0.0;
+
+		EDASUpdateSignificance Significance = EDASUpdateSignificance::High;
+
+		/** Update was requested, it runs in next tick no matter the interval */
+		bool bUpdateRequested = false;
+	};
+
+	/** All registered components, iterated round-robin */
+	TArray<FEntry> Entries;
+
+	/** Index in Entries of each registered component */
+	TMap<const UDASComponent*, int32> EntryIndices;
+
+	/** Index of entry from which processing will start in next frame */
+	int32 UpdateCursor = 0;
+
+	/** Index of entry from which significance will be recalculated in next frame */
+	int32 SignificanceCursor = 0;
+
+	/** View locations cached at the beginning of the frame */
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+
+	/** GFrameCounter of frame in which ViewLocations were cached */
+	uint64 ViewLocationsFrame = MAX_uint64;
+
+	FDASUpdateManagerStats LastFrameStats;
+
+	/** Gathers locations of cameras/players that significance is calculated against, once per frame */
+	void CacheViewLocations();
+
+	/** Recalculates significance of given entry */
+	void UpdateSignificance( FEntry& Entry ) const;
+
+	/** Returns min time between decision updates for given significance, negative means never */
+	static float GetUpdateInterval( EDASUpdateSignificance Significance );
+
+	/** Swap-removes entries with invalid components, keeping cursors in range */
+	void CompactEntries();
+};
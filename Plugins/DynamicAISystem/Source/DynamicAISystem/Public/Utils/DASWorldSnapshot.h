@@ -0,0 +1,83 @@
+// Copyright (C) 2022 Grzegorz Szewczyk - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utils/DASTypes.h"
+
+class UDASComponent;
+class UDASActionSelector;
+class ADASPathPoint;
+class ADASActionPoint;
+class UWorld;
+
+
+/**
+ * State of DAS Component with already resolved references to points
+ * Filled from FDASComponentSnapshot or from compact world snapshot and applied by UDASComponent::LoadFromState
+ */
+struct DYNAMICAISYSTEM_API FDASComponentState
+{
+	EDASRunMode RunMode = EDASRunMode::ExecutePathPoints;
+
+	ADASPathPoint* ActivePathPoint = nullptr;
+
+	TArray<ADASActionPoint*> ActionPointsQueue;
+
+	/** If false, current action selector of component is kept */
+	bool bLoadActionSelector = true;
+
+	/** Class of selector to recreate, nullptr clears selector */
+	UClass* ActionSelectorClass = nullptr;
+
+	/** Data of selector saved with FDASSaveGameArchive, points into memory owned by caller */
+	TArrayView<const uint8> ActionSelectorData;
+
+	/** If true and selector is kept, ActionSelectorData is loaded into current selector of component */
+	bool bLoadActionSelectorState = false;
+
+	bool bWasMovingForward = true;
+	bool bWasReturningToPathPoint = false;
+	bool bHasNewPathPoint = false;
+
+	bool bLoadOwnerTransform = true;
+	FVector OwnerLocation = FVector::ZeroVector;
+	FRotator OwnerRotation = FRotator::ZeroRotator;
+};
+
+
+/**
+ * Versioned binary snapshot of all DAS Components in the world, stored in one contiguous blob
+ *
+ * Layout:
+ * - header ( magic, version, sizes of tables )
+ * - table of point Ids, records reference points by index in this table
+ * - table of owner names, used to match records with components on load
+ * - table of action selector classes
+ * - offsets of records, so they can be decoded in parallel
+ * - records, each starts with mask of fields written, fields equal to class defaults are skipped
+ *
+ * Loading resolves point table once, decodes records in parallel and applies them on game thread
+ */
+struct DYNAMICAISYSTEM_API FDASWorldSnapshot
+{
+	enum class EVersion : uint32
+	{
+		Initial = 1,
+		SelectorState = 2,			// SaveGame state of selectors which weren't overridden
+
+		// add new versions above
+		VersionPlusOne,
+		Latest = VersionPlusOne - 1
+	};
+
+	/** Saves all DAS Components registered in DAS World Subsystem */
+	static bool Save( UWorld* World, TArray<uint8>& OutData );
+
+	/**
+	 * Loads components saved by Save
+	 * Records of components that are no longer in the world are skipped
+	 * @return number of loaded components, INDEX_NONE if data is invalid
+	 */
+	static int32 Load( UWorld* World, const TArray<uint8>& Data, bool bLoadOwnerTransform = true );
+};
@@ -8,6 +8,8 @@
 
 class ADASPathPoint;
 class ADASActionPoint;
+class UDASComponent;
+class ADASPointsReplicator;
 
 /**
  * Globally accessible system
@@ -21,6 +23,8 @@ class DYNAMICAISYSTEM_API UDASWorldSubsystem : public UWorldSubsystem
 public:
 	UDASWorldSubsystem();
 
+	virtual void OnWorldBeginPlay( UWorld& InWorld ) override;
+
 
 
 
@@ -54,12 +58,81 @@ public:
 
 	/** function called by action point when its being destroyed to remove its reference */
 	void RemoveActionPoint( ADASActionPoint* ActionPoint );
+
+	/**
+	 * All DAS Components that are currently in the world
+	 * Used to save/load state of all of them at once
+	 */
+	UPROPERTY( BlueprintReadOnly, Category = DASWorldSubsystem )
+	TArray< UDASComponent* > DASComponents;
+
+	/** function called by DAS Component when it begins play to cache its reference */
+	void AddDASComponent( UDASComponent* DASComponent );
+
+	/**
+	 * function called by DAS Component when it ends play to remove its reference
+	 * Components keep their index in DASComponents, so removing is O(1), but order of array is not preserved
+	 */
+	void RemoveDASComponent( UDASComponent* DASComponent );
+
+	/**
+	 * Appends action points from spatial grid cells overlapping given radius
+	 * Returned points may lie slightly outside of radius, exact distance is up to caller
+	 * @param Radius - 0 or less returns all action points
+	 */
+	void GatherActionPointsInRadius( const FVector& Location, float Radius, TArray<ADASActionPoint*>& OutActionPoints ) const;
+
+	/**
+	 * Moves action point to its current grid cell
+	 * Called by movable action points whenever they are moved, grid uses location from registration otherwise
+	 */
+	void UpdateActionPointLocation( ADASActionPoint* ActionPoint );
+
+protected:
+	/** Path points by their Id, to find them without iterating all of them */
+	TMap<FGuid, ADASPathPoint*> PathPointsById;
+
+	/** Action points by their Id, to find them without iterating all of them */
+	TMap<FGuid, ADASActionPoint*> ActionPointsById;
+
+	/** Size of single cell of action points spatial grid */
+	static constexpr float ActionPointsGridCellSize = 1000.f;
+
+	/** Action points bucketed by 2D grid cell, used to gather points near location without checking all of them */
+	TMap<FIntPoint, TArray<ADASActionPoint*>> ActionPointsGrid;
+
+	/** Cell in which each action point was registered */
+	TMap<const ADASActionPoint*, FIntPoint> ActionPointCells;
+
+	/** Returns grid cell of given location */
+	static FIntPoint GetGridCell( const FVector& Location );
 	/************************************************************************/
 
 
 
 
+	/************************************************************************/
+	/*						ACTION POINTS REPLICATION						*/
+	/************************************************************************/
+protected:
+	/** Replicators of action points state by cell of replication grid, server only */
+	UPROPERTY( Transient )
+	TMap<FIntPoint, ADASPointsReplicator*> PointsReplicators;
+
+	/** Returns true if this world should replicate state of action points through replicators */
+	bool ShouldBatchPointsReplication() const;
 
+	/** Moves replication of point state to replicator of its cell, if point can be referenced over network */
+	void AddActionPointToReplicator( ADASActionPoint* ActionPoint );
+
+	/** Removes point from its replicator */
+	void RemoveActionPointFromReplicator( ADASActionPoint* ActionPoint );
+	/************************************************************************/
+
+
+
+
+public:
 	/** Returns path point in the world by given Id ( if there is any ) */
 	UFUNCTION( BlueprintCallable, Category = DASWorldSubsystem )
 	ADASPathPoint* FindPathPointById( const FGuid& Id );
@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeBatchSolver.h"
+
+#include "CubeOptimalSolver.h"
+#include "CubeTwoPhaseSolver.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace CubeBatchSolverImpl
+{
+using FClock = std::chrono::steady_clock;
+}
+
+using namespace CubeBatchSolverImpl;
+
+struct FCubeBatchSolver::FJob
+{
+	FCubeSolveJob Desc;
+	FClock::time_point Start;
+	FCubeSearchLimits Limits;
+
+	std::atomic<bool> bCancelled{false};
+	/** Set by cancellation or by a found optimal solution, stops every search of the job */
+	std::atomic<bool> bStop{false};
+	std::atomic<uint64_t> Nodes{0};
+
+	/** Optimal search, subtrees of the iteration with Bound are searched by separate tasks */
+	int32_t Bound = 0;
+	std::vector<FCubeOptimalSolver::FSubtree> Subtrees;
+	std::atomic<size_t> PendingSubtrees{0};
+
+	std::mutex Mutex;
+	bool bSolved = false;
+	std::vector<ECubeMove> Moves;
+};
+
+FCubeBatchSolver::FCubeBatchSolver(const FCubeTwoPhaseSolver* InTwoPhase, const FCubeOptimalSolver* InOptimal, int32_t ThreadCount,
+                                   FOnResult InOnResult)
+	: TwoPhase(InTwoPhase)
+	, Optimal(InOptimal)
+	, OnResult(std::move(InOnResult))
+	, Pool(ThreadCount)
+{
+}
+
+bool FCubeBatchSolver::Submit(const FCubeSolveJob& Job)
+{
+	const bool bHasSolver = Job.Method == ECubeSolveMethod::TwoPhase ? TwoPhase != nullptr : Optimal != nullptr;
+	if (!bHasSolver) return false;
+
+	const std::shared_ptr<FJob> NewJob = std::make_shared<FJob>();
+	NewJob->Desc = Job;
+	{
+		std::lock_guard<std::mutex> Lock(JobsMutex);
+		Jobs[Job.Id] = NewJob;
+	}
+	Pool.Submit([this, NewJob]() { StartJob(NewJob); });
+	return true;
+}
+
+void FCubeBatchSolver::Cancel(uint64_t Id)
+{
+	std::lock_guard<std::mutex> Lock(JobsMutex);
+	const auto Found = Jobs.find(Id);
+	if (Found != Jobs.end())
+	{
+		Found->second->bCancelled = true;
+		Found->second->bStop = true;
+	}
+}
+
+void FCubeBatchSolver::CancelAll()
+{
+	std::lock_guard<std::mutex> Lock(JobsMutex);
+	for (const auto& [Id, Job] : Jobs)
+	{
+		Job->bCancelled = true;
+		Job->bStop = true;
+	}
+}
+
+void FCubeBatchSolver::Wait()
+{
+	Pool.Wait();
+}
+
+void FCubeBatchSolver::StartJob(const std::shared_ptr<FJob>& Job)
+{
+	Job->Start = FClock::now();
+	if (Job->Desc.TimeLimit > 0.0)
+	{
+		Job->Limits.Deadline = Job->Start + std::chrono::duration_cast<FClock::duration>(std::chrono::duration<double>(Job->Desc.TimeLimit));
+	}
+	Job->Limits.Cancel = &Job->bStop;
+
+	if (Job->bStop)
+	{
+		FinishJob(Job);
+	}
+	else if (Job->Desc.Method == ECubeSolveMethod::TwoPhase)
+	{
+		SolveTwoPhase(Job);
+	}
+	else
+	{
+		Job->Bound = Optimal->GetLowerBound(Job->Desc.State);
+		StartOptimalIteration(Job);
+	}
+}
+
+void FCubeBatchSolver::SolveTwoPhase(const std::shared_ptr<FJob>& Job)
+{
+	FCubeTwoPhaseOptions Options;
+	Options.Deadline = Job->Limits.Deadline;
+	Options.Cancel = Job->Limits.Cancel;
+	Options.TargetLength = Job->Desc.TargetLength;
+
+	FCubeTwoPhaseStats Stats;
+	Job->bSolved = TwoPhase->Solve(Job->Desc.State, Job->Moves, Options, &Stats);
+	Job->Nodes = Stats.Nodes;
+	FinishJob(Job);
+}
+
+void FCubeBatchSolver::StartOptimalIteration(const std::shared_ptr<FJob>& Job)
+{
+	if (Job->bStop || Job->Bound > FCubeOptimalSolver::MaxSolutionLength || FClock::now() >= Job->Limits.Deadline)
+	{
+		FinishJob(Job);
+		return;
+	}
+
+	uint64_t Nodes = 0;
+	Job->Subtrees = Optimal->SplitSearch(Job->Desc.State, Job->Bound, OptimalSplitDepth, Nodes);
+	Job->Nodes += Nodes;
+	if (Job->Subtrees.empty())
+	{
+		++Job->Bound;
+		StartOptimalIteration(Job);
+		return;
+	}
+
+	// Last subtree may start the next iteration before this loop ends, so the count is read once
+	const size_t SubtreeCount = Job->Subtrees.size();
+	Job->PendingSubtrees = SubtreeCount;
+	for (size_t Subtree = 0; Subtree < SubtreeCount; ++Subtree)
+	{
+		Pool.Submit([this, Job, Subtree]() { SearchOptimalSubtree(Job, Subtree); });
+	}
+}
+
+void FCubeBatchSolver::SearchOptimalSubtree(const std::shared_ptr<FJob>& Job, size_t Subtree)
+{
+	if (!Job->bStop)
+	{
+		std::vector<ECubeMove> Moves;
+		uint64_t Nodes = 0;
+		if (Optimal->SearchSubtree(Job->Subtrees[Subtree], Job->Bound, Moves, Nodes, Job->Limits))
+		{
+			// Every solution of an iteration is optimal, the first one wins
+			std::lock_guard<std::mutex> Lock(Job->Mutex);
+			if (!Job->bSolved)
+			{
+				Job->bSolved = true;
+				Job->Moves = std::move(Moves);
+				Job->bStop = true;
+			}
+		}
+		Job->Nodes += Nodes;
+	}
+
+	if (--Job->PendingSubtrees == 0)
+	{
+		if (Job->bSolved)
+		{
+			FinishJob(Job);
+		}
+		else
+		{
+			++Job->Bound;
+			StartOptimalIteration(Job);
+		}
+	}
+}
+
+void FCubeBatchSolver::FinishJob(const std::shared_ptr<FJob>& Job)
+{
+	FCubeSolveResult Result;
+	Result.Id = Job->Desc.Id;
+	Result.Nodes = Job->Nodes;
+	Result.Seconds = std::chrono::duration<double>(FClock::now() - Job->Start).count();
+	if (Job->bSolved)
+	{
+		Result.Status = ECubeSolveStatus::Solved;
+		Result.Moves = std::move(Job->Moves);
+	}
+	else if (Job->bCancelled)
+	{
+		Result.Status = ECubeSolveStatus::Cancelled;
+	}
+	else if (FClock::now() >= Job->Limits.Deadline)
+	{
+		Result.Status = ECubeSolveStatus::TimedOut;
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(JobsMutex);
+		const auto Found = Jobs.find(Result.Id);
+		if (Found != Jobs.end() && Found->second == Job)
+		{
+			Jobs.erase(Found);
+		}
+	}
+	if (OnResult) OnResult(Result);
+}
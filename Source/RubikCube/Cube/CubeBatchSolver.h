@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CubeState.h"
+#include "CubeTaskPool.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class FCubeOptimalSolver;
+class FCubeTwoPhaseSolver;
+
+enum class ECubeSolveMethod : uint8_t
+{
+	/** Short solution, searched until TargetLength or the time limit */
+	TwoPhase,
+	/** Shortest solution */
+	Optimal
+};
+
+enum class ECubeSolveStatus : uint8_t
+{
+	Solved,
+	NotFound,
+	TimedOut,
+	Cancelled
+};
+
+struct FCubeSolveJob
+{
+	/** Identifies the job in its result and in Cancel, should be unique among jobs in flight */
+	uint64_t Id = 0;
+	FCubeState State;
+	ECubeSolveMethod Method = ECubeSolveMethod::TwoPhase;
+	/** Seconds the job may run after a worker starts it, 0 for no limit */
+	double TimeLimit = 0.0;
+	/** Two-phase search stops at the first solution of at most this many moves */
+	int32_t TargetLength = 20;
+};
+
+struct FCubeSolveResult
+{
+	uint64_t Id = 0;
+	ECubeSolveStatus Status = ECubeSolveStatus::NotFound;
+	/** Best solution found, also for two-phase jobs stopped by their time limit */
+	std::vector<ECubeMove> Moves;
+	uint64_t Nodes = 0;
+	/** Time from start of the job to its result */
+	double Seconds = 0.0;
+};
+
+/**
+ * Solves many states on a work-stealing pool, all workers share the read-only tables of the solvers.
+ * Two-phase jobs are a task each. Optimal jobs split every IDA* iteration into subtrees of OptimalSplitDepth moves,
+ * which idle workers steal, and the last subtree of an iteration queues the next one.
+ * Results are reported as jobs finish, from worker threads.
+ */
+class FCubeBatchSolver
+{
+public:
+	using FOnResult = std::function<void(const FCubeSolveResult& Result)>;
+
+	static constexpr int32_t OptimalSplitDepth = 2;
+
+	/** Either solver may be null, jobs of its method are refused then. OnResult must be thread safe. */
+	FCubeBatchSolver(const FCubeTwoPhaseSolver* InTwoPhase, const FCubeOptimalSolver* InOptimal, int32_t ThreadCount, FOnResult InOnResult);
+
+	/** Queues Job, returns false when there is no solver for its method */
+	bool Submit(const FCubeSolveJob& Job);
+
+	/** Stops job Id, it reports Cancelled unless it has already finished */
+	void Cancel(uint64_t Id);
+	void CancelAll();
+
+	/** Blocks until every submitted job has reported its result */
+	void Wait();
+
+	int32_t GetThreadCount() const { return Pool.GetThreadCount(); }
+
+private:
+	struct FJob;
+
+	void StartJob(const std::shared_ptr<FJob>& Job);
+	void SolveTwoPhase(const std::shared_ptr<FJob>& Job);
+	/** Splits the current optimal iteration of Job and queues its subtrees */
+	void StartOptimalIteration(const std::shared_ptr<FJob>& Job);
+	void SearchOptimalSubtree(const std::shared_ptr<FJob>& Job, size_t Subtree);
+	void FinishJob(const std::shared_ptr<FJob>& Job);
+
+	const FCubeTwoPhaseSolver* TwoPhase;
+	const FCubeOptimalSolver* Optimal;
+	FOnResult OnResult;
+
+	std::mutex JobsMutex;
+	std::unordered_map<uint64_t, std::shared_ptr<FJob>> Jobs;
+
+	/** Declared last, so its threads finish their tasks before the other members go away */
+	FCubeTaskPool Pool;
+};
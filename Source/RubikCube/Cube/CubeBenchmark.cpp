@@ -0,0 +1,600 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeBenchmark.h"
+
+#include "CubeBatchSolver.h"
+#include "CubeCanonical.h"
+#include "CubeNxN.h"
+#include "CubeOptimalSolver.h"
+#include "CubeReductionSolver.h"
+#include "CubeScrambler.h"
+#include "CubeSession.h"
+#include "CubeState.h"
+#include "CubeTranspositionTable.h"
+#include "CubeTwoPhaseSolver.h"
+#include "CubeVector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <atomic>
+#include <map>
+#include <random>
+
+namespace CubeBenchmarkImpl
+{
+using FClock = std::chrono::steady_clock;
+
+static double GetSecondsSince(FClock::time_point Start)
+{
+	return std::chrono::duration<double>(FClock::now() - Start).count();
+}
+
+static std::vector<ECubeMove> MakeRandomMoves(size_t Count, uint32_t Seed)
+{
+	std::mt19937 Random(Seed);
+	std::uniform_int_distribution<int32_t> Distribution(0, CubeMoveCount - 1);
+
+	std::vector<ECubeMove> Moves(Count);
+	for (ECubeMove& Move : Moves)
+	{
+		Move = static_cast<ECubeMove>(Distribution(Random));
+	}
+	return Moves;
+}
+
+/** Scramble without turns of the same face in a row, so its length is close to its distance */
+static std::vector<ECubeMove> MakeScramble(int32_t Length, std::mt19937& Random)
+{
+	// Random walk this long gives practically uniformly distributed states
+	static constexpr int32_t RandomStateLength = 100;
+
+	std::uniform_int_distribution<int32_t> Distribution(0, CubeMoveCount - 1);
+	std::vector<ECubeMove> Moves;
+	while (static_cast<int32_t>(Moves.size()) < (Length > 0 ? Length : RandomStateLength))
+	{
+		const ECubeMove Move = static_cast<ECubeMove>(Distribution(Random));
+		if (!Moves.empty() && GetMoveFace(Moves.back()) == GetMoveFace(Move)) continue;
+		Moves.push_back(Move);
+	}
+	return Moves;
+}
+
+static uint64_t HashMoves(const std::vector<ECubeMove>& Moves)
+{
+	uint64_t Hash = 0xCBF29CE484222325ull;
+	for (const ECubeMove Move : Moves)
+	{
+		Hash = (Hash ^ static_cast<uint8_t>(Move)) * 0x100000001B3ull;
+	}
+	return Hash;
+}
+
+/** Random turns of any layer of a cube of Size */
+static std::vector<FCubeLayerMove> MakeLayerMoves(int32_t Size, size_t Count, std::mt19937& Random)
+{
+	std::uniform_int_distribution<int32_t> Face(0, 5);
+	std::uniform_int_distribution<int32_t> Layer(0, Size - 1);
+	std::uniform_int_distribution<int32_t> Turns(1, 3);
+
+	std::vector<FCubeLayerMove> Moves(Count);
+	for (FCubeLayerMove& Move : Moves)
+	{
+		Move = {static_cast<ECubeFace>(Face(Random)), static_cast<uint8_t>(Layer(Random)), static_cast<uint8_t>(Turns(Random))};
+	}
+	return Moves;
+}
+
+static uint64_t HashLayerMoves(const std::vector<FCubeLayerMove>& Moves)
+{
+	uint64_t Hash = 0xCBF29CE484222325ull;
+	for (const FCubeLayerMove& Move : Moves)
+	{
+		Hash = (Hash ^ (static_cast<uint32_t>(Move.Face) << 16 | Move.Layer << 8 | Move.Turns)) * 0x100000001B3ull;
+	}
+	return Hash;
+}
+
+enum class ETranspositionKey : uint8_t
+{
+	State,
+	Symmetry,
+	SymmetryAndInverse
+};
+
+/** Depth limited search that skips subtrees already searched at least as deep, from this state or one with the same key */
+struct FTranspositionSearch
+{
+	FCubeTranspositionTable& Table;
+	ETranspositionKey Key;
+	uint64_t Nodes = 0;
+	uint64_t Probes = 0;
+	uint64_t Hits = 0;
+
+	void Search(const FCubeVector& State, int32_t Depth, int32_t LastFace)
+	{
+		++Nodes;
+		if (Depth == 0) return;
+
+		const uint64_t Hash = Key == ETranspositionKey::State ? HashCubeVector(State)
+			: CanonicalizeCube(State, Key == ETranspositionKey::SymmetryAndInverse).Hash();
+		uint8_t StoredDepth = 0;
+		uint32_t Value = 0;
+		++Probes;
+		if (Table.Probe(Hash, StoredDepth, Value) && StoredDepth >= Depth)
+		{
+			++Hits;
+			return;
+		}
+
+		// Turns of one face are merged, and of two opposite faces only one order is searched
+		for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+		{
+			const int32_t Face = Move / 3;
+			if (Face == LastFace || (LastFace >= 0 && Face == LastFace - 3)) continue;
+			Search(State.Apply(static_cast<ECubeMove>(Move)), Depth - 1, Face);
+		}
+		Table.Store(Hash, static_cast<uint8_t>(Depth), 0);
+	}
+};
+}
+
+using namespace CubeBenchmarkImpl;
+
+std::vector<FCubeBenchmarkResult> BenchmarkMoveApplication(uint64_t MoveCount, uint32_t Seed)
+{
+	// Sequence is replayed in chunks, so huge counts don't need huge buffers
+	const size_t ChunkSize = static_cast<size_t>(std::min<uint64_t>(MoveCount, 1 << 16));
+	const std::vector<ECubeMove> Moves = MakeRandomMoves(ChunkSize, Seed);
+	const uint64_t Rounds = ChunkSize > 0 ? MoveCount / ChunkSize : 0;
+
+	std::vector<FCubeBenchmarkResult> Results;
+	{
+		FCubeBenchmarkResult& Result = Results.emplace_back();
+		Result.Name = "Packed";
+		Result.Items = Rounds * ChunkSize;
+
+		FCubeState State = FCubeState::Solved();
+		const FClock::time_point Start = FClock::now();
+		for (uint64_t Round = 0; Round < Rounds; ++Round)
+		{
+			for (const ECubeMove Move : Moves)
+			{
+				State = State.Apply(Move);
+			}
+		}
+		Result.Seconds = GetSecondsSince(Start);
+		Result.Checksum = State.Hash();
+	}
+
+	for (int32_t Level = 0; Level <= static_cast<int32_t>(GetSupportedSimdLevel()); ++Level)
+	{
+		FCubeBenchmarkResult& Result = Results.emplace_back();
+		Result.Name = std::string("Vector ") + ToString(static_cast<ECubeSimdLevel>(Level));
+		Result.Items = Rounds * ChunkSize;
+
+		FCubeVector State = FCubeVector::Solved();
+		const FClock::time_point Start = FClock::now();
+		for (uint64_t Round = 0; Round < Rounds; ++Round)
+		{
+			ApplyMoves(State, Moves.data(), Moves.size(), static_cast<ECubeSimdLevel>(Level));
+		}
+		Result.Seconds = GetSecondsSince(Start);
+		Result.Checksum = State.ToState().Hash();
+	}
+	return Results;
+}
+
+std::vector<FCubeBenchmarkResult> BenchmarkOptimalSolver(const FCubeOptimalSolver& Solver, int32_t StateCount, int32_t ScrambleLength,
+                                                         uint32_t Seed)
+{
+	std::mt19937 Random(Seed);
+	std::vector<FCubeBenchmarkResult> Results;
+	FCubeBenchmarkResult Total;
+	Total.Name = "Total";
+
+	for (int32_t Index = 0; Index < StateCount; ++Index)
+	{
+		const FCubeState State = FCubeState::Solved().Apply(MakeScramble(ScrambleLength, Random));
+
+		std::vector<ECubeMove> Solution;
+		FCubeSolveStats Stats;
+		const bool bSolved = Solver.Solve(State, Solution, &Stats) && State.Apply(Solution).IsSolved();
+
+		FCubeBenchmarkResult& Result = Results.emplace_back();
+		Result.Name = "State " + std::to_string(Index) + ": " + (bSolved ? std::to_string(Solution.size()) + " moves" : "not solved");
+		Result.Items = Stats.Nodes;
+		Result.Seconds = Stats.Seconds;
+		Result.Checksum = HashMoves(Solution);
+
+		Total.Items += Result.Items;
+		Total.Seconds += Result.Seconds;
+		Total.Checksum ^= Result.Checksum;
+	}
+	Results.push_back(Total);
+	return Results;
+}
+
+std::vector<FCubeBenchmarkResult> BenchmarkTwoPhaseSolver(const FCubeTwoPhaseSolver& Solver, int32_t StateCount, int32_t TargetLength,
+                                                          double SecondsPerState, uint32_t Seed)
+{
+	std::mt19937 Random(Seed);
+	FCubeBenchmarkResult Solves{"Solves"};
+	FCubeBenchmarkResult FirstSolutions{"First solutions"};
+	FCubeBenchmarkResult Nodes{"Nodes"};
+	FCubeBenchmarkResult Failures{"Not solved"};
+	std::map<size_t, FCubeBenchmarkResult> Lengths;
+
+	for (int32_t Index = 0; Index < StateCount; ++Index)
+	{
+		const FCubeState State = FCubeState::Solved().Apply(MakeScramble(0, Random));
+
+		FCubeTwoPhaseOptions Options;
+		Options.TargetLength = TargetLength;
+		Options.Deadline = FClock::now() + std::chrono::duration_cast<FClock::duration>(std::chrono::duration<double>(SecondsPerState));
+
+		std::vector<ECubeMove> Solution;
+		FCubeTwoPhaseStats Stats;
+		const bool bSolved = Solver.Solve(State, Solution, Options, &Stats) && State.Apply(Solution).IsSolved();
+
+		FCubeBenchmarkResult& Result = bSolved ? Lengths[Solution.size()] : Failures;
+		if (Result.Name.empty()) Result.Name = std::to_string(Solution.size()) + " moves";
+		++Result.Items;
+		Result.Seconds += Stats.Seconds;
+		Result.Checksum ^= HashMoves(Solution);
+
+		++Solves.Items;
+		Solves.Seconds += Stats.Seconds;
+		Solves.Checksum ^= HashMoves(Solution);
+		FirstSolutions.Items += bSolved;
+		FirstSolutions.Seconds += Stats.FirstSolutionSeconds;
+		Nodes.Items += Stats.Nodes;
+		Nodes.Seconds += Stats.Seconds;
+	}
+
+	std::vector<FCubeBenchmarkResult> Results = {Solves, FirstSolutions, Nodes};
+	for (const auto& [Length, Result] : Lengths)
+	{
+		Results.push_back(Result);
+	}
+	if (Failures.Items > 0)
+	{
+		Results.push_back(Failures);
+	}
+	return Results;
+}
+
+std::vector<FCubeBenchmarkResult> BenchmarkBatchSolver(const FCubeTwoPhaseSolver* TwoPhase, const FCubeOptimalSolver* Optimal,
+                                                       const FCubeSolveJob& JobTemplate, int32_t StateCount, int32_t ScrambleLength,
+                                                       int32_t MaxThreadCount, uint32_t Seed)
+{
+	std::mt19937 Random(Seed);
+	std::vector<FCubeState> States;
+	for (int32_t Index = 0; Index < StateCount; ++Index)
+	{
+		States.push_back(FCubeState::Solved().Apply(MakeScramble(ScrambleLength, Random)));
+	}
+
+	std::vector<int32_t> ThreadCounts;
+	for (int32_t ThreadCount = 1; ThreadCount < MaxThreadCount; ThreadCount *= 2)
+	{
+		ThreadCounts.push_back(ThreadCount);
+	}
+	ThreadCounts.push_back(std::max(MaxThreadCount, 1));
+
+	std::vector<FCubeBenchmarkResult> Results;
+	for (const int32_t ThreadCount : ThreadCounts)
+	{
+		// Results arrive in any order, so the checksum only combines them order independently
+		std::atomic<uint64_t> Solved{0};
+		std::atomic<uint64_t> Checksum{0};
+		const auto OnResult = [&](const FCubeSolveResult& Result)
+		{
+			if (Result.Status == ECubeSolveStatus::Solved && States[Result.Id].Apply(Result.Moves).IsSolved())
+			{
+				++Solved;
+				Checksum ^= HashMoves(Result.Moves);
+			}
+		};
+
+		const FClock::time_point Start = FClock::now();
+		{
+			FCubeBatchSolver Solver(TwoPhase, Optimal, ThreadCount, OnResult);
+			for (int32_t Index = 0; Index < StateCount; ++Index)
+			{
+				FCubeSolveJob Job = JobTemplate;
+				Job.Id = static_cast<uint64_t>(Index);
+				Job.State = States[Index];
+				Solver.Submit(Job);
+			}
+			Solver.Wait();
+		}
+
+		FCubeBenchmarkResult& Result = Results.emplace_back();
+		Result.Name = std::to_string(ThreadCount) + (ThreadCount == 1 ? " thread" : " threads");
+		Result.Items = Solved;
+		Result.Seconds = GetSecondsSince(Start);
+		Result.Checksum = Checksum;
+	}
+	return Results;
+}
+
+std::vector<FCubeBenchmarkResult> BenchmarkCubeSizes(const FCubeTwoPhaseSolver& Solver, int32_t MinSize, int32_t MaxSize, uint64_t MoveCount,
+                                                     int32_t SolveCount, uint32_t Seed)
+{
+	std::mt19937 Random(Seed);
+	const FCubeReductionSolver Reduction(Solver);
+	std::vector<FCubeBenchmarkResult> Results;
+	for (int32_t Size = std::max(MinSize, FCubeNxN::MinSize); Size <= std::min(MaxSize, FCubeNxN::MaxSize); ++Size)
+	{
+		const std::string Prefix = std::to_string(Size) + "x" + std::to_string(Size) + " ";
+		{
+			const size_t ChunkSize = static_cast<size_t>(std::min<uint64_t>(MoveCount, 1 << 16));
+			const std::vector<FCubeLayerMove> Moves = MakeLayerMoves(Size, ChunkSize, Random);
+			const uint64_t Rounds = ChunkSize > 0 ? MoveCount / ChunkSize : 0;
+
+			FCubeNxN Cube(Size);
+			const FClock::time_point Start = FClock::now();
+			for (uint64_t Round = 0; Round < Rounds; ++Round)
+			{
+				Cube.Apply(Moves);
+			}
+
+			FCubeBenchmarkResult& Result = Results.emplace_back();
+			Result.Name = Prefix + "turns";
+			Result.Items = Rounds * ChunkSize;
+			Result.Seconds = GetSecondsSince(Start);
+			for (const uint8_t Sticker : Cube.GetStickers())
+			{
+				Result.Checksum = (Result.Checksum ^ Sticker) * 0x100000001B3ull;
+			}
+		}
+		{
+			const FClock::time_point Start = FClock::now();
+			const FCubeReductionTables& Tables = FCubeReductionTables::Get(Size);
+
+			FCubeBenchmarkResult& Result = Results.emplace_back();
+			Result.Name = Prefix + "tables";
+			Result.Seconds = GetSecondsSince(Start);
+			for (const std::vector<FCubeReductionOrbit>* Orbits : {&Tables.Centers, &Tables.Wings})
+			{
+				for (const FCubeReductionOrbit& Orbit : *Orbits)
+				{
+					Result.Items += Orbit.Sequences.size();
+				}
+			}
+		}
+
+		// Scrambles long enough to mix every layer
+		FCubeBenchmarkResult Solves;
+		Solves.Name = Prefix + "solves";
+		FCubeBenchmarkResult Turns;
+		Turns.Name = Prefix + "solution turns";
+		for (int32_t Index = 0; Index < SolveCount; ++Index)
+		{
+			FCubeNxN Cube(Size);
+			Cube.Apply(MakeLayerMoves(Size, 30 * static_cast<size_t>(Size), Random));
+
+			std::vector<FCubeLayerMove> Solution;
+			FCubeReductionStats Stats;
+			const FClock::time_point Start = FClock::now();
+			bool bSolved = Reduction.Solve(Cube, Solution, &Stats);
+			const double Seconds = GetSecondsSince(Start);
+			Cube.Apply(Solution);
+			bSolved = bSolved && Cube.IsSolved();
+
+			Solves.Items += bSolved;
+			Solves.Seconds += Seconds;
+			Solves.Checksum ^= HashLayerMoves(Solution);
+			Turns.Items += bSolved ? Solution.size() : 0;
+			Turns.Seconds += Seconds;
+		}
+		Results.push_back(Solves);
+		Results.push_back(Turns);
+	}
+	return Results;
+}
+
+std::vector<FCubeBenchmarkResult> BenchmarkSessionLog(uint64_t MoveCount, int32_t CubeSize, uint32_t Seed)
+{
+	std::mt19937 Random(Seed);
+	CubeSize = std::clamp(CubeSize, FCubeNxN::MinSize, FCubeNxN::MaxSize);
+	const std::vector<FCubeLayerMove> Moves = MakeLayerMoves(CubeSize, static_cast<size_t>(MoveCount), Random);
+
+	// Scramble is the inverse of the moves, so the session ends solved
+	FCubeNxN Scramble(CubeSize);
+	for (auto Move = Moves.rbegin(); Move != Moves.rend(); ++Move)
+	{
+		Scramble.Apply({Move->Face, Move->Layer, static_cast<uint8_t>(4 - Move->Turns)});
+	}
+
+	// Roughly 5 to 10 turns per second at 60 frames per second
+	std::uniform_int_distribution<int32_t> FrameStep(6, 12);
+	std::vector<uint64_t> Frames(Moves.size());
+	uint64_t Frame = 15 * 60;
+	for (uint64_t& MoveFrame : Frames)
+	{
+		Frame += FrameStep(Random);
+		MoveFrame = Frame;
+	}
+
+	std::vector<FCubeBenchmarkResult> Results;
+	std::vector<uint8_t> Log;
+	{
+		const FClock::time_point Start = FClock::now();
+		FCubeSessionRecorder Recorder(Scramble, 60);
+		Recorder.StartSolve(15 * 60);
+		for (size_t Index = 0; Index < Moves.size(); ++Index)
+		{
+			Recorder.AddMove(Frames[Index], Moves[Index]);
+		}
+		Log = Recorder.Finish(Frame + 1);
+
+		FCubeBenchmarkResult& Result = Results.emplace_back();
+		char Name[64];
+		std::snprintf(Name, sizeof(Name), "Record, %.2f bytes per move", Moves.empty() ? 0.0 : static_cast<double>(Log.size()) / Moves.size());
+		Result.Name = Name;
+		Result.Items = Moves.size();
+		Result.Seconds = GetSecondsSince(Start);
+		Result.Checksum = Log.size();
+	}
+	{
+		const FClock::time_point Start = FClock::now();
+		FCubeSessionStats Stats;
+		std::string Error;
+		const bool bValid = VerifyCubeSession(Log.data(), Log.size(), Scramble, Stats, Error);
+
+		FCubeBenchmarkResult& Result = Results.emplace_back();
+		Result.Name = bValid ? "Verify" : "Verify failed: " + Error;
+		Result.Items = Stats.MoveCount;
+		Result.Seconds = GetSecondsSince(Start);
+		Result.Checksum = Stats.CheckpointCount;
+	}
+	{
+		const FClock::time_point Start = FClock::now();
+		FCubeSession Session;
+		std::string Error;
+		const bool bValid = ReadCubeSession(Log.data(), Log.size(), Session, Error);
+
+		FCubeBenchmarkResult& Result = Results.emplace_back();
+		Result.Name = bValid ? "Decode" : "Decode failed: " + Error;
+		Result.Items = Session.Moves.size();
+		Result.Seconds = GetSecondsSince(Start);
+		Result.Checksum = Session.EndFrame;
+	}
+	return Results;
+}
+
+std::vector<FCubeBenchmarkResult> BenchmarkScrambleGenerator(const FCubeTwoPhaseSolver& Solver, int32_t Count, uint64_t StateCount,
+                                                             int32_t MaxThreadCount, uint32_t Seed)
+{
+	std::mt19937 Random(Seed);
+	std::vector<FCubeBenchmarkResult> Results;
+	std::vector<FCubeState> States;
+	{
+		const FClock::time_point Start = FClock::now();
+		uint64_t Checksum = 0;
+		for (uint64_t Index = 0; Index < StateCount; ++Index)
+		{
+			States.push_back(MakeRandomCubeState(Random));
+			Checksum ^= States.back().Hash();
+		}
+
+		FCubeBenchmarkResult& Result = Results.emplace_back();
+		Result.Name = "Random states";
+		Result.Items = StateCount;
+		Result.Seconds = GetSecondsSince(Start);
+		Result.Checksum = Checksum;
+	}
+	{
+		FCubeScrambleSet Season(StateCount);
+		const FClock::time_point Start = FClock::now();
+		uint64_t Added = 0;
+		for (const FCubeState& State : States)
+		{
+			Added += Season.Add(State);
+		}
+		// Every state is looked up again, so the checksum is twice the count unless a lookup fails
+		for (const FCubeState& State : States)
+		{
+			Added += Season.Contains(State);
+		}
+
+		FCubeBenchmarkResult& Result = Results.emplace_back();
+		Result.Name = "Season add and find";
+		Result.Items = 2 * StateCount;
+		Result.Seconds = GetSecondsSince(Start);
+		Result.Checksum = Added;
+	}
+
+	std::vector<int32_t> ThreadCounts;
+	for (int32_t ThreadCount = 1; ThreadCount < MaxThreadCount; ThreadCount *= 2)
+	{
+		ThreadCounts.push_back(ThreadCount);
+	}
+	ThreadCounts.push_back(std::max(MaxThreadCount, 1));
+
+	for (const int32_t ThreadCount : ThreadCounts)
+	{
+		FCubeScrambleSet Season(static_cast<uint64_t>(std::max(Count, 1)));
+		const FCubeScrambleGenerator Generator(Solver, &Season);
+		const FClock::time_point Start = FClock::now();
+		const std::vector<FCubeScramble> Scrambles = Generator.GenerateBatch(Count, ThreadCount, Seed);
+		const double Seconds = GetSecondsSince(Start);
+
+		uint64_t Generated = 0;
+		uint64_t MoveCount = 0;
+		uint64_t Checksum = 0;
+		for (const FCubeScramble& Scramble : Scrambles)
+		{
+			if (Scramble.Moves.empty() || FCubeState::Solved().Apply(Scramble.Moves) != Scramble.State) continue;
+			++Generated;
+			MoveCount += Scramble.Moves.size();
+			Checksum ^= HashMoves(Scramble.Moves);
+		}
+
+		FCubeBenchmarkResult& Result = Results.emplace_back();
+		char Name[64];
+		std::snprintf(Name, sizeof(Name), "%d %s, %.2f moves", ThreadCount, ThreadCount == 1 ? "thread" : "threads",
+		              Generated > 0 ? static_cast<double>(MoveCount) / Generated : 0.0);
+		Result.Name = Name;
+		Result.Items = Generated;
+		Result.Seconds = Seconds;
+		Result.Checksum = Checksum;
+	}
+	return Results;
+}
+
+std::vector<FCubeBenchmarkResult> BenchmarkCanonicalization(uint64_t StateCount, int32_t SearchDepth, uint64_t TableEntryCount, uint32_t Seed)
+{
+	std::mt19937 Random(Seed);
+	std::vector<FCubeVector> States;
+	for (uint64_t Index = 0; Index < StateCount; ++Index)
+	{
+		States.push_back(FCubeVector::FromState(MakeRandomCubeState(Random)));
+	}
+
+	std::vector<FCubeBenchmarkResult> Results;
+	for (const bool bWithInverse : {false, true})
+	{
+		for (int32_t Level = 0; Level <= static_cast<int32_t>(GetSupportedSimdLevel()); ++Level)
+		{
+			const FClock::time_point Start = FClock::now();
+			uint64_t Checksum = 0;
+			for (const FCubeVector& State : States)
+			{
+				Checksum ^= CanonicalizeCube(State, bWithInverse, static_cast<ECubeSimdLevel>(Level)).Hash();
+			}
+
+			FCubeBenchmarkResult& Result = Results.emplace_back();
+			Result.Name = std::string(bWithInverse ? "Canonical+inverse " : "Canonical ") + ToString(static_cast<ECubeSimdLevel>(Level));
+			Result.Items = StateCount;
+			Result.Seconds = GetSecondsSince(Start);
+			Result.Checksum = Checksum;
+		}
+	}
+
+	const FCubeVector Roots[2] = {FCubeVector::Solved(), FCubeVector::FromState(MakeRandomCubeState(Random))};
+	FCubeTranspositionTable Table(TableEntryCount);
+	for (int32_t Root = 0; Root < 2; ++Root)
+	{
+		for (const ETranspositionKey Key : {ETranspositionKey::State, ETranspositionKey::Symmetry, ETranspositionKey::SymmetryAndInverse})
+		{
+			Table.Clear();
+			FTranspositionSearch Search{Table, Key};
+			const FClock::time_point Start = FClock::now();
+			Search.Search(Roots[Root], SearchDepth, -1);
+
+			static const char* const KeyNames[] = {"state", "symmetry", "sym+inverse"};
+			FCubeBenchmarkResult& Result = Results.emplace_back();
+			char Name[64];
+			std::snprintf(Name, sizeof(Name), "%s %s, %.1f%% hits", Root == 0 ? "Solved" : "Random", KeyNames[static_cast<int32_t>(Key)],
+			              Search.Probes > 0 ? 100.0 * static_cast<double>(Search.Hits) / static_cast<double>(Search.Probes) : 0.0);
+			Result.Name = Name;
+			Result.Items = Search.Nodes;
+			Result.Seconds = GetSecondsSince(Start);
+			Result.Checksum = Search.Hits;
+		}
+	}
+	return Results;
+}
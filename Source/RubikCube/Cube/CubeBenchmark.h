@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class FCubeOptimalSolver;
+class FCubeTwoPhaseSolver;
+struct FCubeSolveJob;
+
+/** Outcome of one benchmark case, Checksum depends on the computed states so work can't be optimized out */
+struct FCubeBenchmarkResult
+{
+	std::string Name;
+	uint64_t Items = 0;
+	double Seconds = 0.0;
+	uint64_t Checksum = 0;
+
+	double GetNanosecondsPerItem() const { return Items > 0 ? Seconds * 1e9 / static_cast<double>(Items) : 0.0; }
+	double GetItemsPerSecond() const { return Seconds > 0.0 ? static_cast<double>(Items) / Seconds : 0.0; }
+};
+
+/**
+ * Applies the same random move sequence with packed FCubeState and with FCubeVector on every
+ * SIMD level the CPU supports. All cases must end with the same checksum.
+ */
+std::vector<FCubeBenchmarkResult> BenchmarkMoveApplication(uint64_t MoveCount, uint32_t Seed = 1);
+
+/**
+ * Solves a fixed set of scrambles optimally, one result per scramble with searched nodes as items, followed by the total.
+ * ScrambleLength of 0 means random states, reached by long random walks.
+ */
+std::vector<FCubeBenchmarkResult> BenchmarkOptimalSolver(const FCubeOptimalSolver& Solver, int32_t StateCount, int32_t ScrambleLength,
+                                                         uint32_t Seed = 1);
+
+/**
+ * Solves random states with the two-phase solver, every search stops at its first solution of at most TargetLength moves
+ * or after SecondsPerState. Reports all solves, time to the first solution, searched nodes and one result per solution length.
+ */
+std::vector<FCubeBenchmarkResult> BenchmarkTwoPhaseSolver(const FCubeTwoPhaseSolver& Solver, int32_t StateCount, int32_t TargetLength,
+                                                          double SecondsPerState, uint32_t Seed = 1);
+
+/**
+ * Solves the same batch of states with FCubeBatchSolver on 1, 2, 4 ... up to MaxThreadCount threads, one result per thread count
+ * with solved states as items and wall time as seconds. Jobs copy JobTemplate except for Id and State.
+ * ScrambleLength of 0 means random states.
+ */
+std::vector<FCubeBenchmarkResult> BenchmarkBatchSolver(const FCubeTwoPhaseSolver* TwoPhase, const FCubeOptimalSolver* Optimal,
+                                                       const FCubeSolveJob& JobTemplate, int32_t StateCount, int32_t ScrambleLength,
+                                                       int32_t MaxThreadCount, uint32_t Seed = 1);
+
+/**
+ * Per cube size from MinSize to MaxSize: layer turn throughput over MoveCount random turns, time to build the reduction tables
+ * with 3-cycles found as items, and SolveCount reductions of random cubes with solved cubes and with solution turns as items.
+ */
+std::vector<FCubeBenchmarkResult> BenchmarkCubeSizes(const FCubeTwoPhaseSolver& Solver, int32_t MinSize, int32_t MaxSize, uint64_t MoveCount,
+                                                     int32_t SolveCount, uint32_t Seed = 1);
+
+/**
+ * Records a session of MoveCount random turns on a cube of CubeSize that the turns solve, then verifies and decodes the log.
+ * One result each for recording, verification and decoding with moves as items.
+ */
+std::vector<FCubeBenchmarkResult> BenchmarkSessionLog(uint64_t MoveCount, int32_t CubeSize, uint32_t Seed = 1);
+
+/**
+ * Random state sampling over StateCount states, inserting as many states into a season set, then Count scrambles generated
+ * on 1, 2, 4 ... up to MaxThreadCount threads, each run with a new season. Scrambles are checked to reach their state.
+ */
+std::vector<FCubeBenchmarkResult> BenchmarkScrambleGenerator(const FCubeTwoPhaseSolver& Solver, int32_t Count, uint64_t StateCount,
+                                                             int32_t MaxThreadCount, uint32_t Seed = 1);
+
+/**
+ * Canonicalizes StateCount random states under the 48 symmetries, without and with the inverse, on every SIMD level the CPU
+ * supports; all levels must end with the same checksum. Then runs depth limited searches of SearchDepth moves from the solved
+ * cube and from a random state with a transposition table of TableEntryCount entries keyed by plain state hashes,
+ * canonical hashes and canonical hashes with inverse. Search results have nodes as items and table hits as checksum.
+ */
+std::vector<FCubeBenchmarkResult> BenchmarkCanonicalization(uint64_t StateCount, int32_t SearchDepth, uint64_t TableEntryCount,
+                                                            uint32_t Seed = 1);
@@ -0,0 +1,286 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeCanonical.h"
+#include "CubeSimd.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace CubeCanonicalImpl
+{
+/**
+ * Conjugation in FCubeVector layout. Byte i of S^-1 * X * S comes from byte Shuffle[i] of X: its cubie is renamed by
+ * Relabel, which also adds the twist of S^-1, and Twist[i] adds the twist of S at position i. Reflections count twists
+ * the other way, so Mirror negates the orientation taken from X. Sums are reduced modulo Wrap like in move application.
+ */
+struct alignas(32) FVectorSymmetry
+{
+	uint8_t Shuffle[32];
+	uint8_t Relabel[32];
+	uint8_t Twist[32];
+	uint8_t Mirror[32];
+};
+
+struct alignas(32) FVectorSymmetryTables
+{
+	FVectorSymmetry Symmetries[CubeSymmetryCount];
+	uint8_t Wrap[32];
+	/** 0xFF on bytes holding a cubie, padding bytes are cleared with it */
+	uint8_t Valid[32];
+};
+
+static FVectorSymmetryTables BuildVectorSymmetryTables()
+{
+	const FCubeSymmetryTables& Symmetry = FCubeSymmetryTables::Get();
+	FVectorSymmetryTables Tables{};
+	for (int32_t Index = 0; Index < 16; ++Index)
+	{
+		Tables.Wrap[Index] = Index < CubeCornerCount ? 3 << 4 : 0;
+		Tables.Wrap[FCubeVector::EdgeOffset + Index] = Index < CubeEdgeCount ? 2 << 4 : 0;
+		Tables.Valid[Index] = Index < CubeCornerCount ? 0xFF : 0;
+		Tables.Valid[FCubeVector::EdgeOffset + Index] = Index < CubeEdgeCount ? 0xFF : 0;
+	}
+
+	for (int32_t SymmetryIndex = 0; SymmetryIndex < CubeSymmetryCount; ++SymmetryIndex)
+	{
+		const FCubieCube& Cube = Symmetry.Cubes[SymmetryIndex];
+		const FCubieCube& Inverse = Symmetry.Cubes[Symmetry.Inverse[SymmetryIndex]];
+		const bool bReflection = Cube.Co[0] >= 3;
+		FVectorSymmetry& Vector = Tables.Symmetries[SymmetryIndex];
+		std::memset(Vector.Shuffle, 0x80, sizeof(Vector.Shuffle));
+		for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+		{
+			const int32_t Twist = Cube.Co[Index] % 3;
+			Vector.Shuffle[Index] = Cube.Cp[Index];
+			Vector.Relabel[Index] = static_cast<uint8_t>(Inverse.Cp[Index] | (Inverse.Co[Index] % 3) << 4);
+			Vector.Twist[Index] = static_cast<uint8_t>((bReflection ? (3 - Twist) % 3 : Twist) << 4);
+			Vector.Mirror[Index] = bReflection ? 0xFF : 0;
+		}
+		for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+		{
+			const int32_t Byte = FCubeVector::EdgeOffset + Index;
+			Vector.Shuffle[Byte] = Cube.Ep[Index];
+			Vector.Relabel[Byte] = static_cast<uint8_t>(Inverse.Ep[Index] | Inverse.Eo[Index] << 4);
+			Vector.Twist[Byte] = static_cast<uint8_t>(Cube.Eo[Index] << 4);
+			Vector.Mirror[Byte] = bReflection ? 0xFF : 0;
+		}
+	}
+	return Tables;
+}
+
+static const FVectorSymmetryTables& GetVectorSymmetryTables()
+{
+	static const FVectorSymmetryTables Tables = BuildVectorSymmetryTables();
+	return Tables;
+}
+
+static FCubeVector ConjugateScalar(const FCubeVector& State, const FVectorSymmetry& Symmetry, const FVectorSymmetryTables& Tables)
+{
+	FCubeVector Result{};
+	for (int32_t Index = 0; Index < 32; ++Index)
+	{
+		if (Tables.Valid[Index] == 0) continue;
+		const uint8_t Byte = State.Bytes[(Index & 16) | Symmetry.Shuffle[Index]];
+		const uint8_t Orientation = Byte & 0x30;
+		const uint8_t Sum = static_cast<uint8_t>(Symmetry.Relabel[(Index & 16) | (Byte & 15)] + Symmetry.Twist[Index] +
+			(Symmetry.Mirror[Index] != 0 ? Tables.Wrap[Index] - Orientation : Orientation));
+		const uint8_t Once = std::min<uint8_t>(Sum, static_cast<uint8_t>(Sum - Tables.Wrap[Index]));
+		Result.Bytes[Index] = std::min<uint8_t>(Once, static_cast<uint8_t>(Once - Tables.Wrap[Index]));
+	}
+	return Result;
+}
+
+static void CanonicalizeScalar(const FCubeVector* Roots, int32_t RootCount, FCubeCanonicalState& OutState)
+{
+	const FVectorSymmetryTables& Tables = GetVectorSymmetryTables();
+	OutState = {Roots[0], 0, false};
+	for (int32_t Root = 0; Root < RootCount; ++Root)
+	{
+		for (int32_t Symmetry = Root == 0 ? 1 : 0; Symmetry < CubeSymmetryCount; ++Symmetry)
+		{
+			const FCubeVector Conjugate = ConjugateScalar(Roots[Root], Tables.Symmetries[Symmetry], Tables);
+			if (std::memcmp(Conjugate.Bytes, OutState.State.Bytes, sizeof(Conjugate.Bytes)) < 0)
+			{
+				OutState = {Conjugate, static_cast<uint8_t>(Symmetry), Root != 0};
+			}
+		}
+	}
+}
+
+#if CUBE_VECTOR_X86
+/** Bit of the first differing byte set in Less means A comes first in byte order */
+static bool IsFirstLess(uint32_t Equal, uint32_t Less)
+{
+	const uint32_t Different = ~Equal;
+	return (Less & Different & (0u - Different)) != 0;
+}
+
+CUBE_VECTOR_TARGET("ssse3")
+static inline __m128i ConjugateHalfSSSE3(__m128i State, const FVectorSymmetry& Symmetry, int32_t Offset, __m128i Wrap, __m128i Valid)
+{
+	const __m128i Byte = _mm_shuffle_epi8(State, _mm_load_si128(reinterpret_cast<const __m128i*>(Symmetry.Shuffle + Offset)));
+	const __m128i Cubie = _mm_and_si128(Byte, _mm_set1_epi8(0x0F));
+	__m128i Orientation = _mm_and_si128(Byte, _mm_set1_epi8(0x30));
+	const __m128i Mirror = _mm_load_si128(reinterpret_cast<const __m128i*>(Symmetry.Mirror + Offset));
+	Orientation = _mm_xor_si128(Orientation, _mm_and_si128(_mm_xor_si128(Orientation, _mm_sub_epi8(Wrap, Orientation)), Mirror));
+
+	__m128i Sum = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(Symmetry.Relabel + Offset)), Cubie);
+	Sum = _mm_add_epi8(_mm_add_epi8(Sum, Orientation), _mm_load_si128(reinterpret_cast<const __m128i*>(Symmetry.Twist + Offset)));
+	Sum = _mm_min_epu8(Sum, _mm_sub_epi8(Sum, Wrap));
+	Sum = _mm_min_epu8(Sum, _mm_sub_epi8(Sum, Wrap));
+	return _mm_and_si128(Sum, Valid);
+}
+
+CUBE_VECTOR_TARGET("ssse3")
+static void CanonicalizeSSSE3(const FCubeVector* Roots, int32_t RootCount, FCubeCanonicalState& OutState)
+{
+	const FVectorSymmetryTables& Tables = GetVectorSymmetryTables();
+	constexpr int32_t Offset = FCubeVector::EdgeOffset;
+	const __m128i CornerWrap = _mm_load_si128(reinterpret_cast<const __m128i*>(Tables.Wrap));
+	const __m128i EdgeWrap = _mm_load_si128(reinterpret_cast<const __m128i*>(Tables.Wrap + Offset));
+	const __m128i CornerValid = _mm_load_si128(reinterpret_cast<const __m128i*>(Tables.Valid));
+	const __m128i EdgeValid = _mm_load_si128(reinterpret_cast<const __m128i*>(Tables.Valid + Offset));
+
+	__m128i BestCorners = _mm_load_si128(reinterpret_cast<const __m128i*>(Roots[0].Bytes));
+	__m128i BestEdges = _mm_load_si128(reinterpret_cast<const __m128i*>(Roots[0].Bytes + Offset));
+	int32_t BestIndex = 0;
+	for (int32_t Root = 0; Root < RootCount; ++Root)
+	{
+		const __m128i Corners = _mm_load_si128(reinterpret_cast<const __m128i*>(Roots[Root].Bytes));
+		const __m128i Edges = _mm_load_si128(reinterpret_cast<const __m128i*>(Roots[Root].Bytes + Offset));
+		for (int32_t Symmetry = Root == 0 ? 1 : 0; Symmetry < CubeSymmetryCount; ++Symmetry)
+		{
+			const FVectorSymmetry& Vector = Tables.Symmetries[Symmetry];
+			const __m128i NewCorners = ConjugateHalfSSSE3(Corners, Vector, 0, CornerWrap, CornerValid);
+			const __m128i NewEdges = ConjugateHalfSSSE3(Edges, Vector, Offset, EdgeWrap, EdgeValid);
+
+			const uint32_t Equal = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(NewCorners, BestCorners))) |
+				static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(NewEdges, BestEdges))) << 16;
+			const uint32_t Less = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(BestCorners, NewCorners))) |
+				static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(BestEdges, NewEdges))) << 16;
+			if (IsFirstLess(Equal, Less))
+			{
+				BestCorners = NewCorners;
+				BestEdges = NewEdges;
+				BestIndex = Root * CubeSymmetryCount + Symmetry;
+			}
+		}
+	}
+
+	_mm_store_si128(reinterpret_cast<__m128i*>(OutState.State.Bytes), BestCorners);
+	_mm_store_si128(reinterpret_cast<__m128i*>(OutState.State.Bytes + Offset), BestEdges);
+	OutState.Symmetry = static_cast<uint8_t>(BestIndex % CubeSymmetryCount);
+	OutState.bInverse = BestIndex >= CubeSymmetryCount;
+}
+
+CUBE_VECTOR_TARGET("avx2")
+static void CanonicalizeAVX2(const FCubeVector* Roots, int32_t RootCount, FCubeCanonicalState& OutState)
+{
+	// Shuffles stay within 128 bit lanes, corners and edges are conjugated side by side
+	const FVectorSymmetryTables& Tables = GetVectorSymmetryTables();
+	const __m256i Wrap = _mm256_load_si256(reinterpret_cast<const __m256i*>(Tables.Wrap));
+	const __m256i Valid = _mm256_load_si256(reinterpret_cast<const __m256i*>(Tables.Valid));
+	const __m256i CubieMask = _mm256_set1_epi8(0x0F);
+	const __m256i OrientationMask = _mm256_set1_epi8(0x30);
+
+	__m256i Best = _mm256_load_si256(reinterpret_cast<const __m256i*>(Roots[0].Bytes));
+	int32_t BestIndex = 0;
+	for (int32_t Root = 0; Root < RootCount; ++Root)
+	{
+		const __m256i State = _mm256_load_si256(reinterpret_cast<const __m256i*>(Roots[Root].Bytes));
+		for (int32_t Symmetry = Root == 0 ? 1 : 0; Symmetry < CubeSymmetryCount; ++Symmetry)
+		{
+			const FVectorSymmetry& Vector = Tables.Symmetries[Symmetry];
+			const __m256i Byte = _mm256_shuffle_epi8(State, _mm256_load_si256(reinterpret_cast<const __m256i*>(Vector.Shuffle)));
+			__m256i Orientation = _mm256_and_si256(Byte, OrientationMask);
+			const __m256i Mirror = _mm256_load_si256(reinterpret_cast<const __m256i*>(Vector.Mirror));
+			Orientation = _mm256_xor_si256(Orientation, _mm256_and_si256(_mm256_xor_si256(Orientation, _mm256_sub_epi8(Wrap, Orientation)), Mirror));
+
+			__m256i Sum = _mm256_shuffle_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(Vector.Relabel)), _mm256_and_si256(Byte, CubieMask));
+			Sum = _mm256_add_epi8(_mm256_add_epi8(Sum, Orientation), _mm256_load_si256(reinterpret_cast<const __m256i*>(Vector.Twist)));
+			Sum = _mm256_min_epu8(Sum, _mm256_sub_epi8(Sum, Wrap));
+			Sum = _mm256_min_epu8(Sum, _mm256_sub_epi8(Sum, Wrap));
+			Sum = _mm256_and_si256(Sum, Valid);
+
+			const uint32_t Equal = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Sum, Best)));
+			const uint32_t Less = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(Best, Sum)));
+			if (IsFirstLess(Equal, Less))
+			{
+				Best = Sum;
+				BestIndex = Root * CubeSymmetryCount + Symmetry;
+			}
+		}
+	}
+
+	_mm256_store_si256(reinterpret_cast<__m256i*>(OutState.State.Bytes), Best);
+	OutState.Symmetry = static_cast<uint8_t>(BestIndex % CubeSymmetryCount);
+	OutState.bInverse = BestIndex >= CubeSymmetryCount;
+}
+#endif
+}
+
+using namespace CubeCanonicalImpl;
+
+uint64_t HashCubeVector(const FCubeVector& State)
+{
+	uint64_t Corners = 0;
+	uint64_t Edges[2] = {};
+	std::memcpy(&Corners, State.Bytes, sizeof(Corners));
+	std::memcpy(Edges, State.Bytes + FCubeVector::EdgeOffset, sizeof(Edges));
+
+	uint64_t Value = (Corners * 0x9E3779B97F4A7C15ull ^ Edges[0]) + Edges[1] * 0xC2B2AE3D27D4EB4Full;
+	Value ^= Value >> 31;
+	Value *= 0xBF58476D1CE4E5B9ull;
+	Value ^= Value >> 27;
+	Value *= 0x94D049BB133111EBull;
+	return Value ^ (Value >> 31);
+}
+
+FCubeVector ConjugateVector(const FCubeVector& State, int32_t Symmetry)
+{
+	const FVectorSymmetryTables& Tables = GetVectorSymmetryTables();
+	return ConjugateScalar(State, Tables.Symmetries[Symmetry], Tables);
+}
+
+FCubeVector InverseVector(const FCubeVector& State)
+{
+	FCubeVector Result{};
+	for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+	{
+		const uint8_t Byte = State.Bytes[Index];
+		Result.Bytes[Byte & 15] = static_cast<uint8_t>(Index | ((3 - (Byte >> 4)) % 3) << 4);
+	}
+	for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+	{
+		const uint8_t Byte = State.Bytes[FCubeVector::EdgeOffset + Index];
+		Result.Bytes[FCubeVector::EdgeOffset + (Byte & 15)] = static_cast<uint8_t>(Index | (Byte & 0x30));
+	}
+	return Result;
+}
+
+FCubeCanonicalState CanonicalizeCube(const FCubeVector& State, bool bWithInverse, ECubeSimdLevel Level)
+{
+	alignas(32) FCubeVector Roots[2] = {State, {}};
+	if (bWithInverse)
+	{
+		Roots[1] = InverseVector(State);
+	}
+	const int32_t RootCount = bWithInverse ? 2 : 1;
+
+	FCubeCanonicalState Result;
+	switch (Level)
+	{
+#if CUBE_VECTOR_X86
+	case ECubeSimdLevel::AVX2:
+		CanonicalizeAVX2(Roots, RootCount, Result);
+		break;
+	case ECubeSimdLevel::SSSE3:
+		CanonicalizeSSSE3(Roots, RootCount, Result);
+		break;
+#endif
+	default:
+		CanonicalizeScalar(Roots, RootCount, Result);
+		break;
+	}
+	return Result;
+}
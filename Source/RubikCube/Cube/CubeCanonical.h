@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CubeSymmetry.h"
+#include "CubeVector.h"
+
+/** Hash of the cubie bytes of State, cheaper than converting to FCubeState first, different from FCubeState::Hash */
+uint64_t HashCubeVector(const FCubeVector& State);
+
+/** S^-1 * State * S for symmetry index Symmetry of FCubeSymmetryTables, same tables as the vector paths of CanonicalizeCube */
+FCubeVector ConjugateVector(const FCubeVector& State, int32_t Symmetry);
+
+FCubeVector InverseVector(const FCubeVector& State);
+
+/** Representative of a state's class and how to get there: State = S^-1 * X * S, X being the original state or its inverse */
+struct FCubeCanonicalState
+{
+	FCubeVector State;
+	uint8_t Symmetry = 0;
+	bool bInverse = false;
+
+	uint64_t Hash() const { return HashCubeVector(State); }
+};
+
+/**
+ * Conjugates State by all 48 symmetries and keeps the one smallest in byte order, with bWithInverse also the conjugates of its
+ * inverse. Symmetric states, and with bWithInverse also mutually inverse ones, get the same representative, so they share
+ * their distance to solved. Each conjugation is two byte shuffles and a few adds, the order compare is one byte compare
+ * of the whole state, so on AVX2 the state never leaves its register.
+ */
+FCubeCanonicalState CanonicalizeCube(const FCubeVector& State, bool bWithInverse, ECubeSimdLevel Level);
+
+inline FCubeCanonicalState CanonicalizeCube(const FCubeVector& State, bool bWithInverse)
+{
+	return CanonicalizeCube(State, bWithInverse, GetSupportedSimdLevel());
+}
@@ -0,0 +1,233 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeCoordinates.h"
+
+namespace CubeCoordinatesImpl
+{
+static int32_t CountBitsBelow(uint32_t Mask, int32_t Bit)
+{
+	uint32_t Bits = Mask & ((1u << Bit) - 1);
+	int32_t Count = 0;
+	for (; Bits != 0; Bits &= Bits - 1) ++Count;
+	return Count;
+}
+
+/** Index of the Nth clear bit of Used */
+static int32_t FindNthUnused(uint32_t Used, int32_t Nth)
+{
+	for (int32_t Bit = 0;; ++Bit)
+	{
+		if ((Used >> Bit & 1) == 0 && Nth-- == 0) return Bit;
+	}
+}
+
+/** Lehmer code of Count distinct values, each below 32 */
+static uint32_t RankPermutation(const uint8_t* Values, int32_t Count)
+{
+	uint32_t Rank = 0;
+	for (int32_t Index = 0; Index < Count; ++Index)
+	{
+		int32_t Smaller = 0;
+		for (int32_t Other = Index + 1; Other < Count; ++Other)
+		{
+			Smaller += Values[Other] < Values[Index];
+		}
+		Rank = Rank * (Count - Index) + Smaller;
+	}
+	return Rank;
+}
+
+/** Inverse of RankPermutation, values are 0..Count-1 */
+static void UnrankPermutation(uint32_t Rank, int32_t Count, uint8_t* OutValues)
+{
+	uint8_t Digits[CubeEdgeCount];
+	for (int32_t Index = Count - 1; Index >= 0; --Index)
+	{
+		Digits[Index] = static_cast<uint8_t>(Rank % (Count - Index));
+		Rank /= Count - Index;
+	}
+
+	uint32_t Used = 0;
+	for (int32_t Index = 0; Index < Count; ++Index)
+	{
+		// Digit counts unused values below the chosen one
+		const int32_t Value = FindNthUnused(Used, Digits[Index]);
+		OutValues[Index] = static_cast<uint8_t>(Value);
+		Used |= 1u << Value;
+	}
+}
+
+static constexpr int32_t Binomial(int32_t N, int32_t K)
+{
+	if (K < 0 || K > N) return 0;
+	int32_t Result = 1;
+	for (int32_t Index = 0; Index < K; ++Index)
+	{
+		Result = Result * (N - Index) / (Index + 1);
+	}
+	return Result;
+}
+
+static constexpr uint8_t FirstSliceEdge = 8;
+}
+
+using namespace CubeCoordinatesImpl;
+
+uint16_t GetCornerTwist(const FCubieCube& Cube)
+{
+	uint32_t Twist = 0;
+	for (int32_t Index = 0; Index < CubeCornerCount - 1; ++Index)
+	{
+		Twist = Twist * 3 + Cube.Co[Index];
+	}
+	return static_cast<uint16_t>(Twist);
+}
+
+void SetCornerTwist(FCubieCube& Cube, uint16_t Twist)
+{
+	int32_t Sum = 0;
+	for (int32_t Index = CubeCornerCount - 2; Index >= 0; --Index)
+	{
+		Cube.Co[Index] = static_cast<uint8_t>(Twist % 3);
+		Sum += Cube.Co[Index];
+		Twist /= 3;
+	}
+	Cube.Co[CubeCornerCount - 1] = static_cast<uint8_t>((3 - Sum % 3) % 3);
+}
+
+uint16_t GetCornerPermutation(const FCubieCube& Cube)
+{
+	return static_cast<uint16_t>(RankPermutation(Cube.Cp, CubeCornerCount));
+}
+
+void SetCornerPermutation(FCubieCube& Cube, uint16_t Permutation)
+{
+	UnrankPermutation(Permutation, CubeCornerCount, Cube.Cp);
+}
+
+uint16_t GetEdgeFlip(const FCubieCube& Cube)
+{
+	uint32_t Flip = 0;
+	for (int32_t Index = 0; Index < CubeEdgeCount - 1; ++Index)
+	{
+		Flip = Flip << 1 | Cube.Eo[Index];
+	}
+	return static_cast<uint16_t>(Flip);
+}
+
+void SetEdgeFlip(FCubieCube& Cube, uint16_t Flip)
+{
+	uint8_t Parity = 0;
+	for (int32_t Index = CubeEdgeCount - 2; Index >= 0; --Index)
+	{
+		Cube.Eo[Index] = static_cast<uint8_t>(Flip & 1);
+		Parity ^= Cube.Eo[Index];
+		Flip >>= 1;
+	}
+	Cube.Eo[CubeEdgeCount - 1] = Parity;
+}
+
+uint16_t GetUDSliceSorted(const FCubieCube& Cube)
+{
+	// Combination is ranked from the last position down, so slice edges in the slice rank 0
+	int32_t Combination = 0;
+	uint8_t SliceEdges[4];
+	int32_t Found = 0;
+	for (int32_t Position = CubeEdgeCount - 1; Position >= 0; --Position)
+	{
+		if (Cube.Ep[Position] >= FirstSliceEdge)
+		{
+			Combination += Binomial(CubeEdgeCount - 1 - Position, Found + 1);
+			SliceEdges[3 - Found] = static_cast<uint8_t>(Cube.Ep[Position] - FirstSliceEdge);
+			++Found;
+		}
+	}
+	return static_cast<uint16_t>(Combination * 24 + RankPermutation(SliceEdges, 4));
+}
+
+void SetUDSliceSorted(FCubieCube& Cube, uint16_t SliceSorted)
+{
+	uint8_t SliceEdges[4];
+	UnrankPermutation(SliceSorted % 24, 4, SliceEdges);
+
+	int32_t Combination = SliceSorted / 24;
+	uint32_t SlicePositions = 0;
+	for (int32_t Found = 3; Found >= 0; --Found)
+	{
+		int32_t Distance = Found;
+		while (Binomial(Distance + 1, Found + 1) <= Combination) ++Distance;
+		Combination -= Binomial(Distance, Found + 1);
+
+		const int32_t Position = CubeEdgeCount - 1 - Distance;
+		Cube.Ep[Position] = static_cast<uint8_t>(SliceEdges[3 - Found] + FirstSliceEdge);
+		SlicePositions |= 1u << Position;
+	}
+
+	uint8_t OtherEdge = 0;
+	for (int32_t Position = 0; Position < CubeEdgeCount; ++Position)
+	{
+		if ((SlicePositions >> Position & 1) == 0) Cube.Ep[Position] = OtherEdge++;
+	}
+}
+
+uint16_t GetUDEdgePermutation(const FCubieCube& Cube)
+{
+	return static_cast<uint16_t>(RankPermutation(Cube.Ep, FirstSliceEdge));
+}
+
+void SetUDEdgePermutation(FCubieCube& Cube, uint16_t Permutation)
+{
+	UnrankPermutation(Permutation, FirstSliceEdge, Cube.Ep);
+	for (uint8_t Edge = FirstSliceEdge; Edge < CubeEdgeCount; ++Edge)
+	{
+		Cube.Ep[Edge] = Edge;
+	}
+}
+
+uint32_t RankEdgeSixPositions(const uint8_t (&Positions)[6])
+{
+	uint32_t Rank = 0;
+	uint32_t Used = 0;
+	for (int32_t Index = 0; Index < 6; ++Index)
+	{
+		Rank = Rank * (CubeEdgeCount - Index) + (Positions[Index] - CountBitsBelow(Used, Positions[Index]));
+		Used |= 1u << Positions[Index];
+	}
+	return Rank;
+}
+
+void UnrankEdgeSixPositions(uint32_t Rank, uint8_t (&OutPositions)[6])
+{
+	uint8_t Digits[6];
+	for (int32_t Index = 5; Index >= 0; --Index)
+	{
+		Digits[Index] = static_cast<uint8_t>(Rank % (CubeEdgeCount - Index));
+		Rank /= CubeEdgeCount - Index;
+	}
+
+	uint32_t Used = 0;
+	for (int32_t Index = 0; Index < 6; ++Index)
+	{
+		const int32_t Position = FindNthUnused(Used, Digits[Index]);
+		OutPositions[Index] = static_cast<uint8_t>(Position);
+		Used |= 1u << Position;
+	}
+}
+
+uint32_t GetEdgeSixCoordinate(const FCubieCube& Cube, const uint8_t (&Edges)[6])
+{
+	uint8_t PositionOf[CubeEdgeCount];
+	for (int32_t Position = 0; Position < CubeEdgeCount; ++Position)
+	{
+		PositionOf[Cube.Ep[Position]] = static_cast<uint8_t>(Position);
+	}
+
+	uint8_t Positions[6];
+	uint32_t Flips = 0;
+	for (int32_t Index = 0; Index < 6; ++Index)
+	{
+		Positions[Index] = PositionOf[Edges[Index]];
+		Flips |= static_cast<uint32_t>(Cube.Eo[Positions[Index]]) << Index;
+	}
+	return RankEdgeSixPositions(Positions) << 6 | Flips;
+}
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CubeState.h"
+
+/**
+ * Coordinates number a subset of the cube state densely, so it can index move and pruning tables.
+ * Every Set function creates some cube with given coordinate, other cubies are left as they were.
+ */
+
+/** Twists of corners URF..DBL in base 3, twist of DRB follows from the others */
+constexpr int32_t CornerTwistCount = 2187;
+
+/** Lehmer code of the corner permutation */
+constexpr int32_t CornerPermutationCount = 40320;
+
+/** Flips of edges UR..BL in base 2, flip of BR follows from the others */
+constexpr int32_t EdgeFlipCount = 2048;
+
+/** Positions of UD slice edges FR, FL, BL and BR regardless of their order, 12 choose 4 */
+constexpr int32_t UDSliceCount = 495;
+
+/** Positions of UD slice edges times their order, divided by 24 gives the UD slice coordinate */
+constexpr int32_t UDSliceSortedCount = UDSliceCount * 24;
+
+/** Lehmer code of the eight U and D layer edges, defined while the slice edges are in the slice */
+constexpr int32_t UDEdgePermutationCount = 40320;
+
+/** Ordered positions of six distinct edges, 12 * 11 * 10 * 9 * 8 * 7 */
+constexpr int32_t EdgeSixPositionCount = 665280;
+
+/** Positions of six edges times their flips */
+constexpr int32_t EdgeSixCount = EdgeSixPositionCount * 64;
+
+uint16_t GetCornerTwist(const FCubieCube& Cube);
+void SetCornerTwist(FCubieCube& Cube, uint16_t Twist);
+
+uint16_t GetCornerPermutation(const FCubieCube& Cube);
+void SetCornerPermutation(FCubieCube& Cube, uint16_t Permutation);
+
+uint16_t GetEdgeFlip(const FCubieCube& Cube);
+void SetEdgeFlip(FCubieCube& Cube, uint16_t Flip);
+
+/** Zero when slice edges are in the slice in solved order, UD slice coordinate is zero when they are in the slice */
+uint16_t GetUDSliceSorted(const FCubieCube& Cube);
+/** Sets all edge positions, U and D layer edges take the positions left by the slice edges in order */
+void SetUDSliceSorted(FCubieCube& Cube, uint16_t SliceSorted);
+
+uint16_t GetUDEdgePermutation(const FCubieCube& Cube);
+/** Sets all edge positions, slice edges are put in the slice in solved order */
+void SetUDEdgePermutation(FCubieCube& Cube, uint16_t Permutation);
+
+uint32_t RankEdgeSixPositions(const uint8_t (&Positions)[6]);
+void UnrankEdgeSixPositions(uint32_t Rank, uint8_t (&OutPositions)[6]);
+
+/** Rank of positions of given edges shifted left by 6, ored with their flips, bit i is the flip of Edges[i] */
+uint32_t GetEdgeSixCoordinate(const FCubieCube& Cube, const uint8_t (&Edges)[6]);
@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/** Called after every finished depth with number of entries at that depth */
+using FCubeOnDepthFinished = std::function<void(int32_t Depth, uint64_t Count)>;
+
+/** Distance of entry Index in a table packed by GenerateDistanceTable */
+inline uint8_t GetPackedDistance(const uint8_t* Data, uint64_t Index)
+{
+	return static_cast<uint8_t>(Data[Index >> 1] >> ((Index & 1) * 4) & 15);
+}
+
+/** Every state has a single entry */
+struct FCubeNoEquivalents
+{
+	template <typename TVisit>
+	void operator()(uint32_t, const TVisit&) const
+	{
+	}
+};
+
+/**
+ * Exact distance from SolvedIndex for every entry of a densely numbered state space, 4 bits per entry.
+ * Multi-threaded breadth first search, GetNeighbor(Index, Move) returns the entry reached by Move in [0, MoveCount).
+ * Symmetry reduced tables have several entries for some states, ForEachEquivalent(Index, Visit) calls Visit
+ * for the other entries of the same state, so they get their distance together.
+ * Distances are stored modulo 15, which keeps distance modulo 3 for tables deeper than that.
+ */
+template <typename TGetNeighbor, typename TForEachEquivalent = FCubeNoEquivalents>
+std::vector<uint8_t> GenerateDistanceTable(uint64_t EntryCount, uint32_t SolvedIndex, int32_t MoveCount, int32_t ThreadCount,
+                                           const TGetNeighbor& GetNeighbor, const FCubeOnDepthFinished& OnDepthFinished = {},
+                                           const TForEachEquivalent& ForEachEquivalent = {})
+{
+	static constexpr uint32_t UnknownDistance = 15;
+	static constexpr uint64_t WordsPerChunk = 4096;
+
+	const uint64_t WordCount = (EntryCount + 7) / 8;
+
+	// Eight entries per word, unknown entries are all ones, so setting a distance only clears bits
+	const std::unique_ptr<std::atomic<uint32_t>[]> Words(new std::atomic<uint32_t>[WordCount]);
+	for (uint64_t Word = 0; Word < WordCount; ++Word)
+	{
+		Words[Word].store(~0u, std::memory_order_relaxed);
+	}
+
+	const auto GetEntry = [&Words](uint32_t Index)
+	{
+		return Words[Index >> 3].load(std::memory_order_relaxed) >> ((Index & 7) * 4) & 15;
+	};
+	// Entry may be set concurrently by several threads, but all of them write the same distance
+	const auto SetEntry = [&Words](uint32_t Index, uint32_t Distance)
+	{
+		const uint32_t Shift = (Index & 7) * 4;
+		const uint32_t Old = Words[Index >> 3].fetch_and(~((UnknownDistance ^ Distance) << Shift), std::memory_order_relaxed);
+		return (Old >> Shift & 15) == UnknownDistance;
+	};
+	// Returns number of entries set, which is zero when another thread was first
+	const auto SetState = [&SetEntry, &ForEachEquivalent](uint32_t Index, uint32_t Distance) -> uint64_t
+	{
+		if (!SetEntry(Index, Distance)) return 0;
+		uint64_t Count = 1;
+		ForEachEquivalent(Index, [&](uint32_t Other) { Count += SetEntry(Other, Distance); });
+		return Count;
+	};
+
+	const uint64_t SolvedCount = SetState(SolvedIndex, 0);
+	if (OnDepthFinished) OnDepthFinished(0, SolvedCount);
+
+	ThreadCount = std::max(ThreadCount, 1);
+	uint64_t Frontier = SolvedCount;
+	uint64_t Unknown = EntryCount - SolvedCount;
+	for (uint32_t Depth = 0; Frontier > 0; ++Depth)
+	{
+		// Entries of Depth - 15 look like the frontier too, but they have no unknown neighbours left
+		const uint32_t Stored = Depth % UnknownDistance;
+		const uint32_t NextStored = (Depth + 1) % UnknownDistance;
+		// Once most states are known it's cheaper to look for a known neighbour of every unknown state
+		const bool bBackward = Unknown < Frontier;
+		std::atomic<uint64_t> NextChunk{0};
+		std::atomic<uint64_t> Found{0};
+
+		const auto Worker = [&]()
+		{
+			uint64_t LocalFound = 0;
+			for (uint64_t Chunk = NextChunk.fetch_add(1); Chunk * WordsPerChunk < WordCount; Chunk = NextChunk.fetch_add(1))
+			{
+				const uint64_t LastWord = std::min(WordCount, (Chunk + 1) * WordsPerChunk);
+				for (uint64_t Word = Chunk * WordsPerChunk; Word < LastWord; ++Word)
+				{
+					const uint32_t Value = Words[Word].load(std::memory_order_relaxed);
+					for (uint32_t Slot = 0; Slot < 8 && Word * 8 + Slot < EntryCount; ++Slot)
+					{
+						const uint32_t Entry = Value >> (Slot * 4) & 15;
+						const uint32_t Index = static_cast<uint32_t>(Word * 8 + Slot);
+						if (bBackward && Entry == UnknownDistance)
+						{
+							for (int32_t Move = 0; Move < MoveCount; ++Move)
+							{
+								if (GetEntry(GetNeighbor(Index, Move)) == Stored)
+								{
+									LocalFound += SetState(Index, NextStored);
+									break;
+								}
+							}
+						}
+						else if (!bBackward && Entry == Stored)
+						{
+							for (int32_t Move = 0; Move < MoveCount; ++Move)
+							{
+								const uint32_t Neighbor = GetNeighbor(Index, Move);
+								if (GetEntry(Neighbor) == UnknownDistance)
+								{
+									LocalFound += SetState(Neighbor, NextStored);
+								}
+							}
+						}
+					}
+				}
+			}
+			Found.fetch_add(LocalFound);
+		};
+
+		std::vector<std::thread> Threads;
+		for (int32_t Thread = 1; Thread < ThreadCount; ++Thread)
+		{
+			Threads.emplace_back(Worker);
+		}
+		Worker();
+		for (std::thread& Thread : Threads)
+		{
+			Thread.join();
+		}
+
+		Frontier = Found.load();
+		Unknown -= Frontier;
+		if (OnDepthFinished && Frontier > 0) OnDepthFinished(static_cast<int32_t>(Depth + 1), Frontier);
+	}
+
+	std::vector<uint8_t> Bytes((EntryCount + 1) / 2);
+	for (size_t Byte = 0; Byte < Bytes.size(); ++Byte)
+	{
+		Bytes[Byte] = static_cast<uint8_t>(Words[Byte >> 2].load(std::memory_order_relaxed) >> ((Byte & 3) * 8));
+	}
+	return Bytes;
+}
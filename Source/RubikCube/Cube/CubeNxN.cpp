@@ -0,0 +1,427 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeNxN.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace CubeNxNImpl
+{
+/** Outward normal of every face */
+static constexpr int32_t FaceNormals[6][3] = {{0, 1, 0}, {1, 0, 0}, {0, 0, 1}, {0, -1, 0}, {-1, 0, 0}, {0, 0, -1}};
+
+static ECubeFace GetFaceOfNormal(const int32_t (&Normal)[3])
+{
+	for (int32_t Face = 0; Face < 6; ++Face)
+	{
+		if (FaceNormals[Face][0] == Normal[0] && FaceNormals[Face][1] == Normal[1] && FaceNormals[Face][2] == Normal[2])
+		{
+			return static_cast<ECubeFace>(Face);
+		}
+	}
+	return ECubeFace::U;
+}
+
+/** Clockwise quarter turn about the axis of U, R or F seen from that face, on a vector centered on the cube */
+static void RotateClockwise(int32_t Axis, int32_t (&Vector)[3])
+{
+	const int32_t X = Vector[0];
+	const int32_t Y = Vector[1];
+	const int32_t Z = Vector[2];
+	switch (Axis)
+	{
+	case 0:
+		Vector[0] = -Z;
+		Vector[2] = X;
+		break;
+	case 1:
+		Vector[1] = Z;
+		Vector[2] = -Y;
+		break;
+	default:
+		Vector[0] = Y;
+		Vector[1] = -X;
+		break;
+	}
+}
+
+static FCubeNxNLayout BuildLayout(int32_t Size)
+{
+	FCubeNxNLayout Layout;
+	Layout.Size = Size;
+	Layout.LayerCycles.resize(3 * Size);
+
+	// Doubled coordinates centered on the cube stay integers for even sizes
+	const auto TurnSticker = [&Layout, Size](int32_t Axis, int32_t Sticker)
+	{
+		int32_t Position[3];
+		Layout.GetStickerPosition(Sticker, Position[0], Position[1], Position[2]);
+		int32_t Centered[3] = {2 * Position[0] - (Size - 1), 2 * Position[1] - (Size - 1), 2 * Position[2] - (Size - 1)};
+		int32_t Normal[3] = {FaceNormals[Sticker / (Size * Size)][0], FaceNormals[Sticker / (Size * Size)][1], FaceNormals[Sticker / (Size * Size)][2]};
+		RotateClockwise(Axis, Centered);
+		RotateClockwise(Axis, Normal);
+		return Layout.GetStickerAt(GetFaceOfNormal(Normal), (Centered[0] + Size - 1) / 2, (Centered[1] + Size - 1) / 2,
+		                           (Centered[2] + Size - 1) / 2);
+	};
+
+	for (int32_t Axis = 0; Axis < 3; ++Axis)
+	{
+		for (int32_t Layer = 0; Layer < Size; ++Layer)
+		{
+			std::vector<bool> bVisited(Layout.GetStickerCount(), false);
+			std::vector<uint16_t>& Cycles = Layout.LayerCycles[Axis * Size + Layer];
+			for (int32_t Sticker = 0; Sticker < Layout.GetStickerCount(); ++Sticker)
+			{
+				int32_t Position[3];
+				Layout.GetStickerPosition(Sticker, Position[0], Position[1], Position[2]);
+				// Axis 0 is Y, 1 is X, 2 is Z, layers count from the positive side
+				const int32_t Coordinate = Position[Axis == 0 ? 1 : Axis == 1 ? 0 : 2];
+				if (bVisited[Sticker] || Coordinate != Size - 1 - Layer) continue;
+
+				const int32_t Next = TurnSticker(Axis, Sticker);
+				bVisited[Sticker] = true;
+				// Center sticker of an odd outer face stays in place
+				if (Next == Sticker) continue;
+
+				int32_t Current = Sticker;
+				for (int32_t Step = 0; Step < 4; ++Step)
+				{
+					Cycles.push_back(static_cast<uint16_t>(Current));
+					bVisited[Current] = true;
+					Current = TurnSticker(Axis, Current);
+				}
+			}
+		}
+	}
+	return Layout;
+}
+
+static int32_t GetDeterminant(const int32_t (&A)[3], const int32_t (&B)[3], const int32_t (&C)[3])
+{
+	return A[0] * (B[1] * C[2] - B[2] * C[1]) - A[1] * (B[0] * C[2] - B[2] * C[0]) + A[2] * (B[0] * C[1] - B[1] * C[0]);
+}
+
+/**
+ * Kind, orbit and identity of every cubie, none of which a layer turn changes. Centers only move between the quarter
+ * turns of their face position, wings keep their distance from the middle of the edge and their handedness,
+ * and the handedness of a piece is the sign of the determinant of its sticker normals ordered by color.
+ */
+static std::vector<uint64_t> GetPieceKeys(const FCubeNxN& Cube)
+{
+	const FCubeNxNLayout& Layout = Cube.GetLayout();
+	const int32_t Size = Layout.Size;
+	const int32_t Last = Size - 1;
+	const int32_t FaceSize = Size * Size;
+
+	std::map<int32_t, std::vector<int32_t>> CubieStickers;
+	for (int32_t Sticker = 0; Sticker < Layout.GetStickerCount(); ++Sticker)
+	{
+		int32_t X, Y, Z;
+		Layout.GetStickerPosition(Sticker, X, Y, Z);
+		CubieStickers[(X * Size + Y) * Size + Z].push_back(Sticker);
+	}
+
+	std::vector<uint64_t> Keys;
+	for (auto& [Cubie, Stickers] : CubieStickers)
+	{
+		std::sort(Stickers.begin(), Stickers.end(), [&Cube](int32_t A, int32_t B) { return Cube.GetSticker(A) < Cube.GetSticker(B); });
+		const auto GetNormal = [FaceSize, &Stickers](size_t Index) -> const int32_t (&)[3] { return FaceNormals[Stickers[Index] / FaceSize]; };
+		uint64_t Orbit = 0;
+		uint64_t Identity = 0;
+		for (const int32_t Sticker : Stickers)
+		{
+			Identity = Identity * 6 + Cube.GetSticker(Sticker);
+		}
+
+		if (Stickers.size() == 1)
+		{
+			int32_t Row = Stickers[0] / Size % Size;
+			int32_t Column = Stickers[0] % Size;
+			Orbit = static_cast<uint64_t>(FaceSize);
+			for (int32_t Turn = 0; Turn < 4; ++Turn)
+			{
+				Orbit = std::min(Orbit, static_cast<uint64_t>(Row * Size + Column));
+				const int32_t Next = Column;
+				Column = Last - Row;
+				Row = Next;
+			}
+		}
+		else if (Stickers.size() == 2)
+		{
+			int32_t Position[3];
+			Layout.GetStickerPosition(Stickers[0], Position[0], Position[1], Position[2]);
+			int32_t Offset[3] = {0, 0, 0};
+			for (int32_t Axis = 0; Axis < 3; ++Axis)
+			{
+				if (Position[Axis] != 0 && Position[Axis] != Last)
+				{
+					Offset[Axis] = 2 * Position[Axis] - Last;
+					Orbit = static_cast<uint64_t>(std::min(Position[Axis], Last - Position[Axis]));
+				}
+			}
+			// Middle edges have no offset, their flip is checked with the corners
+			Identity = Identity * 3 + (GetDeterminant(GetNormal(0), GetNormal(1), Offset) > 0) + (Offset[0] | Offset[1] | Offset[2] ? 1 : 0);
+		}
+		else
+		{
+			Identity = Identity * 2 + (GetDeterminant(GetNormal(0), GetNormal(1), GetNormal(2)) > 0);
+		}
+		Keys.push_back(static_cast<uint64_t>(Stickers.size()) << 56 | Orbit << 24 | Identity);
+	}
+	std::sort(Keys.begin(), Keys.end());
+	return Keys;
+}
+}
+
+using namespace CubeNxNImpl;
+
+const FCubeNxNLayout& FCubeNxNLayout::Get(int32_t Size)
+{
+	static std::mutex Mutex;
+	static std::map<int32_t, std::unique_ptr<FCubeNxNLayout>> Layouts;
+
+	std::lock_guard<std::mutex> Lock(Mutex);
+	std::unique_ptr<FCubeNxNLayout>& Layout = Layouts[Size];
+	if (!Layout)
+	{
+		Layout = std::make_unique<FCubeNxNLayout>(BuildLayout(Size));
+	}
+	return *Layout;
+}
+
+int32_t FCubeNxNLayout::GetStickerAt(ECubeFace Face, int32_t X, int32_t Y, int32_t Z) const
+{
+	const int32_t Last = Size - 1;
+	switch (Face)
+	{
+	case ECubeFace::U: return GetStickerIndex(Face, Z, X);
+	case ECubeFace::R: return GetStickerIndex(Face, Last - Y, Last - Z);
+	case ECubeFace::F: return GetStickerIndex(Face, Last - Y, X);
+	case ECubeFace::D: return GetStickerIndex(Face, Last - Z, X);
+	case ECubeFace::L: return GetStickerIndex(Face, Last - Y, Z);
+	default: return GetStickerIndex(Face, Last - Y, Last - X);
+	}
+}
+
+void FCubeNxNLayout::GetStickerPosition(int32_t Sticker, int32_t& OutX, int32_t& OutY, int32_t& OutZ) const
+{
+	const int32_t Last = Size - 1;
+	const ECubeFace Face = static_cast<ECubeFace>(Sticker / (Size * Size));
+	const int32_t Row = Sticker / Size % Size;
+	const int32_t Column = Sticker % Size;
+	switch (Face)
+	{
+	case ECubeFace::U: OutX = Column; OutY = Last; OutZ = Row; break;
+	case ECubeFace::R: OutX = Last; OutY = Last - Row; OutZ = Last - Column; break;
+	case ECubeFace::F: OutX = Column; OutY = Last - Row; OutZ = Last; break;
+	case ECubeFace::D: OutX = Column; OutY = 0; OutZ = Last - Row; break;
+	case ECubeFace::L: OutX = 0; OutY = Last - Row; OutZ = Column; break;
+	default: OutX = Last - Column; OutY = Last - Row; OutZ = 0; break;
+	}
+}
+
+void FCubeNxNLayout::ToAxisTurn(const FCubeLayerMove& Move, int32_t& OutAxis, int32_t& OutLayer, int32_t& OutTurns) const
+{
+	const int32_t Face = static_cast<int32_t>(Move.Face);
+	OutAxis = Face % 3;
+	OutLayer = Face < 3 ? Move.Layer : Size - 1 - Move.Layer;
+	OutTurns = Face < 3 ? Move.Turns % 4 : (4 - Move.Turns % 4) % 4;
+}
+
+FCubeLayerMove FCubeNxNLayout::FromAxisTurn(int32_t Axis, int32_t Layer, int32_t Turns) const
+{
+	FCubeLayerMove Move;
+	const bool bOpposite = Layer > Size - 1 - Layer;
+	Move.Face = static_cast<ECubeFace>(Axis + (bOpposite ? 3 : 0));
+	Move.Layer = static_cast<uint8_t>(bOpposite ? Size - 1 - Layer : Layer);
+	Move.Turns = static_cast<uint8_t>(bOpposite ? (4 - Turns) % 4 : Turns);
+	return Move;
+}
+
+FCubeNxN::FCubeNxN(int32_t InSize)
+	: Layout(&FCubeNxNLayout::Get(std::clamp(InSize, MinSize, MaxSize)))
+	, Stickers(Layout->GetStickerCount())
+{
+	const int32_t FaceSize = Layout->Size * Layout->Size;
+	for (int32_t Sticker = 0; Sticker < Layout->GetStickerCount(); ++Sticker)
+	{
+		Stickers[Sticker] = static_cast<uint8_t>(Sticker / FaceSize);
+	}
+}
+
+void FCubeNxN::Apply(const FCubeLayerMove& Move)
+{
+	int32_t Axis, Layer, Turns;
+	Layout->ToAxisTurn(Move, Axis, Layer, Turns);
+	if (Layer < 0 || Layer >= Layout->Size || Turns == 0) return;
+
+	const std::vector<uint16_t>& Cycles = Layout->LayerCycles[Axis * Layout->Size + Layer];
+	uint8_t* Data = Stickers.data();
+	for (size_t Index = 0; Index < Cycles.size(); Index += 4)
+	{
+		const uint16_t A = Cycles[Index];
+		const uint16_t B = Cycles[Index + 1];
+		const uint16_t C = Cycles[Index + 2];
+		const uint16_t D = Cycles[Index + 3];
+		const uint8_t Color = Data[A];
+		if (Turns == 1)
+		{
+			Data[A] = Data[D];
+			Data[D] = Data[C];
+			Data[C] = Data[B];
+			Data[B] = Color;
+		}
+		else if (Turns == 2)
+		{
+			Data[A] = Data[C];
+			Data[C] = Color;
+			std::swap(Data[B], Data[D]);
+		}
+		else
+		{
+			Data[A] = Data[B];
+			Data[B] = Data[C];
+			Data[C] = Data[D];
+			Data[D] = Color;
+		}
+	}
+}
+
+void FCubeNxN::Apply(const std::vector<FCubeLayerMove>& Moves)
+{
+	for (const FCubeLayerMove& Move : Moves)
+	{
+		Apply(Move);
+	}
+}
+
+bool FCubeNxN::IsSolved() const
+{
+	const int32_t FaceSize = Layout->Size * Layout->Size;
+	for (int32_t Sticker = 0; Sticker < Layout->GetStickerCount(); ++Sticker)
+	{
+		if (Stickers[Sticker] != Stickers[Sticker - Sticker % FaceSize]) return false;
+	}
+	return true;
+}
+
+bool FCubeNxN::IsReachable() const
+{
+	for (const uint8_t Color : Stickers)
+	{
+		if (Color >= 6) return false;
+	}
+	if (GetPieceKeys(*this) != GetPieceKeys(FCubeNxN(Layout->Size))) return false;
+
+	uint8_t Scheme[6];
+	uint8_t ColorFace[6];
+	if (!GetColorScheme(Scheme)) return false;
+	for (int32_t Face = 0; Face < 6; ++Face)
+	{
+		ColorFace[Scheme[Face]] = static_cast<uint8_t>(Face);
+	}
+
+	// Inner slices of even cubes swap no corners but wings, so only the corner twist is fixed there
+	FCubieCube Cube;
+	const bool bOdd = Layout->Size % 2 == 1;
+	if (!ReadCubie(ColorFace, bOdd, Cube)) return false;
+	if (bOdd) return Cube.IsSolvable();
+
+	int32_t Twist = 0;
+	for (const uint8_t Orientation : Cube.Co)
+	{
+		Twist += Orientation;
+	}
+	return Twist % 3 == 0;
+}
+
+bool FCubeNxN::GetColorScheme(uint8_t (&OutScheme)[6]) const
+{
+	const int32_t Size = Layout->Size;
+	if (Size % 2 == 1)
+	{
+		for (int32_t Face = 0; Face < 6; ++Face)
+		{
+			OutScheme[Face] = GetSticker(static_cast<ECubeFace>(Face), Size / 2, Size / 2);
+		}
+	}
+	else
+	{
+		const uint8_t Down = GetSticker(Layout->GetStickerAt(ECubeFace::D, 0, 0, 0));
+		const uint8_t Back = GetSticker(Layout->GetStickerAt(ECubeFace::B, 0, 0, 0));
+		const uint8_t Left = GetSticker(Layout->GetStickerAt(ECubeFace::L, 0, 0, 0));
+		OutScheme[static_cast<int32_t>(ECubeFace::D)] = Down;
+		OutScheme[static_cast<int32_t>(ECubeFace::B)] = Back;
+		OutScheme[static_cast<int32_t>(ECubeFace::L)] = Left;
+		OutScheme[static_cast<int32_t>(ECubeFace::U)] = static_cast<uint8_t>((Down + 3) % 6);
+		OutScheme[static_cast<int32_t>(ECubeFace::F)] = static_cast<uint8_t>((Back + 3) % 6);
+		OutScheme[static_cast<int32_t>(ECubeFace::R)] = static_cast<uint8_t>((Left + 3) % 6);
+	}
+
+	uint8_t Seen = 0;
+	for (const uint8_t Color : OutScheme)
+	{
+		if (Color >= 6) return false;
+		Seen |= 1 << Color;
+	}
+	return Seen == 0x3F;
+}
+
+bool FCubeNxN::ReadCubie(const uint8_t (&ColorFace)[6], bool bEdges, FCubieCube& OutCube) const
+{
+	const int32_t Size = Layout->Size;
+	const auto ReadFace = [&](int32_t Facelet)
+	{
+		const int32_t Coordinates[3] = {0, Size / 2, Size - 1};
+		return ColorFace[GetSticker(static_cast<ECubeFace>(Facelet / 9), Coordinates[Facelet % 9 / 3], Coordinates[Facelet % 3])];
+	};
+
+	OutCube = FCubieCube::Solved();
+	for (int32_t Corner = 0; Corner < CubeCornerCount; ++Corner)
+	{
+		const uint8_t Faces[3] = {ReadFace(CubeCornerFacelets[Corner][0]), ReadFace(CubeCornerFacelets[Corner][1]), ReadFace(CubeCornerFacelets[Corner][2])};
+		int32_t Twist = 0;
+		while (Twist < 3 && Faces[Twist] != static_cast<uint8_t>(ECubeFace::U) && Faces[Twist] != static_cast<uint8_t>(ECubeFace::D))
+		{
+			++Twist;
+		}
+		if (Twist == 3) return false;
+
+		int32_t Found = -1;
+		for (int32_t Cubie = 0; Cubie < CubeCornerCount && Found < 0; ++Cubie)
+		{
+			if (CubeCornerFacelets[Cubie][1] / 9 == Faces[(Twist + 1) % 3] && CubeCornerFacelets[Cubie][2] / 9 == Faces[(Twist + 2) % 3])
+			{
+				Found = Cubie;
+			}
+		}
+		if (Found < 0) return false;
+		OutCube.Cp[Corner] = static_cast<uint8_t>(Found);
+		OutCube.Co[Corner] = static_cast<uint8_t>(Twist);
+	}
+
+	if (bEdges)
+	{
+		for (int32_t Edge = 0; Edge < CubeEdgeCount; ++Edge)
+		{
+			const uint8_t First = ReadFace(CubeEdgeFacelets[Edge][0]);
+			const uint8_t Second = ReadFace(CubeEdgeFacelets[Edge][1]);
+			int32_t Found = -1;
+			for (int32_t Cubie = 0; Cubie < CubeEdgeCount && Found < 0; ++Cubie)
+			{
+				const uint8_t CubieFirst = CubeEdgeFacelets[Cubie][0] / 9;
+				const uint8_t CubieSecond = CubeEdgeFacelets[Cubie][1] / 9;
+				if ((CubieFirst == First && CubieSecond == Second) || (CubieFirst == Second && CubieSecond == First))
+				{
+					Found = Cubie;
+					OutCube.Eo[Edge] = CubieFirst != First;
+				}
+			}
+			if (Found < 0) return false;
+			OutCube.Ep[Edge] = static_cast<uint8_t>(Found);
+		}
+	}
+	return true;
+}
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CubeState.h"
+
+#include <cstdint>
+#include <vector>
+
+/** Turn of a single layer, Layer 0 is the outer layer of Face and Turns counts clockwise quarter turns seen from Face */
+struct FCubeLayerMove
+{
+	ECubeFace Face = ECubeFace::U;
+	uint8_t Layer = 0;
+	uint8_t Turns = 1;
+
+	bool operator==(const FCubeLayerMove& Other) const = default;
+};
+
+/** Facelets of every corner and edge position on a 3x3x3 as face * 9 + row * 3 + column, in the order of the cubie model */
+inline constexpr uint8_t CubeCornerFacelets[CubeCornerCount][3] = {
+	{8, 9, 20}, {6, 18, 38}, {0, 36, 47}, {2, 45, 11}, {29, 26, 15}, {27, 44, 24}, {33, 53, 42}, {35, 17, 51}};
+inline constexpr uint8_t CubeEdgeFacelets[CubeEdgeCount][2] = {
+	{5, 10}, {7, 19}, {3, 37}, {1, 46}, {32, 16}, {28, 25}, {30, 43}, {34, 52}, {23, 12}, {21, 41}, {50, 39}, {48, 14}};
+
+/**
+ * Sticker layout and layer turns of one cube size, shared by all cubes of that size.
+ * Stickers are stored face by face in U, R, F, D, L, B order, rows and columns as in the usual net:
+ * U seen from above with B at the top, D seen from below with F at the top, side faces with U at the top.
+ * Cubie coordinates run from L to R (X), D to U (Y) and B to F (Z).
+ */
+struct FCubeNxNLayout
+{
+	int32_t Size = 0;
+	/**
+	 * Clockwise quarter turn of every layer as 4-cycles of sticker indices, color at Cycle[0] goes to Cycle[1] and so on.
+	 * Layers are counted from the U, R and F face, [Axis * Size + Layer] with axis 0, 1, 2 for U, R, F.
+	 */
+	std::vector<std::vector<uint16_t>> LayerCycles;
+
+	static const FCubeNxNLayout& Get(int32_t Size);
+
+	int32_t GetStickerCount() const { return 6 * Size * Size; }
+
+	int32_t GetStickerIndex(ECubeFace Face, int32_t Row, int32_t Column) const
+	{
+		return (static_cast<int32_t>(Face) * Size + Row) * Size + Column;
+	}
+
+	/** Sticker of the cubie at X, Y, Z that lies on Face */
+	int32_t GetStickerAt(ECubeFace Face, int32_t X, int32_t Y, int32_t Z) const;
+	void GetStickerPosition(int32_t Sticker, int32_t& OutX, int32_t& OutY, int32_t& OutZ) const;
+
+	/** Same turn seen from the U, R or F face, as axis 0..2, layer counted from that face and clockwise quarter turns */
+	void ToAxisTurn(const FCubeLayerMove& Move, int32_t& OutAxis, int32_t& OutLayer, int32_t& OutTurns) const;
+	/** Inverse of ToAxisTurn, picks the face whose layer count is smaller */
+	FCubeLayerMove FromAxisTurn(int32_t Axis, int32_t Layer, int32_t Turns) const;
+};
+
+/**
+ * Cube of any size from 2 up, one byte per sticker holding the face the sticker belongs to when solved.
+ * A layer turn rewrites only the 4 * Size stickers around the layer and, for outer layers, the turned face.
+ */
+class FCubeNxN
+{
+public:
+	static constexpr int32_t MinSize = 2;
+	static constexpr int32_t MaxSize = 64;
+
+	/** Solved cube of InSize, clamped to [MinSize, MaxSize] */
+	explicit FCubeNxN(int32_t InSize);
+
+	int32_t GetSize() const { return Layout->Size; }
+	const FCubeNxNLayout& GetLayout() const { return *Layout; }
+
+	uint8_t GetSticker(int32_t Sticker) const { return Stickers[Sticker]; }
+	uint8_t GetSticker(ECubeFace Face, int32_t Row, int32_t Column) const { return Stickers[Layout->GetStickerIndex(Face, Row, Column)]; }
+	const std::vector<uint8_t>& GetStickers() const { return Stickers; }
+	void SetSticker(int32_t Sticker, uint8_t Color) { Stickers[Sticker] = Color; }
+
+	void Apply(const FCubeLayerMove& Move);
+	void Apply(const std::vector<FCubeLayerMove>& Moves);
+
+	/** Every face shows a single color, whole cube orientation doesn't matter */
+	bool IsSolved() const;
+
+	/**
+	 * Some sequence of layer turns reaches this cube from solved: every piece exists once with its own colors, and corners,
+	 * and the middle edges of odd cubes, follow the twist, flip and parity rules of a 3x3x3. Wings and centers of one color
+	 * are interchangeable, so any arrangement of them can be reached.
+	 */
+	bool IsReachable() const;
+
+	/** Color of every face: middle centers on odd cubes, the DBL corner and its opposite colors on even ones */
+	bool GetColorScheme(uint8_t (&OutScheme)[6]) const;
+
+	/** Reads the corners, and the middle or paired edges when bEdges, as a 3x3x3 in the faces given by ColorFace */
+	bool ReadCubie(const uint8_t (&ColorFace)[6], bool bEdges, FCubieCube& OutCube) const;
+
+	bool operator==(const FCubeNxN& Other) const { return Stickers == Other.Stickers; }
+
+private:
+	const FCubeNxNLayout* Layout;
+	std::vector<uint8_t> Stickers;
+};
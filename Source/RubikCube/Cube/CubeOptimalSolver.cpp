@@ -0,0 +1,262 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeOptimalSolver.h"
+
+#include "CubeSymmetry.h"
+
+#include <algorithm>
+
+namespace CubeOptimalSolverImpl
+{
+/** Limits are checked once per this many nodes */
+static constexpr uint64_t LimitCheckMask = 4095;
+
+static bool LoadOrGenerate(FCubePatternDatabase& Database, const std::string& Path, int32_t ThreadCount, std::string& OutError)
+{
+	std::string LoadError;
+	if (Database.Load(Path, LoadError))
+	{
+		return true;
+	}
+
+	Database.Generate(ThreadCount);
+	return Database.Save(Path, OutError) && Database.Load(Path, OutError);
+}
+
+/** Faces are skipped after themselves and after their opposite face with higher index, as U D equals D U */
+static bool IsRedundantFace(int32_t Face, int32_t LastFace)
+{
+	return Face == LastFace || Face + 3 == LastFace;
+}
+}
+
+using namespace CubeOptimalSolverImpl;
+
+struct FCubeOptimalSolver::FSearchContext
+{
+	const FCubeSearchLimits& Limits;
+	int32_t Bound = 0;
+	uint64_t Nodes = 0;
+	bool bStop = false;
+	ECubeMove Path[MaxSolutionLength];
+
+	explicit FSearchContext(const FCubeSearchLimits& InLimits)
+		: Limits(InLimits)
+	{
+	}
+
+	/** Counts a node and returns true when the search has to stop */
+	bool CountNode()
+	{
+		if ((++Nodes & LimitCheckMask) == 0 &&
+			(std::chrono::steady_clock::now() >= Limits.Deadline || (Limits.Cancel != nullptr && Limits.Cancel->load(std::memory_order_relaxed))))
+		{
+			bStop = true;
+		}
+		return bStop;
+	}
+};
+
+FCubeOptimalSolver::FCubeOptimalSolver()
+	: Corners(ECubePattern::Corners)
+	, Edges(ECubePattern::Edges)
+	, Tables(FCubePatternMoveTables::Get())
+{
+	const FCubieCube URF3 = GetSymmetryURF3();
+	const FCubieCube URF3Twice = FCubieCube::Multiply(URF3, URF3);
+	Views[0] = FCubieCube::Solved();
+	Views[1] = URF3;
+	Views[2] = URF3Twice;
+	for (int32_t View = 0; View < 3; ++View)
+	{
+		Views[View + 3] = FCubieCube::Multiply(GetSymmetryX2(), Views[View]);
+	}
+
+	for (int32_t View = 0; View < ViewCount; ++View)
+	{
+		for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+		{
+			ViewMoves[View][Move] = static_cast<uint8_t>(ConjugateMove(static_cast<ECubeMove>(Move), Views[View]));
+		}
+	}
+}
+
+bool FCubeOptimalSolver::Initialize(const std::string& Directory, int32_t ThreadCount, std::string& OutError)
+{
+	const std::string Prefix = Directory.empty() || Directory.back() == '/' ? Directory : Directory + '/';
+	return LoadOrGenerate(Corners, Prefix + CornersFileName, ThreadCount, OutError) &&
+		LoadOrGenerate(Edges, Prefix + EdgesFileName, ThreadCount, OutError);
+}
+
+FCubeOptimalSolver::FSearchNode FCubeOptimalSolver::MakeNode(const FCubeState& State) const
+{
+	FSearchNode Node;
+	Node.State = State;
+
+	const FCubieCube Cube = State.ToCubie();
+	for (int32_t View = 0; View < ViewCount; ++View)
+	{
+		const FCubieCube Conjugated = ConjugateCube(Cube, Views[View]);
+		Node.CornerPermutation[View] = GetCornerPermutation(Conjugated);
+		Node.CornerTwist[View] = GetCornerTwist(Conjugated);
+		Node.Edges[View] = GetEdgePatternIndex(Conjugated);
+	}
+	return Node;
+}
+
+bool FCubeOptimalSolver::TryApplyMove(const FSearchNode& Node, int32_t Move, int32_t Remaining, FSearchNode& OutChild) const
+{
+	// Views are moved one by one, so most children are rejected after a few lookups
+	for (int32_t View = 0; View < ViewCount; ++View)
+	{
+		const int32_t ViewMove = ViewMoves[View][Move];
+		OutChild.CornerPermutation[View] = Tables.CornerPermutation[Node.CornerPermutation[View] * CubeMoveCount + ViewMove];
+		OutChild.CornerTwist[View] = Tables.CornerTwist[Node.CornerTwist[View] * CubeMoveCount + ViewMove];
+		OutChild.Edges[View] = Tables.MoveEdgeSix(Node.Edges[View], ViewMove);
+
+		if (Corners.GetDistance(GetCornerPatternIndex(OutChild.CornerPermutation[View], OutChild.CornerTwist[View])) > Remaining ||
+			Edges.GetDistance(OutChild.Edges[View]) > Remaining)
+		{
+			return false;
+		}
+	}
+
+	OutChild.State = Node.State.Apply(static_cast<ECubeMove>(Move));
+	// Inverse lookup is more expensive, so it is done only for children the regular lookups keep
+	return Remaining == 0 || GetInverseHeuristic(OutChild.State) <= Remaining;
+}
+
+int32_t FCubeOptimalSolver::GetHeuristic(const FSearchNode& Node) const
+{
+	int32_t Heuristic = 0;
+	for (int32_t View = 0; View < ViewCount; ++View)
+	{
+		Heuristic = std::max<int32_t>(Heuristic, Corners.GetDistance(GetCornerPatternIndex(Node.CornerPermutation[View], Node.CornerTwist[View])));
+		Heuristic = std::max<int32_t>(Heuristic, Edges.GetDistance(Node.Edges[View]));
+	}
+	return Heuristic;
+}
+
+int32_t FCubeOptimalSolver::GetInverseHeuristic(const FCubeState& State) const
+{
+	const FCubieCube Inverse = State.Inverse().ToCubie();
+	const FCubieCube Rotated = ConjugateCube(Inverse, Views[3]);
+	return std::max({
+		static_cast<int32_t>(Corners.GetDistance(GetCornerPatternIndex(Inverse))),
+		static_cast<int32_t>(Edges.GetDistance(GetEdgePatternIndex(Inverse))),
+		static_cast<int32_t>(Edges.GetDistance(GetEdgePatternIndex(Rotated)))
+	});
+}
+
+int32_t FCubeOptimalSolver::GetLowerBound(const FCubeState& State) const
+{
+	return std::max(GetHeuristic(MakeNode(State)), GetInverseHeuristic(State));
+}
+
+bool FCubeOptimalSolver::Search(FSearchContext& Context, const FSearchNode& Node, int32_t Depth, int32_t LastFace) const
+{
+	if (Depth == Context.Bound)
+	{
+		return Node.State.IsSolved();
+	}
+
+	for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+	{
+		const int32_t Face = Move / 3;
+		if (IsRedundantFace(Face, LastFace)) continue;
+
+		FSearchNode Child;
+		if (Context.CountNode()) return false;
+		if (!TryApplyMove(Node, Move, Context.Bound - Depth - 1, Child)) continue;
+
+		Context.Path[Depth] = static_cast<ECubeMove>(Move);
+		if (Search(Context, Child, Depth + 1, Face))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FCubeOptimalSolver::CollectSubtrees(FSearchContext& Context, const FSearchNode& Node, int32_t Depth, int32_t LastFace,
+                                         int32_t SplitDepth, std::vector<FSubtree>& OutSubtrees) const
+{
+	if (Depth == SplitDepth || Depth == Context.Bound)
+	{
+		OutSubtrees.push_back({std::vector<ECubeMove>(Context.Path, Context.Path + Depth), Node.State});
+		return;
+	}
+
+	for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+	{
+		const int32_t Face = Move / 3;
+		if (IsRedundantFace(Face, LastFace)) continue;
+
+		FSearchNode Child;
+		++Context.Nodes;
+		if (!TryApplyMove(Node, Move, Context.Bound - Depth - 1, Child)) continue;
+
+		Context.Path[Depth] = static_cast<ECubeMove>(Move);
+		CollectSubtrees(Context, Child, Depth + 1, Face, SplitDepth, OutSubtrees);
+	}
+}
+
+std::vector<FCubeOptimalSolver::FSubtree> FCubeOptimalSolver::SplitSearch(const FCubeState& State, int32_t Bound, int32_t SplitDepth,
+                                                                          uint64_t& InOutNodes) const
+{
+	const FCubeSearchLimits Limits;
+	FSearchContext Context(Limits);
+	Context.Bound = std::min(Bound, MaxSolutionLength);
+
+	std::vector<FSubtree> Subtrees;
+	CollectSubtrees(Context, MakeNode(State), 0, -1, SplitDepth, Subtrees);
+	InOutNodes += Context.Nodes;
+	return Subtrees;
+}
+
+bool FCubeOptimalSolver::SearchSubtree(const FSubtree& Subtree, int32_t Bound, std::vector<ECubeMove>& OutMoves, uint64_t& InOutNodes,
+                                       const FCubeSearchLimits& Limits) const
+{
+	FSearchContext Context(Limits);
+	Context.Bound = std::min(Bound, MaxSolutionLength);
+
+	const int32_t Depth = static_cast<int32_t>(Subtree.Path.size());
+	std::copy(Subtree.Path.begin(), Subtree.Path.end(), Context.Path);
+	const int32_t LastFace = Depth > 0 ? static_cast<int32_t>(GetMoveFace(Subtree.Path.back())) : -1;
+
+	const bool bFound = Depth <= Context.Bound && Search(Context, MakeNode(Subtree.State), Depth, LastFace);
+	if (bFound)
+	{
+		OutMoves.assign(Context.Path, Context.Path + Context.Bound);
+	}
+	InOutNodes += Context.Nodes;
+	return bFound;
+}
+
+bool FCubeOptimalSolver::Solve(const FCubeState& State, std::vector<ECubeMove>& OutMoves, FCubeSolveStats* OutStats, int32_t MaxDepth,
+                               const FCubeSearchLimits& Limits) const
+{
+	const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+
+	OutMoves.clear();
+	const FSearchNode Root = MakeNode(State);
+	FSearchContext Context(Limits);
+
+	bool bFound = false;
+	MaxDepth = std::min(MaxDepth, MaxSolutionLength);
+	for (Context.Bound = GetLowerBound(State); !bFound && !Context.bStop && Context.Bound <= MaxDepth; ++Context.Bound)
+	{
+		bFound = Search(Context, Root, 0, -1);
+		if (bFound)
+		{
+			OutMoves.assign(Context.Path, Context.Path + Context.Bound);
+		}
+	}
+
+	if (OutStats)
+	{
+		OutStats->Nodes = Context.Nodes;
+		OutStats->Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+	}
+	return bFound;
+}
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CubePatternDatabase.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+struct FCubeSolveStats
+{
+	uint64_t Nodes = 0;
+	double Seconds = 0.0;
+};
+
+/** Ends a search early, both are checked once per few thousand nodes */
+struct FCubeSearchLimits
+{
+	std::chrono::steady_clock::time_point Deadline = std::chrono::steady_clock::time_point::max();
+	/** May be set from another thread */
+	const std::atomic<bool>* Cancel = nullptr;
+};
+
+/**
+ * Optimal solver, IDA* over face turns with pattern database heuristics in the style of Korf.
+ * Corner and edge databases are looked up in six conjugated views of the state: the identity,
+ * both diagonal rotations and the same three after x2, which brings the other six edges into the edge pattern.
+ * States not pruned that way are also looked up through their inverse, which has the same distance.
+ */
+class FCubeOptimalSolver
+{
+public:
+	static constexpr int32_t MaxSolutionLength = 20;
+	static constexpr const char* CornersFileName = "Corners.pdb";
+	static constexpr const char* EdgesFileName = "Edges.pdb";
+
+	FCubeOptimalSolver();
+
+	/** Loads pattern databases from Directory, missing ones are generated with ThreadCount threads and saved there */
+	bool Initialize(const std::string& Directory, int32_t ThreadCount, std::string& OutError);
+
+	bool IsReady() const { return Corners.IsValid() && Edges.IsValid(); }
+
+	/** Finds the shortest solution, returns false when there is none up to MaxDepth moves or the search hit Limits */
+	bool Solve(const FCubeState& State, std::vector<ECubeMove>& OutMoves, FCubeSolveStats* OutStats = nullptr,
+	           int32_t MaxDepth = MaxSolutionLength, const FCubeSearchLimits& Limits = {}) const;
+
+	/** Node of one IDA* iteration that the heuristic didn't prune, searching below all of them covers the iteration */
+	struct FSubtree
+	{
+		std::vector<ECubeMove> Path;
+		FCubeState State;
+	};
+
+	/** Splits the iteration with Bound at SplitDepth, so threads can search the subtrees independently */
+	std::vector<FSubtree> SplitSearch(const FCubeState& State, int32_t Bound, int32_t SplitDepth, uint64_t& InOutNodes) const;
+
+	/** Searches one subtree of the iteration with Bound, OutMoves is the whole solution including Subtree.Path */
+	bool SearchSubtree(const FSubtree& Subtree, int32_t Bound, std::vector<ECubeMove>& OutMoves, uint64_t& InOutNodes,
+	                   const FCubeSearchLimits& Limits = {}) const;
+
+	/** Lower bound of the distance of State, max over all lookups the search uses */
+	int32_t GetLowerBound(const FCubeState& State) const;
+
+private:
+	static constexpr int32_t ViewCount = 6;
+
+	struct FSearchNode
+	{
+		uint16_t CornerPermutation[ViewCount];
+		uint16_t CornerTwist[ViewCount];
+		uint32_t Edges[ViewCount];
+		FCubeState State;
+	};
+
+	struct FSearchContext;
+
+	FSearchNode MakeNode(const FCubeState& State) const;
+	/** Moves Node to OutChild, returns false as soon as some lookup proves the child needs more than Remaining moves */
+	bool TryApplyMove(const FSearchNode& Node, int32_t Move, int32_t Remaining, FSearchNode& OutChild) const;
+	int32_t GetHeuristic(const FSearchNode& Node) const;
+	int32_t GetInverseHeuristic(const FCubeState& State) const;
+	bool Search(FSearchContext& Context, const FSearchNode& Node, int32_t Depth, int32_t LastFace) const;
+	void CollectSubtrees(FSearchContext& Context, const FSearchNode& Node, int32_t Depth, int32_t LastFace, int32_t SplitDepth,
+	                     std::vector<FSubtree>& OutSubtrees) const;
+
+	FCubePatternDatabase Corners;
+	FCubePatternDatabase Edges;
+	const FCubePatternMoveTables& Tables;
+
+	FCubieCube Views[ViewCount];
+	/** Move applied to view V when the state is turned by move M */
+	uint8_t ViewMoves[ViewCount][CubeMoveCount];
+};
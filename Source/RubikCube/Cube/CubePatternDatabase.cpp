@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubePatternDatabase.h"
+
+namespace CubePatternDatabaseImpl
+{
+static FCubePatternMoveTables BuildMoveTables()
+{
+	FCubieCube Moves[CubeMoveCount];
+	for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+	{
+		Moves[Move] = FCubieCube::FromMove(static_cast<ECubeMove>(Move));
+	}
+
+	FCubePatternMoveTables Tables;
+	Tables.CornerTwist.resize(CornerTwistCount * CubeMoveCount);
+	for (int32_t Twist = 0; Twist < CornerTwistCount; ++Twist)
+	{
+		FCubieCube Cube = FCubieCube::Solved();
+		SetCornerTwist(Cube, static_cast<uint16_t>(Twist));
+		for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+		{
+			Tables.CornerTwist[Twist * CubeMoveCount + Move] = GetCornerTwist(FCubieCube::Multiply(Cube, Moves[Move]));
+		}
+	}
+
+	Tables.CornerPermutation.resize(CornerPermutationCount * CubeMoveCount);
+	for (int32_t Permutation = 0; Permutation < CornerPermutationCount; ++Permutation)
+	{
+		FCubieCube Cube = FCubieCube::Solved();
+		SetCornerPermutation(Cube, static_cast<uint16_t>(Permutation));
+		for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+		{
+			Tables.CornerPermutation[Permutation * CubeMoveCount + Move] = GetCornerPermutation(FCubieCube::Multiply(Cube, Moves[Move]));
+		}
+	}
+
+	// Edges are followed by position: cubie at position P ends at Destination[P]
+	uint8_t Destination[CubeMoveCount][CubeEdgeCount];
+	for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+	{
+		for (int32_t Position = 0; Position < CubeEdgeCount; ++Position)
+		{
+			Destination[Move][Moves[Move].Ep[Position]] = static_cast<uint8_t>(Position);
+		}
+	}
+
+	Tables.EdgeSix.resize(static_cast<size_t>(EdgeSixPositionCount) * CubeMoveCount);
+	for (uint32_t Rank = 0; Rank < EdgeSixPositionCount; ++Rank)
+	{
+		uint8_t Positions[6];
+		UnrankEdgeSixPositions(Rank, Positions);
+		for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+		{
+			uint8_t Moved[6];
+			uint32_t Flips = 0;
+			for (int32_t Index = 0; Index < 6; ++Index)
+			{
+				Moved[Index] = Destination[Move][Positions[Index]];
+				Flips |= static_cast<uint32_t>(Moves[Move].Eo[Moved[Index]]) << Index;
+			}
+			Tables.EdgeSix[static_cast<size_t>(Rank) * CubeMoveCount + Move] = RankEdgeSixPositions(Moved) << 6 | Flips;
+		}
+	}
+	return Tables;
+}
+}
+
+using namespace CubePatternDatabaseImpl;
+
+const FCubePatternMoveTables& FCubePatternMoveTables::Get()
+{
+	static const FCubePatternMoveTables Tables = BuildMoveTables();
+	return Tables;
+}
+
+FCubePatternDatabase::FCubePatternDatabase(ECubePattern InPattern)
+	: Pattern(InPattern)
+{
+}
+
+uint64_t FCubePatternDatabase::GetEntryCount(ECubePattern Pattern)
+{
+	return Pattern == ECubePattern::Corners
+		? static_cast<uint64_t>(CornerPermutationCount) * CornerTwistCount
+		: static_cast<uint64_t>(EdgeSixCount);
+}
+
+void FCubePatternDatabase::Generate(int32_t ThreadCount, const FOnDepthFinished& OnDepthFinished)
+{
+	Table.Reset();
+
+	const FCubePatternMoveTables& Tables = FCubePatternMoveTables::Get();
+	const auto GetNeighbor = [this, &Tables](uint32_t Index, int32_t Move) -> uint32_t
+	{
+		if (Pattern == ECubePattern::Edges)
+		{
+			return Tables.MoveEdgeSix(Index, Move);
+		}
+		const uint32_t Permutation = Index / CornerTwistCount;
+		const uint32_t Twist = Index % CornerTwistCount;
+		return GetCornerPatternIndex(Tables.CornerPermutation[Permutation * CubeMoveCount + Move],
+		                             Tables.CornerTwist[Twist * CubeMoveCount + Move]);
+	};
+
+	const FCubieCube Solved = FCubieCube::Solved();
+	const uint32_t SolvedIndex = Pattern == ECubePattern::Corners ? GetCornerPatternIndex(Solved) : GetEdgePatternIndex(Solved);
+	Table.Assign(GenerateDistanceTable(GetEntryCount(Pattern), SolvedIndex, CubeMoveCount, ThreadCount, GetNeighbor, OnDepthFinished));
+}
+
+bool FCubePatternDatabase::Save(const std::string& Path, std::string& OutError) const
+{
+	return Table.Save(Path, static_cast<uint32_t>(Pattern), GetEntryCount(Pattern), OutError);
+}
+
+bool FCubePatternDatabase::Load(const std::string& Path, std::string& OutError)
+{
+	const uint64_t EntryCount = GetEntryCount(Pattern);
+	return Table.Load(Path, static_cast<uint32_t>(Pattern), EntryCount, static_cast<size_t>((EntryCount + 1) / 2), OutError);
+}
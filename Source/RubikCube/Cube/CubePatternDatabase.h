@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CubeCoordinates.h"
+#include "CubeDistanceTable.h"
+#include "CubeTableFile.h"
+
+#include <string>
+#include <vector>
+
+enum class ECubePattern : uint8_t
+{
+	/** Permutation and twist of all corners, 40320 * 2187 entries */
+	Corners,
+	/** Positions and flips of UR, UF, UL, UB, FR and FL, 665280 * 64 entries */
+	Edges
+};
+
+/** Edges of ECubePattern::Edges, the other six are their image under x2 rotation */
+constexpr uint8_t PatternEdges[6] = {0, 1, 2, 3, 8, 9};
+
+/** Coordinate move tables shared by pattern database generation and search, about 50 MB, built on first use */
+struct FCubePatternMoveTables
+{
+	/** [Twist * CubeMoveCount + Move] */
+	std::vector<uint16_t> CornerTwist;
+	/** [Permutation * CubeMoveCount + Move] */
+	std::vector<uint16_t> CornerPermutation;
+	/** [PositionRank * CubeMoveCount + Move], new position rank shifted left by 6 ored with flips to toggle */
+	std::vector<uint32_t> EdgeSix;
+
+	static const FCubePatternMoveTables& Get();
+
+	uint32_t MoveEdgeSix(uint32_t Coordinate, int32_t Move) const
+	{
+		const uint32_t Entry = EdgeSix[(Coordinate >> 6) * CubeMoveCount + Move];
+		return (Entry & ~63u) | ((Coordinate ^ Entry) & 63u);
+	}
+};
+
+inline uint32_t GetCornerPatternIndex(uint16_t Permutation, uint16_t Twist)
+{
+	return static_cast<uint32_t>(Permutation) * CornerTwistCount + Twist;
+}
+
+inline uint32_t GetCornerPatternIndex(const FCubieCube& Cube)
+{
+	return GetCornerPatternIndex(GetCornerPermutation(Cube), GetCornerTwist(Cube));
+}
+
+inline uint32_t GetEdgePatternIndex(const FCubieCube& Cube)
+{
+	return GetEdgeSixCoordinate(Cube, PatternEdges);
+}
+
+/**
+ * Exact distance to the solved pattern for every state of a pattern, 4 bits per entry.
+ * Generated by multi-threaded breadth first search and stored on disk,
+ * loaded files are memory mapped where the platform supports it.
+ */
+class FCubePatternDatabase
+{
+public:
+	explicit FCubePatternDatabase(ECubePattern InPattern);
+
+	static uint64_t GetEntryCount(ECubePattern Pattern);
+
+	using FOnDepthFinished = FCubeOnDepthFinished;
+
+	void Generate(int32_t ThreadCount, const FOnDepthFinished& OnDepthFinished = {});
+
+	bool Save(const std::string& Path, std::string& OutError) const;
+	bool Load(const std::string& Path, std::string& OutError);
+
+	bool IsValid() const { return Table.IsValid(); }
+	ECubePattern GetPattern() const { return Pattern; }
+
+	uint8_t GetDistance(uint32_t Index) const
+	{
+		return GetPackedDistance(Table.GetData(), Index);
+	}
+
+private:
+	ECubePattern Pattern;
+	FCubeTableFile Table;
+};
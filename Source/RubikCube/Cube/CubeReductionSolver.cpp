@@ -0,0 +1,574 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeReductionSolver.h"
+
+#include "CubeTwoPhaseSolver.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace CubeReductionSolverImpl
+{
+using FClock = std::chrono::steady_clock;
+
+constexpr int32_t PositionCount = FCubeReductionOrbit::PositionCount;
+
+/** Every layer turn in axis form, Moves[(Axis * Size + Layer) * 3 + Turns - 1], with the sticker each sticker moves to */
+struct FMoveSet
+{
+	std::vector<FCubeLayerMove> Moves;
+	std::vector<std::vector<uint16_t>> Maps;
+
+	explicit FMoveSet(const FCubeNxNLayout& Layout)
+	{
+		for (int32_t Axis = 0; Axis < 3; ++Axis)
+		{
+			for (int32_t Layer = 0; Layer < Layout.Size; ++Layer)
+			{
+				const std::vector<uint16_t>& Cycles = Layout.LayerCycles[Axis * Layout.Size + Layer];
+				for (int32_t Turns = 1; Turns <= 3; ++Turns)
+				{
+					std::vector<uint16_t> Map(Layout.GetStickerCount());
+					for (int32_t Sticker = 0; Sticker < Layout.GetStickerCount(); ++Sticker)
+					{
+						Map[Sticker] = static_cast<uint16_t>(Sticker);
+					}
+					for (size_t Index = 0; Index < Cycles.size(); Index += 4)
+					{
+						for (int32_t Step = 0; Step < 4; ++Step)
+						{
+							Map[Cycles[Index + Step]] = Cycles[Index + (Step + Turns) % 4];
+						}
+					}
+					Moves.push_back({static_cast<ECubeFace>(Axis), static_cast<uint8_t>(Layer), static_cast<uint8_t>(Turns)});
+					Maps.push_back(std::move(Map));
+				}
+			}
+		}
+	}
+
+	int32_t GetInverse(int32_t Move) const { return Move - Move % 3 + 2 - Move % 3; }
+	int32_t GetAxis(int32_t Move) const { return static_cast<int32_t>(Moves[Move].Face); }
+};
+
+/** Appends a turn in axis form, merging it with the last turn of the same layer */
+static void AppendMove(std::vector<FCubeLayerMove>& Moves, const FCubeLayerMove& Move)
+{
+	if (!Moves.empty() && Moves.back().Face == Move.Face && Moves.back().Layer == Move.Layer)
+	{
+		const uint8_t Turns = static_cast<uint8_t>((Moves.back().Turns + Move.Turns) % 4);
+		if (Turns == 0)
+		{
+			Moves.pop_back();
+		}
+		else
+		{
+			Moves.back().Turns = Turns;
+		}
+		return;
+	}
+	Moves.push_back(Move);
+}
+
+static std::vector<FCubeLayerMove> MakeSequence(const FMoveSet& MoveSet, const std::vector<int32_t>& Moves)
+{
+	std::vector<FCubeLayerMove> Sequence;
+	for (const int32_t Move : Moves)
+	{
+		AppendMove(Sequence, MoveSet.Moves[Move]);
+	}
+	return Sequence;
+}
+
+static std::vector<int32_t> InvertMoves(const FMoveSet& MoveSet, const std::vector<int32_t>& Moves)
+{
+	std::vector<int32_t> Inverse;
+	for (auto Move = Moves.rbegin(); Move != Moves.rend(); ++Move)
+	{
+		Inverse.push_back(MoveSet.GetInverse(*Move));
+	}
+	return Inverse;
+}
+
+/** Single turn or conjugate P Q P' of turns on different axes, the two halves of a commutator */
+struct FCandidate
+{
+	std::vector<int32_t> Moves;
+	/** Where every sticker goes, and back */
+	std::vector<uint16_t> Map;
+	std::vector<uint16_t> InverseMap;
+	/** Stickers moved */
+	std::vector<uint64_t> Support;
+};
+
+static FCandidate MakeCandidate(const FMoveSet& MoveSet, std::vector<int32_t> Moves, int32_t StickerCount)
+{
+	FCandidate Candidate;
+	Candidate.Map.resize(StickerCount);
+	Candidate.InverseMap.resize(StickerCount);
+	Candidate.Support.assign((StickerCount + 63) / 64, 0);
+	for (int32_t Sticker = 0; Sticker < StickerCount; ++Sticker)
+	{
+		int32_t Position = Sticker;
+		for (const int32_t Move : Moves)
+		{
+			Position = MoveSet.Maps[Move][Position];
+		}
+		Candidate.Map[Sticker] = static_cast<uint16_t>(Position);
+		Candidate.InverseMap[Position] = static_cast<uint16_t>(Sticker);
+		if (Position != Sticker)
+		{
+			Candidate.Support[Sticker / 64] |= uint64_t(1) << (Sticker % 64);
+		}
+	}
+	Candidate.Moves = std::move(Moves);
+	return Candidate;
+}
+
+static void AddCycle(FCubeReductionOrbit& Orbit, int32_t A, int32_t B, int32_t C, std::vector<FCubeLayerMove> Sequence,
+                     std::deque<std::array<int32_t, 3>>& Queue)
+{
+	if (Orbit.FindCycle(A, B, C) >= 0) return;
+
+	const int32_t Index = static_cast<int32_t>(Orbit.Sequences.size());
+	Orbit.Sequences.push_back(std::move(Sequence));
+	Orbit.CycleIndex[(A * PositionCount + B) * PositionCount + C] = Index;
+	Orbit.CycleIndex[(B * PositionCount + C) * PositionCount + A] = Index;
+	Orbit.CycleIndex[(C * PositionCount + A) * PositionCount + B] = Index;
+	Queue.push_back({A, B, C});
+}
+
+static FCubeReductionTables BuildTables(int32_t Size)
+{
+	FCubeReductionTables Tables;
+	Tables.Size = Size;
+	if (Size < 4) return Tables;
+
+	const FCubeNxNLayout& Layout = FCubeNxNLayout::Get(Size);
+	const int32_t StickerCount = Layout.GetStickerCount();
+	const FMoveSet MoveSet(Layout);
+	const int32_t MoveCount = static_cast<int32_t>(MoveSet.Moves.size());
+	const int32_t Last = Size - 1;
+
+	// Stickers of every cubie, middle pieces of odd cubes are left to the 3x3x3 stage
+	std::map<int32_t, std::vector<int32_t>> CubieStickers;
+	for (int32_t Sticker = 0; Sticker < StickerCount; ++Sticker)
+	{
+		int32_t X, Y, Z;
+		Layout.GetStickerPosition(Sticker, X, Y, Z);
+		CubieStickers[(X * Size + Y) * Size + Z].push_back(Sticker);
+	}
+	const auto IsMiddle = [Size, Last](int32_t X, int32_t Y, int32_t Z)
+	{
+		const int32_t Inner = (X != 0 && X != Last) + (Y != 0 && Y != Last) + (Z != 0 && Z != Last);
+		const int32_t Middle = Size % 2 == 1 ? (X == Size / 2) + (Y == Size / 2) + (Z == Size / 2) : 0;
+		return Middle == Inner;
+	};
+
+	std::vector<int32_t> StickerOrbit(StickerCount, -1);
+	std::vector<int32_t> StickerPosition(StickerCount, -1);
+	for (const auto& [Key, Stickers] : CubieStickers)
+	{
+		if (Stickers.size() == 3 || StickerOrbit[Stickers[0]] >= 0) continue;
+		int32_t X, Y, Z;
+		Layout.GetStickerPosition(Stickers[0], X, Y, Z);
+		if (IsMiddle(X, Y, Z)) continue;
+
+		FCubeReductionOrbit Orbit;
+		Orbit.bWing = Stickers.size() == 2;
+		Orbit.Primary.push_back(static_cast<uint16_t>(Stickers[0]));
+		Orbit.Secondary.push_back(static_cast<uint16_t>(Orbit.bWing ? Stickers[1] : Stickers[0]));
+		for (size_t Index = 0; Index < Orbit.Primary.size(); ++Index)
+		{
+			for (int32_t Move = 0; Move < MoveCount; ++Move)
+			{
+				const uint16_t Primary = MoveSet.Maps[Move][Orbit.Primary[Index]];
+				if (std::find(Orbit.Primary.begin(), Orbit.Primary.end(), Primary) != Orbit.Primary.end()) continue;
+				Orbit.Primary.push_back(Primary);
+				Orbit.Secondary.push_back(MoveSet.Maps[Move][Orbit.Secondary[Index]]);
+			}
+		}
+		if (Orbit.Primary.size() != PositionCount) continue;
+
+		std::vector<FCubeReductionOrbit>& Kind = Orbit.bWing ? Tables.Wings : Tables.Centers;
+		for (int32_t Position = 0; Position < PositionCount; ++Position)
+		{
+			StickerOrbit[Orbit.Primary[Position]] = StickerOrbit[Orbit.Secondary[Position]] =
+				static_cast<int32_t>(Kind.size()) * 2 + Orbit.bWing;
+			StickerPosition[Orbit.Primary[Position]] = StickerPosition[Orbit.Secondary[Position]] = Position;
+
+			// Slice through a vertical edge wing moves four wings of the orbit
+			Layout.GetStickerPosition(Orbit.Primary[Position], X, Y, Z);
+			if ((X == 0 || X == Last) && (Z == 0 || Z == Last))
+			{
+				Orbit.ParityLayer = std::min(Last - Y, Y);
+			}
+		}
+		Orbit.CycleIndex.assign(PositionCount * PositionCount * PositionCount, -1);
+		Kind.push_back(std::move(Orbit));
+	}
+	const auto GetOrbit = [&Tables](int32_t Id) -> FCubeReductionOrbit& { return Id % 2 ? Tables.Wings[Id / 2] : Tables.Centers[Id / 2]; };
+
+	std::vector<FCandidate> Candidates;
+	for (int32_t Move = 0; Move < MoveCount; ++Move)
+	{
+		Candidates.push_back(MakeCandidate(MoveSet, {Move}, StickerCount));
+	}
+	for (int32_t Setup = 0; Setup < MoveCount; ++Setup)
+	{
+		for (int32_t Move = 0; Move < MoveCount; ++Move)
+		{
+			if (MoveSet.GetAxis(Setup) == MoveSet.GetAxis(Move)) continue;
+			Candidates.push_back(MakeCandidate(MoveSet, {Setup, Move, MoveSet.GetInverse(Setup)}, StickerCount));
+		}
+	}
+
+	// [A, B] is a pure 3-cycle when A and B share the stickers of a single piece. Shortest ones seed each orbit.
+	struct FBase
+	{
+		std::vector<int32_t> Moves;
+		std::array<int32_t, 3> Cycle;
+	};
+	std::map<int32_t, std::vector<FBase>> Bases;
+	constexpr size_t MaxBasesPerOrbit = 64;
+	std::vector<uint16_t> Commutator(StickerCount);
+	for (size_t First = 0; First < Candidates.size(); ++First)
+	{
+		const FCandidate& A = Candidates[First];
+		for (size_t Second = First + 1; Second < Candidates.size(); ++Second)
+		{
+			const FCandidate& B = Candidates[Second];
+			int32_t Shared = 0;
+			int32_t SharedSticker = -1;
+			for (size_t Word = 0; Word < A.Support.size() && Shared <= 2; ++Word)
+			{
+				const uint64_t Bits = A.Support[Word] & B.Support[Word];
+				if (Bits)
+				{
+					Shared += std::popcount(Bits);
+					SharedSticker = static_cast<int32_t>(Word * 64) + std::countr_zero(Bits);
+				}
+			}
+			if (Shared == 0 || Shared > 2) continue;
+
+			const int32_t OrbitId = StickerOrbit[SharedSticker];
+			if (OrbitId < 0 || Shared != (OrbitId % 2 ? 2 : 1)) continue;
+			const size_t Length = 2 * (A.Moves.size() + B.Moves.size());
+			std::vector<FBase>& OrbitBases = Bases[OrbitId];
+			if (!OrbitBases.empty() && (OrbitBases[0].Moves.size() < Length || OrbitBases.size() >= MaxBasesPerOrbit)) continue;
+
+			const FCubeReductionOrbit& Orbit = GetOrbit(OrbitId);
+			int32_t Moved = 0;
+			bool bPure = true;
+			for (int32_t Sticker = 0; Sticker < StickerCount && bPure; ++Sticker)
+			{
+				Commutator[Sticker] = B.InverseMap[A.InverseMap[B.Map[A.Map[Sticker]]]];
+				if (Commutator[Sticker] != Sticker)
+				{
+					++Moved;
+					bPure = StickerOrbit[Sticker] == OrbitId;
+				}
+			}
+			if (!bPure || Moved != (Orbit.bWing ? 6 : 3)) continue;
+
+			const int32_t Start = StickerPosition[SharedSticker];
+			const int32_t Next = StickerPosition[Commutator[Orbit.Primary[Start]]];
+			const int32_t Third = StickerPosition[Commutator[Orbit.Primary[Next]]];
+			if (Next == Start || StickerPosition[Commutator[Orbit.Primary[Third]]] != Start) continue;
+
+			FBase Base;
+			Base.Moves = A.Moves;
+			Base.Moves.insert(Base.Moves.end(), B.Moves.begin(), B.Moves.end());
+			const std::vector<int32_t> InverseA = InvertMoves(MoveSet, A.Moves);
+			const std::vector<int32_t> InverseB = InvertMoves(MoveSet, B.Moves);
+			Base.Moves.insert(Base.Moves.end(), InverseA.begin(), InverseA.end());
+			Base.Moves.insert(Base.Moves.end(), InverseB.begin(), InverseB.end());
+			Base.Cycle = {Start, Next, Third};
+			if (!OrbitBases.empty() && OrbitBases[0].Moves.size() > Length)
+			{
+				OrbitBases.clear();
+			}
+			OrbitBases.push_back(std::move(Base));
+		}
+	}
+
+	// Conjugating a 3-cycle by a turn moves it to other positions, breadth first gives every cycle its shortest setup
+	for (const auto& [OrbitId, OrbitBases] : Bases)
+	{
+		FCubeReductionOrbit& Orbit = GetOrbit(OrbitId);
+		std::deque<std::array<int32_t, 3>> Queue;
+		for (const FBase& Base : OrbitBases)
+		{
+			const auto [A, B, C] = Base.Cycle;
+			AddCycle(Orbit, A, B, C, MakeSequence(MoveSet, Base.Moves), Queue);
+			AddCycle(Orbit, A, C, B, MakeSequence(MoveSet, InvertMoves(MoveSet, Base.Moves)), Queue);
+		}
+		while (!Queue.empty())
+		{
+			const auto [A, B, C] = Queue.front();
+			Queue.pop_front();
+			const std::vector<FCubeLayerMove> Sequence = Orbit.Sequences[Orbit.FindCycle(A, B, C)];
+			for (int32_t Move = 0; Move < MoveCount; ++Move)
+			{
+				const std::vector<uint16_t>& Back = MoveSet.Maps[MoveSet.GetInverse(Move)];
+				const int32_t NewA = StickerPosition[Back[Orbit.Primary[A]]];
+				const int32_t NewB = StickerPosition[Back[Orbit.Primary[B]]];
+				const int32_t NewC = StickerPosition[Back[Orbit.Primary[C]]];
+				if (Orbit.FindCycle(NewA, NewB, NewC) >= 0) continue;
+
+				std::vector<FCubeLayerMove> Conjugate;
+				AppendMove(Conjugate, MoveSet.Moves[Move]);
+				for (const FCubeLayerMove& Step : Sequence)
+				{
+					AppendMove(Conjugate, Step);
+				}
+				AppendMove(Conjugate, MoveSet.Moves[MoveSet.GetInverse(Move)]);
+				AddCycle(Orbit, NewA, NewB, NewC, std::move(Conjugate), Queue);
+			}
+		}
+	}
+	return Tables;
+}
+
+/** Piece every position of Orbit should hold, wings as first color * 6 + second color */
+static void GetOrbitTargets(const FCubeNxN& Cube, const FCubeReductionOrbit& Orbit, const uint8_t (&Scheme)[6], bool bSwapEdges,
+                            std::vector<uint8_t>& OutTargets)
+{
+	const FCubeNxNLayout& Layout = Cube.GetLayout();
+	const int32_t Size = Layout.Size;
+	const int32_t FaceSize = Size * Size;
+	OutTargets.resize(PositionCount);
+	for (int32_t Position = 0; Position < PositionCount; ++Position)
+	{
+		const int32_t FirstFace = Orbit.Primary[Position] / FaceSize;
+		if (!Orbit.bWing)
+		{
+			OutTargets[Position] = Scheme[FirstFace];
+			continue;
+		}
+
+		const int32_t SecondFace = Orbit.Secondary[Position] / FaceSize;
+		uint8_t First, Second;
+		if (Size % 2 == 1)
+		{
+			// Wings pair with the middle edge between the same faces
+			int32_t Coordinates[3];
+			Layout.GetStickerPosition(Orbit.Primary[Position], Coordinates[0], Coordinates[1], Coordinates[2]);
+			for (int32_t& Coordinate : Coordinates)
+			{
+				if (Coordinate != 0 && Coordinate != Size - 1) Coordinate = Size / 2;
+			}
+			First = Cube.GetSticker(Layout.GetStickerAt(static_cast<ECubeFace>(FirstFace), Coordinates[0], Coordinates[1], Coordinates[2]));
+			Second = Cube.GetSticker(Layout.GetStickerAt(static_cast<ECubeFace>(SecondFace), Coordinates[0], Coordinates[1], Coordinates[2]));
+		}
+		else
+		{
+			int32_t Slot = 0;
+			while (!((CubeEdgeFacelets[Slot][0] / 9 == FirstFace && CubeEdgeFacelets[Slot][1] / 9 == SecondFace) ||
+			         (CubeEdgeFacelets[Slot][0] / 9 == SecondFace && CubeEdgeFacelets[Slot][1] / 9 == FirstFace)))
+			{
+				++Slot;
+			}
+			// UR and UF trade places to cancel odd corner parity
+			const int32_t Home = bSwapEdges && Slot < 2 ? 1 - Slot : Slot;
+			const uint8_t HomeColors[2] = {Scheme[CubeEdgeFacelets[Home][0] / 9], Scheme[CubeEdgeFacelets[Home][1] / 9]};
+			const bool bFlipped = CubeEdgeFacelets[Slot][0] / 9 != FirstFace;
+			First = HomeColors[bFlipped];
+			Second = HomeColors[!bFlipped];
+		}
+		OutTargets[Position] = static_cast<uint8_t>(First * 6 + Second);
+	}
+}
+
+static void GetOrbitPieces(const FCubeNxN& Cube, const FCubeReductionOrbit& Orbit, std::vector<uint8_t>& OutPieces)
+{
+	OutPieces.resize(PositionCount);
+	for (int32_t Position = 0; Position < PositionCount; ++Position)
+	{
+		const uint8_t First = Cube.GetSticker(Orbit.Primary[Position]);
+		OutPieces[Position] = Orbit.bWing ? static_cast<uint8_t>(First * 6 + Cube.GetSticker(Orbit.Secondary[Position])) : First;
+	}
+}
+
+/** Parity of the permutation taking the wings to their targets, -1 when the pieces don't match the targets */
+static int32_t GetWingParity(const std::vector<uint8_t>& Pieces, const std::vector<uint8_t>& Targets)
+{
+	int32_t Destination[PositionCount];
+	for (int32_t Position = 0; Position < PositionCount; ++Position)
+	{
+		const auto Found = std::find(Targets.begin(), Targets.end(), Pieces[Position]);
+		if (Found == Targets.end()) return -1;
+		Destination[Position] = static_cast<int32_t>(Found - Targets.begin());
+	}
+
+	int32_t Parity = 0;
+	bool bVisited[PositionCount] = {};
+	for (int32_t Position = 0; Position < PositionCount; ++Position)
+	{
+		if (bVisited[Position]) continue;
+		int32_t Length = 0;
+		for (int32_t Current = Position; !bVisited[Current]; Current = Destination[Current])
+		{
+			bVisited[Current] = true;
+			++Length;
+		}
+		Parity ^= (Length - 1) & 1;
+	}
+	return Parity;
+}
+
+/** Applies the 3-cycle fixing most positions until the orbit matches Targets */
+static bool SolveOrbit(FCubeNxN& Cube, const FCubeReductionOrbit& Orbit, const std::vector<uint8_t>& Targets, std::vector<FCubeLayerMove>& Moves)
+{
+	std::vector<uint8_t> Pieces;
+	for (int32_t Step = 0; Step < PositionCount; ++Step)
+	{
+		GetOrbitPieces(Cube, Orbit, Pieces);
+		int32_t BestGain = 0;
+		int32_t BestCycle = -1;
+		for (int32_t Target = 0; Target < PositionCount; ++Target)
+		{
+			if (Pieces[Target] == Targets[Target]) continue;
+			for (int32_t Source = 0; Source < PositionCount; ++Source)
+			{
+				if (Source == Target || Pieces[Source] != Targets[Target] || Pieces[Source] == Targets[Source]) continue;
+				for (int32_t Third = 0; Third < PositionCount; ++Third)
+				{
+					const int32_t Cycle = Third == Source || Third == Target ? -1 : Orbit.FindCycle(Source, Target, Third);
+					if (Cycle < 0) continue;
+
+					// Piece at Source goes to Target, Target's to Third and Third's to Source
+					const int32_t Gain = 1 + (Pieces[Target] == Targets[Third]) + (Pieces[Third] == Targets[Source]) -
+						(Pieces[Third] == Targets[Third]);
+					if (Gain > BestGain || (Gain == BestGain && BestCycle >= 0 && Orbit.Sequences[Cycle].size() < Orbit.Sequences[BestCycle].size()))
+					{
+						BestGain = Gain;
+						BestCycle = Cycle;
+					}
+				}
+			}
+		}
+		if (BestCycle < 0) return Pieces == Targets;
+
+		for (const FCubeLayerMove& Move : Orbit.Sequences[BestCycle])
+		{
+			Cube.Apply(Move);
+			AppendMove(Moves, Move);
+		}
+	}
+	GetOrbitPieces(Cube, Orbit, Pieces);
+	return Pieces == Targets;
+}
+}
+
+using namespace CubeReductionSolverImpl;
+
+const FCubeReductionTables& FCubeReductionTables::Get(int32_t Size)
+{
+	static std::mutex Mutex;
+	static std::map<int32_t, std::unique_ptr<FCubeReductionTables>> Tables;
+
+	std::lock_guard<std::mutex> Lock(Mutex);
+	std::unique_ptr<FCubeReductionTables>& SizeTables = Tables[Size];
+	if (!SizeTables)
+	{
+		SizeTables = std::make_unique<FCubeReductionTables>(BuildTables(Size));
+	}
+	return *SizeTables;
+}
+
+FCubeReductionSolver::FCubeReductionSolver(const FCubeTwoPhaseSolver& InFinishSolver)
+	: FinishSolver(InFinishSolver)
+{
+}
+
+bool FCubeReductionSolver::Solve(const FCubeNxN& Cube, std::vector<FCubeLayerMove>& OutMoves, FCubeReductionStats* OutStats) const
+{
+	const FClock::time_point Start = FClock::now();
+	const int32_t Size = Cube.GetSize();
+	const FCubeReductionTables& Tables = FCubeReductionTables::Get(Size);
+	FCubeNxN Work = Cube;
+	std::vector<FCubeLayerMove> Moves;
+	FCubeReductionStats Stats;
+
+	uint8_t Scheme[6];
+	uint8_t ColorFace[6];
+	if (!Work.GetColorScheme(Scheme)) return false;
+	for (int32_t Face = 0; Face < 6; ++Face)
+	{
+		ColorFace[Scheme[Face]] = static_cast<uint8_t>(Face);
+	}
+
+	FCubieCube Reduced;
+	if (!Work.ReadCubie(ColorFace, false, Reduced)) return false;
+	const bool bSwapEdges = Size % 2 == 0 && Reduced.CornerParity() != 0;
+
+	std::vector<uint8_t> Targets;
+	std::vector<uint8_t> Pieces;
+	for (const FCubeReductionOrbit& Orbit : Tables.Wings)
+	{
+		GetOrbitTargets(Work, Orbit, Scheme, bSwapEdges, Targets);
+		GetOrbitPieces(Work, Orbit, Pieces);
+		const int32_t Parity = GetWingParity(Pieces, Targets);
+		if (Parity < 0) return false;
+		if (Parity == 1)
+		{
+			const FCubeLayerMove Slice{ECubeFace::U, static_cast<uint8_t>(Orbit.ParityLayer), 1};
+			Work.Apply(Slice);
+			AppendMove(Moves, Slice);
+		}
+	}
+	Stats.ParityMoves = static_cast<int32_t>(Moves.size());
+
+	for (const FCubeReductionOrbit& Orbit : Tables.Centers)
+	{
+		GetOrbitTargets(Work, Orbit, Scheme, bSwapEdges, Targets);
+		if (!SolveOrbit(Work, Orbit, Targets, Moves)) return false;
+	}
+	Stats.CenterMoves = static_cast<int32_t>(Moves.size()) - Stats.ParityMoves;
+
+	for (const FCubeReductionOrbit& Orbit : Tables.Wings)
+	{
+		GetOrbitTargets(Work, Orbit, Scheme, bSwapEdges, Targets);
+		if (!SolveOrbit(Work, Orbit, Targets, Moves)) return false;
+	}
+	Stats.EdgeMoves = static_cast<int32_t>(Moves.size()) - Stats.ParityMoves - Stats.CenterMoves;
+
+	if (!Work.ReadCubie(ColorFace, Size > 2, Reduced)) return false;
+	if (Size == 2 && Reduced.CornerParity() != 0)
+	{
+		std::swap(Reduced.Ep[0], Reduced.Ep[1]);
+	}
+	if (!Reduced.IsSolvable()) return false;
+
+	FCubeTwoPhaseOptions Options;
+	Options.TargetLength = FinishTargetLength;
+	Options.Deadline = FClock::now() + std::chrono::duration_cast<FClock::duration>(std::chrono::duration<double>(FinishSeconds));
+	std::vector<ECubeMove> Finish;
+	if (!FinishSolver.Solve(FCubeState::FromCubie(Reduced), Finish, Options)) return false;
+	for (const ECubeMove Move : Finish)
+	{
+		const FCubeLayerMove Turn{GetMoveFace(Move), 0, static_cast<uint8_t>(GetMovePower(Move))};
+		Work.Apply(Turn);
+		Moves.push_back(Turn);
+	}
+	Stats.FinishMoves = static_cast<int32_t>(Finish.size());
+	if (!Work.IsSolved()) return false;
+
+	OutMoves.clear();
+	for (const FCubeLayerMove& Move : Moves)
+	{
+		int32_t Axis, Layer, Turns;
+		Work.GetLayout().ToAxisTurn(Move, Axis, Layer, Turns);
+		OutMoves.push_back(Work.GetLayout().FromAxisTurn(Axis, Layer, Turns));
+	}
+	Stats.Seconds = std::chrono::duration<double>(FClock::now() - Start).count();
+	if (OutStats) *OutStats = Stats;
+	return true;
+}
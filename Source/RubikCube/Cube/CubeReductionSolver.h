@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CubeNxN.h"
+
+#include <cstdint>
+#include <vector>
+
+class FCubeTwoPhaseSolver;
+
+/**
+ * Pieces of one kind that layer turns move among the same 24 positions: center pieces off the middle of a face,
+ * or wing edges at one depth along the edges. Every 3-cycle of positions has a sequence moving only those three pieces.
+ */
+struct FCubeReductionOrbit
+{
+	static constexpr int32_t PositionCount = 24;
+
+	bool bWing = false;
+	/** Sticker of every position, wings have their second sticker in Secondary */
+	std::vector<uint16_t> Primary;
+	std::vector<uint16_t> Secondary;
+	/** Layer from U turned to fix the parity of a wing orbit, it moves four of its wings in a single cycle */
+	int32_t ParityLayer = 0;
+
+	/** Index into Sequences for the cycle moving the piece at A to B, B to C and C to A, or -1 */
+	std::vector<int32_t> CycleIndex;
+	std::vector<std::vector<FCubeLayerMove>> Sequences;
+
+	int32_t FindCycle(int32_t A, int32_t B, int32_t C) const { return CycleIndex[(A * PositionCount + B) * PositionCount + C]; }
+};
+
+/** Orbits and 3-cycles of one cube size, generated on first use and shared afterwards */
+struct FCubeReductionTables
+{
+	int32_t Size = 0;
+	std::vector<FCubeReductionOrbit> Centers;
+	std::vector<FCubeReductionOrbit> Wings;
+
+	static const FCubeReductionTables& Get(int32_t Size);
+};
+
+struct FCubeReductionStats
+{
+	int32_t ParityMoves = 0;
+	int32_t CenterMoves = 0;
+	int32_t EdgeMoves = 0;
+	int32_t FinishMoves = 0;
+	double Seconds = 0.0;
+};
+
+/**
+ * Solves cubes of any size by reduction to 3x3x3: wing orbits with odd permutation get one slice turn, then every center
+ * orbit and every wing orbit is solved by greedy pure 3-cycles, and the reduced cube is finished by the two-phase solver.
+ * Odd cubes keep their middle centers and pair wings with the middle edges. Even cubes take the colors from the DBL corner
+ * and pair wings into edges swapped once when the corners have odd parity, so the reduced cube never shows PLL parity.
+ * Orbit tables are found by searching commutators of conjugated layer turns, nothing is written for a particular size.
+ */
+class FCubeReductionSolver
+{
+public:
+	/** Finish search stops at the first solution of this length or when the time runs out */
+	static constexpr int32_t FinishTargetLength = 22;
+	static constexpr double FinishSeconds = 0.01;
+
+	explicit FCubeReductionSolver(const FCubeTwoPhaseSolver& InFinishSolver);
+
+	/** OutMoves solves Cube. Returns false for cubes not reachable by layer turns or when the finish search fails. */
+	bool Solve(const FCubeNxN& Cube, std::vector<FCubeLayerMove>& OutMoves, FCubeReductionStats* OutStats = nullptr) const;
+
+private:
+	const FCubeTwoPhaseSolver& FinishSolver;
+};
@@ -0,0 +1,261 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeScrambler.h"
+
+#include "CubeTaskPool.h"
+#include "CubeTwoPhaseSolver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <utility>
+
+namespace CubeScramblerImpl
+{
+constexpr size_t StateFileSize = 16;
+
+static uint64_t MixHash(uint64_t Value)
+{
+	Value ^= Value >> 33;
+	Value *= 0xFF51AFD7ED558CCDull;
+	Value ^= Value >> 33;
+	return Value;
+}
+
+/** Shard is picked by the top bits, the hash set buckets by the low ones */
+static size_t GetShard(uint64_t Hash)
+{
+	return static_cast<size_t>(Hash >> 58) % FCubeScrambleSet::ShardCount;
+}
+
+template <size_t Count>
+static void Shuffle(uint8_t (&Values)[Count], std::mt19937& Random)
+{
+	for (size_t Index = Count - 1; Index > 0; --Index)
+	{
+		std::uniform_int_distribution<size_t> Distribution(0, Index);
+		std::swap(Values[Index], Values[Distribution(Random)]);
+	}
+}
+}
+
+using namespace CubeScramblerImpl;
+
+FCubeState MakeRandomCubeState(std::mt19937& Random)
+{
+	FCubieCube Cube = FCubieCube::Solved();
+	Shuffle(Cube.Cp, Random);
+	Shuffle(Cube.Ep, Random);
+	// Swapping two edges pairs every arrangement of the wrong parity with exactly one of the right parity
+	if (Cube.CornerParity() != Cube.EdgeParity())
+	{
+		std::swap(Cube.Ep[CubeEdgeCount - 2], Cube.Ep[CubeEdgeCount - 1]);
+	}
+
+	std::uniform_int_distribution<int32_t> Twist(0, 2);
+	int32_t TwistSum = 0;
+	for (int32_t Index = 0; Index < CubeCornerCount - 1; ++Index)
+	{
+		Cube.Co[Index] = static_cast<uint8_t>(Twist(Random));
+		TwistSum += Cube.Co[Index];
+	}
+	Cube.Co[CubeCornerCount - 1] = static_cast<uint8_t>((3 - TwistSum % 3) % 3);
+
+	std::uniform_int_distribution<int32_t> Flip(0, 1);
+	int32_t FlipSum = 0;
+	for (int32_t Index = 0; Index < CubeEdgeCount - 1; ++Index)
+	{
+		Cube.Eo[Index] = static_cast<uint8_t>(Flip(Random));
+		FlipSum += Cube.Eo[Index];
+	}
+	Cube.Eo[CubeEdgeCount - 1] = static_cast<uint8_t>(FlipSum & 1);
+	return FCubeState::FromCubie(Cube);
+}
+
+FCubeScrambleSet::FCubeScrambleSet(uint64_t ExpectedCount)
+{
+	uint64_t BitCount = 1 << 12;
+	while (BitCount < ExpectedCount * 16 && BitCount < (1ull << 40))
+	{
+		BitCount *= 2;
+	}
+	BloomBitMask = BitCount - 1;
+	BloomWords = std::make_unique<std::atomic<uint64_t>[]>(BitCount / 64);
+	Clear();
+}
+
+bool FCubeScrambleSet::MayContain(uint64_t Hash) const
+{
+	// Double hashing, the second hash is odd so the probes of a state never repeat before wrapping around
+	const uint64_t Step = MixHash(Hash) | 1;
+	for (int32_t Probe = 0; Probe < BloomHashCount; ++Probe)
+	{
+		const uint64_t Bit = (Hash + Probe * Step) & BloomBitMask;
+		if ((BloomWords[Bit >> 6].load(std::memory_order_acquire) >> (Bit & 63) & 1) == 0) return false;
+	}
+	return true;
+}
+
+bool FCubeScrambleSet::Add(const FCubeState& State)
+{
+	const uint64_t Hash = State.Hash();
+	FShard& Shard = Shards[GetShard(Hash)];
+	{
+		std::lock_guard<std::mutex> Lock(Shard.Mutex);
+		if (!Shard.States.insert(State).second) return false;
+	}
+
+	// Bits are set after the insert, so a lookup that passes the filter always finds the state in its shard
+	const uint64_t Step = MixHash(Hash) | 1;
+	for (int32_t Probe = 0; Probe < BloomHashCount; ++Probe)
+	{
+		const uint64_t Bit = (Hash + Probe * Step) & BloomBitMask;
+		BloomWords[Bit >> 6].fetch_or(1ull << (Bit & 63), std::memory_order_release);
+	}
+	Count.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+bool FCubeScrambleSet::Contains(const FCubeState& State) const
+{
+	const uint64_t Hash = State.Hash();
+	if (!MayContain(Hash)) return false;
+
+	const FShard& Shard = Shards[GetShard(Hash)];
+	std::lock_guard<std::mutex> Lock(Shard.Mutex);
+	return Shard.States.count(State) != 0;
+}
+
+void FCubeScrambleSet::Clear()
+{
+	for (uint64_t Word = 0; Word <= BloomBitMask >> 6; ++Word)
+	{
+		BloomWords[Word].store(0, std::memory_order_relaxed);
+	}
+	for (FShard& Shard : Shards)
+	{
+		std::lock_guard<std::mutex> Lock(Shard.Mutex);
+		Shard.States.clear();
+	}
+	Count.store(0, std::memory_order_relaxed);
+}
+
+bool FCubeScrambleSet::Save(const std::string& Path, std::string& OutError) const
+{
+	std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+	if (!File)
+	{
+		OutError = "Can't create " + Path;
+		return false;
+	}
+
+	uint8_t Bytes[StateFileSize];
+	for (const FShard& Shard : Shards)
+	{
+		std::lock_guard<std::mutex> Lock(Shard.Mutex);
+		for (const FCubeState& State : Shard.States)
+		{
+			for (size_t Index = 0; Index < 8; ++Index)
+			{
+				Bytes[Index] = static_cast<uint8_t>(State.Corners >> (8 * Index));
+				Bytes[Index + 8] = static_cast<uint8_t>(State.Edges >> (8 * Index));
+			}
+			File.write(reinterpret_cast<const char*>(Bytes), StateFileSize);
+		}
+	}
+	if (!File)
+	{
+		OutError = "Can't write " + Path;
+		return false;
+	}
+	return true;
+}
+
+bool FCubeScrambleSet::Load(const std::string& Path, std::string& OutError)
+{
+	std::ifstream File(Path, std::ios::binary);
+	if (!File)
+	{
+		OutError = "Can't open " + Path;
+		return false;
+	}
+
+	uint8_t Bytes[StateFileSize];
+	while (File.read(reinterpret_cast<char*>(Bytes), StateFileSize))
+	{
+		FCubeState State;
+		for (size_t Index = 0; Index < 8; ++Index)
+		{
+			State.Corners |= static_cast<uint64_t>(Bytes[Index]) << (8 * Index);
+			State.Edges |= static_cast<uint64_t>(Bytes[Index + 8]) << (8 * Index);
+		}
+		if (!State.IsSolvable())
+		{
+			OutError = Path + " isn't a scramble set";
+			return false;
+		}
+		Add(State);
+	}
+	if (File.gcount() != 0)
+	{
+		OutError = Path + " is truncated";
+		return false;
+	}
+	return true;
+}
+
+FCubeScrambleGenerator::FCubeScrambleGenerator(const FCubeTwoPhaseSolver& InSolver, FCubeScrambleSet* InSeason,
+                                               const FCubeScrambleOptions& InOptions)
+	: Solver(InSolver)
+	, Season(InSeason)
+	, Options(InOptions)
+{
+}
+
+bool FCubeScrambleGenerator::Generate(std::mt19937& Random, FCubeScramble& OutScramble) const
+{
+	FCubeTwoPhaseOptions SolveOptions;
+	SolveOptions.TargetLength = Options.TargetLength;
+
+	std::vector<ECubeMove> Solution;
+	while (true)
+	{
+		const FCubeState State = MakeRandomCubeState(Random);
+		if (Season != nullptr && Season->Contains(State)) continue;
+
+		SolveOptions.Deadline = std::chrono::steady_clock::now() +
+			std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(Options.SecondsPerScramble));
+		if (!Solver.Solve(State, Solution, SolveOptions)) return false;
+		if (static_cast<int32_t>(Solution.size()) < Options.MinLength) continue;
+		// Another thread may have drawn the same state meanwhile
+		if (Season != nullptr && !Season->Add(State)) continue;
+
+		OutScramble.State = State;
+		OutScramble.Moves.clear();
+		for (auto Move = Solution.rbegin(); Move != Solution.rend(); ++Move)
+		{
+			OutScramble.Moves.push_back(InverseMove(*Move));
+		}
+		return true;
+	}
+}
+
+std::vector<FCubeScramble> FCubeScrambleGenerator::GenerateBatch(int32_t Count, int32_t ThreadCount, uint64_t Seed) const
+{
+	std::vector<FCubeScramble> Scrambles(std::max(Count, 0));
+	FCubeTaskPool Pool(std::max(ThreadCount, 1));
+	for (size_t Index = 0; Index < Scrambles.size(); ++Index)
+	{
+		Pool.Submit([this, &Scrambles, Index, Seed]()
+		{
+			std::seed_seq Sequence{static_cast<uint32_t>(Seed), static_cast<uint32_t>(Seed >> 32), static_cast<uint32_t>(Index)};
+			std::mt19937 Random(Sequence);
+			if (!Generate(Random, Scrambles[Index]))
+			{
+				Scrambles[Index] = FCubeScramble();
+			}
+		});
+	}
+	Pool.Wait();
+	return Scrambles;
+}
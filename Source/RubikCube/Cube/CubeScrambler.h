@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CubeState.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class FCubeTwoPhaseSolver;
+
+/**
+ * Uniformly distributed solvable state. Corners and edges are shuffled independently and two edges are swapped when
+ * the permutation parities differ, twist and flip are random except for the last corner and edge, which make them sum to zero.
+ */
+FCubeState MakeRandomCubeState(std::mt19937& Random);
+
+/**
+ * Every scrambled state of one season. A bloom filter of atomic words answers most lookups of new states without a lock,
+ * states it may contain are checked in a hash set split into shards with a lock each.
+ */
+class FCubeScrambleSet
+{
+public:
+	static constexpr int32_t ShardCount = 64;
+
+	/** Bloom filter gets 16 bits per expected state, more states only raise its false positive rate */
+	explicit FCubeScrambleSet(uint64_t ExpectedCount = 1 << 20);
+
+	FCubeScrambleSet(const FCubeScrambleSet&) = delete;
+	FCubeScrambleSet& operator=(const FCubeScrambleSet&) = delete;
+
+	/** Adds State, returns false when it is already in the set. Thread safe. */
+	bool Add(const FCubeState& State);
+	bool Contains(const FCubeState& State) const;
+
+	uint64_t GetCount() const { return Count.load(std::memory_order_relaxed); }
+
+	/** Starts a new season, not to be called while other threads use the set */
+	void Clear();
+
+	/** Writes every state as 16 little endian bytes, corners first, so season files are the same on every platform */
+	bool Save(const std::string& Path, std::string& OutError) const;
+	/** Adds the states of a file written by Save */
+	bool Load(const std::string& Path, std::string& OutError);
+
+private:
+	static constexpr int32_t BloomHashCount = 11;
+
+	struct FShard
+	{
+		mutable std::mutex Mutex;
+		std::unordered_set<FCubeState, FCubeStateHasher> States;
+	};
+
+	bool MayContain(uint64_t Hash) const;
+
+	std::unique_ptr<std::atomic<uint64_t>[]> BloomWords;
+	uint64_t BloomBitMask = 0;
+	FShard Shards[ShardCount];
+	std::atomic<uint64_t> Count{0};
+};
+
+struct FCubeScramble
+{
+	FCubeState State;
+	/** Moves from the solved cube to State */
+	std::vector<ECubeMove> Moves;
+};
+
+struct FCubeScrambleOptions
+{
+	/** Solver stops at the first solution of at most this many moves, so scrambles are rarely longer */
+	int32_t TargetLength = 21;
+	/** States solved in fewer moves are drawn again, WCA regulations reject scrambles solvable in under 2 moves */
+	int32_t MinLength = 2;
+	/** Time the solver may take per state before its best solution so far becomes the scramble */
+	double SecondsPerScramble = 0.05;
+};
+
+/**
+ * Random state scrambles: a uniformly random state is solved with the two-phase solver and the inverted solution is the
+ * scramble, so every reachable state is equally likely however the scramble is applied. States already in the season,
+ * when there is one, are drawn again.
+ */
+class FCubeScrambleGenerator
+{
+public:
+	/** Season may be null, it is updated by every generated scramble and must outlive the generator otherwise */
+	FCubeScrambleGenerator(const FCubeTwoPhaseSolver& InSolver, FCubeScrambleSet* InSeason, const FCubeScrambleOptions& InOptions = {});
+
+	/** Returns false when the solver found no solution for a drawn state in time, which takes a tiny time limit */
+	bool Generate(std::mt19937& Random, FCubeScramble& OutScramble) const;
+
+	/**
+	 * Generates Count scrambles on ThreadCount threads. Scramble Index draws from a generator seeded with Seed and Index,
+	 * so a batch doesn't depend on the thread count as long as no state is drawn twice. Failed scrambles are left empty.
+	 */
+	std::vector<FCubeScramble> GenerateBatch(int32_t Count, int32_t ThreadCount, uint64_t Seed) const;
+
+	const FCubeScrambleOptions& GetOptions() const { return Options; }
+
+private:
+	const FCubeTwoPhaseSolver& Solver;
+	FCubeScrambleSet* Season;
+	FCubeScrambleOptions Options;
+};
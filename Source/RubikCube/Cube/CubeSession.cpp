@@ -0,0 +1,356 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeSession.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace CubeSessionImpl
+{
+constexpr uint8_t Magic[4] = {'C', 'U', 'B', 'S'};
+constexpr uint8_t Version = 1;
+constexpr size_t HashSize = 8;
+
+static uint64_t HashBytes(const uint8_t* Data, size_t Size)
+{
+	uint64_t Hash = 0xCBF29CE484222325ull;
+	for (size_t Index = 0; Index < Size; ++Index)
+	{
+		Hash = (Hash ^ Data[Index]) * 0x100000001B3ull;
+	}
+	return Hash;
+}
+
+static void WriteVarint(std::vector<uint8_t>& Log, uint64_t Value)
+{
+	while (Value >= 0x80)
+	{
+		Log.push_back(static_cast<uint8_t>(Value | 0x80));
+		Value >>= 7;
+	}
+	Log.push_back(static_cast<uint8_t>(Value));
+}
+
+static size_t GetPackedStateSize(int32_t CubeSize)
+{
+	return (6 * static_cast<size_t>(CubeSize) * CubeSize + 1) / 2;
+}
+
+static void PackState(const FCubeNxN& Cube, uint8_t* OutBytes)
+{
+	const std::vector<uint8_t>& Stickers = Cube.GetStickers();
+	for (size_t Index = 0; Index < Stickers.size(); Index += 2)
+	{
+		const uint8_t High = Index + 1 < Stickers.size() ? Stickers[Index + 1] : 0;
+		OutBytes[Index / 2] = static_cast<uint8_t>(Stickers[Index] | High << 4);
+	}
+}
+
+static uint64_t EncodeMove(const FCubeLayerMove& Move)
+{
+	return (static_cast<uint64_t>(Move.Layer) * 6 + static_cast<uint64_t>(Move.Face)) * 3 + Move.Turns % 4 - 1;
+}
+
+struct FReader
+{
+	const uint8_t* Data;
+	size_t Size;
+	size_t Offset = 0;
+
+	bool ReadVarint(uint64_t& OutValue)
+	{
+		OutValue = 0;
+		for (int32_t Shift = 0; Shift < 64 && Offset < Size; Shift += 7)
+		{
+			const uint8_t Byte = Data[Offset++];
+			OutValue |= static_cast<uint64_t>(Byte & 0x7F) << Shift;
+			if ((Byte & 0x80) == 0) return true;
+		}
+		return false;
+	}
+
+	const uint8_t* ReadBytes(size_t Count)
+	{
+		if (Size - Offset < Count) return nullptr;
+		const uint8_t* Bytes = Data + Offset;
+		Offset += Count;
+		return Bytes;
+	}
+};
+
+/** Shared by verification and decoding, OnScramble sees the initial state and OnMove every move after it was applied to OutCube */
+template <typename FOnScramble, typename FOnMove>
+static bool ParseSession(const uint8_t* Data, size_t Size, FCubeNxN& OutCube, FCubeSessionStats& OutStats, uint64_t& OutSolveStartFrame,
+                         uint64_t& OutEndFrame, FOnScramble&& OnScramble, FOnMove&& OnMove, std::string& OutError)
+{
+	OutStats = FCubeSessionStats();
+	if (Size < sizeof(Magic) + 2 + HashSize)
+	{
+		OutError = "Log is truncated";
+		return false;
+	}
+
+	uint64_t StoredHash = 0;
+	for (size_t Index = 0; Index < HashSize; ++Index)
+	{
+		StoredHash |= static_cast<uint64_t>(Data[Size - HashSize + Index]) << (8 * Index);
+	}
+	if (StoredHash != HashBytes(Data, Size - HashSize))
+	{
+		OutError = "Log hash doesn't match its contents";
+		return false;
+	}
+
+	FReader Reader{Data, Size - HashSize};
+	const uint8_t* Header = Reader.ReadBytes(sizeof(Magic) + 2);
+	if (std::memcmp(Header, Magic, sizeof(Magic)) != 0 || Header[sizeof(Magic)] != Version)
+	{
+		OutError = "Not a session log of a supported version";
+		return false;
+	}
+	const int32_t CubeSize = Header[sizeof(Magic) + 1];
+	uint64_t FramesPerSecond = 0;
+	uint64_t CheckpointInterval = 0;
+	if (CubeSize < FCubeNxN::MinSize || CubeSize > FCubeNxN::MaxSize || !Reader.ReadVarint(FramesPerSecond) || FramesPerSecond == 0 ||
+	    FramesPerSecond > UINT32_MAX || !Reader.ReadVarint(CheckpointInterval))
+	{
+		OutError = "Invalid log header";
+		return false;
+	}
+	OutStats.CubeSize = CubeSize;
+	OutStats.FramesPerSecond = static_cast<uint32_t>(FramesPerSecond);
+
+	const size_t StateSize = GetPackedStateSize(CubeSize);
+	const uint8_t* Scramble = Reader.ReadBytes(StateSize);
+	if (Scramble == nullptr)
+	{
+		OutError = "Log is truncated";
+		return false;
+	}
+	OutCube = FCubeNxN(CubeSize);
+	const int32_t StickerCount = OutCube.GetLayout().GetStickerCount();
+	for (int32_t Sticker = 0; Sticker < StickerCount; ++Sticker)
+	{
+		const uint8_t Color = Scramble[Sticker / 2] >> (Sticker % 2 * 4) & 0xF;
+		if (Color >= 6)
+		{
+			OutError = "Invalid scrambled state";
+			return false;
+		}
+		OutCube.SetSticker(Sticker, Color);
+	}
+	if (!OutCube.IsReachable())
+	{
+		OutError = "Scrambled state isn't reachable by layer turns";
+		return false;
+	}
+	OutStats.ScrambleHash = HashCubeScramble(OutCube);
+	OnScramble(static_cast<const FCubeNxN&>(OutCube));
+
+	std::vector<uint8_t> Packed(StateSize);
+	uint64_t Frame = 0;
+	uint64_t FirstMoveFrame = 0;
+	bool bSolveStarted = false;
+	bool bEnded = false;
+	while (!bEnded)
+	{
+		uint64_t Tag = 0;
+		if (!Reader.ReadVarint(Tag))
+		{
+			OutError = "Log ends without an end event";
+			return false;
+		}
+		Frame += Tag >> 2;
+
+		switch (static_cast<ECubeSessionEvent>(Tag & 3))
+		{
+		case ECubeSessionEvent::Move:
+		{
+			uint64_t Code = 0;
+			if (!Reader.ReadVarint(Code) || Code / 18 >= static_cast<uint64_t>(CubeSize))
+			{
+				OutError = "Invalid move at frame " + std::to_string(Frame);
+				return false;
+			}
+			const FCubeLayerMove Move{static_cast<ECubeFace>(Code / 3 % 6), static_cast<uint8_t>(Code / 18), static_cast<uint8_t>(Code % 3 + 1)};
+			OutCube.Apply(Move);
+			if (OutStats.MoveCount++ == 0)
+			{
+				FirstMoveFrame = Frame;
+			}
+			OnMove(Frame, Move);
+			break;
+		}
+		case ECubeSessionEvent::Checkpoint:
+		{
+			const uint8_t* Stored = Reader.ReadBytes(StateSize);
+			PackState(OutCube, Packed.data());
+			if (Stored == nullptr || std::memcmp(Stored, Packed.data(), StateSize) != 0)
+			{
+				OutError = "Checkpoint after move " + std::to_string(OutStats.MoveCount) + " doesn't match the replayed state";
+				return false;
+			}
+			++OutStats.CheckpointCount;
+			break;
+		}
+		case ECubeSessionEvent::SolveStart:
+			if (bSolveStarted || OutStats.MoveCount > 0)
+			{
+				OutError = "Solve starts after it already started";
+				return false;
+			}
+			bSolveStarted = true;
+			OutSolveStartFrame = Frame;
+			break;
+		case ECubeSessionEvent::End:
+			bEnded = true;
+			break;
+		}
+	}
+	if (Reader.Offset != Reader.Size)
+	{
+		OutError = "Data after the end event";
+		return false;
+	}
+
+	if (!bSolveStarted)
+	{
+		OutSolveStartFrame = OutStats.MoveCount > 0 ? FirstMoveFrame : Frame;
+	}
+	OutEndFrame = Frame;
+	OutStats.InspectionSeconds = static_cast<double>(OutSolveStartFrame) / static_cast<double>(FramesPerSecond);
+	OutStats.SolveSeconds = static_cast<double>(OutEndFrame - OutSolveStartFrame) / static_cast<double>(FramesPerSecond);
+	OutStats.TurnsPerSecond = OutStats.SolveSeconds > 0.0 ? static_cast<double>(OutStats.MoveCount) / OutStats.SolveSeconds : 0.0;
+	OutStats.bSolved = OutCube.IsSolved();
+	return true;
+}
+}
+
+using namespace CubeSessionImpl;
+
+FCubeSessionRecorder::FCubeSessionRecorder(const FCubeNxN& Scramble, uint32_t FramesPerSecond, uint32_t InCheckpointInterval)
+	: Cube(Scramble)
+	, CheckpointInterval(InCheckpointInterval)
+{
+	for (const uint8_t Byte : Magic)
+	{
+		Log.push_back(Byte);
+	}
+	Log.push_back(Version);
+	Log.push_back(static_cast<uint8_t>(Cube.GetSize()));
+	WriteVarint(Log, std::max<uint32_t>(FramesPerSecond, 1));
+	WriteVarint(Log, CheckpointInterval);
+
+	const size_t Offset = Log.size();
+	Log.resize(Offset + GetPackedStateSize(Cube.GetSize()));
+	PackState(Cube, Log.data() + Offset);
+}
+
+void FCubeSessionRecorder::StartSolve(uint64_t Frame)
+{
+	// Solve start is only valid once and before the first move
+	if (bFinished || bSolveStarted || bMoved) return;
+	WriteEvent(Frame, ECubeSessionEvent::SolveStart);
+	bSolveStarted = true;
+}
+
+void FCubeSessionRecorder::AddMove(uint64_t Frame, const FCubeLayerMove& Move)
+{
+	if (bFinished || Move.Layer >= Cube.GetSize() || Move.Turns % 4 == 0) return;
+
+	WriteEvent(Frame, ECubeSessionEvent::Move);
+	WriteVarint(Log, EncodeMove(Move));
+	Cube.Apply(Move);
+	bMoved = true;
+
+	if (CheckpointInterval > 0 && ++MovesSinceCheckpoint == CheckpointInterval)
+	{
+		MovesSinceCheckpoint = 0;
+		WriteEvent(LastFrame, ECubeSessionEvent::Checkpoint);
+		const size_t Offset = Log.size();
+		Log.resize(Offset + GetPackedStateSize(Cube.GetSize()));
+		PackState(Cube, Log.data() + Offset);
+	}
+}
+
+const std::vector<uint8_t>& FCubeSessionRecorder::Finish(uint64_t Frame)
+{
+	if (!bFinished)
+	{
+		WriteEvent(Frame, ECubeSessionEvent::End);
+		const uint64_t Hash = HashBytes(Log.data(), Log.size());
+		for (size_t Index = 0; Index < HashSize; ++Index)
+		{
+			Log.push_back(static_cast<uint8_t>(Hash >> (8 * Index)));
+		}
+		bFinished = true;
+	}
+	return Log;
+}
+
+void FCubeSessionRecorder::WriteEvent(uint64_t Frame, ECubeSessionEvent Event)
+{
+	Frame = std::max(Frame, LastFrame);
+	WriteVarint(Log, (Frame - LastFrame) << 2 | static_cast<uint64_t>(Event));
+	LastFrame = Frame;
+}
+
+uint64_t HashCubeScramble(const FCubeNxN& Scramble)
+{
+	std::vector<uint8_t> Bytes(1 + GetPackedStateSize(Scramble.GetSize()));
+	Bytes[0] = static_cast<uint8_t>(Scramble.GetSize());
+	PackState(Scramble, Bytes.data() + 1);
+	return HashBytes(Bytes.data(), Bytes.size());
+}
+
+bool VerifyCubeSession(const uint8_t* Data, size_t Size, FCubeSessionStats& OutStats, std::string& OutError)
+{
+	FCubeNxN Cube(3);
+	uint64_t SolveStartFrame = 0;
+	uint64_t EndFrame = 0;
+	bool bScrambled = false;
+	if (!ParseSession(Data, Size, Cube, OutStats, SolveStartFrame, EndFrame,
+	                  [&bScrambled](const FCubeNxN& Scramble) { bScrambled = !Scramble.IsSolved(); }, [](uint64_t, const FCubeLayerMove&) {},
+	                  OutError))
+	{
+		return false;
+	}
+	if (!bScrambled)
+	{
+		OutError = "Session starts from a solved cube";
+		return false;
+	}
+	if (!OutStats.bSolved)
+	{
+		OutError = "Cube isn't solved at the end of the session";
+		return false;
+	}
+	return true;
+}
+
+bool VerifyCubeSession(const uint8_t* Data, size_t Size, const FCubeNxN& ExpectedScramble, FCubeSessionStats& OutStats, std::string& OutError)
+{
+	if (!VerifyCubeSession(Data, Size, OutStats, OutError)) return false;
+	// Hash includes the size, so a log of another cube size never matches
+	if (OutStats.ScrambleHash != HashCubeScramble(ExpectedScramble))
+	{
+		OutError = "Session doesn't start from the expected scramble";
+		return false;
+	}
+	return true;
+}
+
+bool ReadCubeSession(const uint8_t* Data, size_t Size, FCubeSession& OutSession, std::string& OutError)
+{
+	FCubeSessionStats Stats;
+	FCubeNxN Cube(3);
+	OutSession.Moves.clear();
+	if (!ParseSession(Data, Size, Cube, Stats, OutSession.SolveStartFrame, OutSession.EndFrame,
+	                  [&OutSession](const FCubeNxN& Scramble) { OutSession.Scramble = Scramble; },
+	                  [&OutSession](uint64_t Frame, const FCubeLayerMove& Move) { OutSession.Moves.push_back({Frame, Move}); }, OutError))
+	{
+		return false;
+	}
+	OutSession.FramesPerSecond = Stats.FramesPerSecond;
+	return true;
+}
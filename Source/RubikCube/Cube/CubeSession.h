@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CubeNxN.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Session log layout, every multi-byte value written byte by byte so logs are identical on every platform:
+ * "CUBS", version byte, cube size byte, FramesPerSecond and CheckpointInterval as LEB128 varints, scrambled state,
+ * then events and an 8 byte little endian FNV-1a hash of everything before it.
+ * An event is a varint of (frames since the previous event << 2 | type) followed by its payload:
+ * a move as a varint of (Layer * 6 + Face) * 3 + Turns - 1, so outer turns of a 3x3x3 take two bytes with their timestamp,
+ * a checkpoint as the state after the moves so far, or nothing for solve start and end.
+ * States are stickers packed two per byte, low nibble first.
+ */
+enum class ECubeSessionEvent : uint8_t
+{
+	Move,
+	Checkpoint,
+	SolveStart,
+	End,
+};
+
+struct FCubeSessionMove
+{
+	uint64_t Frame = 0;
+	FCubeLayerMove Move;
+};
+
+/** Decoded session, frames count from the start of inspection */
+struct FCubeSession
+{
+	FCubeNxN Scramble = FCubeNxN(3);
+	uint32_t FramesPerSecond = 60;
+	std::vector<FCubeSessionMove> Moves;
+	uint64_t SolveStartFrame = 0;
+	uint64_t EndFrame = 0;
+};
+
+struct FCubeSessionStats
+{
+	int32_t CubeSize = 0;
+	uint32_t FramesPerSecond = 0;
+	uint64_t MoveCount = 0;
+	uint64_t CheckpointCount = 0;
+	/** From the start of recording to the solve start, or to the first move when the timer was never started */
+	double InspectionSeconds = 0.0;
+	double SolveSeconds = 0.0;
+	double TurnsPerSecond = 0.0;
+	/** HashCubeScramble of the recorded scramble, lets a caller match the log to the scramble it issued */
+	uint64_t ScrambleHash = 0;
+	bool bSolved = false;
+};
+
+/** FNV-1a of the cube size and its packed stickers, the same for every platform */
+uint64_t HashCubeScramble(const FCubeNxN& Scramble);
+
+/**
+ * Writes a session log while it is played. Frames are the caller's fixed simulation ticks, so timestamps don't depend on
+ * the clock of the machine. Frames earlier than the previous event are recorded at the previous event's frame.
+ */
+class FCubeSessionRecorder
+{
+public:
+	static constexpr uint32_t DefaultCheckpointInterval = 64;
+
+	/** Recording, and inspection, start at frame 0. A checkpoint follows every CheckpointInterval moves, 0 for none. */
+	FCubeSessionRecorder(const FCubeNxN& Scramble, uint32_t FramesPerSecond, uint32_t CheckpointInterval = DefaultCheckpointInterval);
+
+	/** Starts the solve timer, ignored once a move was recorded. Without it the solve starts with the first move. */
+	void StartSolve(uint64_t Frame);
+	void AddMove(uint64_t Frame, const FCubeLayerMove& Move);
+
+	/** Ends the session, later calls are ignored. Returns the complete log. */
+	const std::vector<uint8_t>& Finish(uint64_t Frame);
+
+	const FCubeNxN& GetCube() const { return Cube; }
+	const std::vector<uint8_t>& GetLog() const { return Log; }
+	bool IsFinished() const { return bFinished; }
+
+private:
+	void WriteEvent(uint64_t Frame, ECubeSessionEvent Event);
+
+	FCubeNxN Cube;
+	uint32_t CheckpointInterval;
+	std::vector<uint8_t> Log;
+	uint64_t LastFrame = 0;
+	uint64_t MovesSinceCheckpoint = 0;
+	bool bSolveStarted = false;
+	bool bMoved = false;
+	bool bFinished = false;
+};
+
+/**
+ * Replays a log without keeping its moves, checks the hash, that the scramble is an unsolved state reachable by layer turns,
+ * that every checkpoint matches the replayed state and that the cube ends solved. OutStats is filled as far as the log could be read.
+ * Returns false with OutError describing the first problem.
+ */
+bool VerifyCubeSession(const uint8_t* Data, size_t Size, FCubeSessionStats& OutStats, std::string& OutError);
+
+/** Same, and fails unless the log starts from ExpectedScramble, the scramble the caller handed out for this session */
+bool VerifyCubeSession(const uint8_t* Data, size_t Size, const FCubeNxN& ExpectedScramble, FCubeSessionStats& OutStats, std::string& OutError);
+
+/** Decodes a log for playback, checking it like VerifyCubeSession except that the cube may start or end solved */
+bool ReadCubeSession(const uint8_t* Data, size_t Size, FCubeSession& OutSession, std::string& OutError);
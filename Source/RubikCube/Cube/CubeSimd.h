@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+ * Intrinsics for the SIMD paths of the cube library. Functions using an instruction set are marked with
+ * CUBE_VECTOR_TARGET so the rest of the module builds for the baseline CPU, and are only called when
+ * GetSupportedSimdLevel allows it.
+ */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define CUBE_VECTOR_X86 1
+	#include <immintrin.h>
+	#if defined(_MSC_VER) && !defined(__clang__)
+		// MSVC allows intrinsics of any instruction set in any function
+		#define CUBE_VECTOR_TARGET(Target)
+	#else
+		#define CUBE_VECTOR_TARGET(Target) __attribute__((target(Target)))
+	#endif
+#else
+	#define CUBE_VECTOR_X86 0
+#endif
@@ -0,0 +1,267 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeState.h"
+
+#include <sstream>
+
+namespace CubeStateImpl
+{
+/**
+ * Face turn on packed words. Each moved field is rotated from its source to its target position,
+ * masked and merged with the fields the turn keeps. Rotation count depends only on the move,
+ * so there are no lookups depending on the state.
+ */
+struct FPackedMove
+{
+	uint64_t CornerKeep = 0;
+	uint64_t EdgeKeep = 0;
+	uint64_t CornerMask[4] = {};
+	uint64_t EdgeMask[4] = {};
+	uint8_t CornerRotate[4] = {};
+	uint8_t EdgeRotate[4] = {};
+	// Twist of every corner shifted to bits 3-4 of its byte
+	uint64_t CornerTwist = 0;
+	uint64_t EdgeFlip = 0;
+};
+
+/** Bit 3 of every corner byte */
+static constexpr uint64_t CornerTwistUnit = 0x0808080808080808ull;
+
+static constexpr uint64_t RotateLeft(uint64_t Value, uint32_t Count)
+{
+	return (Value << (Count & 63)) | (Value >> ((64 - Count) & 63));
+}
+
+static constexpr uint8_t GetRotation(int32_t From, int32_t To, int32_t Bits)
+{
+	return static_cast<uint8_t>(((To - From) * Bits + 64) & 63);
+}
+
+static constexpr FPackedMove BuildPackedMove(ECubeMove MoveIndex)
+{
+	const FCubieCube Cube = FCubieCube::FromMove(MoveIndex);
+	FPackedMove Move{};
+	Move.CornerKeep = ~0ull;
+	Move.EdgeKeep = ~0ull;
+
+	int32_t Count = 0;
+	for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+	{
+		if (Cube.Cp[Index] == Index && Cube.Co[Index] == 0) continue;
+
+		const uint64_t Mask = FCubeState::FieldMask << (Index * FCubeState::CornerBits);
+		Move.CornerKeep &= ~Mask;
+		Move.CornerMask[Count] = Mask;
+		Move.CornerRotate[Count] = GetRotation(Cube.Cp[Index], Index, FCubeState::CornerBits);
+		Move.CornerTwist |= static_cast<uint64_t>(Cube.Co[Index]) << (Index * FCubeState::CornerBits + 3);
+		++Count;
+	}
+
+	Count = 0;
+	for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+	{
+		if (Cube.Ep[Index] == Index && Cube.Eo[Index] == 0) continue;
+
+		const uint64_t Mask = FCubeState::FieldMask << (Index * FCubeState::EdgeBits);
+		Move.EdgeKeep &= ~Mask;
+		Move.EdgeMask[Count] = Mask;
+		Move.EdgeRotate[Count] = GetRotation(Cube.Ep[Index], Index, FCubeState::EdgeBits);
+		Move.EdgeFlip |= static_cast<uint64_t>(Cube.Eo[Index]) << (Index * FCubeState::EdgeBits + 4);
+		++Count;
+	}
+	return Move;
+}
+
+struct FPackedMoveTables
+{
+	FPackedMove Moves[CubeMoveCount];
+	// Corner field with twist added, indexed by twist and old field
+	uint8_t TwistedField[3][32] = {};
+};
+
+static constexpr FPackedMoveTables BuildPackedMoveTables()
+{
+	FPackedMoveTables Tables{};
+	for (int32_t Twist = 0; Twist < 3; ++Twist)
+	{
+		for (int32_t Field = 0; Field < 32; ++Field)
+		{
+			Tables.TwistedField[Twist][Field] = static_cast<uint8_t>((Field & 7) | (((Field >> 3) + Twist) % 3) << 3);
+		}
+	}
+	for (int32_t MoveIndex = 0; MoveIndex < CubeMoveCount; ++MoveIndex)
+	{
+		Tables.Moves[MoveIndex] = BuildPackedMove(static_cast<ECubeMove>(MoveIndex));
+	}
+	return Tables;
+}
+
+static constexpr FPackedMoveTables PackedMoveTables = BuildPackedMoveTables();
+
+static const char* const MoveNames[CubeMoveCount] = {
+	"U", "U2", "U'", "R", "R2", "R'", "F", "F2", "F'", "D", "D2", "D'", "L", "L2", "L'", "B", "B2", "B'"
+};
+}
+
+using namespace CubeStateImpl;
+
+int32_t FCubieCube::CornerParity() const
+{
+	int32_t Parity = 0;
+	for (int32_t Index = CubeCornerCount - 1; Index > 0; --Index)
+	{
+		for (int32_t Other = Index - 1; Other >= 0; --Other)
+		{
+			Parity += Cp[Other] > Cp[Index];
+		}
+	}
+	return Parity & 1;
+}
+
+int32_t FCubieCube::EdgeParity() const
+{
+	int32_t Parity = 0;
+	for (int32_t Index = CubeEdgeCount - 1; Index > 0; --Index)
+	{
+		for (int32_t Other = Index - 1; Other >= 0; --Other)
+		{
+			Parity += Ep[Other] > Ep[Index];
+		}
+	}
+	return Parity & 1;
+}
+
+bool FCubieCube::IsSolvable() const
+{
+	uint32_t CornersSeen = 0;
+	int32_t TwistSum = 0;
+	for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+	{
+		if (Cp[Index] >= CubeCornerCount || Co[Index] > 2) return false;
+		CornersSeen |= 1u << Cp[Index];
+		TwistSum += Co[Index];
+	}
+
+	uint32_t EdgesSeen = 0;
+	int32_t FlipSum = 0;
+	for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+	{
+		if (Ep[Index] >= CubeEdgeCount || Eo[Index] > 1) return false;
+		EdgesSeen |= 1u << Ep[Index];
+		FlipSum += Eo[Index];
+	}
+
+	return CornersSeen == 0xFF && EdgesSeen == 0xFFF && TwistSum % 3 == 0 && FlipSum % 2 == 0 &&
+		CornerParity() == EdgeParity();
+}
+
+FCubeState FCubeState::Apply(ECubeMove Move) const
+{
+	const FPackedMove& Packed = PackedMoveTables.Moves[static_cast<uint8_t>(Move)];
+
+	uint64_t NewCorners = (Corners & Packed.CornerKeep) |
+		(RotateLeft(Corners, Packed.CornerRotate[0]) & Packed.CornerMask[0]) |
+		(RotateLeft(Corners, Packed.CornerRotate[1]) & Packed.CornerMask[1]) |
+		(RotateLeft(Corners, Packed.CornerRotate[2]) & Packed.CornerMask[2]) |
+		(RotateLeft(Corners, Packed.CornerRotate[3]) & Packed.CornerMask[3]);
+	const uint64_t NewEdges = ((Edges & Packed.EdgeKeep) |
+		(RotateLeft(Edges, Packed.EdgeRotate[0]) & Packed.EdgeMask[0]) |
+		(RotateLeft(Edges, Packed.EdgeRotate[1]) & Packed.EdgeMask[1]) |
+		(RotateLeft(Edges, Packed.EdgeRotate[2]) & Packed.EdgeMask[2]) |
+		(RotateLeft(Edges, Packed.EdgeRotate[3]) & Packed.EdgeMask[3])) ^ Packed.EdgeFlip;
+
+	// Twists of all corners are added at once, sums of 3 and 4 are found by carry into bit 5 and reduced by 3
+	NewCorners += Packed.CornerTwist;
+	const uint64_t Wrapped = ((NewCorners + CornerTwistUnit) >> 2) & CornerTwistUnit;
+	NewCorners -= Wrapped * 3;
+
+	return {NewCorners, NewEdges};
+}
+
+FCubeState FCubeState::Apply(const std::vector<ECubeMove>& Moves) const
+{
+	FCubeState State = *this;
+	for (const ECubeMove Move : Moves)
+	{
+		State = State.Apply(Move);
+	}
+	return State;
+}
+
+FCubeState FCubeState::Compose(const FCubeState& A, const FCubeState& B)
+{
+	FCubeState Result;
+	for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+	{
+		const uint32_t Field = static_cast<uint32_t>(B.Corners >> (Index * CornerBits)) & FieldMask;
+		const uint32_t Source = static_cast<uint32_t>(A.Corners >> ((Field & 7) * CornerBits)) & FieldMask;
+		Result.Corners |= static_cast<uint64_t>(PackedMoveTables.TwistedField[Field >> 3][Source]) << (Index * CornerBits);
+	}
+	for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+	{
+		const uint64_t Field = (B.Edges >> (Index * EdgeBits)) & FieldMask;
+		const uint64_t Source = (A.Edges >> ((Field & 15) * EdgeBits)) & FieldMask;
+		Result.Edges |= (Source ^ (Field & 16)) << (Index * EdgeBits);
+	}
+	return Result;
+}
+
+FCubeState FCubeState::Inverse() const
+{
+	FCubeState Result;
+	for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+	{
+		const uint32_t Field = static_cast<uint32_t>(Corners >> (Index * CornerBits)) & FieldMask;
+		const uint64_t Twist = (3 - (Field >> 3)) % 3;
+		Result.Corners |= (static_cast<uint64_t>(Index) | Twist << 3) << ((Field & 7) * CornerBits);
+	}
+	for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+	{
+		const uint64_t Field = (Edges >> (Index * EdgeBits)) & FieldMask;
+		Result.Edges |= (static_cast<uint64_t>(Index) | (Field & 16)) << ((Field & 15) * EdgeBits);
+	}
+	return Result;
+}
+
+const char* ToString(ECubeMove Move)
+{
+	return Move < ECubeMove::Count ? MoveNames[static_cast<uint8_t>(Move)] : "?";
+}
+
+std::string ToString(const std::vector<ECubeMove>& Moves)
+{
+	std::string Result;
+	for (const ECubeMove Move : Moves)
+	{
+		if (!Result.empty()) Result += ' ';
+		Result += ToString(Move);
+	}
+	return Result;
+}
+
+bool ParseMoves(const std::string& Text, std::vector<ECubeMove>& OutMoves)
+{
+	static const char Faces[] = "URFDLB";
+
+	std::istringstream Stream(Text);
+	std::string Token;
+	while (Stream >> Token)
+	{
+		const char* Face = Token.size() <= 2 ? std::char_traits<char>::find(Faces, 6, Token[0]) : nullptr;
+		if (Face == nullptr) return false;
+
+		int32_t Power = 1;
+		if (Token.size() == 2)
+		{
+			switch (Token[1])
+			{
+			case '2': Power = 2; break;
+			case '3':
+			case '\'': Power = 3; break;
+			default: return false;
+			}
+		}
+		OutMoves.push_back(MakeMove(static_cast<ECubeFace>(Face - Faces), Power));
+	}
+	return true;
+}
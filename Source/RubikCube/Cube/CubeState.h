@@ -0,0 +1,277 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Cube state library of the game. Everything under Cube/ is plain C++ without engine types,
+ * so solvers and verifiers can be built and profiled outside of Unreal as well.
+ *
+ * Cubies are numbered as in Kociemba's cube explorer:
+ * corners URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB and
+ * edges UR, UF, UL, UB, DR, DF, DL, DB, FR, FL, BL, BR.
+ */
+
+enum class ECubeFace : uint8_t
+{
+	U, R, F, D, L, B
+};
+
+/** Face turns in face-major order, each face has clockwise, half and counter-clockwise turn */
+enum class ECubeMove : uint8_t
+{
+	U, U2, U3,
+	R, R2, R3,
+	F, F2, F3,
+	D, D2, D3,
+	L, L2, L3,
+	B, B2, B3,
+	Count
+};
+
+constexpr int32_t CubeMoveCount = static_cast<int32_t>(ECubeMove::Count);
+constexpr int32_t CubeCornerCount = 8;
+constexpr int32_t CubeEdgeCount = 12;
+
+inline ECubeFace GetMoveFace(ECubeMove Move) { return static_cast<ECubeFace>(static_cast<uint8_t>(Move) / 3); }
+
+/** Number of clockwise quarter turns, 1..3 */
+inline int32_t GetMovePower(ECubeMove Move) { return static_cast<uint8_t>(Move) % 3 + 1; }
+
+inline ECubeMove MakeMove(ECubeFace Face, int32_t Power)
+{
+	return static_cast<ECubeMove>(static_cast<uint8_t>(Face) * 3 + Power - 1);
+}
+
+inline ECubeMove InverseMove(ECubeMove Move)
+{
+	const uint8_t Index = static_cast<uint8_t>(Move);
+	return static_cast<ECubeMove>(Index - Index % 3 + 2 - Index % 3);
+}
+
+/** Unpacked cubie level representation, used where single cubies are inspected */
+struct FCubieCube
+{
+	uint8_t Cp[CubeCornerCount];
+	uint8_t Co[CubeCornerCount];
+	uint8_t Ep[CubeEdgeCount];
+	uint8_t Eo[CubeEdgeCount];
+
+	static constexpr FCubieCube Solved()
+	{
+		return {{0, 1, 2, 3, 4, 5, 6, 7}, {0, 0, 0, 0, 0, 0, 0, 0},
+		        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+	}
+
+	/**
+	 * Applies B after A: cubie at position i comes from A's position B.Cp[i].
+	 * Corner orientations 3-5 mark mirrored corners, they only appear in reflection symmetries.
+	 */
+	static constexpr FCubieCube Multiply(const FCubieCube& A, const FCubieCube& B)
+	{
+		FCubieCube Result{};
+		for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+		{
+			Result.Cp[Index] = A.Cp[B.Cp[Index]];
+			Result.Co[Index] = MultiplyCornerOrientation(A.Co[B.Cp[Index]], B.Co[Index]);
+		}
+		for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+		{
+			Result.Ep[Index] = A.Ep[B.Ep[Index]];
+			Result.Eo[Index] = static_cast<uint8_t>(A.Eo[B.Ep[Index]] ^ B.Eo[Index]);
+		}
+		return Result;
+	}
+
+	static constexpr FCubieCube Inverse(const FCubieCube& Cube)
+	{
+		FCubieCube Result{};
+		for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+		{
+			const uint8_t Orientation = Cube.Co[Index];
+			Result.Cp[Cube.Cp[Index]] = static_cast<uint8_t>(Index);
+			Result.Co[Cube.Cp[Index]] = static_cast<uint8_t>(Orientation >= 3 ? Orientation : (3 - Orientation) % 3);
+		}
+		for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+		{
+			Result.Ep[Cube.Ep[Index]] = static_cast<uint8_t>(Index);
+			Result.Eo[Cube.Ep[Index]] = Cube.Eo[Index];
+		}
+		return Result;
+	}
+
+	/** Clockwise quarter turn of given face */
+	static constexpr FCubieCube FaceTurn(ECubeFace Face)
+	{
+		switch (Face)
+		{
+		case ECubeFace::U:
+			return {{3, 0, 1, 2, 4, 5, 6, 7}, {0, 0, 0, 0, 0, 0, 0, 0},
+			        {3, 0, 1, 2, 4, 5, 6, 7, 8, 9, 10, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+		case ECubeFace::R:
+			return {{4, 1, 2, 0, 7, 5, 6, 3}, {2, 0, 0, 1, 1, 0, 0, 2},
+			        {8, 1, 2, 3, 11, 5, 6, 7, 4, 9, 10, 0}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+		case ECubeFace::F:
+			return {{1, 5, 2, 3, 0, 4, 6, 7}, {1, 2, 0, 0, 2, 1, 0, 0},
+			        {0, 9, 2, 3, 4, 8, 6, 7, 1, 5, 10, 11}, {0, 1, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0}};
+		case ECubeFace::D:
+			return {{0, 1, 2, 3, 5, 6, 7, 4}, {0, 0, 0, 0, 0, 0, 0, 0},
+			        {0, 1, 2, 3, 5, 6, 7, 4, 8, 9, 10, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+		case ECubeFace::L:
+			return {{0, 2, 6, 3, 4, 1, 5, 7}, {0, 1, 2, 0, 0, 2, 1, 0},
+			        {0, 1, 10, 3, 4, 5, 9, 7, 8, 2, 6, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+		case ECubeFace::B:
+		default:
+			return {{0, 1, 3, 7, 4, 5, 2, 6}, {0, 0, 1, 2, 0, 0, 2, 1},
+			        {0, 1, 2, 11, 4, 5, 6, 10, 8, 9, 3, 7}, {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 1}};
+		}
+	}
+
+	static constexpr FCubieCube FromMove(ECubeMove Move)
+	{
+		const FCubieCube Turn = FaceTurn(static_cast<ECubeFace>(static_cast<uint8_t>(Move) / 3));
+		FCubieCube Result = Turn;
+		for (int32_t Power = static_cast<uint8_t>(Move) % 3; Power > 0; --Power)
+		{
+			Result = Multiply(Result, Turn);
+		}
+		return Result;
+	}
+
+	constexpr bool operator==(const FCubieCube& Other) const
+	{
+		for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+		{
+			if (Cp[Index] != Other.Cp[Index] || Co[Index] != Other.Co[Index]) return false;
+		}
+		for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+		{
+			if (Ep[Index] != Other.Ep[Index] || Eo[Index] != Other.Eo[Index]) return false;
+		}
+		return true;
+	}
+
+	constexpr bool operator!=(const FCubieCube& Other) const { return !(*this == Other); }
+
+	/** Orientation of a corner with orientation A turned by B, mirrored orientations subtract instead of add */
+	static constexpr uint8_t MultiplyCornerOrientation(uint8_t A, uint8_t B)
+	{
+		if (A < 3 && B < 3) return static_cast<uint8_t>((A + B) % 3);
+		if (A < 3) return static_cast<uint8_t>((A + B) % 3 + 3);
+		if (B < 3) return static_cast<uint8_t>((A - B + 3) % 3 + 3);
+		return static_cast<uint8_t>((A - B + 3) % 3);
+	}
+
+	/** Checks permutations, orientation sums and that corner and edge permutation parities match */
+	bool IsSolvable() const;
+
+	int32_t CornerParity() const;
+	int32_t EdgeParity() const;
+};
+
+/**
+ * Cube state packed into two words:
+ * corners take one byte each, position in bits 0-2 and twist in bits 3-4,
+ * edges take 5 bits each, position in bits 0-3 and flip in bit 4.
+ * Spare corner bits let twists of all corners be added at once without carry into neighbours.
+ * Field i describes cubie currently at position i.
+ */
+struct FCubeState
+{
+	uint64_t Corners = 0;
+	uint64_t Edges = 0;
+
+	static constexpr int32_t CornerBits = 8;
+	static constexpr int32_t EdgeBits = 5;
+	static constexpr uint64_t FieldMask = 31;
+
+	static constexpr FCubeState Solved()
+	{
+		FCubeState State;
+		for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+		{
+			State.Corners |= static_cast<uint64_t>(Index) << (Index * CornerBits);
+		}
+		for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+		{
+			State.Edges |= static_cast<uint64_t>(Index) << (Index * EdgeBits);
+		}
+		return State;
+	}
+
+	static constexpr FCubeState FromCubie(const FCubieCube& Cube)
+	{
+		FCubeState State;
+		for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+		{
+			State.Corners |= static_cast<uint64_t>(Cube.Cp[Index] | Cube.Co[Index] << 3) << (Index * CornerBits);
+		}
+		for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+		{
+			State.Edges |= static_cast<uint64_t>(Cube.Ep[Index] | Cube.Eo[Index] << 4) << (Index * EdgeBits);
+		}
+		return State;
+	}
+
+	constexpr FCubieCube ToCubie() const
+	{
+		FCubieCube Cube{};
+		for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+		{
+			const uint32_t Field = static_cast<uint32_t>(Corners >> (Index * CornerBits)) & FieldMask;
+			Cube.Cp[Index] = static_cast<uint8_t>(Field & 7);
+			Cube.Co[Index] = static_cast<uint8_t>(Field >> 3);
+		}
+		for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+		{
+			const uint32_t Field = static_cast<uint32_t>(Edges >> (Index * EdgeBits)) & FieldMask;
+			Cube.Ep[Index] = static_cast<uint8_t>(Field & 15);
+			Cube.Eo[Index] = static_cast<uint8_t>(Field >> 4);
+		}
+		return Cube;
+	}
+
+	/** Applies single face turn, only the 8 fields touched by the turn are rewritten */
+	FCubeState Apply(ECubeMove Move) const;
+
+	FCubeState Apply(const std::vector<ECubeMove>& Moves) const;
+
+	/** State reached by applying B's moves after A's moves */
+	static FCubeState Compose(const FCubeState& A, const FCubeState& B);
+
+	FCubeState Inverse() const;
+
+	bool IsSolved() const { return *this == Solved(); }
+
+	bool IsSolvable() const { return ToCubie().IsSolvable(); }
+
+	/** Same value for equal states on every platform, suitable for hash sets and persisted data */
+	uint64_t Hash() const
+	{
+		uint64_t Value = Corners * 0x9E3779B97F4A7C15ull ^ Edges;
+		Value ^= Value >> 31;
+		Value *= 0xBF58476D1CE4E5B9ull;
+		Value ^= Value >> 27;
+		Value *= 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+
+	constexpr bool operator==(const FCubeState& Other) const { return Corners == Other.Corners && Edges == Other.Edges; }
+	constexpr bool operator!=(const FCubeState& Other) const { return !(*this == Other); }
+};
+
+struct FCubeStateHasher
+{
+	size_t operator()(const FCubeState& State) const { return static_cast<size_t>(State.Hash()); }
+};
+
+/** Singmaster notation of a move, e.g. "R", "U2" or "F'" */
+const char* ToString(ECubeMove Move);
+
+std::string ToString(const std::vector<ECubeMove>& Moves);
+
+/** Parses space separated moves, accepts "R", "R2", "R'" and "R3", returns false on unknown token */
+bool ParseMoves(const std::string& Text, std::vector<ECubeMove>& OutMoves);
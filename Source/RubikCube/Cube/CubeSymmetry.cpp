@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeSymmetry.h"
+
+ECubeMove ConjugateMove(ECubeMove Move, const FCubieCube& Symmetry)
+{
+	const FCubieCube Conjugated = ConjugateCube(FCubieCube::FromMove(Move), Symmetry);
+	for (int32_t Index = 0; Index < CubeMoveCount; ++Index)
+	{
+		if (FCubieCube::FromMove(static_cast<ECubeMove>(Index)) == Conjugated)
+		{
+			return static_cast<ECubeMove>(Index);
+		}
+	}
+	return ECubeMove::Count;
+}
+
+namespace CubeSymmetryImpl
+{
+static FCubeSymmetryTables BuildSymmetryTables()
+{
+	FCubeSymmetryTables Tables;
+	FCubieCube Cube = FCubieCube::Solved();
+	int32_t Index = 0;
+	for (int32_t URF3 = 0; URF3 < 3; ++URF3)
+	{
+		for (int32_t F2 = 0; F2 < 2; ++F2)
+		{
+			for (int32_t U4 = 0; U4 < 4; ++U4)
+			{
+				for (int32_t LR2 = 0; LR2 < 2; ++LR2)
+				{
+					Tables.Cubes[Index++] = Cube;
+					Cube = FCubieCube::Multiply(Cube, GetSymmetryLR2());
+				}
+				Cube = FCubieCube::Multiply(Cube, GetSymmetryU4());
+			}
+			Cube = FCubieCube::Multiply(Cube, GetSymmetryF2());
+		}
+		Cube = FCubieCube::Multiply(Cube, GetSymmetryURF3());
+	}
+
+	for (int32_t Symmetry = 0; Symmetry < CubeSymmetryCount; ++Symmetry)
+	{
+		for (int32_t Other = 0; Other < CubeSymmetryCount; ++Other)
+		{
+			if (FCubieCube::Multiply(Tables.Cubes[Symmetry], Tables.Cubes[Other]) == FCubieCube::Solved())
+			{
+				Tables.Inverse[Symmetry] = static_cast<uint8_t>(Other);
+			}
+		}
+		for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+		{
+			Tables.Moves[Symmetry][Move] = ConjugateMove(static_cast<ECubeMove>(Move), Tables.Cubes[Symmetry]);
+		}
+	}
+	return Tables;
+}
+}
+
+using namespace CubeSymmetryImpl;
+
+const FCubeSymmetryTables& FCubeSymmetryTables::Get()
+{
+	static const FCubeSymmetryTables Tables = BuildSymmetryTables();
+	return Tables;
+}
@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CubeState.h"
+
+/**
+ * Whole cube rotations and reflections. Conjugating a state by symmetry S (S^-1 * State * S) gives a state
+ * with the same distance to solved, so tables can be looked up from several viewpoints or reduced to classes.
+ */
+
+/** Symmetries of the cube including reflections */
+constexpr int32_t CubeSymmetryCount = 48;
+
+/** Symmetries 0..15 of FCubeSymmetryTables keep U and D faces on the UD axis */
+constexpr int32_t CubeUDSymmetryCount = 16;
+
+/** 120 degree rotation around the URF-DBL diagonal, maps U to R, R to F and F to U */
+constexpr FCubieCube GetSymmetryURF3()
+{
+	return {{0, 4, 5, 1, 3, 7, 6, 2}, {1, 2, 1, 2, 2, 1, 2, 1},
+	        {1, 8, 5, 9, 3, 11, 7, 10, 0, 4, 6, 2}, {1, 0, 1, 0, 1, 0, 1, 0, 1, 1, 1, 1}};
+}
+
+/** 180 degree rotation around the R-L axis, swaps U with D and F with B */
+constexpr FCubieCube GetSymmetryX2()
+{
+	return {{7, 6, 5, 4, 3, 2, 1, 0}, {0, 0, 0, 0, 0, 0, 0, 0},
+	        {4, 7, 6, 5, 0, 3, 2, 1, 11, 10, 9, 8}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+}
+
+/** 180 degree rotation around the F-B axis */
+constexpr FCubieCube GetSymmetryF2()
+{
+	return {{5, 4, 7, 6, 1, 0, 3, 2}, {0, 0, 0, 0, 0, 0, 0, 0},
+	        {6, 5, 4, 7, 2, 1, 0, 3, 9, 8, 11, 10}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+}
+
+/** 90 degree rotation around the U-D axis, clockwise seen from U */
+constexpr FCubieCube GetSymmetryU4()
+{
+	return {{3, 0, 1, 2, 7, 4, 5, 6}, {0, 0, 0, 0, 0, 0, 0, 0},
+	        {3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10}, {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1}};
+}
+
+/** Reflection in the plane between L and R, corner orientation 3 marks the mirrored corners */
+constexpr FCubieCube GetSymmetryLR2()
+{
+	return {{1, 0, 3, 2, 5, 4, 7, 6}, {3, 3, 3, 3, 3, 3, 3, 3},
+	        {2, 1, 0, 3, 6, 5, 4, 7, 9, 8, 11, 10}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+}
+
+/** S^-1 * Cube * S */
+inline FCubieCube ConjugateCube(const FCubieCube& Cube, const FCubieCube& Symmetry)
+{
+	return FCubieCube::Multiply(FCubieCube::Multiply(FCubieCube::Inverse(Symmetry), Cube), Symmetry);
+}
+
+/** Move equal to S^-1 * Move * S, Count when Symmetry doesn't map face turns to face turns */
+ECubeMove ConjugateMove(ECubeMove Move, const FCubieCube& Symmetry);
+
+/**
+ * All 48 symmetries, index is 16 * URF3 + 8 * F2 + 2 * U4 + LR2 powers of the generators,
+ * so the first CubeUDSymmetryCount of them keep the UD axis.
+ */
+struct FCubeSymmetryTables
+{
+	FCubieCube Cubes[CubeSymmetryCount];
+	/** Index of the inverse symmetry */
+	uint8_t Inverse[CubeSymmetryCount];
+	/** ConjugateMove of every move */
+	ECubeMove Moves[CubeSymmetryCount][CubeMoveCount];
+
+	static const FCubeSymmetryTables& Get();
+};
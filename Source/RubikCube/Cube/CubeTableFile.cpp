@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeTableFile.h"
+
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#define CUBE_TABLE_MMAP 1
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#else
+	#define CUBE_TABLE_MMAP 0
+#endif
+
+namespace CubeTableFileImpl
+{
+/** File layout is the header followed by table bytes, both little endian */
+struct FTableFileHeader
+{
+	char Magic[8];
+	uint32_t Version;
+	uint32_t Kind;
+	uint64_t EntryCount;
+	uint64_t Reserved;
+};
+static_assert(sizeof(FTableFileHeader) == 32, "Table file header must not contain padding");
+
+static constexpr char TableFileMagic[8] = {'C', 'U', 'B', 'E', 'P', 'D', 'B', '\0'};
+static constexpr uint32_t TableFileVersion = 1;
+
+static bool IsValidHeader(const FTableFileHeader& Header, uint32_t Kind, uint64_t EntryCount)
+{
+	return std::memcmp(Header.Magic, TableFileMagic, sizeof(Header.Magic)) == 0 && Header.Version == TableFileVersion &&
+		Header.Kind == Kind && Header.EntryCount == EntryCount;
+}
+}
+
+using namespace CubeTableFileImpl;
+
+FCubeTableFile::~FCubeTableFile()
+{
+	Reset();
+}
+
+void FCubeTableFile::Assign(std::vector<uint8_t>&& Bytes)
+{
+	Reset();
+	OwnedData = std::move(Bytes);
+	Data = OwnedData.data();
+	Size = OwnedData.size();
+}
+
+void FCubeTableFile::Reset()
+{
+#if CUBE_TABLE_MMAP
+	if (MappedFile != nullptr)
+	{
+		munmap(MappedFile, MappedSize);
+	}
+#endif
+	MappedFile = nullptr;
+	MappedSize = 0;
+	OwnedData.clear();
+	OwnedData.shrink_to_fit();
+	Data = nullptr;
+	Size = 0;
+}
+
+bool FCubeTableFile::Save(const std::string& Path, uint32_t Kind, uint64_t EntryCount, std::string& OutError) const
+{
+	if (!IsValid())
+	{
+		OutError = "Table is empty";
+		return false;
+	}
+
+	FTableFileHeader Header{};
+	std::memcpy(Header.Magic, TableFileMagic, sizeof(Header.Magic));
+	Header.Version = TableFileVersion;
+	Header.Kind = Kind;
+	Header.EntryCount = EntryCount;
+
+	std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+	File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+	File.write(reinterpret_cast<const char*>(Data), static_cast<std::streamsize>(Size));
+	if (!File)
+	{
+		OutError = "Failed to write " + Path;
+		return false;
+	}
+	return true;
+}
+
+bool FCubeTableFile::Load(const std::string& Path, uint32_t Kind, uint64_t EntryCount, size_t InSize, std::string& OutError)
+{
+	Reset();
+
+	const size_t FileSize = sizeof(FTableFileHeader) + InSize;
+
+#if CUBE_TABLE_MMAP
+	const int File = open(Path.c_str(), O_RDONLY);
+	if (File < 0)
+	{
+		OutError = "Failed to open " + Path;
+		return false;
+	}
+
+	struct stat Stat;
+	void* Mapped = MAP_FAILED;
+	if (fstat(File, &Stat) == 0 && static_cast<size_t>(Stat.st_size) == FileSize)
+	{
+		Mapped = mmap(nullptr, FileSize, PROT_READ, MAP_PRIVATE, File, 0);
+	}
+	close(File);
+	if (Mapped == MAP_FAILED)
+	{
+		OutError = "Failed to map " + Path;
+		return false;
+	}
+
+	MappedFile = Mapped;
+	MappedSize = FileSize;
+	if (!IsValidHeader(*static_cast<const FTableFileHeader*>(Mapped), Kind, EntryCount))
+	{
+		Reset();
+		OutError = Path + " is not a table of this kind and version";
+		return false;
+	}
+	// Search touches entries randomly, read ahead of the whole file beats faulting pages one by one
+	madvise(Mapped, FileSize, MADV_WILLNEED);
+	Data = static_cast<const uint8_t*>(Mapped) + sizeof(FTableFileHeader);
+#else
+	std::ifstream File(Path, std::ios::binary);
+	FTableFileHeader Header{};
+	File.read(reinterpret_cast<char*>(&Header), sizeof(Header));
+	if (!File || !IsValidHeader(Header, Kind, EntryCount))
+	{
+		OutError = Path + " is not a table of this kind and version";
+		return false;
+	}
+
+	OwnedData.resize(InSize);
+	File.read(reinterpret_cast<char*>(OwnedData.data()), static_cast<std::streamsize>(OwnedData.size()));
+	if (!File)
+	{
+		Reset();
+		OutError = "Failed to read " + Path;
+		return false;
+	}
+	Data = OwnedData.data();
+#endif
+	Size = InSize;
+	return true;
+}
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Precomputed table kept in memory or on disk. Files start with a small header naming the table kind
+ * and its entry count, loaded files are memory mapped where the platform supports it.
+ */
+class FCubeTableFile
+{
+public:
+	FCubeTableFile() = default;
+	~FCubeTableFile();
+
+	FCubeTableFile(const FCubeTableFile&) = delete;
+	FCubeTableFile& operator=(const FCubeTableFile&) = delete;
+
+	/** Takes ownership of freshly generated table bytes */
+	void Assign(std::vector<uint8_t>&& Bytes);
+
+	/** Writes Data with a header, Kind and EntryCount must match on load */
+	bool Save(const std::string& Path, uint32_t Kind, uint64_t EntryCount, std::string& OutError) const;
+	/** Loads a table of Size bytes written by Save */
+	bool Load(const std::string& Path, uint32_t Kind, uint64_t EntryCount, size_t Size, std::string& OutError);
+
+	void Reset();
+
+	bool IsValid() const { return Data != nullptr; }
+	const uint8_t* GetData() const { return Data; }
+	size_t GetSize() const { return Size; }
+
+private:
+	const uint8_t* Data = nullptr;
+	size_t Size = 0;
+	std::vector<uint8_t> OwnedData;
+	void* MappedFile = nullptr;
+	size_t MappedSize = 0;
+};
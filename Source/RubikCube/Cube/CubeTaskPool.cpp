@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeTaskPool.h"
+
+#include <algorithm>
+
+namespace CubeTaskPoolImpl
+{
+/** Pool and worker index of the current thread, so tasks can queue follow-up work locally */
+static thread_local const FCubeTaskPool* CurrentPool = nullptr;
+static thread_local int32_t CurrentWorker = -1;
+}
+
+using namespace CubeTaskPoolImpl;
+
+FCubeTaskPool::FCubeTaskPool(int32_t ThreadCount)
+{
+	ThreadCount = std::max(ThreadCount, 1);
+	for (int32_t Worker = 0; Worker < ThreadCount; ++Worker)
+	{
+		Queues.push_back(std::make_unique<FQueue>());
+	}
+	for (int32_t Worker = 0; Worker < ThreadCount; ++Worker)
+	{
+		Threads.emplace_back(&FCubeTaskPool::RunWorker, this, Worker);
+	}
+}
+
+FCubeTaskPool::~FCubeTaskPool()
+{
+	Wait();
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		bStopping = true;
+	}
+	TaskQueued.notify_all();
+	for (std::thread& Thread : Threads)
+	{
+		Thread.join();
+	}
+}
+
+void FCubeTaskPool::Submit(FTask Task)
+{
+	// Counted before it is queued, so a worker never finds more tasks than counted
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		++QueuedCount;
+		++UnfinishedCount;
+	}
+
+	FQueue& Queue = CurrentPool == this ? *Queues[CurrentWorker] : SharedQueue;
+	{
+		std::lock_guard<std::mutex> Lock(Queue.Mutex);
+		Queue.Tasks.push_back(std::move(Task));
+	}
+	TaskQueued.notify_one();
+}
+
+void FCubeTaskPool::Wait()
+{
+	std::unique_lock<std::mutex> Lock(Mutex);
+	AllFinished.wait(Lock, [this]() { return UnfinishedCount == 0; });
+}
+
+bool FCubeTaskPool::TryTakeTask(int32_t Worker, FTask& OutTask)
+{
+	{
+		FQueue& Own = *Queues[Worker];
+		std::lock_guard<std::mutex> Lock(Own.Mutex);
+		if (!Own.Tasks.empty())
+		{
+			OutTask = std::move(Own.Tasks.back());
+			Own.Tasks.pop_back();
+			return true;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(SharedQueue.Mutex);
+		if (!SharedQueue.Tasks.empty())
+		{
+			OutTask = std::move(SharedQueue.Tasks.front());
+			SharedQueue.Tasks.pop_front();
+			return true;
+		}
+	}
+
+	const int32_t Count = static_cast<int32_t>(Queues.size());
+	for (int32_t Offset = 1; Offset < Count; ++Offset)
+	{
+		FQueue& Victim = *Queues[(Worker + Offset) % Count];
+		std::lock_guard<std::mutex> Lock(Victim.Mutex);
+		if (!Victim.Tasks.empty())
+		{
+			OutTask = std::move(Victim.Tasks.front());
+			Victim.Tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void FCubeTaskPool::RunWorker(int32_t Worker)
+{
+	CurrentPool = this;
+	CurrentWorker = Worker;
+
+	for (;;)
+	{
+		FTask Task;
+		if (TryTakeTask(Worker, Task))
+		{
+			{
+				std::lock_guard<std::mutex> Lock(Mutex);
+				--QueuedCount;
+			}
+			Task();
+			Task = nullptr;
+
+			std::lock_guard<std::mutex> Lock(Mutex);
+			if (--UnfinishedCount == 0)
+			{
+				AllFinished.notify_all();
+			}
+			continue;
+		}
+
+		// Task may be counted but not queued yet, then the wait returns at once and the worker looks again
+		std::unique_lock<std::mutex> Lock(Mutex);
+		TaskQueued.wait(Lock, [this]() { return QueuedCount > 0 || bStopping; });
+		if (bStopping && QueuedCount == 0) return;
+	}
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads with a task deque each. Tasks submitted by a task go to the deque of its worker, which takes
+ * its newest task first, so work split by a task stays on its thread unless others run dry and steal the oldest ones.
+ * Tasks submitted from outside the pool wait in a shared queue and start in submission order.
+ */
+class FCubeTaskPool
+{
+public:
+	using FTask = std::function<void()>;
+
+	explicit FCubeTaskPool(int32_t ThreadCount);
+	/** Finishes all queued tasks before the threads exit */
+	~FCubeTaskPool();
+
+	FCubeTaskPool(const FCubeTaskPool&) = delete;
+	FCubeTaskPool& operator=(const FCubeTaskPool&) = delete;
+
+	void Submit(FTask Task);
+
+	/** Blocks until every submitted task has finished, including tasks submitted meanwhile. Not to be called from a task. */
+	void Wait();
+
+	int32_t GetThreadCount() const { return static_cast<int32_t>(Threads.size()); }
+
+private:
+	struct FQueue
+	{
+		std::mutex Mutex;
+		std::deque<FTask> Tasks;
+	};
+
+	bool TryTakeTask(int32_t Worker, FTask& OutTask);
+	void RunWorker(int32_t Worker);
+
+	std::vector<std::unique_ptr<FQueue>> Queues;
+	FQueue SharedQueue;
+	std::vector<std::thread> Threads;
+
+	/** Guards the counters and the stop flag, workers sleep on it when no deque has a task */
+	std::mutex Mutex;
+	std::condition_variable TaskQueued;
+	std::condition_variable AllFinished;
+	uint64_t QueuedCount = 0;
+	uint64_t UnfinishedCount = 0;
+	bool bStopping = false;
+};
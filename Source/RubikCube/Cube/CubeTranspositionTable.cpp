@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeTranspositionTable.h"
+
+namespace CubeTranspositionTableImpl
+{
+/** Set in the data of every stored entry, so an empty entry never matches hash 0 */
+constexpr uint64_t UsedBit = 1ull << 63;
+}
+
+using namespace CubeTranspositionTableImpl;
+
+FCubeTranspositionTable::FCubeTranspositionTable(uint64_t EntryCount)
+{
+	uint64_t BucketCount = 1;
+	while (BucketCount * 4 <= EntryCount)
+	{
+		BucketCount *= 2;
+	}
+	BucketMask = BucketCount - 1;
+	Entries = std::make_unique<FEntry[]>(BucketCount * 2);
+}
+
+bool FCubeTranspositionTable::ReadEntry(const FEntry& Entry, uint64_t Hash, uint64_t& OutData)
+{
+	OutData = Entry.Data.load(std::memory_order_relaxed);
+	return (OutData & UsedBit) != 0 && (Entry.Check.load(std::memory_order_relaxed) ^ OutData) == Hash;
+}
+
+bool FCubeTranspositionTable::Probe(uint64_t Hash, uint8_t& OutDepth, uint32_t& OutValue) const
+{
+	const FEntry* Bucket = &Entries[(Hash & BucketMask) * 2];
+	for (int32_t Slot = 0; Slot < 2; ++Slot)
+	{
+		uint64_t Data = 0;
+		if (ReadEntry(Bucket[Slot], Hash, Data))
+		{
+			OutDepth = static_cast<uint8_t>(Data);
+			OutValue = static_cast<uint32_t>(Data >> 8);
+			return true;
+		}
+	}
+	return false;
+}
+
+void FCubeTranspositionTable::Store(uint64_t Hash, uint8_t Depth, uint32_t Value)
+{
+	FEntry* Bucket = &Entries[(Hash & BucketMask) * 2];
+
+	// Same state or a result at least as deep replaces the first entry, anything else goes to the second
+	uint64_t Data = 0;
+	const bool bSameState = ReadEntry(Bucket[0], Hash, Data);
+	FEntry& Entry = bSameState || Depth >= static_cast<uint8_t>(Data) ? Bucket[0] : Bucket[1];
+
+	const uint64_t NewData = PackData(Depth, Value) | UsedBit;
+	Entry.Check.store(Hash ^ NewData, std::memory_order_relaxed);
+	Entry.Data.store(NewData, std::memory_order_relaxed);
+}
+
+void FCubeTranspositionTable::Clear()
+{
+	for (uint64_t Index = 0; Index < GetEntryCount(); ++Index)
+	{
+		Entries[Index].Check.store(0, std::memory_order_relaxed);
+		Entries[Index].Data.store(0, std::memory_order_relaxed);
+	}
+}
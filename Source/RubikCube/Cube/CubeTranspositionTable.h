@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Fixed size hash table of search results shared by all search threads without locks. An entry is two atomic words,
+ * the data and the data xor the key, so an entry torn by two threads writing at once fails the key check and reads as missing.
+ * Buckets hold two entries: the first keeps the deepest result, the second always takes the newest one.
+ */
+class FCubeTranspositionTable
+{
+public:
+	/** Rounded down to a power of two, at least one bucket */
+	explicit FCubeTranspositionTable(uint64_t EntryCount);
+
+	FCubeTranspositionTable(const FCubeTranspositionTable&) = delete;
+	FCubeTranspositionTable& operator=(const FCubeTranspositionTable&) = delete;
+
+	/** Finds the entry of Hash, which should be a canonical state hash so symmetric states share it */
+	bool Probe(uint64_t Hash, uint8_t& OutDepth, uint32_t& OutValue) const;
+	void Store(uint64_t Hash, uint8_t Depth, uint32_t Value);
+
+	/** Not to be called while other threads use the table */
+	void Clear();
+
+	uint64_t GetEntryCount() const { return (BucketMask + 1) * 2; }
+
+private:
+	struct FEntry
+	{
+		std::atomic<uint64_t> Check{0};
+		std::atomic<uint64_t> Data{0};
+	};
+
+	static uint64_t PackData(uint8_t Depth, uint32_t Value) { return static_cast<uint64_t>(Value) << 8 | Depth; }
+	static bool ReadEntry(const FEntry& Entry, uint64_t Hash, uint64_t& OutData);
+
+	/** Entries 2 * Bucket and 2 * Bucket + 1 */
+	std::unique_ptr<FEntry[]> Entries;
+	uint64_t BucketMask = 0;
+};
@@ -0,0 +1,505 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeTwoPhaseSolver.h"
+
+#include "CubeDistanceTable.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace CubeTwoPhaseSolverImpl
+{
+using FClock = std::chrono::steady_clock;
+
+/** Table file kinds, pattern databases use the values of ECubePattern */
+static constexpr uint32_t Phase1TableKind = 16;
+static constexpr uint32_t Phase2TableKind = 17;
+
+static constexpr uint16_t UnknownClass = 0xFFFF;
+
+/** Deadline and cancellation are checked once per this many nodes */
+static constexpr uint64_t DeadlineCheckMask = 1023;
+
+/** Distance change of a move, indexed by (new distance modulo 3 - old distance modulo 3) modulo 3 */
+static constexpr int32_t DistanceChange[3] = {0, 1, -1};
+
+template <typename TGetCoordinate, typename TSetCoordinate>
+static std::vector<uint16_t> BuildMoveTable(int32_t Count, const FCubieCube (&Moves)[CubeMoveCount], TGetCoordinate Get, TSetCoordinate Set)
+{
+	std::vector<uint16_t> Table(static_cast<size_t>(Count) * CubeMoveCount);
+	for (int32_t Coordinate = 0; Coordinate < Count; ++Coordinate)
+	{
+		FCubieCube Cube = FCubieCube::Solved();
+		Set(Cube, static_cast<uint16_t>(Coordinate));
+		for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+		{
+			Table[Coordinate * CubeMoveCount + Move] = Get(FCubieCube::Multiply(Cube, Moves[Move]));
+		}
+	}
+	return Table;
+}
+
+template <typename TGetCoordinate, typename TSetCoordinate>
+static std::vector<uint16_t> BuildConjugateTable(int32_t Count, TGetCoordinate Get, TSetCoordinate Set)
+{
+	const FCubeSymmetryTables& Symmetries = FCubeSymmetryTables::Get();
+	std::vector<uint16_t> Table(static_cast<size_t>(Count) * CubeUDSymmetryCount);
+	for (int32_t Coordinate = 0; Coordinate < Count; ++Coordinate)
+	{
+		FCubieCube Cube = FCubieCube::Solved();
+		Set(Cube, static_cast<uint16_t>(Coordinate));
+		for (int32_t Symmetry = 0; Symmetry < CubeUDSymmetryCount; ++Symmetry)
+		{
+			Table[Coordinate * CubeUDSymmetryCount + Symmetry] = Get(ConjugateCube(Cube, Symmetries.Cubes[Symmetry]));
+		}
+	}
+	return Table;
+}
+
+/** First coordinate of every class is its representative, the others are reached by conjugating it */
+template <typename TGetCoordinate, typename TSetCoordinate>
+static FCubeSymmetryClasses BuildSymmetryClasses(int32_t Count, TGetCoordinate Get, TSetCoordinate Set)
+{
+	const FCubeSymmetryTables& Symmetries = FCubeSymmetryTables::Get();
+	FCubeSymmetryClasses Classes;
+	Classes.Class.assign(Count, UnknownClass);
+	Classes.Symmetry.assign(Count, 0);
+	for (int32_t Coordinate = 0; Coordinate < Count; ++Coordinate)
+	{
+		if (Classes.Class[Coordinate] != UnknownClass) continue;
+
+		const uint16_t Class = static_cast<uint16_t>(Classes.Representative.size());
+		Classes.Representative.push_back(static_cast<uint32_t>(Coordinate));
+		uint16_t& Stabilizer = Classes.Stabilizer.emplace_back(0);
+
+		FCubieCube Cube = FCubieCube::Solved();
+		Set(Cube, static_cast<uint32_t>(Coordinate));
+		for (int32_t Symmetry = 0; Symmetry < CubeUDSymmetryCount; ++Symmetry)
+		{
+			const uint32_t Other = Get(ConjugateCube(Cube, Symmetries.Cubes[Symmetry]));
+			if (Other == static_cast<uint32_t>(Coordinate))
+			{
+				Stabilizer |= 1u << Symmetry;
+			}
+			if (Classes.Class[Other] == UnknownClass)
+			{
+				Classes.Class[Other] = Class;
+				Classes.Symmetry[Other] = Symmetries.Inverse[Symmetry];
+			}
+		}
+	}
+	return Classes;
+}
+
+static FCubeTwoPhaseTables BuildTables()
+{
+	FCubieCube Moves[CubeMoveCount];
+	for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+	{
+		Moves[Move] = FCubieCube::FromMove(static_cast<ECubeMove>(Move));
+	}
+
+	FCubeTwoPhaseTables Tables;
+	Tables.Twist = BuildMoveTable(CornerTwistCount, Moves, GetCornerTwist, SetCornerTwist);
+	Tables.Flip = BuildMoveTable(EdgeFlipCount, Moves, GetEdgeFlip, SetEdgeFlip);
+	Tables.UDSliceSorted = BuildMoveTable(UDSliceSortedCount, Moves, GetUDSliceSorted, SetUDSliceSorted);
+	Tables.CornerPermutation = BuildMoveTable(CornerPermutationCount, Moves, GetCornerPermutation, SetCornerPermutation);
+
+	Tables.UDSlice.resize(UDSliceCount * CubeMoveCount);
+	for (int32_t Slice = 0; Slice < UDSliceCount; ++Slice)
+	{
+		for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+		{
+			Tables.UDSlice[Slice * CubeMoveCount + Move] = Tables.UDSliceSorted[Slice * 24 * CubeMoveCount + Move] / 24;
+		}
+	}
+
+	Tables.UDEdgePermutation.resize(UDEdgePermutationCount * CubePhase2MoveCount);
+	for (int32_t Permutation = 0; Permutation < UDEdgePermutationCount; ++Permutation)
+	{
+		FCubieCube Cube = FCubieCube::Solved();
+		SetUDEdgePermutation(Cube, static_cast<uint16_t>(Permutation));
+		for (int32_t Index = 0; Index < CubePhase2MoveCount; ++Index)
+		{
+			const FCubieCube Moved = FCubieCube::Multiply(Cube, Moves[static_cast<int32_t>(CubePhase2Moves[Index])]);
+			Tables.UDEdgePermutation[Permutation * CubePhase2MoveCount + Index] = GetUDEdgePermutation(Moved);
+		}
+	}
+
+	Tables.TwistConjugate = BuildConjugateTable(CornerTwistCount, GetCornerTwist, SetCornerTwist);
+	Tables.UDEdgeConjugate = BuildConjugateTable(UDEdgePermutationCount, GetUDEdgePermutation, SetUDEdgePermutation);
+
+	Tables.FlipSlice = BuildSymmetryClasses(UDSliceCount * EdgeFlipCount,
+		[](const FCubieCube& Cube) { return static_cast<uint32_t>(GetUDSliceSorted(Cube) / 24 * EdgeFlipCount + GetEdgeFlip(Cube)); },
+		[](FCubieCube& Cube, uint32_t FlipSlice)
+		{
+			SetUDSliceSorted(Cube, static_cast<uint16_t>(FlipSlice / EdgeFlipCount * 24));
+			SetEdgeFlip(Cube, static_cast<uint16_t>(FlipSlice % EdgeFlipCount));
+		});
+	Tables.Corners = BuildSymmetryClasses(CornerPermutationCount,
+		[](const FCubieCube& Cube) { return static_cast<uint32_t>(GetCornerPermutation(Cube)); },
+		[](FCubieCube& Cube, uint32_t Permutation) { SetCornerPermutation(Cube, static_cast<uint16_t>(Permutation)); });
+
+	const auto GetCornerSliceNeighbor = [&Tables](uint32_t Index, int32_t Phase2Move) -> uint32_t
+	{
+		const int32_t Move = static_cast<int32_t>(CubePhase2Moves[Phase2Move]);
+		return Tables.CornerPermutation[Index / 24 * CubeMoveCount + Move] * 24u + Tables.UDSliceSorted[Index % 24 * CubeMoveCount + Move];
+	};
+	Tables.CornerSliceDistance = GenerateDistanceTable(static_cast<uint64_t>(CornerPermutationCount) * 24, 0, CubePhase2MoveCount, 1,
+	                                                   GetCornerSliceNeighbor);
+	return Tables;
+}
+
+/** Loads a pruning table with distances modulo 3, when missing it is generated from exact distances and saved */
+template <typename TGetNeighbor, typename TForEachEquivalent>
+static bool LoadOrGenerate(FCubeTableFile& Table, const std::string& Path, uint32_t Kind, uint64_t EntryCount, uint32_t SolvedIndex,
+                           int32_t MoveCount, int32_t ThreadCount, const TGetNeighbor& GetNeighbor, const TForEachEquivalent& ForEachEquivalent,
+                           std::string& OutError)
+{
+	const size_t Size = static_cast<size_t>((EntryCount + 3) / 4);
+	std::string LoadError;
+	if (Table.Load(Path, Kind, EntryCount, Size, LoadError))
+	{
+		return true;
+	}
+
+	const std::vector<uint8_t> Distances = GenerateDistanceTable(EntryCount, SolvedIndex, MoveCount, ThreadCount, GetNeighbor, {},
+	                                                             ForEachEquivalent);
+
+	// Neighbours differ by at most one move, so distance modulo 3 tells whether a move goes closer
+	std::vector<uint8_t> Packed(Size);
+	for (uint64_t Index = 0; Index < EntryCount; ++Index)
+	{
+		Packed[Index >> 2] |= static_cast<uint8_t>(GetPackedDistance(Distances.data(), Index) % 3 << ((Index & 3) * 2));
+	}
+	Table.Assign(std::move(Packed));
+	return Table.Save(Path, Kind, EntryCount, OutError) && Table.Load(Path, Kind, EntryCount, Size, OutError);
+}
+
+/**
+ * Representatives symmetric to themselves stand for the same state with several conjugated values of the other coordinate,
+ * pruning table entries are Class * OtherCount + Other
+ */
+static auto MakeForEachEquivalent(const FCubeSymmetryClasses& Classes, const std::vector<uint16_t>& OtherConjugate, uint32_t OtherCount)
+{
+	return [&Classes, &OtherConjugate, OtherCount](uint32_t Index, const auto& Visit)
+	{
+		const uint32_t Class = Index / OtherCount;
+		const uint32_t Other = Index % OtherCount;
+		for (uint32_t Stabilizer = Classes.Stabilizer[Class] & ~1u; Stabilizer != 0; Stabilizer &= Stabilizer - 1)
+		{
+			const uint32_t Symmetry = static_cast<uint32_t>(std::countr_zero(Stabilizer));
+			const uint32_t Equivalent = Class * OtherCount + OtherConjugate[Other * CubeUDSymmetryCount + Symmetry];
+			if (Equivalent != Index) Visit(Equivalent);
+		}
+	};
+}
+
+/** Faces are skipped after themselves and after their opposite face with higher index, as U D equals D U */
+static bool IsRedundantFace(int32_t Face, int32_t LastFace)
+{
+	return Face == LastFace || Face + 3 == LastFace;
+}
+
+static bool IsPhase2Move(ECubeMove Move)
+{
+	return std::find(std::begin(CubePhase2Moves), std::end(CubePhase2Moves), Move) != std::end(CubePhase2Moves);
+}
+}
+
+using namespace CubeTwoPhaseSolverImpl;
+
+const FCubeTwoPhaseTables& FCubeTwoPhaseTables::Get()
+{
+	static const FCubeTwoPhaseTables Tables = BuildTables();
+	return Tables;
+}
+
+struct FCubeTwoPhaseSolver::FSearchContext
+{
+	const FCubeTwoPhaseOptions& Options;
+	const FSearchDirection* Direction = nullptr;
+	FClock::time_point Start;
+	int32_t Phase1Bound = 0;
+	int32_t Phase1Length = 0;
+	/** Length of the best solution so far, solutions have to be shorter */
+	int32_t BestLength = 0;
+	bool bStop = false;
+	FCubeTwoPhaseStats Stats;
+	ECubeMove Path[MaxSearchLength];
+	std::vector<ECubeMove> Best;
+
+	explicit FSearchContext(const FCubeTwoPhaseOptions& InOptions)
+		: Options(InOptions)
+		, Start(FClock::now())
+	{
+	}
+
+	/** Keeps Path as the best solution, turned back from the searched direction to the original state */
+	void SetBest(int32_t Length)
+	{
+		const FCubeSymmetryTables& Symmetries = FCubeSymmetryTables::Get();
+		const uint8_t Inverse = Symmetries.Inverse[Direction->Symmetry];
+		BestLength = Length;
+		Best.resize(Length);
+		for (int32_t Index = 0; Index < Length; ++Index)
+		{
+			const ECubeMove Move = Symmetries.Moves[Inverse][static_cast<int32_t>(Path[Index])];
+			// Solution of the inverse solves the state when reversed and inverted
+			Best[Direction->bInverse ? Length - 1 - Index : Index] = Direction->bInverse ? InverseMove(Move) : Move;
+		}
+	}
+
+	/** Counts a node and returns true when the search has to stop */
+	bool CountNode()
+	{
+		if ((++Stats.Nodes & DeadlineCheckMask) == 0 &&
+			(FClock::now() >= Options.Deadline || (Options.Cancel != nullptr && Options.Cancel->load(std::memory_order_relaxed))))
+		{
+			bStop = true;
+		}
+		return bStop;
+	}
+};
+
+FCubeTwoPhaseSolver::FCubeTwoPhaseSolver()
+	: Tables(FCubeTwoPhaseTables::Get())
+{
+}
+
+bool FCubeTwoPhaseSolver::Initialize(const std::string& Directory, int32_t ThreadCount, std::string& OutError)
+{
+	const std::string Prefix = Directory.empty() || Directory.back() == '/' ? Directory : Directory + '/';
+
+	const auto GetPhase1Neighbor = [this](uint32_t Index, int32_t Move) -> uint32_t
+	{
+		const uint32_t FlipSlice = Tables.FlipSlice.Representative[Index / CornerTwistCount];
+		const uint32_t Twist = Index % CornerTwistCount;
+		return Tables.GetPhase1Index(Tables.Flip[FlipSlice % EdgeFlipCount * CubeMoveCount + Move],
+		                             Tables.UDSlice[FlipSlice / EdgeFlipCount * CubeMoveCount + Move],
+		                             Tables.Twist[Twist * CubeMoveCount + Move]);
+	};
+	const auto GetPhase2Neighbor = [this](uint32_t Index, int32_t Phase2Move) -> uint32_t
+	{
+		const uint32_t Corners = Tables.Corners.Representative[Index / UDEdgePermutationCount];
+		const uint32_t Edges = Index % UDEdgePermutationCount;
+		return Tables.GetPhase2Index(Tables.CornerPermutation[Corners * CubeMoveCount + static_cast<int32_t>(CubePhase2Moves[Phase2Move])],
+		                             Tables.UDEdgePermutation[Edges * CubePhase2MoveCount + Phase2Move]);
+	};
+
+	return LoadOrGenerate(Phase1, Prefix + Phase1FileName, Phase1TableKind,
+	                      static_cast<uint64_t>(Tables.FlipSlice.GetClassCount()) * CornerTwistCount, Tables.GetPhase1Index(0, 0, 0),
+	                      CubeMoveCount, ThreadCount, GetPhase1Neighbor,
+	                      MakeForEachEquivalent(Tables.FlipSlice, Tables.TwistConjugate, CornerTwistCount), OutError) &&
+		LoadOrGenerate(Phase2, Prefix + Phase2FileName, Phase2TableKind,
+		               static_cast<uint64_t>(Tables.Corners.GetClassCount()) * UDEdgePermutationCount, Tables.GetPhase2Index(0, 0),
+		               CubePhase2MoveCount, ThreadCount, GetPhase2Neighbor,
+		               MakeForEachEquivalent(Tables.Corners, Tables.UDEdgeConjugate, UDEdgePermutationCount), OutError);
+}
+
+int32_t FCubeTwoPhaseSolver::GetPhase1Distance(const FCubeState& State) const
+{
+	const FCubieCube Cube = State.ToCubie();
+	return GetPhase1Distance(GetEdgeFlip(Cube), static_cast<uint16_t>(GetUDSliceSorted(Cube) / 24), GetCornerTwist(Cube));
+}
+
+int32_t FCubeTwoPhaseSolver::GetPhase1Distance(uint16_t Flip, uint16_t Slice, uint16_t Twist) const
+{
+	int32_t Distance = 0;
+	uint32_t Modulo = GetModulo3(Phase1, Tables.GetPhase1Index(Flip, Slice, Twist));
+	while (Flip != 0 || Slice != 0 || Twist != 0)
+	{
+		const uint32_t Closer = (Modulo + 2) % 3;
+		for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+		{
+			const uint16_t NextFlip = Tables.Flip[Flip * CubeMoveCount + Move];
+			const uint16_t NextSlice = Tables.UDSlice[Slice * CubeMoveCount + Move];
+			const uint16_t NextTwist = Tables.Twist[Twist * CubeMoveCount + Move];
+			if (GetModulo3(Phase1, Tables.GetPhase1Index(NextFlip, NextSlice, NextTwist)) == Closer)
+			{
+				Flip = NextFlip;
+				Slice = NextSlice;
+				Twist = NextTwist;
+				break;
+			}
+		}
+		Modulo = Closer;
+		++Distance;
+	}
+	return Distance;
+}
+
+int32_t FCubeTwoPhaseSolver::GetPhase2Distance(uint16_t Corners, uint16_t Edges) const
+{
+	int32_t Distance = 0;
+	uint32_t Modulo = GetModulo3(Phase2, Tables.GetPhase2Index(Corners, Edges));
+	while (Corners != 0 || Edges != 0)
+	{
+		const uint32_t Closer = (Modulo + 2) % 3;
+		for (int32_t Index = 0; Index < CubePhase2MoveCount; ++Index)
+		{
+			const uint16_t NextCorners = Tables.CornerPermutation[Corners * CubeMoveCount + static_cast<int32_t>(CubePhase2Moves[Index])];
+			const uint16_t NextEdges = Tables.UDEdgePermutation[Edges * CubePhase2MoveCount + Index];
+			if (GetModulo3(Phase2, Tables.GetPhase2Index(NextCorners, NextEdges)) == Closer)
+			{
+				Corners = NextCorners;
+				Edges = NextEdges;
+				break;
+			}
+		}
+		Modulo = Closer;
+		++Distance;
+	}
+	return Distance;
+}
+
+bool FCubeTwoPhaseSolver::SearchPhase1(FSearchContext& Context, uint16_t Flip, uint16_t Slice, uint16_t Twist, int32_t Distance,
+                                       int32_t Depth, int32_t LastFace) const
+{
+	const int32_t Remaining = Context.Phase1Bound - Depth;
+	if (Remaining == 0)
+	{
+		// Phase 1 ending with a phase 2 move reached the subgroup one move earlier and was completed then
+		if (Depth > 0 && IsPhase2Move(Context.Path[Depth - 1])) return false;
+		return SolvePhase2(Context, Depth);
+	}
+
+	for (int32_t Move = 0; Move < CubeMoveCount; ++Move)
+	{
+		const int32_t Face = Move / 3;
+		if (IsRedundantFace(Face, LastFace)) continue;
+		if (Context.CountNode()) return true;
+
+		const uint16_t NextFlip = Tables.Flip[Flip * CubeMoveCount + Move];
+		const uint16_t NextSlice = Tables.UDSlice[Slice * CubeMoveCount + Move];
+		const uint16_t NextTwist = Tables.Twist[Twist * CubeMoveCount + Move];
+		const uint32_t Modulo = GetModulo3(Phase1, Tables.GetPhase1Index(NextFlip, NextSlice, NextTwist));
+		const int32_t NextDistance = Distance + DistanceChange[(Modulo + 3 - Distance % 3) % 3];
+		if (NextDistance >= Remaining) continue;
+
+		Context.Path[Depth] = static_cast<ECubeMove>(Move);
+		if (SearchPhase1(Context, NextFlip, NextSlice, NextTwist, NextDistance, Depth + 1, Face))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FCubeTwoPhaseSolver::SolvePhase2(FSearchContext& Context, int32_t Phase1Length) const
+{
+	const int32_t Limit = Context.BestLength - 1 - Phase1Length;
+	if (Limit < 0) return false;
+
+	FCubeState State = Context.Direction->Root;
+	for (int32_t Index = 0; Index < Phase1Length; ++Index)
+	{
+		State = State.Apply(Context.Path[Index]);
+	}
+	const FCubieCube Cube = State.ToCubie();
+	const uint16_t Corners = GetCornerPermutation(Cube);
+	const uint16_t Edges = GetUDEdgePermutation(Cube);
+	const uint16_t Slice = GetUDSliceSorted(Cube);
+	if (GetPackedDistance(Tables.CornerSliceDistance.data(), Corners * 24u + Slice) > Limit) return false;
+
+	const int32_t Distance = GetPhase2Distance(Corners, Edges);
+	const int32_t LastFace = Phase1Length > 0 ? static_cast<int32_t>(GetMoveFace(Context.Path[Phase1Length - 1])) : -1;
+	Context.Phase1Length = Phase1Length;
+	for (int32_t Bound = Distance; Bound <= Limit; ++Bound)
+	{
+		if (SearchPhase2(Context, Corners, Edges, Slice, Distance, 0, Bound, LastFace))
+		{
+			Context.SetBest(Phase1Length + Bound);
+			if (Context.Stats.SolutionCount++ == 0)
+			{
+				Context.Stats.FirstSolutionSeconds = std::chrono::duration<double>(FClock::now() - Context.Start).count();
+			}
+			if (Context.Options.OnSolution) Context.Options.OnSolution(Context.Best);
+			Context.bStop |= Context.BestLength <= Context.Options.TargetLength;
+			break;
+		}
+		if (Context.bStop) break;
+	}
+	return Context.bStop;
+}
+
+bool FCubeTwoPhaseSolver::SearchPhase2(FSearchContext& Context, uint16_t Corners, uint16_t Edges, uint16_t Slice, int32_t Distance,
+                                       int32_t Depth, int32_t Bound, int32_t LastFace) const
+{
+	if (Depth == Bound)
+	{
+		return Distance == 0 && Slice == 0;
+	}
+
+	const int32_t Remaining = Bound - Depth;
+	for (int32_t Index = 0; Index < CubePhase2MoveCount; ++Index)
+	{
+		const ECubeMove Move = CubePhase2Moves[Index];
+		const int32_t Face = static_cast<int32_t>(GetMoveFace(Move));
+		if (IsRedundantFace(Face, LastFace)) continue;
+		if (Context.CountNode()) return false;
+
+		const uint16_t NextCorners = Tables.CornerPermutation[Corners * CubeMoveCount + static_cast<int32_t>(Move)];
+		const uint16_t NextEdges = Tables.UDEdgePermutation[Edges * CubePhase2MoveCount + Index];
+		const uint16_t NextSlice = Tables.UDSliceSorted[Slice * CubeMoveCount + static_cast<int32_t>(Move)];
+		const uint32_t Modulo = GetModulo3(Phase2, Tables.GetPhase2Index(NextCorners, NextEdges));
+		const int32_t NextDistance = Distance + DistanceChange[(Modulo + 3 - Distance % 3) % 3];
+		if (NextDistance >= Remaining || GetPackedDistance(Tables.CornerSliceDistance.data(), NextCorners * 24u + NextSlice) >= Remaining)
+		{
+			continue;
+		}
+
+		Context.Path[Context.Phase1Length + Depth] = Move;
+		if (SearchPhase2(Context, NextCorners, NextEdges, NextSlice, NextDistance, Depth + 1, Bound, Face))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FCubeTwoPhaseSolver::Solve(const FCubeState& State, std::vector<ECubeMove>& OutMoves, const FCubeTwoPhaseOptions& Options,
+                                FCubeTwoPhaseStats* OutStats) const
+{
+	FSearchContext Context(Options);
+	Context.BestLength = std::min(Options.MaxLength, MaxSearchLength) + 1;
+
+	// Symmetries 16 and 32 turn the cube around the URF-DBL diagonal, so the UD axis of the search becomes RL and FB
+	const FCubeSymmetryTables& Symmetries = FCubeSymmetryTables::Get();
+	const FCubieCube Cube = State.ToCubie();
+	const FCubieCube Inverse = FCubieCube::Inverse(Cube);
+	FSearchDirection Directions[DirectionCount];
+	int32_t MinDistance = MaxSearchLength;
+	for (int32_t Index = 0; Index < DirectionCount; ++Index)
+	{
+		FSearchDirection& Direction = Directions[Index];
+		Direction.Symmetry = static_cast<uint8_t>(Index / 2 * CubeUDSymmetryCount);
+		Direction.bInverse = Index % 2 == 1;
+
+		const FCubieCube Conjugated = ConjugateCube(Direction.bInverse ? Inverse : Cube, Symmetries.Cubes[Direction.Symmetry]);
+		Direction.Root = FCubeState::FromCubie(Conjugated);
+		Direction.Flip = GetEdgeFlip(Conjugated);
+		Direction.Slice = static_cast<uint16_t>(GetUDSliceSorted(Conjugated) / 24);
+		Direction.Twist = GetCornerTwist(Conjugated);
+		Direction.Distance = GetPhase1Distance(Direction.Flip, Direction.Slice, Direction.Twist);
+		MinDistance = std::min(MinDistance, Direction.Distance);
+	}
+
+	for (Context.Phase1Bound = MinDistance; Context.Phase1Bound < Context.BestLength && !Context.bStop; ++Context.Phase1Bound)
+	{
+		for (const FSearchDirection& Direction : Directions)
+		{
+			if (Direction.Distance > Context.Phase1Bound || Context.bStop) continue;
+			Context.Direction = &Direction;
+			SearchPhase1(Context, Direction.Flip, Direction.Slice, Direction.Twist, Direction.Distance, 0, -1);
+		}
+	}
+
+	OutMoves = Context.Best;
+	if (OutStats)
+	{
+		*OutStats = Context.Stats;
+		OutStats->Seconds = std::chrono::duration<double>(FClock::now() - Context.Start).count();
+	}
+	return Context.Stats.SolutionCount > 0;
+}
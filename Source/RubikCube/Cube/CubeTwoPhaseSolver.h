@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CubeCoordinates.h"
+#include "CubeSymmetry.h"
+#include "CubeTableFile.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+/** Face turns allowed in phase 2, they keep twist, flip and UD slice solved */
+constexpr int32_t CubePhase2MoveCount = 10;
+constexpr ECubeMove CubePhase2Moves[CubePhase2MoveCount] = {
+	ECubeMove::U, ECubeMove::U2, ECubeMove::U3, ECubeMove::R2, ECubeMove::F2,
+	ECubeMove::D, ECubeMove::D2, ECubeMove::D3, ECubeMove::L2, ECubeMove::B2
+};
+
+/** Classes of a coordinate under the 16 UD symmetries */
+struct FCubeSymmetryClasses
+{
+	/** Class of every coordinate */
+	std::vector<uint16_t> Class;
+	/** Symmetry S for which S^-1 * Cube * S has the representative coordinate */
+	std::vector<uint8_t> Symmetry;
+	std::vector<uint32_t> Representative;
+	/** Symmetries mapping the representative of a class to itself, bit per symmetry, bit 0 is always set */
+	std::vector<uint16_t> Stabilizer;
+
+	uint32_t GetClassCount() const { return static_cast<uint32_t>(Representative.size()); }
+};
+
+/**
+ * Move, symmetry and small pruning tables of the two-phase solver, about 8 MB, built on first use.
+ * Flip slice coordinate is UDSlice * EdgeFlipCount + Flip.
+ */
+struct FCubeTwoPhaseTables
+{
+	/** [Coordinate * CubeMoveCount + Move] */
+	std::vector<uint16_t> Twist;
+	std::vector<uint16_t> Flip;
+	std::vector<uint16_t> UDSlice;
+	std::vector<uint16_t> UDSliceSorted;
+	std::vector<uint16_t> CornerPermutation;
+	/** [Permutation * CubePhase2MoveCount + index into CubePhase2Moves] */
+	std::vector<uint16_t> UDEdgePermutation;
+
+	/** Coordinate of S^-1 * Cube * S, [Coordinate * CubeUDSymmetryCount + Symmetry] */
+	std::vector<uint16_t> TwistConjugate;
+	std::vector<uint16_t> UDEdgeConjugate;
+
+	FCubeSymmetryClasses FlipSlice;
+	FCubeSymmetryClasses Corners;
+
+	/** Exact phase 2 distance of [CornerPermutation * 24 + SlicePermutation], 4 bits each */
+	std::vector<uint8_t> CornerSliceDistance;
+
+	static const FCubeTwoPhaseTables& Get();
+
+	/** Entry of the phase 1 pruning table, flip slice class times CornerTwistCount plus the conjugated twist */
+	uint32_t GetPhase1Index(uint16_t InFlip, uint16_t InUDSlice, uint16_t InTwist) const
+	{
+		const uint32_t Coordinate = static_cast<uint32_t>(InUDSlice) * EdgeFlipCount + InFlip;
+		return static_cast<uint32_t>(FlipSlice.Class[Coordinate]) * CornerTwistCount +
+			TwistConjugate[InTwist * CubeUDSymmetryCount + FlipSlice.Symmetry[Coordinate]];
+	}
+
+	/** Entry of the phase 2 pruning table, corner permutation class times UDEdgePermutationCount plus the conjugated edges */
+	uint32_t GetPhase2Index(uint16_t InCornerPermutation, uint16_t InUDEdgePermutation) const
+	{
+		return static_cast<uint32_t>(Corners.Class[InCornerPermutation]) * UDEdgePermutationCount +
+			UDEdgeConjugate[InUDEdgePermutation * CubeUDSymmetryCount + Corners.Symmetry[InCornerPermutation]];
+	}
+};
+
+struct FCubeTwoPhaseOptions
+{
+	/** Search gives up improving the solution at this time */
+	std::chrono::steady_clock::time_point Deadline = std::chrono::steady_clock::time_point::max();
+	/** Search stops at the first solution of at most this many moves */
+	int32_t TargetLength = 0;
+	/** Longest solution accepted */
+	int32_t MaxLength = 30;
+	/** Search stops as soon as it sees this set, may be set from another thread */
+	const std::atomic<bool>* Cancel = nullptr;
+	/** Called for every solution shorter than all found before */
+	std::function<void(const std::vector<ECubeMove>& Moves)> OnSolution;
+};
+
+struct FCubeTwoPhaseStats
+{
+	uint64_t Nodes = 0;
+	int32_t SolutionCount = 0;
+	double FirstSolutionSeconds = 0.0;
+	double Seconds = 0.0;
+};
+
+/**
+ * Kociemba's two-phase solver. Phase 1 brings the cube into the subgroup <U, D, R2, F2, L2, B2> where twist, flip and
+ * UD slice are solved, phase 2 solves it inside the subgroup. Phase 1 is searched with growing depth and every
+ * phase 1 solution is completed by the shortest phase 2 that beats the best solution so far,
+ * so solutions get shorter the longer the search runs. Every depth is searched in six directions, the state and
+ * its inverse seen along each of the three axes, as some of them usually reach the subgroup much sooner.
+ *
+ * Pruning tables hold distance modulo 3 in 2 bits per entry and are reduced by the 16 symmetries keeping the UD axis:
+ * phase 1 for every flip slice class and twist, phase 2 for every corner permutation class and UD edge permutation.
+ * Exact distances are recovered along the search path.
+ */
+class FCubeTwoPhaseSolver
+{
+public:
+	static constexpr int32_t MaxSearchLength = 30;
+	static constexpr const char* Phase1FileName = "TwoPhase1.pdb";
+	static constexpr const char* Phase2FileName = "TwoPhase2.pdb";
+
+	FCubeTwoPhaseSolver();
+
+	/** Loads pruning tables from Directory, missing ones are generated with ThreadCount threads and saved there */
+	bool Initialize(const std::string& Directory, int32_t ThreadCount, std::string& OutError);
+
+	bool IsReady() const { return Phase1.IsValid() && Phase2.IsValid(); }
+
+	/**
+	 * Searches until a solution of at most Options.TargetLength moves is found, Options.Deadline passes or Options.Cancel is set.
+	 * OutMoves is the shortest solution found. Returns false when no solution was found in time.
+	 */
+	bool Solve(const FCubeState& State, std::vector<ECubeMove>& OutMoves, const FCubeTwoPhaseOptions& Options = {},
+	           FCubeTwoPhaseStats* OutStats = nullptr) const;
+
+	/** Moves needed to reach the phase 2 subgroup */
+	int32_t GetPhase1Distance(const FCubeState& State) const;
+
+private:
+	static constexpr int32_t DirectionCount = 6;
+
+	/** State conjugated by Symmetry, or its inverse, searched as if it was the scrambled state */
+	struct FSearchDirection
+	{
+		FCubeState Root;
+		uint16_t Flip = 0;
+		uint16_t Slice = 0;
+		uint16_t Twist = 0;
+		int32_t Distance = 0;
+		uint8_t Symmetry = 0;
+		bool bInverse = false;
+	};
+
+	struct FSearchContext;
+
+	static uint32_t GetModulo3(const FCubeTableFile& Table, uint32_t Index)
+	{
+		return Table.GetData()[Index >> 2] >> ((Index & 3) * 2) & 3;
+	}
+
+	/** Exact distance of the subgroup, walks to it by moves going one closer */
+	int32_t GetPhase1Distance(uint16_t Flip, uint16_t Slice, uint16_t Twist) const;
+	/** Exact phase 2 distance ignoring the order of slice edges */
+	int32_t GetPhase2Distance(uint16_t Corners, uint16_t Edges) const;
+
+	bool SearchPhase1(FSearchContext& Context, uint16_t Flip, uint16_t Slice, uint16_t Twist, int32_t Distance, int32_t Depth,
+	                  int32_t LastFace) const;
+	/** Completes the phase 1 path in Context, returns true when the search has to stop */
+	bool SolvePhase2(FSearchContext& Context, int32_t Phase1Length) const;
+	bool SearchPhase2(FSearchContext& Context, uint16_t Corners, uint16_t Edges, uint16_t Slice, int32_t Distance, int32_t Depth,
+	                  int32_t Bound, int32_t LastFace) const;
+
+	const FCubeTwoPhaseTables& Tables;
+	FCubeTableFile Phase1;
+	FCubeTableFile Phase2;
+};
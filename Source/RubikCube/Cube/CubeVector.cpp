@@ -0,0 +1,261 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeVector.h"
+#include "CubeSimd.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if CUBE_VECTOR_X86
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+namespace CubeVectorImpl
+{
+/**
+ * Byte i of the result is byte Shuffle[i] of the same 16 byte half plus Twist[i].
+ * Orientation sums reaching Wrap are reduced by Wrap: unsigned min of sum and sum - Wrap
+ * keeps the sum whenever the subtraction underflows.
+ */
+struct alignas(32) FVectorMove
+{
+	uint8_t Shuffle[32];
+	uint8_t Twist[32];
+};
+
+struct alignas(32) FVectorMoveTables
+{
+	FVectorMove Moves[CubeMoveCount];
+	uint8_t Wrap[32];
+};
+
+static constexpr FVectorMoveTables BuildVectorMoveTables()
+{
+	FVectorMoveTables Tables{};
+	for (int32_t Index = 0; Index < 16; ++Index)
+	{
+		Tables.Wrap[Index] = Index < CubeCornerCount ? 3 << 4 : 0;
+		Tables.Wrap[FCubeVector::EdgeOffset + Index] = Index < CubeEdgeCount ? 2 << 4 : 0;
+	}
+
+	for (int32_t MoveIndex = 0; MoveIndex < CubeMoveCount; ++MoveIndex)
+	{
+		const FCubieCube Cube = FCubieCube::FromMove(static_cast<ECubeMove>(MoveIndex));
+		FVectorMove& Move = Tables.Moves[MoveIndex];
+		for (int32_t Index = 0; Index < 16; ++Index)
+		{
+			const bool bCorner = Index < CubeCornerCount;
+			const bool bEdge = Index < CubeEdgeCount;
+			Move.Shuffle[Index] = static_cast<uint8_t>(bCorner ? Cube.Cp[Index] : Index);
+			Move.Twist[Index] = static_cast<uint8_t>(bCorner ? Cube.Co[Index] << 4 : 0);
+			Move.Shuffle[FCubeVector::EdgeOffset + Index] = static_cast<uint8_t>(bEdge ? Cube.Ep[Index] : Index);
+			Move.Twist[FCubeVector::EdgeOffset + Index] = static_cast<uint8_t>(bEdge ? Cube.Eo[Index] << 4 : 0);
+		}
+	}
+	return Tables;
+}
+
+static constexpr FVectorMoveTables VectorMoveTables = BuildVectorMoveTables();
+
+static void ApplyMovesScalar(FCubeVector& State, const ECubeMove* Moves, size_t Count)
+{
+	// Same tables as the vector paths, but only the bytes holding cubies are visited, padding stays zero
+	const auto ApplyRange = [](const FCubeVector& From, FCubeVector& To, const FVectorMove& Move, int32_t Begin, int32_t End)
+	{
+		for (int32_t Index = Begin; Index < End; ++Index)
+		{
+			const uint8_t Sum = static_cast<uint8_t>(From.Bytes[(Index & 16) | Move.Shuffle[Index]] + Move.Twist[Index]);
+			To.Bytes[Index] = std::min<uint8_t>(Sum, static_cast<uint8_t>(Sum - VectorMoveTables.Wrap[Index]));
+		}
+	};
+
+	for (size_t MoveIndex = 0; MoveIndex < Count; ++MoveIndex)
+	{
+		const FVectorMove& Move = VectorMoveTables.Moves[static_cast<uint8_t>(Moves[MoveIndex])];
+		FCubeVector Result = State;
+		ApplyRange(State, Result, Move, 0, CubeCornerCount);
+		ApplyRange(State, Result, Move, FCubeVector::EdgeOffset, FCubeVector::EdgeOffset + CubeEdgeCount);
+		State = Result;
+	}
+}
+
+#if CUBE_VECTOR_X86
+CUBE_VECTOR_TARGET("ssse3")
+static void ApplyMovesSSSE3(FCubeVector& State, const ECubeMove* Moves, size_t Count)
+{
+	__m128i Corners = _mm_load_si128(reinterpret_cast<const __m128i*>(State.Bytes));
+	__m128i Edges = _mm_load_si128(reinterpret_cast<const __m128i*>(State.Bytes + FCubeVector::EdgeOffset));
+	const __m128i CornerWrap = _mm_load_si128(reinterpret_cast<const __m128i*>(VectorMoveTables.Wrap));
+	const __m128i EdgeWrap = _mm_load_si128(reinterpret_cast<const __m128i*>(VectorMoveTables.Wrap + FCubeVector::EdgeOffset));
+
+	for (size_t MoveIndex = 0; MoveIndex < Count; ++MoveIndex)
+	{
+		const FVectorMove& Move = VectorMoveTables.Moves[static_cast<uint8_t>(Moves[MoveIndex])];
+		Corners = _mm_shuffle_epi8(Corners, _mm_load_si128(reinterpret_cast<const __m128i*>(Move.Shuffle)));
+		Corners = _mm_add_epi8(Corners, _mm_load_si128(reinterpret_cast<const __m128i*>(Move.Twist)));
+		Corners = _mm_min_epu8(Corners, _mm_sub_epi8(Corners, CornerWrap));
+
+		Edges = _mm_shuffle_epi8(Edges, _mm_load_si128(reinterpret_cast<const __m128i*>(Move.Shuffle + FCubeVector::EdgeOffset)));
+		Edges = _mm_add_epi8(Edges, _mm_load_si128(reinterpret_cast<const __m128i*>(Move.Twist + FCubeVector::EdgeOffset)));
+		Edges = _mm_min_epu8(Edges, _mm_sub_epi8(Edges, EdgeWrap));
+	}
+
+	_mm_store_si128(reinterpret_cast<__m128i*>(State.Bytes), Corners);
+	_mm_store_si128(reinterpret_cast<__m128i*>(State.Bytes + FCubeVector::EdgeOffset), Edges);
+}
+
+CUBE_VECTOR_TARGET("avx2")
+static void ApplyMovesAVX2(FCubeVector& State, const ECubeMove* Moves, size_t Count)
+{
+	// vpshufb shuffles within 128 bit lanes, which is exactly the corner and edge split
+	__m256i Value = _mm256_load_si256(reinterpret_cast<const __m256i*>(State.Bytes));
+	const __m256i Wrap = _mm256_load_si256(reinterpret_cast<const __m256i*>(VectorMoveTables.Wrap));
+
+	for (size_t MoveIndex = 0; MoveIndex < Count; ++MoveIndex)
+	{
+		const FVectorMove& Move = VectorMoveTables.Moves[static_cast<uint8_t>(Moves[MoveIndex])];
+		Value = _mm256_shuffle_epi8(Value, _mm256_load_si256(reinterpret_cast<const __m256i*>(Move.Shuffle)));
+		Value = _mm256_add_epi8(Value, _mm256_load_si256(reinterpret_cast<const __m256i*>(Move.Twist)));
+		Value = _mm256_min_epu8(Value, _mm256_sub_epi8(Value, Wrap));
+	}
+
+	_mm256_store_si256(reinterpret_cast<__m256i*>(State.Bytes), Value);
+}
+
+static void GetCpuId(uint32_t Leaf, uint32_t SubLeaf, uint32_t (&OutRegisters)[4])
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int Registers[4];
+	__cpuidex(Registers, static_cast<int>(Leaf), static_cast<int>(SubLeaf));
+	for (int32_t Index = 0; Index < 4; ++Index) OutRegisters[Index] = static_cast<uint32_t>(Registers[Index]);
+#else
+	__cpuid_count(Leaf, SubLeaf, OutRegisters[0], OutRegisters[1], OutRegisters[2], OutRegisters[3]);
+#endif
+}
+
+static uint64_t GetEnabledXStateFeatures()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	return _xgetbv(0);
+#else
+	uint32_t Low = 0;
+	uint32_t High = 0;
+	__asm__ volatile("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+	return static_cast<uint64_t>(High) << 32 | Low;
+#endif
+}
+
+static ECubeSimdLevel DetectSimdLevel()
+{
+	uint32_t Registers[4];
+	GetCpuId(0, 0, Registers);
+	const uint32_t MaxLeaf = Registers[0];
+
+	GetCpuId(1, 0, Registers);
+	const bool bSSSE3 = (Registers[2] & (1u << 9)) != 0;
+	const bool bOSXSave = (Registers[2] & (1u << 27)) != 0;
+	if (!bSSSE3) return ECubeSimdLevel::Scalar;
+
+	// AVX registers are usable only when the OS saves them on context switch
+	if (MaxLeaf >= 7 && bOSXSave && (GetEnabledXStateFeatures() & 6) == 6)
+	{
+		GetCpuId(7, 0, Registers);
+		if (Registers[1] & (1u << 5)) return ECubeSimdLevel::AVX2;
+	}
+	return ECubeSimdLevel::SSSE3;
+}
+#else
+static ECubeSimdLevel DetectSimdLevel()
+{
+	return ECubeSimdLevel::Scalar;
+}
+#endif
+}
+
+using namespace CubeVectorImpl;
+
+const char* ToString(ECubeSimdLevel Level)
+{
+	switch (Level)
+	{
+	case ECubeSimdLevel::SSSE3: return "SSSE3";
+	case ECubeSimdLevel::AVX2: return "AVX2";
+	default: return "Scalar";
+	}
+}
+
+ECubeSimdLevel GetSupportedSimdLevel()
+{
+	static const ECubeSimdLevel Level = DetectSimdLevel();
+	return Level;
+}
+
+FCubeVector FCubeVector::Solved()
+{
+	return FromState(FCubeState::Solved());
+}
+
+FCubeVector FCubeVector::FromState(const FCubeState& State)
+{
+	const FCubieCube Cube = State.ToCubie();
+	FCubeVector Result{};
+	for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+	{
+		Result.Bytes[Index] = static_cast<uint8_t>(Cube.Cp[Index] | Cube.Co[Index] << 4);
+	}
+	for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+	{
+		Result.Bytes[EdgeOffset + Index] = static_cast<uint8_t>(Cube.Ep[Index] | Cube.Eo[Index] << 4);
+	}
+	return Result;
+}
+
+FCubeState FCubeVector::ToState() const
+{
+	FCubieCube Cube{};
+	for (int32_t Index = 0; Index < CubeCornerCount; ++Index)
+	{
+		Cube.Cp[Index] = Bytes[Index] & 15;
+		Cube.Co[Index] = static_cast<uint8_t>(Bytes[Index] >> 4);
+	}
+	for (int32_t Index = 0; Index < CubeEdgeCount; ++Index)
+	{
+		Cube.Ep[Index] = Bytes[EdgeOffset + Index] & 15;
+		Cube.Eo[Index] = static_cast<uint8_t>(Bytes[EdgeOffset + Index] >> 4);
+	}
+	return FCubeState::FromCubie(Cube);
+}
+
+FCubeVector FCubeVector::Apply(ECubeMove Move) const
+{
+	FCubeVector Result = *this;
+	ApplyMoves(Result, &Move, 1, GetSupportedSimdLevel());
+	return Result;
+}
+
+bool FCubeVector::operator==(const FCubeVector& Other) const
+{
+	return std::memcmp(Bytes, Other.Bytes, sizeof(Bytes)) == 0;
+}
+
+void ApplyMoves(FCubeVector& State, const ECubeMove* Moves, size_t Count, ECubeSimdLevel Level)
+{
+	switch (Level)
+	{
+#if CUBE_VECTOR_X86
+	case ECubeSimdLevel::AVX2:
+		ApplyMovesAVX2(State, Moves, Count);
+		break;
+	case ECubeSimdLevel::SSSE3:
+		ApplyMovesSSSE3(State, Moves, Count);
+		break;
+#endif
+	default:
+		ApplyMovesScalar(State, Moves, Count);
+		break;
+	}
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CubeState.h"
+
+#include <cstddef>
+
+/** Instruction sets FCubeVector can use, ordered from slowest to fastest */
+enum class ECubeSimdLevel : uint8_t
+{
+	Scalar,
+	SSSE3,
+	AVX2
+};
+
+const char* ToString(ECubeSimdLevel Level);
+
+/** Best level supported by the CPU and OS, detected once */
+ECubeSimdLevel GetSupportedSimdLevel();
+
+/**
+ * Cube state laid out for byte shuffles: bytes 0-7 are corners, bytes 16-27 are edges,
+ * each byte holds cubie position in bits 0-3 and orientation in bits 4-5, remaining bytes are zero.
+ * Face turn is one shuffle of all 32 bytes followed by orientation add,
+ * so on AVX2 whole state stays in one register and on SSSE3 in two.
+ */
+struct alignas(32) FCubeVector
+{
+	uint8_t Bytes[32];
+
+	static constexpr int32_t EdgeOffset = 16;
+
+	static FCubeVector Solved();
+	static FCubeVector FromState(const FCubeState& State);
+	FCubeState ToState() const;
+
+	/** Applies single move with best supported level */
+	FCubeVector Apply(ECubeMove Move) const;
+
+	bool operator==(const FCubeVector& Other) const;
+	bool operator!=(const FCubeVector& Other) const { return !(*this == Other); }
+};
+
+/** Applies moves in order, state is kept in registers for whole sequence. Level must be supported by the CPU. */
+void ApplyMoves(FCubeVector& State, const ECubeMove* Moves, size_t Count, ECubeSimdLevel Level);
+
+inline void ApplyMoves(FCubeVector& State, const std::vector<ECubeMove>& Moves)
+{
+	ApplyMoves(State, Moves.data(), Moves.size(), GetSupportedSimdLevel());
+}
@@ -0,0 +1,234 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeCommands.h"
+#include "RubikCube.h"
+#include "Cube/CubeBatchSolver.h"
+#include "Cube/CubeBenchmark.h"
+#include "Cube/CubeOptimalSolver.h"
+#include "Cube/CubeScrambler.h"
+#include "Cube/CubeTwoPhaseSolver.h"
+#include "Cube/CubeVector.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMisc.h"
+#include "Misc/Paths.h"
+
+namespace CubeCommandsImpl
+{
+static int64 ParseCountArgument(const TArray<FString>& Args, int32 Index, int64 Default)
+{
+	return Args.IsValidIndex(Index) ? FMath::Max<int64>(1, FCString::Atoi64(*Args[Index])) : Default;
+}
+
+static void BenchmarkMoves(const TArray<FString>& Args)
+{
+	const int64 MoveCount = ParseCountArgument(Args, 0, 100000000);
+	const FString Title = FString::Printf(TEXT("Move application, %lld random moves, best SIMD level %s"),
+	                                      MoveCount, UTF8_TO_TCHAR(ToString(GetSupportedSimdLevel())));
+	LogCubeBenchmarkResults(Title, BenchmarkMoveApplication(static_cast<uint64_t>(MoveCount)));
+}
+
+static void BenchmarkOptimal(const TArray<FString>& Args)
+{
+	const FCubeOptimalSolver* Solver = GetCubeOptimalSolver();
+	if (Solver == nullptr) return;
+
+	const int32 StateCount = static_cast<int32>(ParseCountArgument(Args, 0, 5));
+	const int32 ScrambleLength = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 0;
+	const FString Title = FString::Printf(TEXT("Optimal solver, %d %s"), StateCount,
+	                                      ScrambleLength > 0 ? *FString::Printf(TEXT("scrambles of %d moves"), ScrambleLength) : TEXT("random states"));
+	LogCubeBenchmarkResults(Title, BenchmarkOptimalSolver(*Solver, StateCount, ScrambleLength));
+}
+
+static void BenchmarkTwoPhase(const TArray<FString>& Args)
+{
+	const FCubeTwoPhaseSolver* Solver = GetCubeTwoPhaseSolver();
+	if (Solver == nullptr) return;
+
+	const int32 StateCount = static_cast<int32>(ParseCountArgument(Args, 0, 10000));
+	const int32 Milliseconds = static_cast<int32>(ParseCountArgument(Args, 1, 10));
+	const int32 TargetLength = static_cast<int32>(ParseCountArgument(Args, 2, 20));
+	const FString Title = FString::Printf(TEXT("Two-phase solver, %d random states, target %d moves, %d ms per state"),
+	                                      StateCount, TargetLength, Milliseconds);
+	LogCubeBenchmarkResults(Title, BenchmarkTwoPhaseSolver(*Solver, StateCount, TargetLength, Milliseconds / 1000.0));
+}
+
+static void BenchmarkBatch(const TArray<FString>& Args)
+{
+	const FCubeTwoPhaseSolver* Solver = GetCubeTwoPhaseSolver();
+	if (Solver == nullptr) return;
+
+	const int32 StateCount = static_cast<int32>(ParseCountArgument(Args, 0, 2000));
+	const int32 Milliseconds = static_cast<int32>(ParseCountArgument(Args, 1, 10));
+	const int32 MaxThreadCount = static_cast<int32>(ParseCountArgument(Args, 2, FPlatformMisc::NumberOfCoresIncludingHyperthreads()));
+
+	FCubeSolveJob Job;
+	Job.Method = ECubeSolveMethod::TwoPhase;
+	Job.TimeLimit = Milliseconds / 1000.0;
+	const FString Title = FString::Printf(TEXT("Batch two-phase solver, %d random states, target %d moves, %d ms per state"),
+	                                      StateCount, Job.TargetLength, Milliseconds);
+	LogCubeBenchmarkResults(Title, BenchmarkBatchSolver(Solver, nullptr, Job, StateCount, 0, MaxThreadCount));
+}
+
+static void BenchmarkBatchOptimal(const TArray<FString>& Args)
+{
+	const FCubeOptimalSolver* Solver = GetCubeOptimalSolver();
+	if (Solver == nullptr) return;
+
+	const int32 StateCount = static_cast<int32>(ParseCountArgument(Args, 0, 8));
+	const int32 ScrambleLength = static_cast<int32>(ParseCountArgument(Args, 1, 13));
+	const int32 MaxThreadCount = static_cast<int32>(ParseCountArgument(Args, 2, FPlatformMisc::NumberOfCoresIncludingHyperthreads()));
+
+	FCubeSolveJob Job;
+	Job.Method = ECubeSolveMethod::Optimal;
+	const FString Title = FString::Printf(TEXT("Batch optimal solver, %d scrambles of %d moves"), StateCount, ScrambleLength);
+	LogCubeBenchmarkResults(Title, BenchmarkBatchSolver(nullptr, Solver, Job, StateCount, ScrambleLength, MaxThreadCount));
+}
+
+static void BenchmarkSizes(const TArray<FString>& Args)
+{
+	const FCubeTwoPhaseSolver* Solver = GetCubeTwoPhaseSolver();
+	if (Solver == nullptr) return;
+
+	const int32 MaxSize = static_cast<int32>(ParseCountArgument(Args, 0, 7));
+	const int32 SolveCount = static_cast<int32>(ParseCountArgument(Args, 1, 20));
+	const int64 MoveCount = ParseCountArgument(Args, 2, 10000000);
+	const FString Title = FString::Printf(TEXT("Cube sizes 2 to %d, %lld random turns and %d reduction solves per size"),
+	                                      MaxSize, MoveCount, SolveCount);
+	LogCubeBenchmarkResults(Title, BenchmarkCubeSizes(*Solver, 2, MaxSize, static_cast<uint64_t>(MoveCount), SolveCount));
+}
+
+static void BenchmarkSession(const TArray<FString>& Args)
+{
+	const int64 MoveCount = ParseCountArgument(Args, 0, 10000000);
+	const int32 CubeSize = static_cast<int32>(ParseCountArgument(Args, 1, 3));
+	const FString Title = FString::Printf(TEXT("Session log, %lld random turns on %dx%dx%d"), MoveCount, CubeSize, CubeSize, CubeSize);
+	LogCubeBenchmarkResults(Title, BenchmarkSessionLog(static_cast<uint64_t>(MoveCount), CubeSize));
+}
+
+static void BenchmarkScrambles(const TArray<FString>& Args)
+{
+	const FCubeTwoPhaseSolver* Solver = GetCubeTwoPhaseSolver();
+	if (Solver == nullptr) return;
+
+	const int32 Count = static_cast<int32>(ParseCountArgument(Args, 0, 5000));
+	const int32 MaxThreadCount = static_cast<int32>(ParseCountArgument(Args, 1, FPlatformMisc::NumberOfCoresIncludingHyperthreads()));
+	const int64 StateCount = ParseCountArgument(Args, 2, 1000000);
+	const FString Title = FString::Printf(TEXT("Random state scrambles, %lld states sampled, %d scrambles of at most %d moves"),
+	                                      StateCount, Count, FCubeScrambleOptions().TargetLength);
+	LogCubeBenchmarkResults(Title, BenchmarkScrambleGenerator(*Solver, Count, static_cast<uint64_t>(StateCount), MaxThreadCount));
+}
+
+static void BenchmarkCanonical(const TArray<FString>& Args)
+{
+	const int64 StateCount = ParseCountArgument(Args, 0, 1000000);
+	const int32 SearchDepth = static_cast<int32>(FMath::Min<int64>(ParseCountArgument(Args, 1, 6), 20));
+	const int64 TableEntryCount = ParseCountArgument(Args, 2, 1 << 22);
+	const FString Title = FString::Printf(TEXT("Canonicalization, %lld random states, searches of %d moves with %lld table entries"),
+	                                      StateCount, SearchDepth, TableEntryCount);
+	LogCubeBenchmarkResults(Title, BenchmarkCanonicalization(static_cast<uint64_t>(StateCount), SearchDepth, static_cast<uint64_t>(TableEntryCount)));
+}
+}
+
+using namespace CubeCommandsImpl;
+
+void LogCubeBenchmarkResults(const FString& Title, const std::vector<FCubeBenchmarkResult>& Results)
+{
+	UE_LOG(LogRubikCube, Display, TEXT("%s"), *Title);
+	for (const FCubeBenchmarkResult& Result : Results)
+	{
+		UE_LOG(LogRubikCube, Display, TEXT("  %-24s %12llu items %10.3f s %10.2f ns/item %14.0f items/s checksum %016llx"),
+		       UTF8_TO_TCHAR(Result.Name.c_str()), static_cast<unsigned long long>(Result.Items), Result.Seconds,
+		       Result.GetNanosecondsPerItem(), Result.GetItemsPerSecond(), static_cast<unsigned long long>(Result.Checksum));
+	}
+}
+
+FString GetCubeTableDirectory()
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("Cube"));
+}
+
+const FCubeOptimalSolver* GetCubeOptimalSolver()
+{
+	static const TUniquePtr<FCubeOptimalSolver> Solver = []() -> TUniquePtr<FCubeOptimalSolver>
+	{
+		const FString Directory = GetCubeTableDirectory();
+		IFileManager::Get().MakeDirectory(*Directory, true);
+		UE_LOG(LogRubikCube, Display, TEXT("Loading optimal solver tables from %s, missing ones are generated"), *Directory);
+
+		TUniquePtr<FCubeOptimalSolver> NewSolver = MakeUnique<FCubeOptimalSolver>();
+		std::string Error;
+		if (!NewSolver->Initialize(TCHAR_TO_UTF8(*Directory), FPlatformMisc::NumberOfCoresIncludingHyperthreads(), Error))
+		{
+			UE_LOG(LogRubikCube, Error, TEXT("Failed to initialize optimal solver: %s"), UTF8_TO_TCHAR(Error.c_str()));
+			return nullptr;
+		}
+		return NewSolver;
+	}();
+	return Solver.Get();
+}
+
+const FCubeTwoPhaseSolver* GetCubeTwoPhaseSolver()
+{
+	static const TUniquePtr<FCubeTwoPhaseSolver> Solver = []() -> TUniquePtr<FCubeTwoPhaseSolver>
+	{
+		const FString Directory = GetCubeTableDirectory();
+		IFileManager::Get().MakeDirectory(*Directory, true);
+		UE_LOG(LogRubikCube, Display, TEXT("Loading two-phase solver tables from %s, they are generated when missing"), *Directory);
+
+		TUniquePtr<FCubeTwoPhaseSolver> NewSolver = MakeUnique<FCubeTwoPhaseSolver>();
+		std::string Error;
+		if (!NewSolver->Initialize(TCHAR_TO_UTF8(*Directory), FPlatformMisc::NumberOfCoresIncludingHyperthreads(), Error))
+		{
+			UE_LOG(LogRubikCube, Error, TEXT("Failed to initialize two-phase solver: %s"), UTF8_TO_TCHAR(Error.c_str()));
+			return nullptr;
+		}
+		return NewSolver;
+	}();
+	return Solver.Get();
+}
+
+static FAutoConsoleCommand BenchmarkMovesCommand(
+	TEXT("Cube.Benchmark.Moves"),
+	TEXT("Compares packed, scalar and SIMD move application. Usage: Cube.Benchmark.Moves [MoveCount]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkMoves));
+
+static FAutoConsoleCommand BenchmarkOptimalCommand(
+	TEXT("Cube.Benchmark.Optimal"),
+	TEXT("Solves fixed scrambles optimally and reports nodes per second. Usage: Cube.Benchmark.Optimal [StateCount] [ScrambleLength, 0 for random states]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkOptimal));
+
+static FAutoConsoleCommand BenchmarkTwoPhaseCommand(
+	TEXT("Cube.Benchmark.TwoPhase"),
+	TEXT("Solves random states with the two-phase solver under a time limit. Usage: Cube.Benchmark.TwoPhase [StateCount] [MillisecondsPerState] [TargetLength]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkTwoPhase));
+
+static FAutoConsoleCommand BenchmarkBatchCommand(
+	TEXT("Cube.Benchmark.Batch"),
+	TEXT("Solves a batch of random states with the two-phase solver on 1 to MaxThreads threads. Usage: Cube.Benchmark.Batch [StateCount] [MillisecondsPerState] [MaxThreads]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkBatch));
+
+static FAutoConsoleCommand BenchmarkBatchOptimalCommand(
+	TEXT("Cube.Benchmark.BatchOptimal"),
+	TEXT("Solves scrambles optimally with the search split over 1 to MaxThreads threads. Usage: Cube.Benchmark.BatchOptimal [StateCount] [ScrambleLength] [MaxThreads]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkBatchOptimal));
+
+static FAutoConsoleCommand BenchmarkSizesCommand(
+	TEXT("Cube.Benchmark.Sizes"),
+	TEXT("Measures layer turns and reduction solves on cubes from 2x2x2 up to MaxSize. Usage: Cube.Benchmark.Sizes [MaxSize] [SolveCount] [MoveCount]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkSizes));
+
+static FAutoConsoleCommand BenchmarkSessionCommand(
+	TEXT("Cube.Benchmark.Session"),
+	TEXT("Records, verifies and decodes a session log of random turns. Usage: Cube.Benchmark.Session [MoveCount] [CubeSize]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkSession));
+
+static FAutoConsoleCommand BenchmarkScramblesCommand(
+	TEXT("Cube.Benchmark.Scrambles"),
+	TEXT("Samples random states and generates unique random state scrambles on 1 to MaxThreads threads. Usage: Cube.Benchmark.Scrambles [Count] [MaxThreads] [StateCount]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkScrambles));
+
+static FAutoConsoleCommand BenchmarkCanonicalCommand(
+	TEXT("Cube.Benchmark.Canonical"),
+	TEXT("Measures symmetry canonicalization and transposition table hits in depth limited searches. Usage: Cube.Benchmark.Canonical [StateCount] [SearchDepth] [TableEntries]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkCanonical));
@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <vector>
+
+struct FCubeBenchmarkResult;
+class FCubeOptimalSolver;
+class FCubeTwoPhaseSolver;
+
+/** Writes benchmark results to LogRubikCube, shared by console commands and commandlets */
+void LogCubeBenchmarkResults(const FString& Title, const std::vector<FCubeBenchmarkResult>& Results);
+
+/** Directory of generated solver tables, Saved/Cube of the project */
+FString GetCubeTableDirectory();
+
+/** Optimal solver shared by the whole process, tables missing on disk are generated on first call. Null if tables can't be loaded. */
+const FCubeOptimalSolver* GetCubeOptimalSolver();
+
+/** Two-phase solver shared by the whole process, pruning tables missing on disk are generated on first call. Null if it can't be loaded. */
+const FCubeTwoPhaseSolver* GetCubeTwoPhaseSolver();
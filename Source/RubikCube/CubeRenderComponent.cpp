@@ -0,0 +1,274 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeRenderComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "UObject/ConstructorHelpers.h"
+
+namespace CubeRenderComponentImpl
+{
+/** Outward normal of every face in component space, U, R, F, D, L, B */
+static const FVector FaceNormals[6] = {
+	FVector(0.0, 0.0, 1.0), FVector(0.0, -1.0, 0.0), FVector(1.0, 0.0, 0.0),
+	FVector(0.0, 0.0, -1.0), FVector(0.0, 1.0, 0.0), FVector(-1.0, 0.0, 0.0)};
+
+static FIntVector RoundToIntVector(const FVector& Vector)
+{
+	return FIntVector(FMath::RoundToInt(Vector.X), FMath::RoundToInt(Vector.Y), FMath::RoundToInt(Vector.Z));
+}
+
+/** Rotation after whole quarter turns, rounded so float error doesn't build up over many turns */
+static FQuat SnapRotation(const FQuat& Rotation)
+{
+	const FVector X(RoundToIntVector(Rotation.GetAxisX()));
+	const FVector Y(RoundToIntVector(Rotation.GetAxisY()));
+	const FVector Z(RoundToIntVector(Rotation.GetAxisZ()));
+	return FMatrix(X, Y, Z, FVector::ZeroVector).ToQuat();
+}
+}
+
+using namespace CubeRenderComponentImpl;
+
+UCubeRenderComponent::UCubeRenderComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	NumCustomDataFloats = 6;
+
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> CubieMesh(TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (CubieMesh.Succeeded())
+	{
+		SetStaticMesh(CubieMesh.Object);
+	}
+
+	StickerColors = {
+		FLinearColor::White, FLinearColor(0.8f, 0.0f, 0.0f), FLinearColor(0.0f, 0.6f, 0.1f),
+		FLinearColor(1.0f, 0.85f, 0.0f), FLinearColor(1.0f, 0.35f, 0.0f), FLinearColor(0.0f, 0.2f, 0.8f),
+		FLinearColor(0.02f, 0.02f, 0.02f)};
+}
+
+void UCubeRenderComponent::SetCubeSize(int32 NewSize)
+{
+	SetCubeState(FCubeNxN(NewSize));
+}
+
+void UCubeRenderComponent::TurnLayer(int32 Face, int32 Layer, int32 QuarterTurns)
+{
+	if (Face < 0 || Face >= 6) return;
+	QueueTurn({static_cast<ECubeFace>(Face), static_cast<uint8_t>(FMath::Clamp(Layer, 0, 255)),
+	           static_cast<uint8_t>((QuarterTurns % 4 + 4) % 4)});
+}
+
+void UCubeRenderComponent::QueueTurn(const FCubeLayerMove& Move)
+{
+	if (Move.Layer >= Cube.GetSize() || Move.Turns % 4 == 0) return;
+
+	Cube.Apply(Move);
+	PendingTurns.Add(Move);
+	SetComponentTickEnabled(true);
+}
+
+void UCubeRenderComponent::QueueTurns(const std::vector<FCubeLayerMove>& Moves)
+{
+	for (const FCubeLayerMove& Move : Moves)
+	{
+		QueueTurn(Move);
+	}
+}
+
+void UCubeRenderComponent::SetCubeState(const FCubeNxN& State)
+{
+	PendingTurns.Reset();
+	bTurning = false;
+	TurningCubies.Reset();
+
+	Cube = State;
+	CubeSize = State.GetSize();
+	RebuildInstances();
+}
+
+void UCubeRenderComponent::FinishTurns()
+{
+	if (bTurning)
+	{
+		FinishCurrentTurn();
+	}
+	while (!PendingTurns.IsEmpty())
+	{
+		StartNextTurn();
+		FinishCurrentTurn();
+	}
+}
+
+void UCubeRenderComponent::ApplyStickerColors()
+{
+	if (GetMaterial(0) == nullptr) return;
+
+	UMaterialInstanceDynamic* Material = CreateDynamicMaterialInstance(0);
+	for (int32 Index = 0; Index < StickerColors.Num(); ++Index)
+	{
+		Material->SetVectorParameterValue(*FString::Printf(TEXT("StickerColor%d"), Index), StickerColors[Index]);
+	}
+}
+
+void UCubeRenderComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// Cubies aren't serialized, a loaded component starts solved
+	if (Cubies.IsEmpty() || Cube.GetSize() != CubeSize)
+	{
+		Cube = FCubeNxN(CubeSize);
+		RebuildInstances();
+	}
+}
+
+void UCubeRenderComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	ApplyStickerColors();
+}
+
+void UCubeRenderComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!bTurning)
+	{
+		StartNextTurn();
+	}
+	if (bTurning)
+	{
+		TurnElapsed += DeltaTime;
+		if (TurnElapsed >= TurnSeconds)
+		{
+			FinishCurrentTurn();
+		}
+		else
+		{
+			SetTurnAngle(TurnAngle * FMath::SmoothStep(0.0f, 1.0f, TurnElapsed / TurnSeconds));
+		}
+	}
+
+	if (!IsTurning())
+	{
+		SetComponentTickEnabled(false);
+	}
+}
+
+#if WITH_EDITOR
+void UCubeRenderComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	const FName Name = PropertyChangedEvent.GetMemberPropertyName();
+	if (Name == GET_MEMBER_NAME_CHECKED(UCubeRenderComponent, CubeSize))
+	{
+		SetCubeSize(CubeSize);
+	}
+	else if (Name == GET_MEMBER_NAME_CHECKED(UCubeRenderComponent, CubieSpacing) || Name == GET_MEMBER_NAME_CHECKED(UCubeRenderComponent, CubieScale))
+	{
+		FinishTurns();
+		RebuildInstances();
+	}
+}
+#endif
+
+void UCubeRenderComponent::RebuildInstances()
+{
+	ClearInstances();
+	Cubies.Reset();
+	SetNumCustomDataFloats(6);
+
+	// Instances only for cubies with a sticker, the inside of big cubes is never seen
+	const FCubeNxNLayout& Layout = Cube.GetLayout();
+	const int32 Last = Cube.GetSize() - 1;
+	TArray<FTransform> Transforms;
+	TArray<float> CustomData;
+	for (int32 X = 0; X <= Last; ++X)
+	{
+		for (int32 Y = 0; Y <= Last; ++Y)
+		{
+			for (int32 Z = 0; Z <= Last; ++Z)
+			{
+				const bool bOnFace[6] = {Y == Last, X == Last, Z == Last, Y == 0, X == 0, Z == 0};
+				if (!(bOnFace[0] || bOnFace[1] || bOnFace[2] || bOnFace[3] || bOnFace[4] || bOnFace[5])) continue;
+
+				// Cube model runs X from L to R, Y from D to U and Z from B to F
+				FCubie& Cubie = Cubies.AddDefaulted_GetRef();
+				Cubie.Position = FIntVector(2 * Z - Last, Last - 2 * X, 2 * Y - Last);
+				Transforms.Add(GetCubieTransform(FVector(Cubie.Position), Cubie.Rotation));
+				for (int32 Face = 0; Face < 6; ++Face)
+				{
+					CustomData.Add(bOnFace[Face] ? Cube.GetSticker(Layout.GetStickerAt(static_cast<ECubeFace>(Face), X, Y, Z)) : BodyColorIndex);
+				}
+			}
+		}
+	}
+
+	AddInstances(Transforms, false);
+	for (int32 Instance = 0; Instance < Cubies.Num(); ++Instance)
+	{
+		SetCustomData(Instance, MakeArrayView(CustomData.GetData() + Instance * 6, 6));
+	}
+	MarkRenderStateDirty();
+}
+
+FTransform UCubeRenderComponent::GetCubieTransform(const FVector& Position, const FQuat& Rotation) const
+{
+	return FTransform(Rotation, Position * (CubieSpacing * 0.5f), FVector(CubieScale));
+}
+
+void UCubeRenderComponent::StartNextTurn()
+{
+	if (PendingTurns.IsEmpty()) return;
+	const FCubeLayerMove Move = PendingTurns[0];
+	PendingTurns.RemoveAt(0);
+
+	// Positive angles about the outward normal turn clockwise seen from the face
+	const int32 Turns = Move.Turns % 4;
+	TurnAxis = FaceNormals[static_cast<int32>(Move.Face)];
+	TurnAngle = Turns == 3 ? -90.0f : 90.0f * Turns;
+	TurnSeconds = QuarterTurnSeconds * (Turns == 2 ? 2 : 1) / (1 + PendingTurns.Num());
+	TurnElapsed = 0.0f;
+
+	const int32 LayerOffset = Cube.GetSize() - 1 - 2 * Move.Layer;
+	TurningCubies.Reset();
+	for (int32 Index = 0; Index < Cubies.Num(); ++Index)
+	{
+		if (FMath::RoundToInt(FVector::DotProduct(FVector(Cubies[Index].Position), TurnAxis)) == LayerOffset)
+		{
+			TurningCubies.Add(Index);
+		}
+	}
+	bTurning = true;
+}
+
+void UCubeRenderComponent::SetTurnAngle(float Angle)
+{
+	const FQuat Turn(TurnAxis, FMath::DegreesToRadians(Angle));
+	// Only the last update marks the instances dirty, the render thread then takes every changed transform at once
+	for (int32 TurningIndex = 0; TurningIndex < TurningCubies.Num(); ++TurningIndex)
+	{
+		const int32 Index = TurningCubies[TurningIndex];
+		const FCubie& Cubie = Cubies[Index];
+		UpdateInstanceTransform(Index, GetCubieTransform(Turn.RotateVector(FVector(Cubie.Position)), Turn * Cubie.Rotation), false,
+		                        TurningIndex == TurningCubies.Num() - 1, true);
+	}
+}
+
+void UCubeRenderComponent::FinishCurrentTurn()
+{
+	const FQuat Turn(TurnAxis, FMath::DegreesToRadians(TurnAngle));
+	for (int32 TurningIndex = 0; TurningIndex < TurningCubies.Num(); ++TurningIndex)
+	{
+		const int32 Index = TurningCubies[TurningIndex];
+		FCubie& Cubie = Cubies[Index];
+		Cubie.Position = RoundToIntVector(Turn.RotateVector(FVector(Cubie.Position)));
+		Cubie.Rotation = SnapRotation(Turn * Cubie.Rotation);
+		UpdateInstanceTransform(Index, GetCubieTransform(FVector(Cubie.Position), Cubie.Rotation), false, TurningIndex == TurningCubies.Num() - 1, true);
+	}
+	bTurning = false;
+	TurningCubies.Reset();
+}
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Cube/CubeNxN.h"
+#include "CubeRenderComponent.generated.h"
+
+/**
+ * Draws a cube of any size as one mesh instance per visible cubie, 218 instances for 7x7x7, so a cube costs one instanced
+ * draw per material section and pass no matter its size.
+ *
+ * Sticker colors travel with the cubies: per-instance custom data holds a palette index for each of the six faces of the
+ * cubie mesh, slots 0-5 for local +Z, -Y, +X, -Z, +Y, -X (U, R, F, D, L, B before any turn), 0-5 picks a sticker color and
+ * 6 the body color. The material picks the slot from the vertex normal and the color from vector parameters StickerColor0-6.
+ * Custom data is written only by SetCubeState, a turn just rotates the instances of its layer. Each step of a turn updates
+ * the transforms of the turning instances only, the last update of the step marks the instances dirty so the renderer
+ * takes the changed transforms without recreating the render state.
+ */
+UCLASS(ClassGroup = (Rendering), meta = (BlueprintSpawnableComponent))
+class RUBIKCUBE_API UCubeRenderComponent : public UInstancedStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr int32 BodyColorIndex = 6;
+
+	UCubeRenderComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cube", meta = (ClampMin = "2", ClampMax = "64"))
+	int32 CubeSize = 3;
+
+	/** Distance between neighboring cubie centers */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cube", meta = (ClampMin = "0"))
+	float CubieSpacing = 100.0f;
+
+	/** Scale of the cubie mesh, below 1 leaves gaps between cubies of the 100 unit engine cube */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cube", meta = (ClampMin = "0"))
+	float CubieScale = 0.95f;
+
+	/** Quarter turn animation length, half turns take twice as long. Queued turns play faster to catch up. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cube", meta = (ClampMin = "0"))
+	float QuarterTurnSeconds = 0.15f;
+
+	/** U, R, F, D, L, B sticker colors followed by the body color */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cube")
+	TArray<FLinearColor> StickerColors;
+
+	/** Shows a solved cube of NewSize, dropping queued turns */
+	UFUNCTION(BlueprintCallable, Category = "Cube")
+	void SetCubeSize(int32 NewSize);
+
+	/** Queues a turn of Layer, counted from Face in U, R, F, D, L, B order, by clockwise quarter turns seen from Face */
+	UFUNCTION(BlueprintCallable, Category = "Cube")
+	void TurnLayer(int32 Face, int32 Layer, int32 QuarterTurns);
+
+	/** Plays the current and all queued turns to their end at once */
+	UFUNCTION(BlueprintCallable, Category = "Cube")
+	void FinishTurns();
+
+	UFUNCTION(BlueprintPure, Category = "Cube")
+	bool IsTurning() const { return bTurning || !PendingTurns.IsEmpty(); }
+
+	/** Sends StickerColors to a dynamic instance of the first material */
+	UFUNCTION(BlueprintCallable, Category = "Cube")
+	void ApplyStickerColors();
+
+	/** Cube is updated at once, the turn plays after the ones already queued */
+	void QueueTurn(const FCubeLayerMove& Move);
+	void QueueTurns(const std::vector<FCubeLayerMove>& Moves);
+
+	/** Shows State without animation, dropping queued turns */
+	void SetCubeState(const FCubeNxN& State);
+
+	/** State after every queued turn */
+	const FCubeNxN& GetCube() const { return Cube; }
+
+	virtual void OnRegister() override;
+	virtual void BeginPlay() override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	/** Position in cubie steps doubled, so even sizes stay integer, centered on the cube in component space */
+	struct FCubie
+	{
+		FIntVector Position;
+		FQuat Rotation = FQuat::Identity;
+	};
+
+	void RebuildInstances();
+	FTransform GetCubieTransform(const FVector& Position, const FQuat& Rotation) const;
+
+	void StartNextTurn();
+	void SetTurnAngle(float Angle);
+	void FinishCurrentTurn();
+
+	FCubeNxN Cube = FCubeNxN(3);
+	/** Cubie of every instance, same index */
+	TArray<FCubie> Cubies;
+
+	TArray<FCubeLayerMove> PendingTurns;
+	bool bTurning = false;
+	FVector TurnAxis = FVector::UpVector;
+	float TurnAngle = 0.0f;
+	float TurnSeconds = 0.0f;
+	float TurnElapsed = 0.0f;
+	TArray<int32> TurningCubies;
+};
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeSessionCommandlet.h"
+#include "RubikCube.h"
+#include "Cube/CubeSession.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+
+UCubeSessionCommandlet::UCubeSessionCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UCubeSessionCommandlet::Main(const FString& Params)
+{
+	FString Path;
+	if (!FParse::Value(*Params, TEXT("Verify="), Path))
+	{
+		UE_LOG(LogRubikCube, Error, TEXT("Usage: -run=CubeSession -Verify=<session file> [-ScrambleHash=<hex>]"));
+		return 1;
+	}
+
+	TArray<uint8> Log;
+	if (!FFileHelper::LoadFileToArray(Log, *Path))
+	{
+		UE_LOG(LogRubikCube, Error, TEXT("Can't read %s"), *Path);
+		return 1;
+	}
+
+	FCubeSessionStats Stats;
+	std::string Error;
+	const bool bValid = VerifyCubeSession(Log.GetData(), static_cast<size_t>(Log.Num()), Stats, Error);
+	UE_LOG(LogRubikCube, Display, TEXT("%s: %dx%dx%d, scramble %016llx, %llu moves, inspection %.2f s, solve %.2f s, %.2f TPS, %llu checkpoints"),
+	       *Path, Stats.CubeSize, Stats.CubeSize, Stats.CubeSize, static_cast<unsigned long long>(Stats.ScrambleHash),
+	       static_cast<unsigned long long>(Stats.MoveCount), Stats.InspectionSeconds, Stats.SolveSeconds, Stats.TurnsPerSecond,
+	       static_cast<unsigned long long>(Stats.CheckpointCount));
+	if (!bValid)
+	{
+		UE_LOG(LogRubikCube, Error, TEXT("%s is not a valid solve: %s"), *Path, UTF8_TO_TCHAR(Error.c_str()));
+		return 1;
+	}
+
+	FString ExpectedHash;
+	if (FParse::Value(*Params, TEXT("ScrambleHash="), ExpectedHash) &&
+	    FCString::Strtoui64(*ExpectedHash, nullptr, 16) != Stats.ScrambleHash)
+	{
+		UE_LOG(LogRubikCube, Error, TEXT("%s doesn't start from the scramble %s"), *Path, *ExpectedHash);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CubeSessionCommandlet.generated.h"
+
+/**
+ * Headless verification of recorded sessions, needs no solver tables:
+ * -run=CubeSession -Verify=Path/To/Session.cubesession   replays the log and prints its statistics, fails if it isn't a valid solve
+ *                   -ScrambleHash=<hex>                  also fails unless the log starts from the scramble with this HashCubeScramble
+ */
+UCLASS()
+class RUBIKCUBE_API UCubeSessionCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCubeSessionCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeSolverCommandlet.h"
+#include "CubeCommands.h"
+#include "RubikCube.h"
+#include "Cube/CubeBenchmark.h"
+#include "Cube/CubeOptimalSolver.h"
+#include "Misc/Parse.h"
+
+UCubeSolverCommandlet::UCubeSolverCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UCubeSolverCommandlet::Main(const FString& Params)
+{
+	const FCubeOptimalSolver* Solver = GetCubeOptimalSolver();
+	if (Solver == nullptr)
+	{
+		return 1;
+	}
+
+	FString Scramble;
+	if (FParse::Value(*Params, TEXT("Solve="), Scramble))
+	{
+		std::vector<ECubeMove> Moves;
+		if (!ParseMoves(TCHAR_TO_UTF8(*Scramble), Moves))
+		{
+			UE_LOG(LogRubikCube, Error, TEXT("Invalid scramble \"%s\""), *Scramble);
+			return 1;
+		}
+
+		std::vector<ECubeMove> Solution;
+		FCubeSolveStats Stats;
+		if (!Solver->Solve(FCubeState::Solved().Apply(Moves), Solution, &Stats))
+		{
+			UE_LOG(LogRubikCube, Error, TEXT("No solution found for \"%s\""), *Scramble);
+			return 1;
+		}
+		UE_LOG(LogRubikCube, Display, TEXT("%s (%d moves, %llu nodes, %.3f s)"), UTF8_TO_TCHAR(ToString(Solution).c_str()),
+		       static_cast<int32>(Solution.size()), static_cast<unsigned long long>(Stats.Nodes), Stats.Seconds);
+	}
+
+	int32 StateCount = 0;
+	if (FParse::Value(*Params, TEXT("Benchmark="), StateCount) && StateCount > 0)
+	{
+		int32 ScrambleLength = 0;
+		FParse::Value(*Params, TEXT("ScrambleLength="), ScrambleLength);
+		LogCubeBenchmarkResults(FString::Printf(TEXT("Optimal solver, %d states, scramble length %d"), StateCount, ScrambleLength),
+		                        BenchmarkOptimalSolver(*Solver, StateCount, ScrambleLength));
+	}
+	return 0;
+}
@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CubeSolverCommandlet.generated.h"
+
+/**
+ * Command line front end of the optimal solver, pattern databases missing in Saved/Cube are generated first:
+ * -run=CubeSolver                                     only generates pattern databases
+ * -run=CubeSolver -Solve="R U R' U'"                  prints optimal solution of the scramble
+ * -run=CubeSolver -Benchmark=5 [-ScrambleLength=14]   solves fixed scrambles, no length means random states
+ */
+UCLASS()
+class RUBIKCUBE_API UCubeSolverCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCubeSolverCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
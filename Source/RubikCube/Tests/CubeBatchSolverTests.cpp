@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeCommands.h"
+#include "CubeTestUtils.h"
+#include "Cube/CubeBatchSolver.h"
+#include "Cube/CubeOptimalSolver.h"
+#include "Cube/CubeTaskPool.h"
+#include "Misc/AutomationTest.h"
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace CubeTestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeTaskPoolTest, "RubikCube.Cube.TaskPool",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCubeTaskPoolTest::RunTest(const FString& Parameters)
+{
+	// Tasks split themselves into a binary tree, so most work is submitted from inside the pool and has to be stolen
+	constexpr int32 TreeDepth = 12;
+	FCubeTaskPool Pool(4);
+	std::atomic<int32> FinishedCount{0};
+	std::function<void(int32)> Split = [&Pool, &FinishedCount, &Split](int32 Depth)
+	{
+		if (Depth < TreeDepth)
+		{
+			Pool.Submit([&Split, Depth]() { Split(Depth + 1); });
+			Pool.Submit([&Split, Depth]() { Split(Depth + 1); });
+		}
+		FinishedCount.fetch_add(1);
+	};
+
+	for (int32 Round = 0; Round < 2; ++Round)
+	{
+		FinishedCount = 0;
+		Pool.Submit([&Split]() { Split(0); });
+		Pool.Wait();
+		TestEqual(FString::Printf(TEXT("Every task of round %d ran"), Round), FinishedCount.load(), (1 << (TreeDepth + 1)) - 1);
+	}
+	return true;
+}
+
+// Stress filter, missing solver tables are generated into Saved/Cube first, which takes minutes
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeBatchSolverTest, "RubikCube.Cube.BatchSolver",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::StressFilter)
+
+bool FCubeBatchSolverTest::RunTest(const FString& Parameters)
+{
+	const FCubeTwoPhaseSolver* TwoPhase = GetCubeTwoPhaseSolver();
+	const FCubeOptimalSolver* Optimal = GetCubeOptimalSolver();
+	if (!TestNotNull(TEXT("Two-phase solver"), TwoPhase) || !TestNotNull(TEXT("Optimal solver"), Optimal))
+	{
+		return false;
+	}
+
+	std::mutex ResultsMutex;
+	std::map<uint64, FCubeSolveResult> Results;
+	FCubeBatchSolver Batch(TwoPhase, Optimal, 4, [&ResultsMutex, &Results](const FCubeSolveResult& Result)
+	{
+		std::lock_guard<std::mutex> Lock(ResultsMutex);
+		Results[Result.Id] = Result;
+	});
+
+	std::mt19937 Random(Seed);
+	std::map<uint64, FCubeSolveJob> Jobs;
+	for (uint64 Id = 0; Id < 24; ++Id)
+	{
+		FCubeSolveJob Job;
+		Job.Id = Id;
+		Job.Method = Id % 3 == 0 ? ECubeSolveMethod::Optimal : ECubeSolveMethod::TwoPhase;
+		Job.State = Job.Method == ECubeSolveMethod::Optimal ? FCubeState::Solved().Apply(MakeRandomMoves(Random, 8)) : MakeScrambledState(Random);
+		Job.TimeLimit = 30.0;
+		Job.TargetLength = 21;
+		Jobs[Id] = Job;
+		TestTrue(TEXT("Job is accepted"), Batch.Submit(Job));
+	}
+
+	// Deep optimal searches that have to stop early
+	FCubeSolveJob Cancelled;
+	Cancelled.Id = 100;
+	Cancelled.Method = ECubeSolveMethod::Optimal;
+	Cancelled.State = MakeScrambledState(Random);
+	Cancelled.TimeLimit = 30.0;
+	Batch.Submit(Cancelled);
+	Batch.Cancel(Cancelled.Id);
+
+	FCubeSolveJob TimedOut = Cancelled;
+	TimedOut.Id = 101;
+	TimedOut.TimeLimit = 0.05;
+	Batch.Submit(TimedOut);
+
+	Batch.Wait();
+
+	TestEqual(TEXT("Every job reported"), Results.size(), Jobs.size() + 2);
+	for (const auto& [Id, Job] : Jobs)
+	{
+		const auto Found = Results.find(Id);
+		if (!TestTrue(FString::Printf(TEXT("Job %d is solved"), static_cast<int32>(Id)), Found != Results.end() && Found->second.Status == ECubeSolveStatus::Solved))
+		{
+			continue;
+		}
+		const std::vector<ECubeMove>& Moves = Found->second.Moves;
+		TestTrue(FString::Printf(TEXT("Solution %s of job %d solves it"), *Describe(Moves), static_cast<int32>(Id)), Job.State.Apply(Moves).IsSolved());
+		if (Job.Method == ECubeSolveMethod::Optimal)
+		{
+			// Split search has to find a solution as short as the single threaded one
+			std::vector<ECubeMove> Reference;
+			Optimal->Solve(Job.State, Reference);
+			TestEqual(FString::Printf(TEXT("Optimal job %d length"), static_cast<int32>(Id)), Moves.size(), Reference.size());
+		}
+	}
+	TestTrue(TEXT("Cancelled job reports cancellation"), Results.count(Cancelled.Id) != 0 && Results[Cancelled.Id].Status == ECubeSolveStatus::Cancelled);
+	TestTrue(TEXT("Job out of time reports timeout"), Results.count(TimedOut.Id) != 0 && Results[TimedOut.Id].Status == ECubeSolveStatus::TimedOut);
+	return true;
+}
+
+#endif
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeTestUtils.h"
+#include "Cube/CubeCanonical.h"
+#include "Cube/CubeSymmetry.h"
+#include "Cube/CubeTranspositionTable.h"
+#include "Misc/AutomationTest.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace CubeTestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeCanonicalTest, "RubikCube.Cube.Symmetry.Canonical",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCubeCanonicalTest::RunTest(const FString& Parameters)
+{
+	const FCubeSymmetryTables& Tables = FCubeSymmetryTables::Get();
+	const TArray<ECubeSimdLevel> Levels = GetTestedSimdLevels();
+	std::mt19937 Random(Seed);
+
+	// Scrambled states have no symmetry, the solved cube and superflip are symmetric in every way
+	std::vector<FCubeState> States = {FCubeState::Solved()};
+	FCubieCube Superflip = FCubieCube::Solved();
+	std::fill(std::begin(Superflip.Eo), std::end(Superflip.Eo), 1);
+	States.push_back(FCubeState::FromCubie(Superflip));
+	for (int32 Index = 0; Index < 24; ++Index)
+	{
+		States.push_back(MakeScrambledState(Random));
+	}
+
+	for (const FCubeState& State : States)
+	{
+		const FCubieCube Cube = State.ToCubie();
+		const FCubeVector Vector = FCubeVector::FromState(State);
+		TestTrue(TEXT("Vector inverse matches packed inverse"), InverseVector(Vector) == FCubeVector::FromState(State.Inverse()));
+
+		for (int32 Symmetry = 0; Symmetry < CubeSymmetryCount; ++Symmetry)
+		{
+			if (!TestTrue(FString::Printf(TEXT("Vector conjugation by symmetry %d"), Symmetry),
+			              ConjugateVector(Vector, Symmetry) == FCubeVector::FromState(FCubeState::FromCubie(ConjugateCube(Cube, Tables.Cubes[Symmetry])))))
+			{
+				return false;
+			}
+		}
+
+		for (const bool bWithInverse : {false, true})
+		{
+			const FCubeCanonicalState Reference = CanonicalizeCube(Vector, bWithInverse, ECubeSimdLevel::Scalar);
+			const FCubeVector Source = Reference.bInverse ? InverseVector(Vector) : Vector;
+			TestTrue(TEXT("Canonical state is the conjugate it reports"), ConjugateVector(Source, Reference.Symmetry) == Reference.State);
+			TestTrue(TEXT("Inverse is only used when asked for"), bWithInverse || !Reference.bInverse);
+
+			for (int32 Symmetry = 0; Symmetry < CubeSymmetryCount; ++Symmetry)
+			{
+				const FCubeVector Conjugate = ConjugateVector(Vector, Symmetry);
+				TestTrue(TEXT("Canonical state is the smallest conjugate"), std::memcmp(Conjugate.Bytes, Reference.State.Bytes, sizeof(Conjugate.Bytes)) >= 0);
+
+				for (const ECubeSimdLevel Level : Levels)
+				{
+					const FCubeCanonicalState Canonical = CanonicalizeCube(Conjugate, bWithInverse, Level);
+					if (!TestTrue(FString::Printf(TEXT("%s canonical state of conjugate %d"), UTF8_TO_TCHAR(ToString(Level)), Symmetry),
+					              Canonical.State == Reference.State && Canonical.Hash() == Reference.Hash()))
+					{
+						return false;
+					}
+				}
+			}
+
+			if (bWithInverse)
+			{
+				for (const ECubeSimdLevel Level : Levels)
+				{
+					TestTrue(FString::Printf(TEXT("%s canonical state of inverse"), UTF8_TO_TCHAR(ToString(Level))),
+					         CanonicalizeCube(InverseVector(Vector), true, Level).State == Reference.State);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeTranspositionTableTest, "RubikCube.Cube.TranspositionTable",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCubeTranspositionTableTest::RunTest(const FString& Parameters)
+{
+	FCubeTranspositionTable Table(1000);
+	TestEqual(TEXT("Entry count is rounded down to buckets of two"), Table.GetEntryCount(), static_cast<uint64_t>(512));
+
+	uint8_t Depth = 0;
+	uint32_t Value = 0;
+	TestFalse(TEXT("Empty table misses hash 0"), Table.Probe(0, Depth, Value));
+
+	Table.Store(42, 5, 1234);
+	TestTrue(TEXT("Stored entry is found"), Table.Probe(42, Depth, Value) && Depth == 5 && Value == 1234);
+	TestFalse(TEXT("Other hash of the same bucket misses"), Table.Probe(42 + 256, Depth, Value));
+
+	// Shallower result of another state goes to the second slot, keeping the deep one
+	Table.Store(42 + 256, 3, 7);
+	TestTrue(TEXT("Deep entry is kept"), Table.Probe(42, Depth, Value) && Depth == 5);
+	TestTrue(TEXT("Shallow entry is found"), Table.Probe(42 + 256, Depth, Value) && Depth == 3 && Value == 7);
+
+	Table.Store(42, 2, 99);
+	TestTrue(TEXT("Same state is replaced"), Table.Probe(42, Depth, Value) && Depth == 2 && Value == 99);
+
+	Table.Clear();
+	TestFalse(TEXT("Cleared table misses"), Table.Probe(42, Depth, Value) || Table.Probe(42 + 256, Depth, Value));
+	return true;
+}
+
+#endif
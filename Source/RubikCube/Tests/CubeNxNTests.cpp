@@ -0,0 +1,197 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeCommands.h"
+#include "CubeTestUtils.h"
+#include "Cube/CubeReductionSolver.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace CubeTestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeNxNMovesTest, "RubikCube.Cube.NxN.Moves",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCubeNxNMovesTest::RunTest(const FString& Parameters)
+{
+	std::mt19937 Random(Seed);
+	for (const int32 Size : {2, 3, 4, 5, 7, 10})
+	{
+		const FCubeNxN Solved(Size);
+		TestTrue(FString::Printf(TEXT("New %dx%dx%d is solved"), Size, Size, Size), Solved.IsSolved());
+
+		for (int32 Face = 0; Face < 6; ++Face)
+		{
+			for (int32 Layer = 0; Layer < Size; ++Layer)
+			{
+				FCubeNxN Cube(Size);
+				const FCubeLayerMove Move = {static_cast<ECubeFace>(Face), static_cast<uint8_t>(Layer), 1};
+				Cube.Apply(Move);
+				TestFalse(TEXT("Layer turn scrambles the cube"), Cube.IsSolved());
+				Cube.Apply(Move);
+				Cube.Apply(Move);
+				Cube.Apply(Move);
+				TestTrue(TEXT("Four quarter turns restore the cube"), Cube == Solved);
+
+				// Same turn named from the opposite face is the same move
+				int32 Axis = 0;
+				int32 AxisLayer = 0;
+				int32 Turns = 0;
+				Solved.GetLayout().ToAxisTurn(Move, Axis, AxisLayer, Turns);
+				FCubeNxN Named(Size);
+				Named.Apply(Move);
+				FCubeNxN Converted(Size);
+				Converted.Apply(Solved.GetLayout().FromAxisTurn(Axis, AxisLayer, Turns));
+				TestTrue(TEXT("Axis turn round trip"), Named == Converted);
+			}
+
+			// Turning every layer of an axis only turns the whole cube
+			FCubeNxN Rotated(Size);
+			for (int32 Layer = 0; Layer < Size; ++Layer)
+			{
+				Rotated.Apply(FCubeLayerMove{static_cast<ECubeFace>(Face), static_cast<uint8_t>(Layer), 1});
+			}
+			TestTrue(TEXT("Whole cube rotation is solved"), Rotated.IsSolved() && Rotated != Solved);
+		}
+
+		const std::vector<FCubeLayerMove> Moves = MakeRandomLayerMoves(Random, Size, 100);
+		FCubeNxN Cube(Size);
+		Cube.Apply(Moves);
+		TestFalse(FString::Printf(TEXT("Scrambled %dx%dx%d isn't solved"), Size, Size, Size), Cube.IsSolved());
+		Cube.Apply(InvertLayerMoves(Moves));
+		TestTrue(FString::Printf(TEXT("Inverted moves restore %dx%dx%d"), Size, Size, Size), Cube == Solved);
+	}
+
+	return true;
+}
+
+// Stress filter, missing two-phase tables are generated into Saved/Cube first, which takes minutes
+namespace CubeNxNTestsImpl
+{
+/** Sticker under a facelet of the 3x3x3 numbering, with the middle row and column standing for the middle of the face */
+static int32 GetFaceletSticker(const FCubeNxN& Cube, int32 Facelet)
+{
+	const int32 Coordinates[3] = {0, Cube.GetSize() / 2, Cube.GetSize() - 1};
+	return Cube.GetLayout().GetStickerIndex(static_cast<ECubeFace>(Facelet / 9), Coordinates[Facelet % 9 / 3], Coordinates[Facelet % 3]);
+}
+
+static void SwapStickers(FCubeNxN& Cube, int32 First, int32 Second)
+{
+	const uint8_t Color = Cube.GetSticker(First);
+	Cube.SetSticker(First, Cube.GetSticker(Second));
+	Cube.SetSticker(Second, Color);
+}
+}
+
+using namespace CubeNxNTestsImpl;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeNxNReachableTest, "RubikCube.Cube.NxN.Reachable",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCubeNxNReachableTest::RunTest(const FString& Parameters)
+{
+	std::mt19937 Random(Seed);
+	for (const int32 Size : {2, 3, 4, 5, 6, 7})
+	{
+		const bool bOdd = Size % 2 == 1;
+		for (int32 Iteration = 0; Iteration < 32; ++Iteration)
+		{
+			FCubeNxN Cube(Size);
+			Cube.Apply(MakeRandomLayerMoves(Random, Size, 20 * Size));
+			if (!TestTrue(FString::Printf(TEXT("Scrambled %dx%dx%d is reachable"), Size, Size, Size), Cube.IsReachable()))
+			{
+				return false;
+			}
+		}
+
+		FCubeNxN Scrambled(Size);
+		Scrambled.Apply(MakeRandomLayerMoves(Random, Size, 20 * Size));
+		const FCubeNxNLayout& Layout = Scrambled.GetLayout();
+		const int32 Last = Size - 1;
+
+		FCubeNxN Twisted = Scrambled;
+		const int32 Corner[3] = {Layout.GetStickerAt(ECubeFace::D, 0, 0, 0), Layout.GetStickerAt(ECubeFace::B, 0, 0, 0),
+		                         Layout.GetStickerAt(ECubeFace::L, 0, 0, 0)};
+		SwapStickers(Twisted, Corner[0], Corner[1]);
+		SwapStickers(Twisted, Corner[1], Corner[2]);
+		TestFalse(FString::Printf(TEXT("%dx%dx%d with a twisted corner isn't reachable"), Size, Size, Size), Twisted.IsReachable());
+
+		FCubeNxN Mirrored = Scrambled;
+		SwapStickers(Mirrored, Corner[0], Corner[1]);
+		TestFalse(FString::Printf(TEXT("%dx%dx%d with a mirrored corner isn't reachable"), Size, Size, Size), Mirrored.IsReachable());
+
+		FCubeNxN Recolored = Scrambled;
+		Recolored.SetSticker(Corner[0], static_cast<uint8_t>((Recolored.GetSticker(Corner[0]) + 1) % 6));
+		TestFalse(FString::Printf(TEXT("%dx%dx%d with a recolored sticker isn't reachable"), Size, Size, Size), Recolored.IsReachable());
+
+		FCubeNxN Invalid = Scrambled;
+		Invalid.SetSticker(0, 6);
+		TestFalse(FString::Printf(TEXT("%dx%dx%d with an invalid color isn't reachable"), Size, Size, Size), Invalid.IsReachable());
+
+		// Two corners trading places is a parity that inner slices fix on even cubes only
+		FCubeNxN SwappedCorners(Size);
+		for (int32 Facelet = 0; Facelet < 3; ++Facelet)
+		{
+			SwapStickers(SwappedCorners, GetFaceletSticker(SwappedCorners, CubeCornerFacelets[0][Facelet]),
+			             GetFaceletSticker(SwappedCorners, CubeCornerFacelets[1][Facelet]));
+		}
+		TestEqual(FString::Printf(TEXT("%dx%dx%d with two corners swapped is reachable on even cubes"), Size, Size, Size),
+		          SwappedCorners.IsReachable(), !bOdd);
+
+		if (Size > 2)
+		{
+			// Wing next to the corner, its two stickers swapped
+			FCubeNxN FlippedWing(Size);
+			SwapStickers(FlippedWing, Layout.GetStickerAt(ECubeFace::U, 1, Last, Last), Layout.GetStickerAt(ECubeFace::F, 1, Last, Last));
+			TestEqual(FString::Printf(TEXT("%dx%dx%d with a flipped edge piece isn't reachable"), Size, Size, Size), FlippedWing.IsReachable(),
+			          false);
+
+			// Centers of one orbit are interchangeable, those of different colors can trade places
+			FCubeNxN SwappedCenters(Size);
+			SwapStickers(SwappedCenters, Layout.GetStickerIndex(ECubeFace::U, 1, 1), Layout.GetStickerIndex(ECubeFace::F, 1, 1));
+			TestEqual(FString::Printf(TEXT("%dx%dx%d with two centers swapped"), Size, Size, Size), SwappedCenters.IsReachable(), Size > 3);
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeReductionSolverTest, "RubikCube.Cube.ReductionSolver",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::StressFilter)
+
+bool FCubeReductionSolverTest::RunTest(const FString& Parameters)
+{
+	const FCubeTwoPhaseSolver* TwoPhase = GetCubeTwoPhaseSolver();
+	if (!TestNotNull(TEXT("Two-phase solver"), TwoPhase))
+	{
+		return false;
+	}
+
+	std::mt19937 Random(Seed);
+	const FCubeReductionSolver Reduction(*TwoPhase);
+	for (const int32 Size : {2, 3, 4, 5, 6})
+	{
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			FCubeNxN Cube(Size);
+			Cube.Apply(MakeRandomLayerMoves(Random, Size, 60));
+			std::vector<FCubeLayerMove> Moves;
+			if (!TestTrue(FString::Printf(TEXT("Reduction solver solves %dx%dx%d"), Size, Size, Size), Reduction.Solve(Cube, Moves)))
+			{
+				return false;
+			}
+			Cube.Apply(Moves);
+			TestTrue(FString::Printf(TEXT("Reduction solution solves %dx%dx%d"), Size, Size, Size), Cube.IsSolved());
+		}
+	}
+
+	// Single sticker swap can't be reached by layer turns
+	FCubeNxN Broken(4);
+	const uint8_t Color = Broken.GetSticker(0);
+	Broken.SetSticker(0, Broken.GetSticker(Broken.GetLayout().GetStickerCount() - 1));
+	Broken.SetSticker(Broken.GetLayout().GetStickerCount() - 1, Color);
+	std::vector<FCubeLayerMove> Moves;
+	TestFalse(TEXT("Unreachable cube is refused"), Reduction.Solve(Broken, Moves));
+	return true;
+}
+
+#endif
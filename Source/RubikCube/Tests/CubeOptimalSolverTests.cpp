@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeCommands.h"
+#include "CubeTestUtils.h"
+#include "Cube/CubeOptimalSolver.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace CubeTestUtils;
+
+// Stress filter, missing pattern databases are generated into Saved/Cube first, which takes minutes
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeOptimalSolverTest, "RubikCube.Cube.OptimalSolver",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::StressFilter)
+
+bool FCubeOptimalSolverTest::RunTest(const FString& Parameters)
+{
+	const FCubeOptimalSolver* Optimal = GetCubeOptimalSolver();
+	if (!TestNotNull(TEXT("Optimal solver"), Optimal))
+	{
+		return false;
+	}
+
+	std::vector<ECubeMove> Solution;
+	TestTrue(TEXT("Solved cube takes no moves"), Optimal->Solve(FCubeState::Solved(), Solution) && Solution.empty());
+
+	// Optimal lengths are pinned by also failing one move shorter
+	std::mt19937 Random(Seed);
+	for (int32 Length = 1; Length <= 9; ++Length)
+	{
+		const std::vector<ECubeMove> Scramble = MakeRandomMoves(Random, Length);
+		const FCubeState State = FCubeState::Solved().Apply(Scramble);
+		if (State.IsSolved())
+		{
+			continue;
+		}
+		if (!TestTrue(FString::Printf(TEXT("Optimal solver solves %s"), *Describe(Scramble)), Optimal->Solve(State, Solution)))
+		{
+			return false;
+		}
+		const int32 Distance = static_cast<int32>(Solution.size());
+		TestTrue(FString::Printf(TEXT("Optimal solution %s solves %s"), *Describe(Solution), *Describe(Scramble)), State.Apply(Solution).IsSolved());
+		TestTrue(TEXT("Optimal solution isn't longer than the scramble"), Distance <= Length);
+		TestTrue(TEXT("Lower bound doesn't exceed the distance"), Optimal->GetLowerBound(State) <= Distance);
+		std::vector<ECubeMove> Shorter;
+		TestFalse(TEXT("No solution one move shorter"), Optimal->Solve(State, Shorter, nullptr, Distance - 1));
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeCommands.h"
+#include "CubeTestUtils.h"
+#include "Cube/CubeScrambler.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include <algorithm>
+#include <atomic>
+#include <unordered_set>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace CubeTestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeScrambleSetTest, "RubikCube.Cube.ScrambleSet",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCubeScrambleSetTest::RunTest(const FString& Parameters)
+{
+	std::mt19937 Random(Seed);
+	constexpr int32 StateCount = 4096;
+
+	std::vector<FCubeState> States;
+	std::vector<FCubeState> Others;
+	for (int32 Index = 0; Index < StateCount; ++Index)
+	{
+		States.push_back(MakeRandomCubeState(Random));
+		Others.push_back(MakeRandomCubeState(Random));
+	}
+	const bool bAllSolvable = std::all_of(States.begin(), States.end(), [](const FCubeState& State) { return State.IsSolvable(); });
+	TestTrue(TEXT("Random states are solvable"), bAllSolvable);
+	TestEqual(TEXT("Random states differ"), std::unordered_set<FCubeState, FCubeStateHasher>(States.begin(), States.end()).size(), States.size());
+
+	// Small filter for the state count, lookups must stay exact when the filter is saturated
+	FCubeScrambleSet Set(StateCount / 16);
+	std::atomic<int32> AddedCount{0};
+	ParallelFor(4, [&States, &Set, &AddedCount](int32 Thread)
+	{
+		// Every thread adds every state, each state is added exactly once
+		for (const FCubeState& State : States)
+		{
+			if (Set.Add(State))
+			{
+				AddedCount.fetch_add(1);
+			}
+		}
+	});
+	TestEqual(TEXT("Each state added once"), AddedCount.load(), StateCount);
+	TestEqual(TEXT("Set count"), Set.GetCount(), static_cast<uint64>(StateCount));
+	TestTrue(TEXT("Set contains added states"), std::all_of(States.begin(), States.end(), [&Set](const FCubeState& State) { return Set.Contains(State); }));
+	TestTrue(TEXT("Set doesn't contain other states"), std::none_of(Others.begin(), Others.end(), [&Set](const FCubeState& State) { return Set.Contains(State); }));
+
+	const FString Path = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("CubeScrambleSet.bin"));
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+	std::string Error;
+	if (!TestTrue(TEXT("Set saves"), Set.Save(TCHAR_TO_UTF8(*Path), Error)))
+	{
+		return false;
+	}
+	TestEqual(TEXT("File has 16 bytes per state"), IFileManager::Get().FileSize(*Path), static_cast<int64>(StateCount) * 16);
+
+	FCubeScrambleSet Loaded;
+	TestTrue(TEXT("Set loads"), Loaded.Load(TCHAR_TO_UTF8(*Path), Error));
+	TestEqual(TEXT("Loaded count"), Loaded.GetCount(), static_cast<uint64>(StateCount));
+	TestTrue(TEXT("Loaded set contains saved states"), std::all_of(States.begin(), States.end(), [&Loaded](const FCubeState& State) { return Loaded.Contains(State); }));
+
+	TArray<uint8> Bytes;
+	FFileHelper::LoadFileToArray(Bytes, *Path);
+	Bytes.SetNum(Bytes.Num() - 3);
+	FFileHelper::SaveArrayToFile(Bytes, *Path);
+	FCubeScrambleSet Truncated;
+	TestFalse(TEXT("Truncated file is rejected"), Truncated.Load(TCHAR_TO_UTF8(*Path), Error));
+
+	Bytes.Init(0xFF, 16);
+	FFileHelper::SaveArrayToFile(Bytes, *Path);
+	FCubeScrambleSet Invalid;
+	TestFalse(TEXT("Unsolvable state is rejected"), Invalid.Load(TCHAR_TO_UTF8(*Path), Error));
+	IFileManager::Get().Delete(*Path);
+
+	Set.Clear();
+	TestEqual(TEXT("Cleared count"), Set.GetCount(), static_cast<uint64>(0));
+	TestFalse(TEXT("Cleared set is empty"), Set.Contains(States[0]));
+	TestTrue(TEXT("Cleared set takes states again"), Set.Add(States[0]));
+	return true;
+}
+
+// Stress filter, missing two-phase tables are generated into Saved/Cube first, which takes minutes
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeScrambleGeneratorTest, "RubikCube.Cube.ScrambleGenerator",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::StressFilter)
+
+bool FCubeScrambleGeneratorTest::RunTest(const FString& Parameters)
+{
+	const FCubeTwoPhaseSolver* TwoPhase = GetCubeTwoPhaseSolver();
+	if (!TestNotNull(TEXT("Two-phase solver"), TwoPhase))
+	{
+		return false;
+	}
+
+	// Scrambles are random states, so they have to be found again whatever the thread count
+	FCubeScrambleSet Season;
+	FCubeScrambleSet OtherSeason;
+	const std::vector<FCubeScramble> Scrambles = FCubeScrambleGenerator(*TwoPhase, &Season).GenerateBatch(8, 2, Seed);
+	const std::vector<FCubeScramble> SingleThread = FCubeScrambleGenerator(*TwoPhase, &OtherSeason).GenerateBatch(8, 1, Seed);
+	TestEqual(TEXT("Season holds every scramble"), Season.GetCount(), static_cast<uint64>(Scrambles.size()));
+	for (size_t Index = 0; Index < Scrambles.size(); ++Index)
+	{
+		const FCubeScramble& Scramble = Scrambles[Index];
+		TestTrue(FString::Printf(TEXT("Scramble %s reaches its state"), *Describe(Scramble.Moves)), FCubeState::Solved().Apply(Scramble.Moves) == Scramble.State);
+		TestTrue(TEXT("Scramble isn't too short"), static_cast<int32>(Scramble.Moves.size()) >= FCubeScrambleOptions().MinLength);
+		TestTrue(TEXT("Scramble doesn't depend on thread count"), Scramble.State == SingleThread[Index].State);
+		TestTrue(TEXT("Season contains scramble"), Season.Contains(Scramble.State));
+	}
+
+	// States of a season are never drawn again
+	const std::vector<FCubeScramble> NextBatch = FCubeScrambleGenerator(*TwoPhase, &Season).GenerateBatch(8, 2, Seed);
+	for (const FCubeScramble& Scramble : NextBatch)
+	{
+		TestFalse(TEXT("Repeated seed gives new states"), std::any_of(Scrambles.begin(), Scrambles.end(), [&Scramble](const FCubeScramble& Other) { return Other.State == Scramble.State; }));
+	}
+	TestEqual(TEXT("Season holds both batches"), Season.GetCount(), static_cast<uint64>(Scrambles.size() + NextBatch.size()));
+	return true;
+}
+
+#endif
@@ -0,0 +1,203 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeTestUtils.h"
+#include "Cube/CubeSession.h"
+#include "Misc/AutomationTest.h"
+
+#include <string>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CubeSessionTestsImpl
+{
+/** FNV-1a as documented in CubeSession.h, lets the test forge logs that pass the hash check */
+static void RehashSessionLog(std::vector<uint8_t>& Log)
+{
+	constexpr size_t HashSize = 8;
+	uint64 Hash = 0xCBF29CE484222325ull;
+	for (size_t Index = 0; Index + HashSize < Log.size(); ++Index)
+	{
+		Hash = (Hash ^ Log[Index]) * 0x100000001B3ull;
+	}
+	for (size_t Index = 0; Index < HashSize; ++Index)
+	{
+		Log[Log.size() - HashSize + Index] = static_cast<uint8_t>(Hash >> (8 * Index));
+	}
+}
+}
+
+using namespace CubeSessionTestsImpl;
+using namespace CubeTestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeSessionTest, "RubikCube.Cube.Session",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCubeSessionTest::RunTest(const FString& Parameters)
+{
+	std::mt19937 Random(Seed);
+	constexpr uint32 FramesPerSecond = 60;
+	constexpr uint32 CheckpointInterval = 4;
+	constexpr uint64 SolveStartFrame = 30;
+
+	for (const int32 Size : {2, 3, 4, 7})
+	{
+		// Scramble is undone move by move, so the session ends solved
+		const std::vector<FCubeLayerMove> ScrambleMoves = MakeRandomLayerMoves(Random, Size, 25);
+		FCubeNxN Scramble(Size);
+		Scramble.Apply(ScrambleMoves);
+
+		std::vector<FCubeSessionMove> Moves;
+		uint64 Frame = SolveStartFrame;
+		for (auto Move = ScrambleMoves.rbegin(); Move != ScrambleMoves.rend(); ++Move)
+		{
+			Frame += 1 + Random() % 20;
+			Moves.push_back({Frame, {Move->Face, Move->Layer, static_cast<uint8_t>(4 - Move->Turns)}});
+		}
+		// Long pause before the end takes a varint of several bytes
+		const uint64 EndFrame = Frame + (1ull << 40);
+
+		auto Record = [&](const std::vector<FCubeSessionMove>& RecordedMoves)
+		{
+			FCubeSessionRecorder Recorder(Scramble, FramesPerSecond, CheckpointInterval);
+			Recorder.StartSolve(SolveStartFrame);
+			for (const FCubeSessionMove& Move : RecordedMoves)
+			{
+				Recorder.AddMove(Move.Frame, Move.Move);
+			}
+			return Recorder.Finish(EndFrame);
+		};
+		const std::vector<uint8_t> Log = Record(Moves);
+		TestTrue(TEXT("Same session gives the same log"), Record(Moves) == Log);
+
+		FCubeSessionStats Stats;
+		std::string Error;
+		if (!TestTrue(FString::Printf(TEXT("%dx%dx%d session verifies: %s"), Size, Size, Size, UTF8_TO_TCHAR(Error.c_str())),
+		              VerifyCubeSession(Log.data(), Log.size(), Stats, Error)))
+		{
+			return false;
+		}
+		TestEqual(TEXT("Cube size"), Stats.CubeSize, Size);
+		TestEqual(TEXT("Frames per second"), Stats.FramesPerSecond, FramesPerSecond);
+		TestEqual(TEXT("Move count"), Stats.MoveCount, static_cast<uint64>(Moves.size()));
+		TestEqual(TEXT("Checkpoint count"), Stats.CheckpointCount, static_cast<uint64>(Moves.size() / CheckpointInterval));
+		TestEqual(TEXT("Inspection time"), Stats.InspectionSeconds, static_cast<double>(SolveStartFrame) / FramesPerSecond);
+		TestEqual(TEXT("Solve time"), Stats.SolveSeconds, static_cast<double>(EndFrame - SolveStartFrame) / FramesPerSecond);
+		TestTrue(TEXT("Solved"), Stats.bSolved);
+		TestEqual(TEXT("Scramble hash"), Stats.ScrambleHash, HashCubeScramble(Scramble));
+		TestTrue(TEXT("Session verifies against its scramble"), VerifyCubeSession(Log.data(), Log.size(), Scramble, Stats, Error));
+		FCubeNxN Other = Scramble;
+		Other.Apply(FCubeLayerMove{ECubeFace::U, 0, 1});
+		TestFalse(TEXT("Session doesn't verify against another scramble"), VerifyCubeSession(Log.data(), Log.size(), Other, Stats, Error));
+		TestFalse(TEXT("Session doesn't verify against another cube size"),
+		          VerifyCubeSession(Log.data(), Log.size(), FCubeNxN(Size + 1), Stats, Error));
+
+		FCubeSession Session;
+		if (!TestTrue(TEXT("Session reads back"), ReadCubeSession(Log.data(), Log.size(), Session, Error)))
+		{
+			return false;
+		}
+		TestTrue(TEXT("Scramble reads back"), Session.Scramble == Scramble);
+		TestEqual(TEXT("Solve start frame"), Session.SolveStartFrame, SolveStartFrame);
+		TestEqual(TEXT("End frame"), Session.EndFrame, EndFrame);
+		TestEqual(TEXT("Moves read back"), Session.Moves.size(), Moves.size());
+		for (size_t Index = 0; Index < FMath::Min(Session.Moves.size(), Moves.size()); ++Index)
+		{
+			if (!TestTrue(FString::Printf(TEXT("Move %d reads back"), static_cast<int32>(Index)),
+			              Session.Moves[Index].Frame == Moves[Index].Frame && Session.Moves[Index].Move == Moves[Index].Move))
+			{
+				return false;
+			}
+		}
+
+		// Every changed bit and every cut breaks the hash
+		for (size_t Index = 0; Index < Log.size(); ++Index)
+		{
+			std::vector<uint8_t> Tampered = Log;
+			Tampered[Index] ^= 1 << (Index % 8);
+			if (!TestFalse(FString::Printf(TEXT("Log with byte %d changed is rejected"), static_cast<int32>(Index)),
+			               VerifyCubeSession(Tampered.data(), Tampered.size(), Stats, Error)))
+			{
+				return false;
+			}
+			if (!TestFalse(FString::Printf(TEXT("Log cut to %d bytes is rejected"), static_cast<int32>(Index)),
+			               VerifyCubeSession(Log.data(), Index, Stats, Error)))
+			{
+				return false;
+			}
+		}
+	}
+
+	// A forged move with a valid hash is caught by the next checkpoint
+	{
+		const std::vector<FCubeLayerMove> ScrambleMoves = MakeRandomLayerMoves(Random, 3, 8);
+		FCubeNxN Scramble(3);
+		Scramble.Apply(ScrambleMoves);
+		FCubeSessionRecorder Recorder(Scramble, FramesPerSecond, CheckpointInterval);
+		for (auto Move = ScrambleMoves.rbegin(); Move != ScrambleMoves.rend(); ++Move)
+		{
+			Recorder.AddMove(1, {Move->Face, Move->Layer, static_cast<uint8_t>(4 - Move->Turns)});
+		}
+		std::vector<uint8_t> Log = Recorder.Finish(2);
+
+		// Header of a 3x3x3 at 60 fps is magic, version, size, two one byte varints and 27 bytes of stickers,
+		// the first event is the move tag followed by its one byte code
+		constexpr size_t FirstMoveCode = 4 + 1 + 1 + 1 + 1 + 27 + 1;
+		Log[FirstMoveCode] = static_cast<uint8_t>((Log[FirstMoveCode] + 3) % 18);
+		RehashSessionLog(Log);
+
+		FCubeSessionStats Stats;
+		std::string Error;
+		TestFalse(TEXT("Forged move is rejected"), VerifyCubeSession(Log.data(), Log.size(), Stats, Error));
+		TestTrue(FString::Printf(TEXT("Forged move fails the checkpoint: %s"), UTF8_TO_TCHAR(Error.c_str())), Error.find("Checkpoint") != std::string::npos);
+	}
+
+	// Unsolved session is a valid recording but not a valid solve, late frames are kept in order
+	{
+		FCubeNxN Scramble(3);
+		Scramble.Apply(FCubeLayerMove{ECubeFace::R, 0, 1});
+		FCubeSessionRecorder Recorder(Scramble, FramesPerSecond);
+		Recorder.AddMove(50, FCubeLayerMove{ECubeFace::U, 0, 1});
+		Recorder.AddMove(10, FCubeLayerMove{ECubeFace::U, 0, 3});
+		const std::vector<uint8_t>& Log = Recorder.Finish(60);
+
+		FCubeSessionStats Stats;
+		FCubeSession Session;
+		std::string Error;
+		TestFalse(TEXT("Unsolved session doesn't verify"), VerifyCubeSession(Log.data(), Log.size(), Stats, Error));
+		TestTrue(TEXT("Unsolved session reads"), ReadCubeSession(Log.data(), Log.size(), Session, Error));
+		TestTrue(TEXT("Earlier frame is recorded at the previous event"), Session.Moves.size() == 2 && Session.Moves[1].Frame == 50);
+		TestEqual(TEXT("Solve starts with the first move"), Session.SolveStartFrame, static_cast<uint64>(50));
+	}
+
+	// Scramble must be an unsolved state that layer turns can reach
+	{
+		FCubeSessionRecorder SolvedRecorder(FCubeNxN(3), FramesPerSecond);
+		SolvedRecorder.AddMove(1, FCubeLayerMove{ECubeFace::U, 0, 1});
+		SolvedRecorder.AddMove(2, FCubeLayerMove{ECubeFace::U, 0, 3});
+		const std::vector<uint8_t>& SolvedLog = SolvedRecorder.Finish(3);
+
+		FCubeSessionStats Stats;
+		std::string Error;
+		TestFalse(TEXT("Session from a solved cube doesn't verify"), VerifyCubeSession(SolvedLog.data(), SolvedLog.size(), Stats, Error));
+
+		// Twisted corner keeps every color count, only the reachability check catches it
+		FCubeNxN Twisted(3);
+		const FCubeNxNLayout& Layout = Twisted.GetLayout();
+		const int32 Corner[3] = {Layout.GetStickerAt(ECubeFace::U, 0, 2, 0), Layout.GetStickerAt(ECubeFace::L, 0, 2, 0),
+		                         Layout.GetStickerAt(ECubeFace::B, 0, 2, 0)};
+		const uint8_t Color = Twisted.GetSticker(Corner[0]);
+		Twisted.SetSticker(Corner[0], Twisted.GetSticker(Corner[1]));
+		Twisted.SetSticker(Corner[1], Twisted.GetSticker(Corner[2]));
+		Twisted.SetSticker(Corner[2], Color);
+		FCubeSessionRecorder TwistedRecorder(Twisted, FramesPerSecond);
+		const std::vector<uint8_t>& TwistedLog = TwistedRecorder.Finish(1);
+
+		FCubeSession Session;
+		TestFalse(TEXT("Session from a twisted corner doesn't verify"), VerifyCubeSession(TwistedLog.data(), TwistedLog.size(), Stats, Error));
+		TestTrue(FString::Printf(TEXT("Twisted corner is reported: %s"), UTF8_TO_TCHAR(Error.c_str())), Error.find("reachable") != std::string::npos);
+		TestFalse(TEXT("Session from a twisted corner doesn't read"), ReadCubeSession(TwistedLog.data(), TwistedLog.size(), Session, Error));
+	}
+	return true;
+}
+
+#endif
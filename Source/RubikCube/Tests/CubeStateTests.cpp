@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeTestUtils.h"
+#include "Misc/AutomationTest.h"
+
+#include <utility>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace CubeTestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeStateMovesTest, "RubikCube.Cube.State.Moves",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCubeStateMovesTest::RunTest(const FString& Parameters)
+{
+	for (int32 Move = 0; Move < CubeMoveCount; ++Move)
+	{
+		const ECubeMove CubeMove = static_cast<ECubeMove>(Move);
+		const FCubeState Turned = FCubeState::Solved().Apply(CubeMove);
+		TestTrue(FString::Printf(TEXT("%s matches its cubie turn"), UTF8_TO_TCHAR(ToString(CubeMove))),
+		         Turned == FCubeState::FromCubie(FCubieCube::FromMove(CubeMove)));
+		TestTrue(FString::Printf(TEXT("%s undone by its inverse"), UTF8_TO_TCHAR(ToString(CubeMove))), Turned.Apply(InverseMove(CubeMove)).IsSolved());
+		const FCubeState Twice = Turned.Apply(CubeMove);
+		TestTrue(FString::Printf(TEXT("%s has order 2 or 4"), UTF8_TO_TCHAR(ToString(CubeMove))),
+		         Twice.IsSolved() == (GetMovePower(CubeMove) == 2) && Twice.Apply(CubeMove).Apply(CubeMove).IsSolved());
+	}
+
+	std::mt19937 Random(Seed);
+	for (int32 Sequence = 0; Sequence < 512; ++Sequence)
+	{
+		const FCubeState Start = Sequence % 2 == 0 ? FCubeState::Solved() : MakeScrambledState(Random);
+		const std::vector<ECubeMove> Moves = MakeRandomMoves(Random, Sequence % 64);
+		const FCubeState Expected = FCubeState::FromCubie(ApplyCubieMoves(Start.ToCubie(), Moves));
+
+		FCubeState Packed = Start;
+		for (const ECubeMove Move : Moves)
+		{
+			Packed = Packed.Apply(Move);
+		}
+		if (!TestTrue(FString::Printf(TEXT("Packed state after %s"), *Describe(Moves)), Packed == Expected && Start.Apply(Moves) == Expected))
+		{
+			return false;
+		}
+		TestTrue(TEXT("Cubie round trip"), FCubeState::FromCubie(Packed.ToCubie()) == Packed);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeStateComposeInverseTest, "RubikCube.Cube.State.ComposeInverse",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCubeStateComposeInverseTest::RunTest(const FString& Parameters)
+{
+	std::mt19937 Random(Seed);
+	std::uniform_int_distribution<int32> Length(0, 30);
+
+	for (int32 Iteration = 0; Iteration < 256; ++Iteration)
+	{
+		const std::vector<ECubeMove> MovesA = MakeRandomMoves(Random, Length(Random));
+		const std::vector<ECubeMove> MovesB = MakeRandomMoves(Random, Length(Random));
+		std::vector<ECubeMove> MovesAB = MovesA;
+		MovesAB.insert(MovesAB.end(), MovesB.begin(), MovesB.end());
+
+		const FCubeState A = FCubeState::Solved().Apply(MovesA);
+		const FCubeState B = FCubeState::Solved().Apply(MovesB);
+		const FCubeState C = MakeScrambledState(Random);
+		const FCubeState AB = FCubeState::Solved().Apply(MovesAB);
+
+		const bool bComposed = TestTrue(TEXT("Compose applies B's moves after A's"), FCubeState::Compose(A, B) == AB) &&
+			TestTrue(TEXT("Compose matches cubie multiplication"), FCubeState::FromCubie(FCubieCube::Multiply(A.ToCubie(), B.ToCubie())) == AB) &&
+			TestTrue(TEXT("Compose is associative"), FCubeState::Compose(FCubeState::Compose(A, B), C) == FCubeState::Compose(A, FCubeState::Compose(B, C))) &&
+			TestTrue(TEXT("Solved is the identity of Compose"), FCubeState::Compose(C, FCubeState::Solved()) == C && FCubeState::Compose(FCubeState::Solved(), C) == C);
+
+		const bool bInverted = TestTrue(TEXT("Inverse is reached by the inverted moves"), A.Inverse() == FCubeState::Solved().Apply(InvertMoves(MovesA))) &&
+			TestTrue(TEXT("State composed with its inverse is solved"), FCubeState::Compose(C, C.Inverse()).IsSolved() && FCubeState::Compose(C.Inverse(), C).IsSolved()) &&
+			TestTrue(TEXT("Inverse matches cubie inverse"), FCubeState::FromCubie(FCubieCube::Inverse(C.ToCubie())) == C.Inverse()) &&
+			TestTrue(TEXT("Inverse of inverse is the state"), C.Inverse().Inverse() == C);
+
+		if (!bComposed || !bInverted)
+		{
+			AddInfo(FString::Printf(TEXT("A: %s, B: %s"), *Describe(MovesA), *Describe(MovesB)));
+			return false;
+		}
+
+		std::vector<ECubeMove> Parsed;
+		if (!TestTrue(TEXT("Notation round trip"), ParseMoves(ToString(MovesAB), Parsed) && Parsed == MovesAB))
+		{
+			return false;
+		}
+	}
+
+	// Single twisted corner, flipped edge or swapped edge pair can't be reached by face turns
+	FCubieCube Twisted = FCubieCube::Solved();
+	Twisted.Co[0] = 1;
+	FCubieCube Flipped = FCubieCube::Solved();
+	Flipped.Eo[0] = 1;
+	FCubieCube Swapped = FCubieCube::Solved();
+	std::swap(Swapped.Ep[0], Swapped.Ep[1]);
+	TestFalse(TEXT("Twisted corner isn't solvable"), Twisted.IsSolvable());
+	TestFalse(TEXT("Flipped edge isn't solvable"), Flipped.IsSolvable());
+	TestFalse(TEXT("Swapped edges aren't solvable"), Swapped.IsSolvable());
+	TestTrue(TEXT("Scrambled states are solvable"), MakeScrambledState(Random).IsSolvable());
+	return true;
+}
+
+#endif
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Cube/CubeNxN.h"
+#include "Cube/CubeState.h"
+#include "Cube/CubeVector.h"
+
+#include <random>
+#include <vector>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Helpers shared by the RubikCube.Cube automation tests */
+namespace CubeTestUtils
+{
+/** Every test draws from a fixed seed, so a failing sequence fails again on the next run */
+constexpr uint32 Seed = 0x43554245;
+
+inline std::vector<ECubeMove> MakeRandomMoves(std::mt19937& Random, int32 Count)
+{
+	std::uniform_int_distribution<int32> Distribution(0, CubeMoveCount - 1);
+	std::vector<ECubeMove> Moves(Count);
+	for (ECubeMove& Move : Moves)
+	{
+		Move = static_cast<ECubeMove>(Distribution(Random));
+	}
+	return Moves;
+}
+
+/** Random moves mix the cube well past 40 turns, without depending on the scrambler under test */
+inline FCubeState MakeScrambledState(std::mt19937& Random)
+{
+	return FCubeState::Solved().Apply(MakeRandomMoves(Random, 60));
+}
+
+inline std::vector<ECubeMove> InvertMoves(const std::vector<ECubeMove>& Moves)
+{
+	std::vector<ECubeMove> Inverse;
+	for (auto Move = Moves.rbegin(); Move != Moves.rend(); ++Move)
+	{
+		Inverse.push_back(InverseMove(*Move));
+	}
+	return Inverse;
+}
+
+/** Reference for every other representation, one cubie multiplication per move */
+inline FCubieCube ApplyCubieMoves(FCubieCube Cube, const std::vector<ECubeMove>& Moves)
+{
+	for (const ECubeMove Move : Moves)
+	{
+		Cube = FCubieCube::Multiply(Cube, FCubieCube::FromMove(Move));
+	}
+	return Cube;
+}
+
+inline std::vector<FCubeLayerMove> MakeRandomLayerMoves(std::mt19937& Random, int32 Size, int32 Count)
+{
+	std::uniform_int_distribution<int32> Face(0, 5);
+	std::uniform_int_distribution<int32> Layer(0, Size - 1);
+	std::uniform_int_distribution<int32> Turns(1, 3);
+	std::vector<FCubeLayerMove> Moves(Count);
+	for (FCubeLayerMove& Move : Moves)
+	{
+		Move = {static_cast<ECubeFace>(Face(Random)), static_cast<uint8_t>(Layer(Random)), static_cast<uint8_t>(Turns(Random))};
+	}
+	return Moves;
+}
+
+inline std::vector<FCubeLayerMove> InvertLayerMoves(const std::vector<FCubeLayerMove>& Moves)
+{
+	std::vector<FCubeLayerMove> Inverse;
+	for (auto Move = Moves.rbegin(); Move != Moves.rend(); ++Move)
+	{
+		Inverse.push_back({Move->Face, Move->Layer, static_cast<uint8_t>(4 - Move->Turns)});
+	}
+	return Inverse;
+}
+
+/** Scalar and every SIMD level the CPU supports */
+inline TArray<ECubeSimdLevel> GetTestedSimdLevels()
+{
+	TArray<ECubeSimdLevel> Levels;
+	for (uint8 Level = 0; Level <= static_cast<uint8>(GetSupportedSimdLevel()); ++Level)
+	{
+		Levels.Add(static_cast<ECubeSimdLevel>(Level));
+	}
+	return Levels;
+}
+
+inline FString Describe(const std::vector<ECubeMove>& Moves)
+{
+	return UTF8_TO_TCHAR(ToString(Moves).c_str());
+}
+}
+
+#endif
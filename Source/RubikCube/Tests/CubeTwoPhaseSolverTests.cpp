@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeCommands.h"
+#include "CubeTestUtils.h"
+#include "Cube/CubeSymmetry.h"
+#include "Cube/CubeTwoPhaseSolver.h"
+#include "Misc/AutomationTest.h"
+
+#include <algorithm>
+#include <chrono>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace CubeTestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeSymmetryTablesTest, "RubikCube.Cube.Symmetry.Tables",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCubeSymmetryTablesTest::RunTest(const FString& Parameters)
+{
+	const FCubeSymmetryTables& Tables = FCubeSymmetryTables::Get();
+	TestTrue(TEXT("Symmetry 0 is the identity"), Tables.Cubes[0] == FCubieCube::Solved());
+
+	for (int32 Symmetry = 0; Symmetry < CubeSymmetryCount; ++Symmetry)
+	{
+		const FCubieCube& Cube = Tables.Cubes[Symmetry];
+		TestTrue(FString::Printf(TEXT("Inverse of symmetry %d"), Symmetry),
+		         FCubieCube::Multiply(Cube, Tables.Cubes[Tables.Inverse[Symmetry]]) == FCubieCube::Solved());
+		for (int32 Other = 0; Other < Symmetry; ++Other)
+		{
+			TestTrue(FString::Printf(TEXT("Symmetries %d and %d differ"), Other, Symmetry), Tables.Cubes[Other] != Cube);
+		}
+
+		for (int32 Move = 0; Move < CubeMoveCount; ++Move)
+		{
+			const ECubeMove Conjugated = Tables.Moves[Symmetry][Move];
+			if (!TestTrue(FString::Printf(TEXT("Symmetry %d maps move %d to a face turn"), Symmetry, Move),
+			              Conjugated != ECubeMove::Count && ConjugateMove(static_cast<ECubeMove>(Move), Cube) == Conjugated &&
+			              ConjugateCube(FCubieCube::FromMove(static_cast<ECubeMove>(Move)), Cube) == FCubieCube::FromMove(Conjugated)))
+			{
+				return false;
+			}
+		}
+
+		if (Symmetry < CubeUDSymmetryCount)
+		{
+			const ECubeFace Face = GetMoveFace(Tables.Moves[Symmetry][static_cast<int32>(ECubeMove::U)]);
+			TestTrue(FString::Printf(TEXT("Symmetry %d keeps the UD axis"), Symmetry), Face == ECubeFace::U || Face == ECubeFace::D);
+		}
+	}
+
+	// Conjugation is a homomorphism, the moved state conjugates to the conjugate moved by the conjugated move
+	std::mt19937 Random(Seed);
+	for (int32 Index = 0; Index < 16; ++Index)
+	{
+		const FCubieCube Cube = MakeScrambledState(Random).ToCubie();
+		for (int32 Symmetry = 0; Symmetry < CubeSymmetryCount; ++Symmetry)
+		{
+			const ECubeMove Move = static_cast<ECubeMove>(Symmetry % CubeMoveCount);
+			TestTrue(FString::Printf(TEXT("Conjugate of moved state by symmetry %d"), Symmetry),
+			         ConjugateCube(FCubieCube::Multiply(Cube, FCubieCube::FromMove(Move)), Tables.Cubes[Symmetry]) ==
+			         FCubieCube::Multiply(ConjugateCube(Cube, Tables.Cubes[Symmetry]), FCubieCube::FromMove(Tables.Moves[Symmetry][static_cast<int32>(Move)])));
+		}
+	}
+	return true;
+}
+
+// Stress filter, missing pruning tables are generated into Saved/Cube first, which takes minutes
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeTwoPhaseSolverTest, "RubikCube.Cube.TwoPhaseSolver",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::StressFilter)
+
+bool FCubeTwoPhaseSolverTest::RunTest(const FString& Parameters)
+{
+	const FCubeTwoPhaseSolver* TwoPhase = GetCubeTwoPhaseSolver();
+	if (!TestNotNull(TEXT("Two-phase solver"), TwoPhase))
+	{
+		return false;
+	}
+
+	std::vector<ECubeMove> Solution;
+	TestTrue(TEXT("Solved cube takes no moves"), TwoPhase->Solve(FCubeState::Solved(), Solution) && Solution.empty());
+
+	std::mt19937 Random(Seed);
+	for (int32 Index = 0; Index < 32; ++Index)
+	{
+		const FCubeState State = MakeScrambledState(Random);
+		FCubeTwoPhaseOptions Options;
+		Options.TargetLength = 21;
+		Options.Deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		if (!TestTrue(TEXT("Two-phase solver finds a solution"), TwoPhase->Solve(State, Solution, Options)))
+		{
+			return false;
+		}
+		TestTrue(FString::Printf(TEXT("Two-phase solution %s solves the state"), *Describe(Solution)), State.Apply(Solution).IsSolved());
+		TestTrue(FString::Printf(TEXT("Two-phase solution %s is at most %d moves"), *Describe(Solution), FCubeTwoPhaseSolver::MaxSearchLength),
+		         static_cast<int32>(Solution.size()) <= FCubeTwoPhaseSolver::MaxSearchLength);
+		const bool bRepeatsFace = std::adjacent_find(Solution.begin(), Solution.end(), [](ECubeMove A, ECubeMove B) { return GetMoveFace(A) == GetMoveFace(B); }) != Solution.end();
+		TestFalse(FString::Printf(TEXT("Two-phase solution %s doesn't turn a face twice in a row"), *Describe(Solution)), bRepeatsFace);
+	}
+	return true;
+}
+
+#endif
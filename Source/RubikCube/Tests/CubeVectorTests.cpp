@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CubeTestUtils.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace CubeTestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeVectorMovesTest, "RubikCube.Cube.Vector.Moves",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCubeVectorMovesTest::RunTest(const FString& Parameters)
+{
+	const TArray<ECubeSimdLevel> Levels = GetTestedSimdLevels();
+	if (GetSupportedSimdLevel() != ECubeSimdLevel::AVX2)
+	{
+		AddWarning(FString::Printf(TEXT("CPU supports only %s, the AVX2 shuffle path isn't covered"), UTF8_TO_TCHAR(ToString(GetSupportedSimdLevel()))));
+	}
+
+	TestTrue(TEXT("Solved vector"), FCubeVector::Solved() == FCubeVector::FromState(FCubeState::Solved()));
+
+	// Lengths run through 0..63, so sequences shorter and longer than any unrolled block of the vector paths are covered
+	std::mt19937 Random(Seed);
+	for (int32 Sequence = 0; Sequence < 512; ++Sequence)
+	{
+		const FCubeState Start = Sequence % 2 == 0 ? FCubeState::Solved() : MakeScrambledState(Random);
+		const std::vector<ECubeMove> Moves = MakeRandomMoves(Random, Sequence % 64);
+		const FCubeState Expected = FCubeState::FromCubie(ApplyCubieMoves(Start.ToCubie(), Moves));
+
+		FCubeVector Single = FCubeVector::FromState(Start);
+		for (const ECubeMove Move : Moves)
+		{
+			Single = Single.Apply(Move);
+		}
+		if (!TestTrue(FString::Printf(TEXT("Vector state moved one by one after %s"), *Describe(Moves)), Single.ToState() == Expected))
+		{
+			return false;
+		}
+
+		for (const ECubeSimdLevel Level : Levels)
+		{
+			FCubeVector Vector = FCubeVector::FromState(Start);
+			ApplyMoves(Vector, Moves.data(), Moves.size(), Level);
+			// Comparing whole vectors also checks the padding bytes stay zero
+			if (!TestTrue(FString::Printf(TEXT("%s vector state after %s"), UTF8_TO_TCHAR(ToString(Level)), *Describe(Moves)),
+			              Vector == FCubeVector::FromState(Expected)))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+#endif